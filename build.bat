@@ -6,6 +6,9 @@ echo ========================================
 REM Navigate to project root
 cd /d "%~dp0"
 
+REM "build.bat tools" builds and runs the portable tests and benchmarks instead
+if /i "%~1"=="tools" goto tools
+
 REM Create build directory if it doesn't exist
 if not exist build mkdir build
 
@@ -24,9 +27,18 @@ gcc -c src\input_blocker.cpp -o build\input_blocker.o
 gcc -c src\tray_icon.cpp -o build\tray_icon.o
 gcc -c src\audio_manager.cpp -o build\audio_manager.o
 gcc -c src\custom_notifications.cpp -o build\custom_notifications.o
+gcc -c src\animation_clock.cpp -o build\animation_clock.o
 gcc -c src\notifications.cpp -o build\notifications.o
 gcc -c src\overlay.cpp -o build\overlay.o
 gcc -c src\utils\hotkey_utils.cpp -o build\hotkey_utils.o
+gcc -c src\utils\sha256.cpp -o build\sha256.o
+gcc -c src\utils\sha1.cpp -o build\sha1.o
+gcc -c src\utils\hmac.cpp -o build\hmac.o
+gcc -c src\utils\latency_histogram.cpp -o build\latency_histogram.o
+gcc -c src\utils\notification_compositor.cpp -o build\notification_compositor.o
+gcc -c src\utils\pixel_kernels.cpp -o build\pixel_kernels.o
+gcc -c src\utils\notification_queue.cpp -o build\notification_queue.o
+gcc -c src\utils\notification_slab.cpp -o build\notification_slab.o
 gcc -c src\features\lock_input\lock_input_tab.cpp -o build\lock_input_tab.o
 gcc -c src\ui\productivity_tab.cpp -o build\productivity_tab.o
 gcc -c src\ui\privacy_tab.cpp -o build\privacy_tab.o
@@ -43,6 +55,25 @@ gcc -c src\settings.cpp -o build\settings.o
 gcc -c src\features\lock_input\hotkey_manager.cpp -o build\hotkey_manager.o
 gcc -c src\features\appearance\overlay_manager.cpp -o build\overlay_manager.o
 gcc -c src\features\lock_input\password_manager.cpp -o build\password_manager.o
+gcc -c src\features\lock_input\password_matcher.cpp -o build\password_matcher.o
+gcc -c src\features\lock_input\credential_set.cpp -o build\credential_set.o
+gcc -c src\features\lock_input\verification_worker.cpp -o build\verification_worker.o
+gcc -c src\features\lock_input\key_policy.cpp -o build\key_policy.o
+gcc -c src\features\lock_input\hook_latency.cpp -o build\hook_latency.o
+gcc -c src\features\lock_input\hook_watchdog.cpp -o build\hook_watchdog.o
+gcc -c src\features\lock_input\hook_policy.cpp -o build\hook_policy.o
+gcc -c src\features\lock_input\lock_engine.cpp -o build\lock_engine.o
+gcc -c src\features\lock_input\lock_pipeline.cpp -o build\lock_pipeline.o
+gcc -c src\features\lock_input\chord_trie.cpp -o build\chord_trie.o
+gcc -c src\features\lock_input\app_lock_rules.cpp -o build\app_lock_rules.o
+gcc -c src\features\lock_input\key_translation.cpp -o build\key_translation.o
+gcc -c src\features\lock_input\totp.cpp -o build\totp.o
+gcc -c src\features\lock_input\totp_manager.cpp -o build\totp_manager.o
+gcc -c src\features\lock_input\synthetic_input_backend.cpp -o build\synthetic_input_backend.o
+gcc -c src\features\lock_input\hook_input_backend.cpp -o build\hook_input_backend.o
+gcc -c src\features\lock_input\raw_input_backend.cpp -o build\raw_input_backend.o
+gcc -c src\features\lock_input\input_trace.cpp -o build\input_trace.o
+gcc -c src\features\lock_input\input_trace_replay.cpp -o build\input_trace_replay.o
 gcc -c src\settings\settings_core.cpp -o build\settings_core.o
 gcc -c src\features\lock_input\timer_manager.cpp -o build\timer_manager.o
 if %errorlevel% neq 0 (
@@ -68,9 +99,18 @@ gcc -o UtilityApp.exe ^
     build\tray_icon.o ^
     build\audio_manager.o ^
     build\custom_notifications.o ^
+    build\animation_clock.o ^
     build\notifications.o ^
     build\overlay.o ^
     build\hotkey_utils.o ^
+    build\sha256.o ^
+    build\sha1.o ^
+    build\hmac.o ^
+    build\latency_histogram.o ^
+    build\notification_compositor.o ^
+    build\pixel_kernels.o ^
+    build\notification_queue.o ^
+    build\notification_slab.o ^
     build\lock_input_tab.o ^
     build\productivity_tab.o ^
     build\privacy_tab.o ^
@@ -80,12 +120,31 @@ gcc -o UtilityApp.exe ^
     build\hotkey_manager.o ^
     build\overlay_manager.o ^
     build\password_manager.o ^
+    build\password_matcher.o ^
+    build\credential_set.o ^
+    build\verification_worker.o ^
+    build\key_policy.o ^
+    build\hook_latency.o ^
+    build\hook_watchdog.o ^
+    build\hook_policy.o ^
+    build\lock_engine.o ^
+    build\lock_pipeline.o ^
+    build\chord_trie.o ^
+    build\app_lock_rules.o ^
+    build\key_translation.o ^
+    build\totp.o ^
+    build\totp_manager.o ^
+    build\synthetic_input_backend.o ^
+    build\hook_input_backend.o ^
+    build\raw_input_backend.o ^
+    build\input_trace.o ^
+    build\input_trace_replay.o ^
     build\settings_core.o ^
     build\timer_manager.o ^
     build\privacy_manager.o ^
     build\productivity_manager.o ^
     build\resources.o ^
-    -static-libgcc -static-libstdc++ -std=c++17 -mwindows -lgdi32 -luser32 -lshell32 -ladvapi32 -lcomctl32 -lstdc++ -lwinmm -lmsimg32 -ldwmapi
+    -static-libgcc -static-libstdc++ -std=c++17 -mwindows -lgdi32 -luser32 -lshell32 -ladvapi32 -lcomctl32 -lstdc++ -lwinmm -lmsimg32 -ldwmapi -lcrypt32
 
 if %errorlevel% neq 0 (
     echo ERROR: Failed to link executable
@@ -106,3 +165,88 @@ echo Build completed at: %date% %time%
 echo.
 echo The application is ready to run!
 pause
+exit /b 0
+
+:tools
+echo ========================================
+echo Building and running portable tests and benchmarks (tools\)...
+echo ========================================
+if not exist build\tools mkdir build\tools
+set TOOL_FLAGS=-std=c++17 -O2 -Wall -pthread -Isrc -static
+
+g++ %TOOL_FLAGS% tools\spsc_ring_bench.cpp -o build\tools\spsc_ring_bench.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\sha256_vectors.cpp src\utils\sha256.cpp -o build\tools\sha256_vectors.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\lock_engine_bench.cpp src\features\lock_input\lock_engine.cpp src\features\lock_input\hook_policy.cpp src\features\lock_input\key_policy.cpp -o build\tools\lock_engine_bench.exe || goto tool_failed
+build\tools\lock_engine_bench.exe || goto tool_failed
+build\tools\sha256_vectors.exe || goto tool_failed
+build\tools\spsc_ring_bench.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\snapshot_publisher_stress.cpp -o build\tools\snapshot_publisher_stress.exe || goto tool_failed
+build\tools\snapshot_publisher_stress.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\chord_matcher_bench.cpp src\features\lock_input\chord_trie.cpp src\features\lock_input\lock_pipeline.cpp src\features\lock_input\lock_engine.cpp src\features\lock_input\hook_policy.cpp src\features\lock_input\key_policy.cpp src\features\lock_input\key_translation.cpp -o build\tools\chord_matcher_bench.exe || goto tool_failed
+build\tools\chord_matcher_bench.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\mouse_lock_modes.cpp src\features\lock_input\lock_engine.cpp src\features\lock_input\hook_policy.cpp src\features\lock_input\key_policy.cpp -o build\tools\mouse_lock_modes.exe || goto tool_failed
+build\tools\mouse_lock_modes.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\key_translation_tests.cpp src\features\lock_input\key_translation.cpp src\features\lock_input\lock_pipeline.cpp src\features\lock_input\lock_engine.cpp src\features\lock_input\hook_policy.cpp src\features\lock_input\key_policy.cpp src\features\lock_input\chord_trie.cpp -o build\tools\key_translation_tests.exe || goto tool_failed
+build\tools\key_translation_tests.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\credential_set_tests.cpp src\features\lock_input\credential_set.cpp src\features\lock_input\password_matcher.cpp src\utils\sha256.cpp -o build\tools\credential_set_tests.exe || goto tool_failed
+build\tools\credential_set_tests.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\totp_vectors.cpp src\features\lock_input\totp.cpp src\utils\hmac.cpp src\utils\sha1.cpp src\utils\sha256.cpp -o build\tools\totp_vectors.exe || goto tool_failed
+build\tools\totp_vectors.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\hook_watchdog_tests.cpp src\features\lock_input\hook_watchdog.cpp -o build\tools\hook_watchdog_tests.exe || goto tool_failed
+build\tools\hook_watchdog_tests.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\notification_queue_tests.cpp src\utils\notification_queue.cpp -o build\tools\notification_queue_tests.exe || goto tool_failed
+build\tools\notification_queue_tests.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\notification_slab_tests.cpp src\utils\notification_slab.cpp -o build\tools\notification_slab_tests.exe || goto tool_failed
+build\tools\notification_slab_tests.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\pixel_kernel_tests.cpp src\utils\pixel_kernels.cpp -o build\tools\pixel_kernel_tests.exe || goto tool_failed
+build\tools\pixel_kernel_tests.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\password_matcher_bench.cpp src\features\lock_input\password_matcher.cpp src\utils\sha256.cpp -o build\tools\password_matcher_bench.exe || goto tool_failed
+build\tools\password_matcher_bench.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\verification_worker_bench.cpp src\features\lock_input\verification_worker.cpp -o build\tools\verification_worker_bench.exe || goto tool_failed
+build\tools\verification_worker_bench.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\key_policy_bench.cpp src\features\lock_input\key_policy.cpp -o build\tools\key_policy_bench.exe || goto tool_failed
+build\tools\key_policy_bench.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\latency_histogram_tests.cpp src\utils\latency_histogram.cpp -o build\tools\latency_histogram_tests.exe || goto tool_failed
+build\tools\latency_histogram_tests.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\hook_thread_latency.cpp src\features\lock_input\lock_pipeline.cpp src\features\lock_input\lock_engine.cpp src\features\lock_input\hook_policy.cpp src\features\lock_input\key_policy.cpp src\features\lock_input\chord_trie.cpp src\features\lock_input\key_translation.cpp src\utils\latency_histogram.cpp -o build\tools\hook_thread_latency.exe || goto tool_failed
+build\tools\hook_thread_latency.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\pipeline_bench.cpp src\features\lock_input\synthetic_input_backend.cpp src\features\lock_input\lock_pipeline.cpp src\features\lock_input\lock_engine.cpp src\features\lock_input\hook_policy.cpp src\features\lock_input\key_policy.cpp src\features\lock_input\chord_trie.cpp src\features\lock_input\key_translation.cpp src\features\lock_input\password_matcher.cpp -o build\tools\pipeline_bench.exe || goto tool_failed
+build\tools\pipeline_bench.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\app_lock_rules_tests.cpp src\features\lock_input\app_lock_rules.cpp src\features\lock_input\lock_engine.cpp src\features\lock_input\hook_policy.cpp src\features\lock_input\key_policy.cpp -o build\tools\app_lock_rules_tests.exe || goto tool_failed
+build\tools\app_lock_rules_tests.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\notification_compositor_bench.cpp src\utils\notification_compositor.cpp src\utils\pixel_kernels.cpp src\utils\latency_histogram.cpp -o build\tools\notification_compositor_bench.exe || goto tool_failed
+build\tools\notification_compositor_bench.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\notification_clock_replay.cpp src\utils\notification_compositor.cpp src\utils\pixel_kernels.cpp src\utils\notification_queue.cpp -o build\tools\notification_clock_replay.exe || goto tool_failed
+build\tools\notification_clock_replay.exe || goto tool_failed
+
+g++ %TOOL_FLAGS% tools\trace_replay.cpp src\features\lock_input\input_trace.cpp src\features\lock_input\input_trace_replay.cpp src\features\lock_input\lock_pipeline.cpp src\features\lock_input\lock_engine.cpp src\features\lock_input\hook_policy.cpp src\features\lock_input\chord_trie.cpp src\features\lock_input\key_translation.cpp src\features\lock_input\password_matcher.cpp src\utils\latency_histogram.cpp -o build\tools\trace_replay.exe || goto tool_failed
+build\tools\trace_replay.exe tools\traces\lock_session.bin 1000 00000000 --expect-unlocks=2 || goto tool_failed
+
+echo.
+echo All tools built; every test passed.
+exit /b 0
+
+:tool_failed
+echo ERROR: A tool failed to build or a test failed
+exit /b 1
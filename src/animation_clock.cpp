@@ -0,0 +1,128 @@
+// src/animation_clock.cpp
+// Animation clock implementation
+
+#include "animation_clock.h"
+#include <dwmapi.h>
+
+// DwmFlush returning this fast means nothing is being composed (for example
+// on a locked workstation); sleep instead of spinning
+static const double MIN_FLUSH_MICROSECONDS = 500.0;
+static const DWORD QUICK_FLUSH_SLEEP = 4;  // ms
+static const DWORD FRAME_SLACK = 4;        // ms early a frame may start, to stay on a composition
+
+AnimationClock::AnimationClock()
+    : ticking(false), stopRequested(false), target(nullptr), tickMessage(0), frameInterval(0),
+      tickPending(false), ticksPosted(0), threadWakeups(0), resumes(0) {
+}
+
+AnimationClock::~AnimationClock() {
+    Stop();
+}
+
+bool AnimationClock::Start(HWND target, UINT tickMessage, DWORD frameInterval) {
+    if (IsRunning() || !target) return false;
+
+    this->target = target;
+    this->tickMessage = tickMessage;
+    this->frameInterval = frameInterval;
+    ticking = false;
+    stopRequested = false;
+    tickPending.store(false, std::memory_order_relaxed);
+
+    try {
+        thread = std::thread(&AnimationClock::Run, this);
+    } catch (...) {
+        return false; // Resume() falls back to a window timer
+    }
+    return true;
+}
+
+void AnimationClock::Stop() {
+    if (target) KillTimer(target, FALLBACK_TIMER_ID);
+    if (!IsRunning()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopRequested = true;
+    }
+    stateSignal.notify_one();
+    thread.join();
+}
+
+void AnimationClock::Resume() {
+    if (!IsRunning()) {
+        if (target) SetTimer(target, FALLBACK_TIMER_ID, frameInterval, nullptr);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (ticking) return;
+        ticking = true;
+    }
+    resumes.fetch_add(1, std::memory_order_relaxed);
+    stateSignal.notify_one();
+}
+
+void AnimationClock::Pause() {
+    if (!IsRunning()) {
+        if (target) KillTimer(target, FALLBACK_TIMER_ID);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(stateMutex);
+    ticking = false;
+}
+
+bool AnimationClock::IsTicking() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return ticking;
+}
+
+// Blocks until the next composition, or for a frame when DWM is off
+void AnimationClock::WaitForFrame() {
+    LARGE_INTEGER frequency, before, after;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&before);
+
+    if (FAILED(DwmFlush())) {
+        Sleep(frameInterval);
+        return;
+    }
+    QueryPerformanceCounter(&after);
+    double microseconds = (double)(after.QuadPart - before.QuadPart) * 1000000.0 / (double)frequency.QuadPart;
+    if (microseconds < MIN_FLUSH_MICROSECONDS) Sleep(QUICK_FLUSH_SLEEP);
+}
+
+void AnimationClock::Run() {
+    DWORD lastTick = GetTickCount() - frameInterval;
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    while (!stopRequested) {
+        if (!ticking) {
+            stateSignal.wait(lock);
+            continue;
+        }
+        lock.unlock();
+
+        WaitForFrame();
+        threadWakeups.fetch_add(1, std::memory_order_relaxed);
+
+        DWORD now = GetTickCount();
+        if (now - lastTick + FRAME_SLACK >= frameInterval && !tickPending.exchange(true, std::memory_order_acq_rel)) {
+            if (PostMessage(target, tickMessage, 0, 0)) {
+                ticksPosted.fetch_add(1, std::memory_order_relaxed);
+                lastTick = now;
+            } else {
+                tickPending.store(false, std::memory_order_release);
+            }
+        }
+        lock.lock();
+    }
+}
+
+AnimationClockStats AnimationClock::GetStats() const {
+    AnimationClockStats stats;
+    stats.ticksPosted = ticksPosted.load(std::memory_order_relaxed);
+    stats.threadWakeups = threadWakeups.load(std::memory_order_relaxed);
+    stats.resumes = resumes.load(std::memory_order_relaxed);
+    return stats;
+}
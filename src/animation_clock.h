@@ -0,0 +1,65 @@
+// src/animation_clock.h
+// Frame clock for window animations: ticks in step with DWM composition, silent when idle
+
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+// Counters for diagnostics (monotonic since Start)
+struct AnimationClockStats {
+    uint64_t ticksPosted;    // Tick messages sent to the window
+    uint64_t threadWakeups;  // Clock thread returns from DwmFlush/Sleep
+    uint64_t resumes;        // Idle -> ticking transitions
+};
+
+// A thread waits in DwmFlush() while ticking and posts the tick message to
+// the window at most once per frameInterval, right after a composition, so
+// frames are drawn in step with the screen. Between Pause() and Resume() the
+// thread blocks on a condition variable and nothing wakes at all. A tick is
+// not posted again until the window calls TickHandled(), so a busy UI thread
+// never finds a backlog. Without a thread it falls back to a window timer
+// that delivers WM_TIMER with FALLBACK_TIMER_ID.
+class AnimationClock {
+public:
+    static const UINT_PTR FALLBACK_TIMER_ID = 1;
+
+private:
+    std::thread thread;
+    std::mutex stateMutex;
+    std::condition_variable stateSignal;
+    bool ticking;
+    bool stopRequested;
+
+    HWND target;
+    UINT tickMessage;
+    DWORD frameInterval;
+    std::atomic<bool> tickPending;
+
+    std::atomic<uint64_t> ticksPosted;
+    std::atomic<uint64_t> threadWakeups;
+    std::atomic<uint64_t> resumes;
+
+    void Run();
+    void WaitForFrame();
+
+public:
+    AnimationClock();
+    ~AnimationClock();
+
+    bool Start(HWND target, UINT tickMessage, DWORD frameInterval);
+    void Stop();
+    bool IsRunning() const { return thread.joinable(); }
+
+    // UI thread: start or stop ticking (cheap if already in that state)
+    void Resume();
+    void Pause();
+    bool IsTicking();
+
+    // UI thread, first thing in the tick handler
+    void TickHandled() { tickPending.store(false, std::memory_order_release); }
+
+    AnimationClockStats GetStats() const;
+};
@@ -2,10 +2,12 @@
 // Custom lightweight notification system implementation
 
 #include "custom_notifications.h"
+#include "utils/pixel_kernels.h"
 #include "audio_manager.h"
 #include "settings.h"
 #include <windows.h>
 #include <dwmapi.h>
+#include <cstdio>
 
 // Global instance
 CustomNotificationSystem* g_customNotifications = nullptr;
@@ -16,10 +18,35 @@ extern HWND g_mainWindow;
 
 const char* NOTIFY_CLASS_NAME = "CustomNotifyClass";
 
+// 2 px progress line just above the bottom border, 4 px corners
+const NotificationLayout CustomNotificationSystem::LAYOUT = {
+    NOTIFY_WIDTH, NOTIFY_HEIGHT, 10, NOTIFY_HEIGHT - 3, 2, 4
+};
+
+static uint32_t ColorToPixel(COLORREF color) {
+    return MakePixel(GetRValue(color), GetGValue(color), GetBValue(color));
+}
+
+static void DestroySurface(DibSurface& surface) {
+    if (surface.dc) {
+        SelectObject(surface.dc, surface.oldBitmap);
+        DeleteDC(surface.dc);
+    }
+    if (surface.bitmap) DeleteObject(surface.bitmap);
+    surface = DibSurface();
+}
+
 CustomNotificationSystem::CustomNotificationSystem() 
     : hNotifyWindow(nullptr), hTitleFont(nullptr), hMessageFont(nullptr),
-      hBackgroundBrush(nullptr), hBorderPen(nullptr), currentStyle(NOTIFY_STYLE_CUSTOM) {
+      hBackgroundBrush(nullptr), hBorderPen(nullptr), hErrorBrush(nullptr), hErrorBorderPen(nullptr),
+      bodySurface(), frameSurface(), windowPosition(), currentStyle(NOTIFY_STYLE_CUSTOM) {
     instance = this;
+    renderStats.frames = 0;
+    renderStats.gdiObjectsCreated = 0;
+    renderStats.bodiesRendered = 0;
+    renderStats.clockTicks = 0;
+    renderStats.idleTicks = 0;
+    renderStats.scheduledWakes = 0;
 }
 
 CustomNotificationSystem::~CustomNotificationSystem() {
@@ -60,10 +87,13 @@ void CustomNotificationSystem::Initialize() {
     // Create drawing objects
     hBackgroundBrush = CreateSolidBrush(BG_COLOR);
     hBorderPen = CreatePen(PS_SOLID, 1, RGB(40, 40, 40));
+    hErrorBrush = CreateSolidBrush(ERROR_BG_COLOR);
+    hErrorBorderPen = CreatePen(PS_SOLID, 1, ERROR_BORDER_COLOR);
+    CreateSurface(bodySurface, NOTIFY_WIDTH, NOTIFY_HEIGHT);
     
-    // OPTIMIZATION: Reduce timer frequency to save CPU/RAM usage
-    // 30 FPS is sufficient for notification animations and reduces resource usage
-    SetTimer(hNotifyWindow, 1, 33, TimerProc); // ~30 FPS for balanced performance
+    // 30 FPS is sufficient for notification animations; the clock only runs
+    // while a notification fades or slides, so an idle app never wakes for it
+    animationClock.Start(hNotifyWindow, WM_NOTIFY_FRAME, FRAME_INTERVAL);
 }
 
 void CustomNotificationSystem::CreateNotificationWindow() {
@@ -76,11 +106,12 @@ void CustomNotificationSystem::CreateNotificationWindow() {
         nullptr, nullptr, GetModuleHandle(nullptr), this
     );
     
-    // Enable per-pixel alpha for smooth transparency
-    SetLayeredWindowAttributes(hNotifyWindow, 0, 255, LWA_ALPHA);
+    // No SetLayeredWindowAttributes: the window's contents, per-pixel alpha
+    // included, come only from UpdateLayeredWindow in PresentFrame()
 }
 
-void CustomNotificationSystem::ShowNotification(const std::string& title, const std::string& message, DWORD duration, NotificationLevel level) {
+void CustomNotificationSystem::ShowNotification(const char* title, const char* message, DWORD duration,
+                                                NotificationLevel level, uint32_t source) {
     if (currentStyle == NOTIFY_STYLE_NONE) return;
     
     if (currentStyle == NOTIFY_STYLE_WINDOWS) {
@@ -89,7 +120,7 @@ void CustomNotificationSystem::ShowNotification(const std::string& title, const
         if (level == NOTIFY_LEVEL_WARNING) iconType = MB_ICONWARNING;
         else if (level == NOTIFY_LEVEL_ERROR) iconType = MB_ICONERROR;
         
-        MessageBox(g_mainWindow, message.c_str(), title.c_str(), MB_OK | iconType | MB_TOPMOST);
+        MessageBox(g_mainWindow, message, title, MB_OK | iconType | MB_TOPMOST);
         return;
     }
     
@@ -100,12 +131,28 @@ void CustomNotificationSystem::ShowNotification(const std::string& title, const
         DWORD iconType = NIIF_INFO;
         if (level == NOTIFY_LEVEL_WARNING) iconType = NIIF_WARNING;
         else if (level == NOTIFY_LEVEL_ERROR) iconType = NIIF_ERROR;
-        ShowBalloonTip(g_mainWindow, title.c_str(), message.c_str(), iconType);
+        ShowBalloonTip(g_mainWindow, title, message, iconType);
         return;
     }
     
     // NOTIFY_STYLE_CUSTOM - use custom notification system
-    auto notif = std::make_unique<CustomNotification>(title, message, duration, level);
+    DWORD now = GetTickCount();
+    NotificationOffer offer = queue.Offer(NotificationKey((uint8_t)level, title, message),
+                                          source, (uint8_t)level, now);
+    if (offer.admission == NOTIFY_ADMIT_COALESCED) {
+        // Show the count and keep it up for a full duration from this repeat
+        CustomNotification* notif = &slots[offer.slot];
+        notif->repeatCount = offer.count;
+        notif->duration = (now - notif->showTime) + notif->baseDuration;
+        notif->body.clear();
+        PresentFrame();
+        KillTimer(hNotifyWindow, WAKE_TIMER_ID);
+        animationClock.Resume();
+        return;
+    }
+    if (offer.admission != NOTIFY_ADMIT_NEW) {
+        return; // Rate limited or outranked; the queue counts it
+    }
     
     // Play sound for error notifications only when using CUSTOM notification style
     extern AppSettings g_appSettings;
@@ -121,17 +168,31 @@ void CustomNotificationSystem::ShowNotification(const std::string& title, const
     int screenWidth = GetSystemMetrics(SM_CXSCREEN);
     int screenHeight = GetSystemMetrics(SM_CYSCREEN);
     
-    notif->targetY = screenHeight - NOTIFY_HEIGHT - NOTIFY_MARGIN - (notifications.size() * (NOTIFY_HEIGHT + 10));
+    CustomNotification* notif = &slots[offer.slot];
+    notif->title.assign(title); // Into the slot's existing capacity
+    notif->message.assign(message);
+    notif->showTime = now;
+    notif->duration = duration;
+    notif->baseDuration = duration;
+    notif->isVisible = true;
+    notif->opacity = 0.0f;
+    notif->level = level;
+    notif->repeatCount = 1;
+    notif->suppressed = offer.suppressed;
+    notif->body.clear(); // Keeps its capacity for this slot's next body
+    
+    notif->targetY = screenHeight - NOTIFY_HEIGHT - NOTIFY_MARGIN - NotificationSlotTop(LAYOUT, queue.GetCount() - 1);
     notif->yPosition = screenHeight; // Start off-screen
     
-    notifications.push_back(std::move(notif));
-    
-    // Update window size and position
+    // Update window size and position (an eviction keeps the size but not the contents)
     PositionNotifications();
+    
+    KillTimer(hNotifyWindow, WAKE_TIMER_ID);
+    animationClock.Resume();
 }
 
 void CustomNotificationSystem::PositionNotifications() {
-    if (notifications.empty()) {
+    if (queue.GetCount() == 0) {
         ShowWindow(hNotifyWindow, SW_HIDE);
         return;
     }
@@ -139,23 +200,25 @@ void CustomNotificationSystem::PositionNotifications() {
     int screenWidth = GetSystemMetrics(SM_CXSCREEN);
     int screenHeight = GetSystemMetrics(SM_CYSCREEN);
     
-    int totalHeight = notifications.size() * (NOTIFY_HEIGHT + 10) - 10;
-    int windowX = screenWidth - NOTIFY_WIDTH - NOTIFY_MARGIN;
-    int windowY = screenHeight - totalHeight - NOTIFY_MARGIN;
+    int totalHeight = NotificationStackHeight(LAYOUT, queue.GetCount());
+    windowPosition.x = screenWidth - NOTIFY_WIDTH - NOTIFY_MARGIN;
+    windowPosition.y = screenHeight - totalHeight - NOTIFY_MARGIN;
     
-    SetWindowPos(hNotifyWindow, HWND_TOPMOST, 
-                 windowX, windowY, 
-                 NOTIFY_WIDTH, totalHeight,
-                 SWP_NOACTIVATE | SWP_SHOWWINDOW);
+    // The frame carries the new position and size
+    if (!PresentFrame()) return;
+    if (!IsWindowVisible(hNotifyWindow)) {
+        SetWindowPos(hNotifyWindow, HWND_TOPMOST, 0, 0, 0, 0,
+                     SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE | SWP_SHOWWINDOW);
+    }
 }
 
-void CustomNotificationSystem::UpdateNotifications() {
+bool CustomNotificationSystem::UpdateNotifications() {
     DWORD currentTime = GetTickCount();
     bool needsUpdate = false;
     
     // Update notifications and remove expired ones
-    for (auto it = notifications.begin(); it != notifications.end();) {
-        auto& notif = *it;
+    for (size_t position = 0; position < queue.GetCount();) {
+        CustomNotification* notif = At(position);
         
         // Handle fading
         DWORD elapsed = currentTime - notif->showTime;
@@ -170,7 +233,7 @@ void CustomNotificationSystem::UpdateNotifications() {
             needsUpdate = true;
             
             if (notif->opacity <= 0) {
-                it = notifications.erase(it);
+                queue.Remove(queue.GetSlot(position));
                 continue;
             }
         } else {
@@ -179,103 +242,168 @@ void CustomNotificationSystem::UpdateNotifications() {
         
         // Handle slide animation
         if (notif->yPosition != notif->targetY) {
-            int diff = notif->targetY - notif->yPosition;
-            notif->yPosition += diff / 8; // Smooth slide
-            if (abs(diff) < 2) notif->yPosition = notif->targetY;
+            notif->yPosition = NotificationSlide(notif->yPosition, notif->targetY);
             needsUpdate = true;
         }
         
-        ++it;
+        ++position;
     }
     
     if (needsUpdate) {
         PositionNotifications();
-        InvalidateRect(hNotifyWindow, nullptr, FALSE);
     }
+    return needsUpdate && queue.GetCount() > 0; // The last one gone is the end, not another frame
 }
 
-void CustomNotificationSystem::DrawNotification(HDC hdc, CustomNotification* notif, int index) {
-    int y = index * (NOTIFY_HEIGHT + 10);
-    
-    // Apply opacity
-    BLENDFUNCTION blend = {};
-    blend.BlendOp = AC_SRC_OVER;
-    blend.BlendFlags = 0;
-    blend.SourceConstantAlpha = (BYTE)(notif->opacity * 255);
-    blend.AlphaFormat = 0;
-    
-    // Create memory DC for double buffering
-    HDC memDC = CreateCompatibleDC(hdc);
-    HBITMAP memBitmap = CreateCompatibleBitmap(hdc, NOTIFY_WIDTH, NOTIFY_HEIGHT);
-    HBITMAP oldBitmap = (HBITMAP)SelectObject(memDC, memBitmap);
-    
-    // Choose colors based on notification level
-    COLORREF bgColor = BG_COLOR;
-    COLORREF accentColor = ACCENT_COLOR;
-    COLORREF borderColor = RGB(40, 40, 40);
-    
-    if (notif->level == NOTIFY_LEVEL_ERROR) {
-        bgColor = ERROR_BG_COLOR;
-        accentColor = ERROR_ACCENT_COLOR;
-        borderColor = ERROR_BORDER_COLOR;
+// Clock tick: advance the animations; once nothing moves, stop the clock
+// until the next fade-out is due
+void CustomNotificationSystem::OnFrameTick() {
+    renderStats.clockTicks++;
+    if (queue.GetCount() == 0) renderStats.idleTicks++;
+    
+    if (UpdateNotifications()) return;
+    animationClock.Pause();
+    ScheduleNextAnimation();
+}
+
+void CustomNotificationSystem::ScheduleNextAnimation() {
+    KillTimer(hNotifyWindow, WAKE_TIMER_ID);
+    if (queue.GetCount() == 0) return; // Nothing left to wake for
+    
+    DWORD now = GetTickCount();
+    uint32_t wait = 0xFFFFFFFFu;
+    for (size_t position = 0; position < queue.GetCount(); position++) {
+        const CustomNotification* notif = At(position);
+        uint32_t idle = NotificationIdleTime(now - notif->showTime, notif->duration, FADE_DURATION);
+        if (idle < wait) wait = idle;
     }
     
-    // Create brushes and pens for this notification
-    HBRUSH currentBgBrush = CreateSolidBrush(bgColor);
-    HPEN currentBorderPen = CreatePen(PS_SOLID, 1, borderColor);
-    
-    // Draw background with rounded corners
+    if (wait == 0) {
+        animationClock.Resume();
+    } else {
+        SetTimer(hNotifyWindow, WAKE_TIMER_ID, wait, TimerProc);
+    }
+}
+
+bool CustomNotificationSystem::CreateSurface(DibSurface& surface, int width, int height) {
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = width;
+    info.bmiHeader.biHeight = -height; // Top-down, so row 0 is the top
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+    
+    void* bits = nullptr;
+    surface.bitmap = CreateDIBSection(nullptr, &info, DIB_RGB_COLORS, &bits, nullptr, 0);
+    surface.dc = surface.bitmap ? CreateCompatibleDC(nullptr) : nullptr;
+    if (!surface.dc) {
+        DestroySurface(surface);
+        return false;
+    }
+    surface.oldBitmap = SelectObject(surface.dc, surface.bitmap);
+    surface.pixels = (uint32_t*)bits;
+    surface.width = width;
+    surface.height = height;
+    renderStats.gdiObjectsCreated += 2;
+    return true;
+}
+
+// Draws the parts of a notification that never change with GDI, once, and
+// keeps the pixels. Uses the brushes, pens and fonts made in Initialize().
+void CustomNotificationSystem::RenderBody(CustomNotification* notif) {
+    if (!bodySurface.dc) return;
+    HDC dc = bodySurface.dc;
+    bool error = notif->level == NOTIFY_LEVEL_ERROR;
+    
+    // Background, then a subtle rounded border
     RECT rect = {0, 0, NOTIFY_WIDTH, NOTIFY_HEIGHT};
-    FillRect(memDC, &rect, currentBgBrush);
-    
-    // Draw subtle border
-    SelectObject(memDC, currentBorderPen);
-    SelectObject(memDC, GetStockObject(NULL_BRUSH));
-    RoundRect(memDC, 0, 0, NOTIFY_WIDTH, NOTIFY_HEIGHT, 8, 8);
+    FillRect(dc, &rect, error ? hErrorBrush : hBackgroundBrush);
+    HGDIOBJ oldPen = SelectObject(dc, error ? hErrorBorderPen : hBorderPen);
+    HGDIOBJ oldBrush = SelectObject(dc, GetStockObject(NULL_BRUSH));
+    int corner = LAYOUT.cornerRadius * 2;
+    RoundRect(dc, 0, 0, NOTIFY_WIDTH, NOTIFY_HEIGHT, corner, corner);
     
-    // Draw text
-    SetBkMode(memDC, TRANSPARENT);
+    SetBkMode(dc, TRANSPARENT);
     
     // Title
-    SelectObject(memDC, hTitleFont);
-    SetTextColor(memDC, TITLE_COLOR);
+    HGDIOBJ oldFont = SelectObject(dc, hTitleFont);
+    SetTextColor(dc, TITLE_COLOR);
     RECT titleRect = {15, 10, NOTIFY_WIDTH - 15, 30};
-    DrawText(memDC, notif->title.c_str(), -1, &titleRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE | DT_END_ELLIPSIS);
+    char title[160];
+    if (notif->repeatCount > 1) {
+        snprintf(title, sizeof(title), "%s (x%u)", notif->title.c_str(), notif->repeatCount);
+    } else {
+        snprintf(title, sizeof(title), "%s", notif->title.c_str());
+    }
+    DrawText(dc, title, -1, &titleRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE | DT_END_ELLIPSIS);
     
     // Message
-    SelectObject(memDC, hMessageFont);
-    SetTextColor(memDC, TEXT_COLOR);
+    SelectObject(dc, hMessageFont);
+    SetTextColor(dc, TEXT_COLOR);
     RECT msgRect = {15, 32, NOTIFY_WIDTH - 15, NOTIFY_HEIGHT - 10};
-    DrawText(memDC, notif->message.c_str(), -1, &msgRect, DT_LEFT | DT_TOP | DT_WORDBREAK | DT_END_ELLIPSIS);
+    char message[320];
+    if (notif->suppressed > 0) {
+        snprintf(message, sizeof(message), "%s (+%u more)", notif->message.c_str(), notif->suppressed);
+    } else {
+        snprintf(message, sizeof(message), "%s", notif->message.c_str());
+    }
+    DrawText(dc, message, -1, &msgRect, DT_LEFT | DT_TOP | DT_WORDBREAK | DT_END_ELLIPSIS);
+    
+    SelectObject(dc, oldFont);
+    SelectObject(dc, oldBrush);
+    SelectObject(dc, oldPen);
+    
+    // GDI batches drawing; finish it before reading the bits
+    GdiFlush();
+    PixelSurface pixels = bodySurface.View();
+    SetSurfaceOpaque(pixels, LAYOUT.cornerRadius); // Transparent outside the border's corners
+    notif->body.assign(bodySurface.pixels, bodySurface.pixels + (size_t)NOTIFY_WIDTH * NOTIFY_HEIGHT);
+    renderStats.bodiesRendered++;
+}
+
+// One frame: every notification's cached body with its progress line, at its
+// opacity, on a transparent background, handed to the window in one
+// UpdateLayeredWindow (position and size included). The desktop shows
+// through the gaps, the rounded corners and fading notifications.
+bool CustomNotificationSystem::PresentFrame() {
+    LARGE_INTEGER start;
+    QueryPerformanceCounter(&start);
+    
+    int height = NotificationStackHeight(LAYOUT, queue.GetCount());
+    if (height <= 0) return false;
+    if (frameSurface.height != height) {
+        DestroySurface(frameSurface);
+        if (!CreateSurface(frameSurface, NOTIFY_WIDTH, height)) return false;
+    }
     
-    // Accent line at bottom (progress indicator)
-    DWORD elapsed = GetTickCount() - notif->showTime;
-    if (elapsed < notif->duration) {
-        float progress = (float)elapsed / notif->duration;
-        int lineWidth = (int)(NOTIFY_WIDTH * progress);
-        
-        HPEN accentPen = CreatePen(PS_SOLID, 2, accentColor);
-        HPEN oldPen = (HPEN)SelectObject(memDC, accentPen);
-        
-        MoveToEx(memDC, 0, NOTIFY_HEIGHT - 2, nullptr);
-        LineTo(memDC, lineWidth, NOTIFY_HEIGHT - 2);
+    PixelSurface frame = frameSurface.View();
+    FillSurface(frame, 0);
+    
+    DWORD now = GetTickCount();
+    for (size_t i = 0; i < queue.GetCount(); ++i) {
+        CustomNotification* notif = At(i);
+        if (notif->body.empty()) RenderBody(notif);
+        if (notif->body.empty()) continue;
         
-        SelectObject(memDC, oldPen);
-        DeleteObject(accentPen);
+        COLORREF accentColor = notif->level == NOTIFY_LEVEL_ERROR ? ERROR_ACCENT_COLOR : ACCENT_COLOR;
+        NotificationBand band = NotificationProgressBand(LAYOUT, now - notif->showTime, notif->duration,
+                                                         ColorToPixel(accentColor));
+        PixelSurface body = { notif->body.data(), NOTIFY_WIDTH, NOTIFY_HEIGHT, NOTIFY_WIDTH };
+        CompositeNotification(frame, 0, NotificationSlotTop(LAYOUT, i), body, band, NotificationAlpha(notif->opacity));
     }
     
-    // Blend to main DC
-    AlphaBlend(hdc, 0, y, NOTIFY_WIDTH, NOTIFY_HEIGHT,
-               memDC, 0, 0, NOTIFY_WIDTH, NOTIFY_HEIGHT, blend);
-    
-    // Cleanup
-    SelectObject(memDC, oldBitmap);
-    DeleteObject(memBitmap);
-    DeleteObject(memDC);
-    DeleteObject(currentBgBrush);
-    DeleteObject(currentBorderPen);
-    DeleteObject(memBitmap);
-    DeleteDC(memDC);
+    SIZE size = { NOTIFY_WIDTH, height };
+    POINT source = { 0, 0 };
+    BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA }; // Pixels are premultiplied
+    BOOL presented = UpdateLayeredWindow(hNotifyWindow, nullptr, &windowPosition, &size, frameSurface.dc,
+                                         &source, 0, &blend, ULW_ALPHA);
+    
+    LARGE_INTEGER end;
+    QueryPerformanceCounter(&end);
+    renderStats.paintTicks.Record((uint64_t)(end.QuadPart - start.QuadPart));
+    renderStats.frames++;
+    return presented != FALSE;
 }
 
 LRESULT CALLBACK CustomNotificationSystem::NotifyWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
@@ -292,23 +420,18 @@ LRESULT CALLBACK CustomNotificationSystem::NotifyWndProc(HWND hwnd, UINT msg, WP
     if (!pThis) return DefWindowProc(hwnd, msg, wParam, lParam);
     
     switch (msg) {
-        case WM_PAINT: {
-            PAINTSTRUCT ps;
-            HDC hdc = BeginPaint(hwnd, &ps);
-            
-            // Clear background
-            RECT rect;
-            GetClientRect(hwnd, &rect);
-            FillRect(hdc, &rect, (HBRUSH)GetStockObject(BLACK_BRUSH));
-            
-            // Draw all notifications
-            for (size_t i = 0; i < pThis->notifications.size(); ++i) {
-                pThis->DrawNotification(hdc, pThis->notifications[i].get(), (int)i);
-            }
-            
-            EndPaint(hwnd, &ps);
+        case WM_NOTIFY_FRAME:
+            pThis->animationClock.TickHandled();
+            pThis->OnFrameTick();
             return 0;
-        }
+        
+        case WM_TIMER:
+            // Only without a clock thread (see AnimationClock)
+            if (wParam == AnimationClock::FALLBACK_TIMER_ID) {
+                pThis->OnFrameTick();
+                return 0;
+            }
+            break;
         
         case WM_LBUTTONDOWN: {
             // Click to dismiss
@@ -324,18 +447,25 @@ LRESULT CALLBACK CustomNotificationSystem::NotifyWndProc(HWND hwnd, UINT msg, WP
     return DefWindowProc(hwnd, msg, wParam, lParam);
 }
 
+// One-shot wake for a fade-out after a still period
 void CALLBACK CustomNotificationSystem::TimerProc(HWND hwnd, UINT msg, UINT_PTR idTimer, DWORD dwTime) {
+    KillTimer(hwnd, idTimer);
     if (instance) {
-        instance->UpdateNotifications();
+        instance->renderStats.scheduledWakes++;
+        instance->animationClock.Resume();
     }
 }
 
 void CustomNotificationSystem::ClearAll() {
-    notifications.clear();
+    queue.Clear();
+    animationClock.Pause();
+    KillTimer(hNotifyWindow, WAKE_TIMER_ID);
     PositionNotifications();
 }
 
 void CustomNotificationSystem::Cleanup() {
+    animationClock.Stop();
+    
     if (hNotifyWindow) {
         DestroyWindow(hNotifyWindow);
         hNotifyWindow = nullptr;
@@ -361,13 +491,26 @@ void CustomNotificationSystem::Cleanup() {
         hBorderPen = nullptr;
     }
     
+    if (hErrorBrush) {
+        DeleteObject(hErrorBrush);
+        hErrorBrush = nullptr;
+    }
+    
+    if (hErrorBorderPen) {
+        DeleteObject(hErrorBorderPen);
+        hErrorBorderPen = nullptr;
+    }
+    
+    DestroySurface(bodySurface);
+    DestroySurface(frameSurface);
+    
     UnregisterClass(NOTIFY_CLASS_NAME, GetModuleHandle(nullptr));
 }
 
 // Helper functions
 void ShowCustomNotification(const std::string& title, const std::string& message, NotificationLevel level) {
     if (g_customNotifications) {
-        g_customNotifications->ShowNotification(title, message, 4000, level);
+        g_customNotifications->ShowNotification(title.c_str(), message.c_str(), 4000, level);
     }
 }
 
@@ -6,6 +6,11 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include "utils/latency_histogram.h"
+#include "utils/notification_compositor.h"
+#include "utils/notification_queue.h"
+#include "animation_clock.h"
 
 enum NotificationStyle {
     NOTIFY_STYLE_CUSTOM = 0,               // Our custom black popup
@@ -30,10 +35,42 @@ struct CustomNotification {
     int yPosition;
     int targetY;
     NotificationLevel level;
+    DWORD baseDuration;   // As shown; a repeat extends duration to this from the repeat
+    uint32_t repeatCount; // Coalesced identical notifications, shown as "(xN)"
+    uint32_t suppressed;  // Rate-limited ones from the same source before this, shown as "(+N more)"
+    std::vector<uint32_t> body; // Background, border, title and message, premultiplied; rendered on first paint
+    
+    CustomNotification()
+        : showTime(0), duration(0), isVisible(false), opacity(0.0f), yPosition(0), targetY(0),
+          level(NOTIFY_LEVEL_INFO), baseDuration(0), repeatCount(0), suppressed(0) {}
     
     CustomNotification(const std::string& t, const std::string& m, DWORD dur = 4000, NotificationLevel lvl = NOTIFY_LEVEL_INFO) 
         : title(t), message(m), showTime(GetTickCount()), duration(dur), 
-          isVisible(true), opacity(0.0f), yPosition(0), targetY(0), level(lvl) {}
+          isVisible(true), opacity(0.0f), yPosition(0), targetY(0), level(lvl),
+          baseDuration(dur), repeatCount(1), suppressed(0) {}
+};
+
+// Top-down 32-bit DIB section selected into its own memory DC
+struct DibSurface {
+    HDC dc;
+    HBITMAP bitmap;
+    HGDIOBJ oldBitmap;
+    uint32_t* pixels;
+    int width;
+    int height;
+    
+    PixelSurface View() const { PixelSurface view = { pixels, width, height, width }; return view; }
+};
+
+// Counters for the notification renderer, kept for the life of the system
+struct NotificationRenderStats {
+    uint64_t frames;
+    uint64_t gdiObjectsCreated;
+    uint64_t bodiesRendered;
+    LatencyHistogram paintTicks; // Compose and present duration in QPC ticks
+    uint64_t clockTicks;      // Animation frames handled
+    uint64_t idleTicks;       // Frames that found no notification (should stay 0)
+    uint64_t scheduledWakes;  // One-shot wakes for a fade-out after a still period
 };
 
 class CustomNotificationSystem {
@@ -41,17 +78,40 @@ private:
     static CustomNotificationSystem* instance;
     
     HWND hNotifyWindow;
-    std::vector<std::unique_ptr<CustomNotification>> notifications;
+    
+    // Shown notifications live in fixed slots; the queue keeps their order
+    // and decides what gets in, so a burst can never grow the stack
+    CustomNotification slots[NotificationQueue::CAPACITY];
+    NotificationQueue queue;
+    
     HFONT hTitleFont;
     HFONT hMessageFont;
     HBRUSH hBackgroundBrush;
     HPEN hBorderPen;
+    HBRUSH hErrorBrush;
+    HPEN hErrorBorderPen;
+    
+    // Each notification's body is drawn once with GDI into bodySurface and
+    // kept as pixels; a frame only composites bodies, progress lines and
+    // opacity into frameSurface and presents it with UpdateLayeredWindow
+    DibSurface bodySurface;
+    DibSurface frameSurface; // Resized with the stack
+    POINT windowPosition;    // Screen position of the stack, passed with each frame
+    NotificationRenderStats renderStats;
+    
+    // Runs only while something fades or slides; a still stack waits on a
+    // one-shot timer for its next fade-out, an empty one on nothing
+    AnimationClock animationClock;
     
     // Notification properties
     static const int NOTIFY_WIDTH = 320;
     static const int NOTIFY_HEIGHT = 80;
     static const int NOTIFY_MARGIN = 10;
     static const int FADE_DURATION = 200;
+    static const DWORD FRAME_INTERVAL = 33;            // ~30 FPS while animating
+    static const UINT WM_NOTIFY_FRAME = WM_APP + 1;    // Posted by animationClock
+    static const UINT_PTR WAKE_TIMER_ID = 2;
+    static const NotificationLayout LAYOUT;
     
     // Colors
     static const COLORREF BG_COLOR = RGB(13, 13, 13);      // #0D0D0D
@@ -65,8 +125,13 @@ private:
     static const COLORREF ERROR_BORDER_COLOR = RGB(180, 40, 40); // Red border
     
     void CreateNotificationWindow();
-    void UpdateNotifications();
-    void DrawNotification(HDC hdc, CustomNotification* notif, int index);
+    bool UpdateNotifications(); // Returns true while anything still animates
+    void OnFrameTick();
+    void ScheduleNextAnimation();
+    CustomNotification* At(size_t position) { return &slots[queue.GetSlot(position)]; }
+    void RenderBody(CustomNotification* notif);
+    bool PresentFrame(); // False if there is nothing to show or the window refused it
+    bool CreateSurface(DibSurface& surface, int width, int height);
     void PositionNotifications();
     
     static LRESULT CALLBACK NotifyWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
@@ -80,9 +145,20 @@ public:
     
     void Initialize();
     void Cleanup();
-    void ShowNotification(const std::string& title, const std::string& message, DWORD duration = 4000, NotificationLevel level = NOTIFY_LEVEL_INFO);
+    // source selects the rate limit bucket (NotificationType for app notifications)
+    void ShowNotification(const char* title, const char* message, DWORD duration = 4000,
+                          NotificationLevel level = NOTIFY_LEVEL_INFO, uint32_t source = NotificationQueue::SOURCE_OTHER);
+    void ShowNotification(const std::string& title, const std::string& message, DWORD duration = 4000,
+                          NotificationLevel level = NOTIFY_LEVEL_INFO, uint32_t source = NotificationQueue::SOURCE_OTHER) {
+        ShowNotification(title.c_str(), message.c_str(), duration, level, source);
+    }
     void ClearAll();
     void SetStyle(NotificationStyle style) { currentStyle = style; }
+    
+    // Diagnostics: counters since the system was created
+    const NotificationRenderStats& GetRenderStats() const { return renderStats; }
+    AnimationClockStats GetClockStats() const { return animationClock.GetStats(); }
+    NotificationQueueStats GetQueueStats() const { return queue.GetStats(); }
     NotificationStyle GetStyle() const { return currentStyle; }
     
 private:
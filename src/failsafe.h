@@ -1,16 +1,42 @@
 // src/failsafe.h
 
 #pragma once
-#include <windows.h>
+#include <cstdint>
 
 class Failsafe {
 public:
-    Failsafe();
+    Failsafe() : esc_press_count(0), last_esc_press_time(0) {}
     // Call this every time the ESC key is pressed.
     // Returns true if the failsafe condition is met.
     bool recordEscPress();
 
+    // Same, with the press time supplied by the caller (milliseconds on the
+    // GetTickCount clock, e.g. KBDLLHOOKSTRUCT::time) so the check has no
+    // Win32 dependency and can run from a replayed event stream.
+    bool recordEscPress(uint32_t current_time) {
+        // If the time since the last press is outside the window, reset the count.
+        if (current_time - last_esc_press_time > FAILSAFE_TIME_WINDOW_MS) {
+            esc_press_count = 1;
+        } else {
+            esc_press_count++;
+        }
+
+        last_esc_press_time = current_time;
+
+        // Check if the failsafe condition is met
+        if (esc_press_count >= FAILSAFE_KEY_COUNT) {
+            esc_press_count = 0; // Reset after triggering
+            return true;
+        }
+
+        return false;
+    }
+
 private:
+    // Failsafe configuration
+    static const int FAILSAFE_KEY_COUNT = 3;
+    static const uint32_t FAILSAFE_TIME_WINDOW_MS = 3000; // 3 seconds
+
     int esc_press_count;
-    DWORD last_esc_press_time;
-};
\ No newline at end of file
+    uint32_t last_esc_press_time;
+};
@@ -0,0 +1,104 @@
+// src/features/lock_input/app_lock_rules.cpp
+// Per-application lock rule parsing and matching
+
+#include "app_lock_rules.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+static char LowerAscii(char ch) {
+    return (ch >= 'A' && ch <= 'Z') ? (char)(ch - 'A' + 'a') : ch;
+}
+
+// FNV-1a over the lower-cased name
+uint32_t AppLockRules::HashName(const char* name, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)LowerAscii(name[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Trims surrounding whitespace and lower-cases
+static std::string NormalizeRuleToken(const std::string& text, size_t start, size_t end) {
+    while (start < end && isspace((unsigned char)text[start])) start++;
+    while (end > start && isspace((unsigned char)text[end - 1])) end--;
+
+    std::string token = text.substr(start, end - start);
+    for (size_t i = 0; i < token.length(); i++) {
+        token[i] = LowerAscii(token[i]);
+    }
+    return token;
+}
+
+size_t AppLockRules::Parse(const std::string& text) {
+    rules.clear();
+
+    size_t start = 0;
+    while (start < text.length()) {
+        size_t end = text.find(';', start);
+        if (end == std::string::npos) end = text.length();
+
+        size_t equals = text.find('=', start);
+        if (equals == std::string::npos || equals > end) equals = end;
+
+        Rule rule;
+        rule.name = NormalizeRuleToken(text, start, equals);
+        rule.scope = LOCK_SCOPE_ALL;
+        if (equals < end) {
+            std::string scope = NormalizeRuleToken(text, equals + 1, end);
+            if (scope == "keyboard") {
+                rule.scope = LOCK_SCOPE_KEYBOARD;
+            } else if (scope == "mouse") {
+                rule.scope = LOCK_SCOPE_MOUSE;
+            } else if (scope != "all") {
+                rule.name.clear(); // Unknown scope - skip the rule rather than guess
+            }
+        }
+        start = end + 1;
+
+        // Rules name files, not paths
+        if (rule.name.empty() || rule.name.find_first_of("\\/") != std::string::npos) continue;
+
+        rule.hash = HashName(rule.name.c_str(), rule.name.length());
+        rules.push_back(rule);
+    }
+
+    // Stable, so of two rules naming the same file the first one written
+    // sorts first; it is the one kept
+    std::stable_sort(rules.begin(), rules.end(), [](const Rule& a, const Rule& b) {
+        return a.hash < b.hash || (a.hash == b.hash && a.name < b.name);
+    });
+    rules.erase(std::unique(rules.begin(), rules.end(), [](const Rule& a, const Rule& b) {
+        return a.hash == b.hash && a.name == b.name;
+    }), rules.end());
+    return rules.size();
+}
+
+uint8_t AppLockRules::Match(const char* imagePath) const {
+    if (!imagePath || rules.empty()) return LOCK_SCOPE_NONE;
+
+    const char* name = imagePath;
+    for (const char* p = imagePath; *p; p++) {
+        if (*p == '\\' || *p == '/') name = p + 1;
+    }
+    size_t length = strlen(name);
+    uint32_t hash = HashName(name, length);
+
+    // First rule with this hash, then compare names (Parse() dropped duplicates)
+    size_t low = 0, high = rules.size();
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (rules[mid].hash < hash) low = mid + 1; else high = mid;
+    }
+    for (size_t i = low; i < rules.size() && rules[i].hash == hash; i++) {
+        const std::string& candidate = rules[i].name;
+        if (candidate.length() != length) continue;
+
+        size_t j = 0;
+        while (j < length && LowerAscii(name[j]) == candidate[j]) j++;
+        if (j == length) return rules[i].scope;
+    }
+    return LOCK_SCOPE_NONE;
+}
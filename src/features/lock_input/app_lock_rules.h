@@ -0,0 +1,42 @@
+// src/features/lock_input/app_lock_rules.h
+// Per-application lock rules: which devices a lock applies to while a given process is in front (portable)
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "lock_engine.h"
+
+// Maps process image names to the LockScope a lock has while that process
+// owns the foreground window. Matching happens on foreground changes only;
+// the result is handed to the engine with SetScope(), which the hook reads.
+//
+// Rule syntax: "kiosk.exe; vlc.exe = mouse; notepad.exe = keyboard". Names
+// are matched case-insensitively against the file name of the image path;
+// the scope is keyboard, mouse or all (the default).
+class AppLockRules {
+private:
+    struct Rule {
+        uint32_t hash;    // Of the lower-case name; rules are sorted by it
+        std::string name; // Lower case
+        uint8_t scope;    // LockScope
+    };
+
+    std::vector<Rule> rules;
+
+    static uint32_t HashName(const char* name, size_t length);
+
+public:
+    // Replaces the rules; returns how many were recognised. A name listed
+    // twice keeps its first rule.
+    size_t Parse(const std::string& text);
+    void Clear() { rules.clear(); }
+
+    // No rules: locks apply everywhere, as before
+    bool IsEmpty() const { return rules.empty(); }
+    size_t GetRuleCount() const { return rules.size(); }
+
+    // Full image path or bare file name; LOCK_SCOPE_NONE if no rule matches
+    uint8_t Match(const char* imagePath) const;
+};
@@ -0,0 +1,149 @@
+// src/features/lock_input/chord_trie.cpp
+// Chord trie construction and matching
+
+#include "chord_trie.h"
+#include <cstring>
+
+static const size_t INITIAL_TABLE_SIZE = 16;
+
+ChordTrie::ChordTrie() : generation(0) {
+    Clear();
+}
+
+void ChordTrie::Clear() {
+    table.assign(INITIAL_TABLE_SIZE, Edge());
+    mask = (uint32_t)INITIAL_TABLE_SIZE - 1;
+    nodeCount = 1;
+    edgeCount = 0;
+    chordCount = 0;
+}
+
+// Slot holding key, or the empty slot where it belongs
+ChordTrie::Edge* ChordTrie::FindSlot(uint32_t key) {
+    for (uint32_t slot = Slot(key) & mask;; slot = (slot + 1) & mask) {
+        Edge& edge = table[slot];
+        if (edge.key == key || edge.key == 0) return &edge;
+    }
+}
+
+void ChordTrie::Grow() {
+    std::vector<Edge> old;
+    old.swap(table);
+    table.assign(old.size() * 2, Edge());
+    mask = (uint32_t)table.size() - 1;
+    for (size_t i = 0; i < old.size(); i++) {
+        if (old[i].key != 0) *FindSlot(old[i].key) = old[i];
+    }
+}
+
+bool ChordTrie::Add(const ChordStroke* strokes, size_t count, uint16_t action) {
+    if (count == 0 || count > MAX_STROKES || action == 0) return false;
+
+    // Check the whole path first so a rejected chord leaves no edges behind
+    uint32_t node = 0;
+    size_t existing = 0;
+    while (existing < count) {
+        if (strokes[existing].vkCode == 0) return false;
+        const Edge* edge = Find(node, strokes[existing]);
+        if (!edge) break;
+        if (edge->action != 0 || existing + 1 == count) return false; // Conflicts with an existing chord
+        node = edge->child;
+        existing++;
+    }
+    if (nodeCount + (count - existing - 1) > MAX_NODES) return false;
+
+    for (size_t i = existing; i < count; i++) {
+        if ((edgeCount + 1) * 2 > table.size()) Grow();
+
+        uint32_t key = EdgeKey(node, strokes[i]);
+        Edge* edge = FindSlot(key);
+        edge->key = key;
+        if (i + 1 == count) {
+            edge->child = 0;
+            edge->action = action;
+        } else {
+            edge->child = (uint16_t)nodeCount++;
+            edge->action = 0;
+        }
+        edgeCount++;
+        node = edge->child;
+    }
+    chordCount++;
+    return true;
+}
+
+ChordMatcher::ChordMatcher() : node(0), lastTime(0), trieGeneration(0), prefixCount(0) {
+    memset(swallowed, 0, sizeof(swallowed));
+}
+
+static bool IsModifierKey(uint8_t vk) {
+    return (vk >= 0x10 && vk <= 0x12) || (vk >= 0xA0 && vk <= 0xA5) || vk == 0x5B || vk == 0x5C;
+}
+
+// Moves the strokes of the abandoned prefix to the end of replay
+void ChordMatcher::TakePrefix(ChordReplay& replay) {
+    for (size_t i = 0; i < prefixCount; i++) {
+        replay.strokes[replay.count++] = prefix[i];
+    }
+    node = 0;
+    prefixCount = 0;
+}
+
+ChordMatchResult ChordMatcher::Feed(const ChordTrie& trie, ChordStroke stroke, uint32_t time, uint16_t& action,
+                                    ChordReplay& replay) {
+    replay.count = 0;
+    if (IsModifierKey(stroke.vkCode)) return CHORD_NO_MATCH;
+
+    // Node indices only mean something in the trie they came from
+    if (trie.generation != trieGeneration) {
+        trieGeneration = trie.generation;
+        TakePrefix(replay);
+    }
+    if (node != 0 && time - lastTime > STROKE_TIMEOUT_MS) {
+        TakePrefix(replay);
+    }
+
+    const ChordTrie::Edge* edge = trie.Find(node, stroke);
+    if (!edge && node != 0) {
+        // Give the prefix back; the key may still start another chord
+        TakePrefix(replay);
+        edge = trie.Find(0, stroke);
+    }
+
+    uint64_t bit = 1ULL << (stroke.vkCode & 63);
+    if (!edge) {
+        if (replay.count == 0) {
+            swallowed[stroke.vkCode >> 6] &= ~bit; // Its release passes with it
+            return CHORD_NO_MATCH;
+        }
+        replay.strokes[replay.count++] = stroke;
+        swallowed[stroke.vkCode >> 6] |= bit;
+        return CHORD_BROKEN;
+    }
+
+    swallowed[stroke.vkCode >> 6] |= bit;
+    lastTime = time;
+    if (edge->action != 0) {
+        node = 0;
+        prefixCount = 0;
+        action = edge->action;
+        return CHORD_MATCHED;
+    }
+    node = edge->child;
+    prefix[prefixCount++] = stroke;
+    return CHORD_PREFIX;
+}
+
+bool ChordMatcher::Expire(uint32_t now, ChordReplay& replay) {
+    replay.count = 0;
+    if (node == 0 || now - lastTime <= STROKE_TIMEOUT_MS) return false;
+    TakePrefix(replay);
+    return true;
+}
+
+bool ChordMatcher::ConsumeRelease(uint8_t vkCode) {
+    uint64_t bit = 1ULL << (vkCode & 63);
+    if (!(swallowed[vkCode >> 6] & bit)) return false;
+    swallowed[vkCode >> 6] &= ~bit;
+    return true;
+}
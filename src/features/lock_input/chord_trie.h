@@ -0,0 +1,126 @@
+// src/features/lock_input/chord_trie.h
+// Multi-stroke chord hotkeys ("Ctrl+K, L") matched one key press at a time (portable)
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One keystroke of a chord: LockModifier bits (same values as MOD_*) plus the key
+struct ChordStroke {
+    uint8_t modifiers;
+    uint8_t vkCode;
+};
+
+// Trie of chord sequences. Every edge (parent node, stroke) lives in one
+// open-addressing table kept at most half full, so following an edge is one
+// hash and about one probe whatever the number of chords loaded. Built on
+// the UI thread (see ParseChordHotkeys), then published read-only to the hook thread.
+class ChordTrie {
+public:
+    static const size_t MAX_STROKES = 4;
+    static const uint32_t MAX_NODES = 0xFFFF;
+
+    struct Edge {
+        uint32_t key;    // EdgeKey(parent, stroke); 0 = empty slot
+        uint16_t child;  // Node the edge leads to (0 on a chord's last stroke)
+        uint16_t action; // Hotkey ID on a chord's last stroke, otherwise 0
+    };
+
+    uint32_t generation; // Set by the publisher
+
+private:
+    std::vector<Edge> table; // Power-of-two size
+    uint32_t mask;
+    uint32_t nodeCount;      // Node 0 is the root
+    size_t edgeCount;
+    size_t chordCount;
+
+    // Stroke keys are never 0 (vkCode is never 0)
+    static uint32_t EdgeKey(uint32_t node, ChordStroke stroke) {
+        return (node << 16) | ((uint32_t)stroke.modifiers << 8) | stroke.vkCode;
+    }
+    // Multiplicative hash with the high half folded down: the table is indexed
+    // by the low bits, which a plain product would take from the stroke alone
+    static uint32_t Slot(uint32_t key) {
+        uint32_t hash = key * 0x9E3779B1u;
+        return hash ^ (hash >> 16);
+    }
+
+    Edge* FindSlot(uint32_t key);
+    void Grow();
+
+public:
+    ChordTrie();
+
+    // UI thread. Fails if the chord repeats an existing one, is a prefix of
+    // one, or has one as its prefix (either would make it unreachable).
+    bool Add(const ChordStroke* strokes, size_t count, uint16_t action);
+    void Clear();
+
+    size_t GetChordCount() const { return chordCount; }
+    size_t GetMemoryUsage() const { return table.size() * sizeof(Edge); }
+
+    // Hook thread: the edge leaving node for stroke, or nullptr
+    const Edge* Find(uint32_t node, ChordStroke stroke) const {
+        if (edgeCount == 0) return nullptr;
+        uint32_t key = EdgeKey(node, stroke);
+        for (uint32_t slot = Slot(key) & mask;; slot = (slot + 1) & mask) {
+            const Edge& edge = table[slot];
+            if (edge.key == key) return &edge;
+            if (edge.key == 0) return nullptr;
+        }
+    }
+};
+
+enum ChordMatchResult {
+    CHORD_NO_MATCH = 0, // Not part of a chord - let it through
+    CHORD_PREFIX = 1,   // Started or continued a chord - swallow, wait for the next stroke
+    CHORD_MATCHED = 2,  // Completed a chord - swallow and run the action
+    CHORD_BROKEN = 3    // Ended a prefix no chord follows - swallow; it is replayed after the prefix
+};
+
+// Strokes swallowed as a chord prefix that turned out not to start a chord,
+// in the order they were typed. The caller re-injects them so the keys
+// still reach the foreground window.
+struct ChordReplay {
+    ChordStroke strokes[ChordTrie::MAX_STROKES];
+    size_t count;
+};
+
+// Per-hook matching state: where in the trie the strokes so far lead. Feed()
+// is a single trie lookup (two on a mismatch) and never allocates.
+class ChordMatcher {
+private:
+    uint32_t node;           // 0 = not inside a chord
+    uint32_t lastTime;
+    uint32_t trieGeneration; // Trie that node belongs to
+    uint64_t swallowed[4];   // Keys whose press was swallowed; their release is too
+    ChordStroke prefix[ChordTrie::MAX_STROKES]; // Strokes that led to node
+    size_t prefixCount;
+
+    void TakePrefix(ChordReplay& replay);
+
+public:
+    static const uint32_t STROKE_TIMEOUT_MS = 2000;
+
+    ChordMatcher();
+
+    // Key press. Modifier keys neither advance nor break a chord. A prefix
+    // that timed out, or that this key does not continue, is handed back in
+    // replay; a key that continues no chord itself is then added after it
+    // (CHORD_BROKEN), since letting it through would put it ahead of the prefix.
+    ChordMatchResult Feed(const ChordTrie& trie, ChordStroke stroke, uint32_t time, uint16_t& action,
+                          ChordReplay& replay);
+
+    // Hands back a prefix with no stroke for STROKE_TIMEOUT_MS. Called from a
+    // timer on the delivering thread, so a prefix typed last is not held back
+    // until the next key press.
+    bool Expire(uint32_t now, ChordReplay& replay);
+
+    // Key release: true if its press was swallowed
+    bool ConsumeRelease(uint8_t vkCode);
+
+    void Reset() { node = 0; prefixCount = 0; }
+    bool IsPending() const { return node != 0; }
+};
@@ -0,0 +1,210 @@
+// src/features/lock_input/credential_set.cpp
+// Sorted credential storage, branchless lookup and persistence format
+
+#include "credential_set.h"
+#include "password_matcher.h"
+#include <algorithm>
+#include <cstring>
+
+static const uint8_t CREDENTIAL_BLOB_MAGIC[4] = { 'U', 'A', 'C', 'S' };
+static const uint32_t CREDENTIAL_BLOB_VERSION = 1;
+static const size_t CREDENTIAL_BLOB_HEADER_SIZE = 12;
+static const size_t CREDENTIAL_BLOB_ENTRY_SIZE = SHA256_DIGEST_SIZE + 2;
+
+uint64_t CredentialSet::DigestKey(const uint8_t* digest) {
+    uint64_t key = 0;
+    for (int i = 0; i < 8; i++) key = (key << 8) | digest[i];
+    return key;
+}
+
+// First position whose key is not below key. The loop has a fixed trip count
+// for a given size and the step is a conditional move, not a branch.
+size_t CredentialSet::LowerBound(uint64_t key) const {
+    size_t count = keys.size();
+    if (count == 0) return 0;
+
+    const uint64_t* first = keys.data();
+    const uint64_t* base = first;
+    while (count > 1) {
+        size_t half = count / 2;
+        base = (base[half] < key) ? base + half : base;
+        count -= half;
+    }
+    return (size_t)(base - first) + (*base < key);
+}
+
+bool CredentialSet::Add(const uint8_t* digest, size_t length, CredentialKind kind) {
+    if (credentials.size() >= MAX_CREDENTIALS || Find(digest) >= 0) return false;
+
+    uint64_t key = DigestKey(digest);
+    size_t position = LowerBound(key);
+    // Equal prefixes: keep full digest order (only matters for a stable blob)
+    while (position < keys.size() && keys[position] == key &&
+           memcmp(credentials[position].digest, digest, SHA256_DIGEST_SIZE) < 0) {
+        position++;
+    }
+
+    Credential credential;
+    memcpy(credential.digest, digest, SHA256_DIGEST_SIZE);
+    credential.length = (uint8_t)(length <= 0xFF ? length : 0);
+    credential.kind = (uint8_t)kind;
+
+    keys.insert(keys.begin() + position, key);
+    credentials.insert(credentials.begin() + position, credential);
+    return true;
+}
+
+bool CredentialSet::Remove(const uint8_t* digest) {
+    int index = Find(digest);
+    if (index < 0) return false;
+
+    memset(credentials[index].digest, 0, SHA256_DIGEST_SIZE);
+    keys.erase(keys.begin() + index);
+    credentials.erase(credentials.begin() + index);
+    return true;
+}
+
+size_t CredentialSet::RemoveKind(CredentialKind kind) {
+    size_t kept = 0;
+    for (size_t i = 0; i < credentials.size(); i++) {
+        if (credentials[i].kind == (uint8_t)kind) continue;
+        keys[kept] = keys[i];
+        credentials[kept] = credentials[i];
+        kept++;
+    }
+    size_t removed = credentials.size() - kept;
+    for (size_t i = kept; i < credentials.size(); i++) {
+        memset(credentials[i].digest, 0, SHA256_DIGEST_SIZE);
+    }
+    keys.resize(kept);
+    credentials.resize(kept);
+    return removed;
+}
+
+void CredentialSet::Clear() {
+    for (size_t i = 0; i < credentials.size(); i++) {
+        memset(credentials[i].digest, 0, SHA256_DIGEST_SIZE);
+    }
+    keys.clear();
+    credentials.clear();
+}
+
+size_t CredentialSet::GetCount(CredentialKind kind) const {
+    size_t count = 0;
+    for (size_t i = 0; i < credentials.size(); i++) {
+        count += credentials[i].kind == (uint8_t)kind;
+    }
+    return count;
+}
+
+int CredentialSet::Find(const uint8_t* digest) const {
+    int found;
+    FindBatch((const uint8_t (*)[SHA256_DIGEST_SIZE])digest, 1, &found);
+    return found;
+}
+
+void CredentialSet::FindBatch(const uint8_t (*digests)[SHA256_DIGEST_SIZE], size_t count, int* found) const {
+    static const size_t LANES = 32;
+    const size_t total = keys.size();
+
+    for (size_t start = 0; start < count; start += LANES) {
+        size_t lanes = (count - start < LANES) ? count - start : LANES;
+        uint64_t key[LANES];
+        size_t base[LANES];
+        for (size_t i = 0; i < lanes; i++) {
+            key[i] = DigestKey(digests[start + i]);
+            base[i] = 0;
+            found[start + i] = -1;
+        }
+        if (total == 0) continue;
+
+        // Same halving sequence for every lane, one level at a time
+        for (size_t length = total; length > 1; length -= length / 2) {
+            size_t half = length / 2;
+            for (size_t i = 0; i < lanes; i++) {
+                base[i] += (keys[base[i] + half] < key[i]) ? half : 0;
+            }
+        }
+
+        for (size_t i = 0; i < lanes; i++) {
+            size_t position = base[i] + (keys[base[i]] < key[i]);
+            // A shared 64-bit prefix is practically never seen; compare whole digests
+            for (; position < total && keys[position] == key[i]; position++) {
+                if (Sha256DigestEquals(credentials[position].digest, digests[start + i])) {
+                    found[start + i] = (int)position;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+uint64_t CredentialSet::GetCandidateLengths() const {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < credentials.size(); i++) {
+        if (credentials[i].length == 0) return PasswordMatcher::LegacyLengthMask() | mask;
+        mask |= PasswordMatcher::LengthBit(credentials[i].length);
+    }
+    return mask;
+}
+
+static void WriteUint32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back((uint8_t)(value >> (i * 8)));
+}
+
+static uint32_t ReadUint32(const uint8_t* data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+void CredentialSet::Serialize(std::vector<uint8_t>& out) const {
+    out.clear();
+    out.reserve(CREDENTIAL_BLOB_HEADER_SIZE + credentials.size() * CREDENTIAL_BLOB_ENTRY_SIZE);
+    out.insert(out.end(), CREDENTIAL_BLOB_MAGIC, CREDENTIAL_BLOB_MAGIC + 4);
+    WriteUint32(out, CREDENTIAL_BLOB_VERSION);
+    WriteUint32(out, (uint32_t)credentials.size());
+
+    for (size_t i = 0; i < credentials.size(); i++) {
+        out.insert(out.end(), credentials[i].digest, credentials[i].digest + SHA256_DIGEST_SIZE);
+        out.push_back(credentials[i].length);
+        out.push_back(credentials[i].kind);
+    }
+}
+
+bool CredentialSet::Deserialize(const uint8_t* data, size_t size) {
+    if (size < CREDENTIAL_BLOB_HEADER_SIZE || memcmp(data, CREDENTIAL_BLOB_MAGIC, 4) != 0 ||
+        ReadUint32(data + 4) != CREDENTIAL_BLOB_VERSION) {
+        return false;
+    }
+    uint32_t count = ReadUint32(data + 8);
+    if (count > MAX_CREDENTIALS || size != CREDENTIAL_BLOB_HEADER_SIZE + count * CREDENTIAL_BLOB_ENTRY_SIZE) {
+        return false;
+    }
+
+    // Sorted here rather than trusted, so a hand-edited blob still loads correctly
+    Clear();
+    const uint8_t* entry = data + CREDENTIAL_BLOB_HEADER_SIZE;
+    for (uint32_t i = 0; i < count; i++, entry += CREDENTIAL_BLOB_ENTRY_SIZE) {
+        Credential credential;
+        memcpy(credential.digest, entry, SHA256_DIGEST_SIZE);
+        credential.length = entry[SHA256_DIGEST_SIZE];
+        credential.kind = entry[SHA256_DIGEST_SIZE + 1];
+        if (credential.kind > CREDENTIAL_RECOVERY_CODE) continue; // Written by a newer version
+        credentials.push_back(credential);
+    }
+
+    std::sort(credentials.begin(), credentials.end(), [](const Credential& a, const Credential& b) {
+        return memcmp(a.digest, b.digest, SHA256_DIGEST_SIZE) < 0;
+    });
+    size_t kept = 0;
+    for (size_t i = 0; i < credentials.size(); i++) {
+        if (kept > 0 && memcmp(credentials[kept - 1].digest, credentials[i].digest, SHA256_DIGEST_SIZE) == 0) continue;
+        credentials[kept++] = credentials[i];
+    }
+    credentials.resize(kept);
+
+    keys.resize(kept);
+    for (size_t i = 0; i < kept; i++) {
+        keys[i] = DigestKey(credentials[i].digest);
+    }
+    return true;
+}
@@ -0,0 +1,63 @@
+// src/features/lock_input/credential_set.h
+// Unlock credentials: per-user PINs and single-use recovery codes, looked up by digest (portable)
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../../utils/sha256.h"
+
+enum CredentialKind {
+    CREDENTIAL_PASSWORD = 0,     // Password or PIN; unlocks any number of times
+    CREDENTIAL_RECOVERY_CODE = 1 // Revoked by the unlock that uses it
+};
+
+struct Credential {
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    uint8_t length; // Bytes hashed; 0 = unknown (hash saved by an older version)
+    uint8_t kind;   // CredentialKind
+};
+
+// Credentials sorted by digest. The first eight digest bytes are kept in a
+// separate array that is binary searched without branches, so checking a
+// candidate costs one hash plus about log2(count) loads whatever the number
+// of staff PINs and recovery codes. Built and changed under the owner's lock.
+class CredentialSet {
+public:
+    static const size_t MAX_CREDENTIALS = 4096;
+
+private:
+    std::vector<uint64_t> keys;          // Digest prefixes, big-endian so they sort like the digests
+    std::vector<Credential> credentials; // Same order as keys
+
+    static uint64_t DigestKey(const uint8_t* digest);
+    size_t LowerBound(uint64_t key) const;
+
+public:
+    // Fails if the digest is already present or the set is full
+    bool Add(const uint8_t* digest, size_t length, CredentialKind kind);
+    bool Remove(const uint8_t* digest);
+    size_t RemoveKind(CredentialKind kind); // Returns how many were removed
+    void Clear();
+
+    bool IsEmpty() const { return credentials.empty(); }
+    size_t GetCount() const { return credentials.size(); }
+    size_t GetCount(CredentialKind kind) const;
+    const Credential& Get(size_t index) const { return credentials[index]; }
+    void SetLength(size_t index, size_t length) { credentials[index].length = (uint8_t)length; }
+
+    // Index of the credential with this digest, or -1
+    int Find(const uint8_t* digest) const;
+
+    // Find() for several digests at once; the searches advance in lockstep so
+    // their cache misses overlap. found[i] receives the index or -1.
+    void FindBatch(const uint8_t (*digests)[SHA256_DIGEST_SIZE], size_t count, int* found) const;
+
+    // Suffix lengths worth hashing (PasswordMatcher mask): every stored length,
+    // or all legacy lengths if any credential's length is unknown
+    uint64_t GetCandidateLengths() const;
+
+    // Registry blob: "UACS", version, count, then 34 bytes per credential
+    void Serialize(std::vector<uint8_t>& out) const;
+    bool Deserialize(const uint8_t* data, size_t size);
+};
@@ -0,0 +1,134 @@
+// src/features/lock_input/hook_input_backend.cpp
+// Low-level hook input backend implementation
+
+#include "hook_input_backend.h"
+#include "hook_latency.h"
+
+HookInputBackend* HookInputBackend::activeKeyboard = NULL;
+HookInputBackend* HookInputBackend::activeMouse = NULL;
+
+HookInputBackend::HookInputBackend(InputDevice device, LatencyHistogram* latency)
+    : device(device), hook(NULL), sink(NULL), latency(latency), passMouseMoves(false), heartbeats(0) {}
+
+HookInputBackend::~HookInputBackend() {
+    Stop();
+}
+
+const char* HookInputBackend::GetName() const {
+    return device == INPUT_DEVICE_KEYBOARD ? "Low-level keyboard hook" : "Low-level mouse hook";
+}
+
+bool HookInputBackend::Start(InputEventSink* sink) {
+    if (!sink) return false;
+    HookInputBackend*& active = device == INPUT_DEVICE_KEYBOARD ? activeKeyboard : activeMouse;
+    if (hook != NULL) {
+        this->sink = sink;
+        return true;
+    }
+    if (active != NULL) return false; // Another instance owns this hook type
+
+    this->sink = sink;
+    active = this;
+    if (device == INPUT_DEVICE_KEYBOARD) {
+        hook = SetWindowsHookEx(WH_KEYBOARD_LL, KeyboardProc, GetModuleHandle(NULL), 0);
+    } else {
+        hook = SetWindowsHookEx(WH_MOUSE_LL, MouseProc, GetModuleHandle(NULL), 0);
+    }
+    if (hook == NULL) {
+        active = NULL;
+        this->sink = NULL;
+        return false;
+    }
+    return true;
+}
+
+void HookInputBackend::Stop() {
+    if (hook == NULL) return;
+    UnhookWindowsHookEx(hook);
+    hook = NULL;
+    sink = NULL;
+    if (device == INPUT_DEVICE_KEYBOARD) {
+        activeKeyboard = NULL;
+    } else {
+        activeMouse = NULL;
+    }
+}
+
+LRESULT CALLBACK HookInputBackend::KeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
+    uint64_t start = HookTimestamp();
+    HookInputBackend* self = activeKeyboard;
+    if (self) self->heartbeats.fetch_add(1, std::memory_order_relaxed);
+
+    // CRITICAL: Process only HC_ACTION and return immediately for others
+    InputVerdict verdict = INPUT_VERDICT_PASS;
+    if (nCode == HC_ACTION && self && self->sink) {
+        KBDLLHOOKSTRUCT* pkbhs = (KBDLLHOOKSTRUCT*)lParam;
+        InputEvent event = {};
+        event.device = INPUT_DEVICE_KEYBOARD;
+        event.type = (pkbhs->flags & LLKHF_UP) ? INPUT_EVENT_KEY_UP : INPUT_EVENT_KEY_DOWN;
+        if (pkbhs->flags & LLKHF_INJECTED) event.flags |= INPUT_FLAG_INJECTED;
+        if (pkbhs->flags & LLKHF_EXTENDED) event.flags |= INPUT_FLAG_EXTENDED;
+        if (wParam == WM_SYSKEYDOWN || wParam == WM_SYSKEYUP) event.flags |= INPUT_FLAG_SYSTEM_KEY;
+        event.code = (uint16_t)pkbhs->vkCode;
+        event.time = pkbhs->time;
+        verdict = self->sink->OnInputEvent(event);
+    }
+
+    LRESULT result = verdict == INPUT_VERDICT_BLOCK ? 1 : CallNextHookEx(NULL, nCode, wParam, lParam);
+    if (self && self->latency) {
+        self->latency->Record(HookTimestamp() - start);
+    }
+    return result;
+}
+
+LRESULT CALLBACK HookInputBackend::MouseProc(int nCode, WPARAM wParam, LPARAM lParam) {
+    HookInputBackend* self = activeMouse;
+    if (self) self->heartbeats.fetch_add(1, std::memory_order_relaxed);
+    if (wParam == WM_MOUSEMOVE && self && self->passMouseMoves) {
+        return CallNextHookEx(NULL, nCode, wParam, lParam);
+    }
+
+    uint64_t start = HookTimestamp();
+
+    InputVerdict verdict = INPUT_VERDICT_PASS;
+    if (nCode == HC_ACTION && self && self->sink) {
+        MSLLHOOKSTRUCT* pmhs = (MSLLHOOKSTRUCT*)lParam;
+        InputEvent event = {};
+        event.device = INPUT_DEVICE_MOUSE;
+        event.x = pmhs->pt.x;
+        event.y = pmhs->pt.y;
+        event.time = pmhs->time;
+        if (pmhs->flags & LLMHF_INJECTED) event.flags |= INPUT_FLAG_INJECTED;
+
+        int16_t high = (int16_t)(pmhs->mouseData >> 16);
+        switch (wParam) {
+            case WM_LBUTTONDOWN: event.type = INPUT_EVENT_BUTTON_DOWN; event.code = INPUT_BUTTON_LEFT; break;
+            case WM_LBUTTONUP:   event.type = INPUT_EVENT_BUTTON_UP;   event.code = INPUT_BUTTON_LEFT; break;
+            case WM_RBUTTONDOWN: event.type = INPUT_EVENT_BUTTON_DOWN; event.code = INPUT_BUTTON_RIGHT; break;
+            case WM_RBUTTONUP:   event.type = INPUT_EVENT_BUTTON_UP;   event.code = INPUT_BUTTON_RIGHT; break;
+            case WM_MBUTTONDOWN: event.type = INPUT_EVENT_BUTTON_DOWN; event.code = INPUT_BUTTON_MIDDLE; break;
+            case WM_MBUTTONUP:   event.type = INPUT_EVENT_BUTTON_UP;   event.code = INPUT_BUTTON_MIDDLE; break;
+            case WM_XBUTTONDOWN:
+            case WM_XBUTTONUP:
+                event.type = wParam == WM_XBUTTONDOWN ? INPUT_EVENT_BUTTON_DOWN : INPUT_EVENT_BUTTON_UP;
+                event.code = high == 2 ? INPUT_BUTTON_X2 : INPUT_BUTTON_X1;
+                break;
+            case WM_MOUSEWHEEL:
+            case WM_MOUSEHWHEEL:
+                event.type = INPUT_EVENT_WHEEL;
+                event.wheelDelta = high;
+                if (wParam == WM_MOUSEHWHEEL) event.flags |= INPUT_FLAG_HORIZONTAL;
+                break;
+            default:
+                event.type = INPUT_EVENT_MOUSE_MOVE;
+                break;
+        }
+        verdict = self->sink->OnInputEvent(event);
+    }
+
+    LRESULT result = verdict == INPUT_VERDICT_BLOCK ? 1 : CallNextHookEx(NULL, nCode, wParam, lParam);
+    if (self && self->latency) {
+        self->latency->Record(HookTimestamp() - start);
+    }
+    return result;
+}
@@ -0,0 +1,45 @@
+// src/features/lock_input/hook_input_backend.h
+// Low-level keyboard/mouse hook input backend (WH_KEYBOARD_LL / WH_MOUSE_LL)
+
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include "input_backend.h"
+#include "../../utils/latency_histogram.h"
+
+// Blocking backend over a global low-level hook. Start() installs the hook on
+// the calling thread, which must pump messages for callbacks to arrive. At
+// most one keyboard and one mouse instance may run at a time, since low-level
+// hook procedures carry no context pointer.
+class HookInputBackend : public InputBackend {
+private:
+    InputDevice device;
+    HHOOK hook;
+    InputEventSink* sink;
+    LatencyHistogram* latency; // Callback duration in QPC ticks (optional)
+    bool passMouseMoves;       // Hand WM_MOUSEMOVE straight on without building an event
+    std::atomic<uint32_t> heartbeats; // Every callback, for the watchdog
+
+    static HookInputBackend* activeKeyboard;
+    static HookInputBackend* activeMouse;
+
+    static LRESULT CALLBACK KeyboardProc(int nCode, WPARAM wParam, LPARAM lParam);
+    static LRESULT CALLBACK MouseProc(int nCode, WPARAM wParam, LPARAM lParam);
+
+public:
+    HookInputBackend(InputDevice device, LatencyHistogram* latency);
+    ~HookInputBackend();
+
+    const char* GetName() const override;
+    bool CanBlock() const override { return true; }
+    bool Start(InputEventSink* sink) override;
+    void Stop() override;
+    bool IsRunning() const override { return hook != NULL; }
+
+    // Thread that services the hook. For mouse lock modes that never block
+    // movement, so the sink is not called for the bulk of mouse traffic.
+    void SetPassMouseMoves(bool value) { passMouseMoves = value; }
+
+    // Callbacks received so far. Stops advancing when Windows removes the hook.
+    uint32_t GetHeartbeats() const { return heartbeats.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,256 @@
+// src/features/lock_input/hook_latency.cpp
+// Hook latency reporting and timeout warning implementation
+
+#include "hook_latency.h"
+#include "../../notifications.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+LatencyHistogram g_keyboardHookLatency;
+LatencyHistogram g_mouseHookLatency;
+std::atomic<uint64_t> g_inputCallbackCounts[INPUT_COUNTER_SOURCE_COUNT][2];
+
+static const UINT_PTR HOOK_LATENCY_TIMER_ID = 3001;
+static const UINT HOOK_LATENCY_CHECK_INTERVAL = 10000; // ms
+static const DWORD DEFAULT_HOOKS_TIMEOUT = 300;        // ms, used when the value is not set
+static const size_t HOOK_REPORT_SIZE = 2048;
+
+// Warn when p99.9 reaches half the timeout; re-arm once it falls below a quarter
+static const double WARNING_FRACTION = 0.5;
+static const double REARM_FRACTION = 0.25;
+
+static double g_ticksPerMicrosecond = 0.0;
+static DWORD g_hooksTimeout = DEFAULT_HOOKS_TIMEOUT;
+static bool g_latencyWarningShown = false;
+
+// Histograms as of the previous check, so each check sees only its own
+// interval: a slow spell long ago must not keep the warning up (UI thread only)
+static LatencyHistogram::Snapshot g_keyboardLatencyChecked;
+static LatencyHistogram::Snapshot g_mouseLatencyChecked;
+
+// Watchdog incidents, most recent last (UI thread only)
+struct HookIncident {
+    SYSTEMTIME time;
+    HookWatchdogHook hook;
+    DWORD silentFor;
+    bool reinstalled;
+    LatencySummary latency; // The lost hook's histogram when it was found
+};
+static const size_t HOOK_INCIDENT_HISTORY = 4;
+static HookIncident g_hookIncidents[HOOK_INCIDENT_HISTORY];
+static uint32_t g_hookIncidentCount = 0;
+
+// Lock state time accounting (UI thread only)
+static bool g_countingLocked = false;
+static ULONGLONG g_stateSince = 0;
+static ULONGLONG g_stateMilliseconds[2] = { 0, 0 };
+
+static double TicksToMicroseconds(uint64_t ticks) {
+    return g_ticksPerMicrosecond > 0.0 ? (double)ticks / g_ticksPerMicrosecond : 0.0;
+}
+
+static void CALLBACK HookLatencyTimerProc(HWND hwnd, UINT msg, UINT_PTR id, DWORD time) {
+    CheckHookLatency(hwnd);
+}
+
+DWORD GetLowLevelHooksTimeout() {
+    HKEY hKey;
+    if (RegOpenKeyExA(HKEY_CURRENT_USER, "Control Panel\\Desktop", 0, KEY_READ, &hKey) != ERROR_SUCCESS) {
+        return DEFAULT_HOOKS_TIMEOUT;
+    }
+
+    DWORD timeout = DEFAULT_HOOKS_TIMEOUT;
+    BYTE data[32];
+    DWORD dataSize = sizeof(data);
+    DWORD type;
+    if (RegQueryValueExA(hKey, "LowLevelHooksTimeout", NULL, &type, data, &dataSize) == ERROR_SUCCESS) {
+        if (type == REG_DWORD && dataSize == sizeof(DWORD)) {
+            timeout = *(DWORD*)data;
+        } else if (type == REG_SZ && dataSize > 0) {
+            data[sizeof(data) - 1] = 0;
+            timeout = (DWORD)strtoul((const char*)data, NULL, 10);
+        }
+    }
+    RegCloseKey(hKey);
+
+    return timeout ? timeout : DEFAULT_HOOKS_TIMEOUT;
+}
+
+void InitializeHookLatency(HWND hwnd) {
+    LARGE_INTEGER frequency;
+    if (QueryPerformanceFrequency(&frequency) && frequency.QuadPart > 0) {
+        g_ticksPerMicrosecond = (double)frequency.QuadPart / 1000000.0;
+    }
+    g_hooksTimeout = GetLowLevelHooksTimeout();
+    g_stateSince = GetTickCount64();
+    SetTimer(hwnd, HOOK_LATENCY_TIMER_ID, HOOK_LATENCY_CHECK_INTERVAL, HookLatencyTimerProc);
+}
+
+void ShutdownHookLatency(HWND hwnd) {
+    KillTimer(hwnd, HOOK_LATENCY_TIMER_ID);
+}
+
+void NoteLockStateChange(bool locked) {
+    ULONGLONG now = GetTickCount64();
+    g_stateMilliseconds[g_countingLocked ? 1 : 0] += now - g_stateSince;
+    g_stateSince = now;
+    g_countingLocked = locked;
+}
+
+// p99.9 in microseconds of the samples recorded since checked was taken;
+// checked moves on to now. False if there were none.
+static bool GetIntervalP999(const LatencyHistogram& histogram, LatencyHistogram::Snapshot& checked,
+                            double& microseconds) {
+    static LatencyHistogram::Snapshot now; // ~8 KB, kept off the stack
+    histogram.TakeSnapshot(now);
+    bool any = now.count > checked.count;
+    microseconds = TicksToMicroseconds(LatencyHistogram::GetPercentileBetween(checked, now, 0.999));
+    checked = now;
+    return any;
+}
+
+void CheckHookLatency(HWND hwnd) {
+    double timeoutMicroseconds = g_hooksTimeout * 1000.0;
+    double keyboardP999, mouseP999;
+    bool keyboardActive = GetIntervalP999(g_keyboardHookLatency, g_keyboardLatencyChecked, keyboardP999);
+    bool mouseActive = GetIntervalP999(g_mouseHookLatency, g_mouseLatencyChecked, mouseP999);
+    if (!keyboardActive && !mouseActive) return; // No input since the last check: nothing new to judge
+    double worst = keyboardP999 > mouseP999 ? keyboardP999 : mouseP999;
+
+    if (!g_latencyWarningShown && worst >= timeoutMicroseconds * WARNING_FRACTION) {
+        char message[160];
+        snprintf(message, sizeof(message),
+                 "Input hook is slow: p99.9 %.1f ms of the %lu ms system limit - Windows may remove it",
+                 worst / 1000.0, (unsigned long)g_hooksTimeout);
+        ShowNotification(hwnd, NOTIFY_HOOK_LATENCY_WARNING, message);
+        g_latencyWarningShown = true;
+    } else if (g_latencyWarningShown && worst < timeoutMicroseconds * REARM_FRACTION) {
+        g_latencyWarningShown = false;
+    }
+}
+
+void RecordHookIncident(HWND hwnd, HookWatchdogHook hook, DWORD silentFor, bool reinstalled, bool locked) {
+    HookIncident& incident = g_hookIncidents[g_hookIncidentCount % HOOK_INCIDENT_HISTORY];
+    GetLocalTime(&incident.time);
+    incident.hook = hook;
+    incident.silentFor = silentFor;
+    incident.reinstalled = reinstalled;
+    incident.latency = (hook == HOOK_WATCHDOG_KEYBOARD ? g_keyboardHookLatency : g_mouseHookLatency).GetSummary();
+    g_hookIncidentCount++;
+
+    // Unlocked, a lost hook only costs the failsafe for a moment - not worth a balloon
+    if (locked) {
+        const char* name = hook == HOOK_WATCHDOG_KEYBOARD ? "Keyboard" : "Mouse";
+        char message[256];
+        snprintf(message, sizeof(message), "%s hook was removed by Windows and has been %s",
+                 name, reinstalled ? "reinstalled" : "lost - unlock with the failsafe if input is stuck");
+        ShowNotification(hwnd, NOTIFY_HOOK_LATENCY_WARNING, message);
+    }
+}
+
+static int FormatHistogramLine(char* buffer, size_t bufferSize, const char* name, const LatencyHistogram& histogram) {
+    LatencySummary summary = histogram.GetSummary();
+    return snprintf(buffer, bufferSize,
+                    "%s hook: %llu calls\r\n"
+                    "  p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us\r\n"
+                    "  mean %.1f us, max %.1f us\r\n",
+                    name, (unsigned long long)summary.count,
+                    TicksToMicroseconds(summary.p50), TicksToMicroseconds(summary.p90),
+                    TicksToMicroseconds(summary.p99), TicksToMicroseconds(summary.p999),
+                    summary.mean / (g_ticksPerMicrosecond > 0.0 ? g_ticksPerMicrosecond : 1.0),
+                    TicksToMicroseconds(summary.max));
+}
+
+size_t FormatHookLatencyReport(char* buffer, size_t bufferSize) {
+    size_t length = 0;
+    int written = FormatHistogramLine(buffer, bufferSize, "Keyboard", g_keyboardHookLatency);
+    if (written < 0 || (size_t)written >= bufferSize) return bufferSize ? bufferSize - 1 : 0;
+    length += written;
+
+    written = FormatHistogramLine(buffer + length, bufferSize - length, "Mouse", g_mouseHookLatency);
+    if (written < 0 || (size_t)written >= bufferSize - length) return bufferSize - 1;
+    length += written;
+
+    written = snprintf(buffer + length, bufferSize - length,
+                       "LowLevelHooksTimeout: %lu ms\r\n", (unsigned long)g_hooksTimeout);
+    if (written < 0 || (size_t)written >= bufferSize - length) return bufferSize - 1;
+    length += written;
+
+    // Callbacks per second in each lock state (including the current one)
+    double seconds[2];
+    for (int state = 0; state < 2; state++) {
+        ULONGLONG ms = g_stateMilliseconds[state];
+        if ((g_countingLocked ? 1 : 0) == state) ms += GetTickCount64() - g_stateSince;
+        seconds[state] = ms > 0 ? ms / 1000.0 : 1.0;
+    }
+    static const char* SOURCE_NAMES[INPUT_COUNTER_SOURCE_COUNT] = { "Keyboard hook", "Mouse hook", "Raw input" };
+    for (int source = 0; source < INPUT_COUNTER_SOURCE_COUNT; source++) {
+        written = snprintf(buffer + length, bufferSize - length,
+                           "%s calls/s: unlocked %.1f, locked %.1f\r\n", SOURCE_NAMES[source],
+                           g_inputCallbackCounts[source][0].load(std::memory_order_relaxed) / seconds[0],
+                           g_inputCallbackCounts[source][1].load(std::memory_order_relaxed) / seconds[1]);
+        if (written < 0 || (size_t)written >= bufferSize - length) return bufferSize - 1;
+        length += written;
+    }
+
+    written = snprintf(buffer + length, bufferSize - length,
+                       "Hooks removed by Windows: %lu\r\n", (unsigned long)g_hookIncidentCount);
+    if (written < 0 || (size_t)written >= bufferSize - length) return bufferSize - 1;
+    length += written;
+
+    uint32_t shown = g_hookIncidentCount < HOOK_INCIDENT_HISTORY ? g_hookIncidentCount : (uint32_t)HOOK_INCIDENT_HISTORY;
+    for (uint32_t i = g_hookIncidentCount - shown; i < g_hookIncidentCount; i++) {
+        const HookIncident& incident = g_hookIncidents[i % HOOK_INCIDENT_HISTORY];
+        written = snprintf(buffer + length, bufferSize - length,
+                           "  %02u:%02u:%02u %s, unhooked %lu ms, %s: p99 %.1f us, p99.9 %.1f us, max %.1f us\r\n",
+                           incident.time.wHour, incident.time.wMinute, incident.time.wSecond,
+                           incident.hook == HOOK_WATCHDOG_KEYBOARD ? "keyboard" : "mouse",
+                           (unsigned long)incident.silentFor, incident.reinstalled ? "reinstalled" : "not reinstalled",
+                           TicksToMicroseconds(incident.latency.p99), TicksToMicroseconds(incident.latency.p999),
+                           TicksToMicroseconds(incident.latency.max));
+        if (written < 0 || (size_t)written >= bufferSize - length) return bufferSize - 1;
+        length += written;
+    }
+    return length;
+}
+
+bool SaveHookLatencyReport(const char* path) {
+    char report[HOOK_REPORT_SIZE];
+    size_t length = FormatHookLatencyReport(report, sizeof(report));
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(report, length);
+    return file.good();
+}
+
+void ShowHookLatencyReport(HWND hwnd) {
+    char report[HOOK_REPORT_SIZE];
+    FormatHookLatencyReport(report, sizeof(report));
+
+    char text[HOOK_REPORT_SIZE + 64];
+    snprintf(text, sizeof(text), "%s\r\nSave this report to a file?", report);
+    if (MessageBoxA(hwnd, text, "Hook Latency", MB_YESNO | MB_ICONINFORMATION) != IDYES) {
+        return;
+    }
+
+    char path[MAX_PATH];
+    DWORD tempLength = GetTempPathA(MAX_PATH, path);
+    if (tempLength == 0 || tempLength + 32 >= MAX_PATH) {
+        ShowNotification(hwnd, NOTIFY_SETTINGS_ERROR, "Could not locate the temp folder");
+        return;
+    }
+    strcat_s(path, MAX_PATH, "UtilityApp_hook_latency.txt");
+
+    if (SaveHookLatencyReport(path)) {
+        char message[MAX_PATH + 32];
+        snprintf(message, sizeof(message), "Latency report saved to %s", path);
+        MessageBoxA(hwnd, message, "Hook Latency", MB_OK | MB_ICONINFORMATION);
+    } else {
+        ShowNotification(hwnd, NOTIFY_SETTINGS_ERROR, "Failed to save latency report");
+    }
+}
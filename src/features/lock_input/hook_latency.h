@@ -0,0 +1,58 @@
+// src/features/lock_input/hook_latency.h
+// Low-level hook callback timing and LowLevelHooksTimeout early warning
+
+#pragma once
+#include <windows.h>
+#include <cstddef>
+#include <atomic>
+#include "../../utils/latency_histogram.h"
+#include "hook_watchdog.h"
+
+// Callback durations in QueryPerformanceCounter ticks
+extern LatencyHistogram g_keyboardHookLatency;
+extern LatencyHistogram g_mouseHookLatency;
+
+// Input callbacks counted per lock state, to show what the hooks cost while unlocked
+enum InputCounterSource {
+    INPUT_COUNTER_KEYBOARD_HOOK = 0,
+    INPUT_COUNTER_MOUSE_HOOK = 1,
+    INPUT_COUNTER_RAW_INPUT = 2,
+    INPUT_COUNTER_SOURCE_COUNT = 3
+};
+extern std::atomic<uint64_t> g_inputCallbackCounts[INPUT_COUNTER_SOURCE_COUNT][2]; // [source][locked]
+
+inline void CountInputCallback(InputCounterSource source, bool locked) {
+    g_inputCallbackCounts[source][locked ? 1 : 0].fetch_add(1, std::memory_order_relaxed);
+}
+
+// Tracks time spent in each lock state so counts can be reported per second
+void NoteLockStateChange(bool locked);
+
+inline uint64_t HookTimestamp() {
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)counter.QuadPart;
+}
+
+// Reads the OS hook timeout and starts the periodic latency check
+void InitializeHookLatency(HWND hwnd);
+void ShutdownHookLatency(HWND hwnd);
+
+// HKCU\Control Panel\Desktop\LowLevelHooksTimeout in milliseconds
+DWORD GetLowLevelHooksTimeout();
+
+// Warns once when p99.9 of either hook over the last check interval gets
+// close to the OS timeout
+void CheckHookLatency(HWND hwnd);
+
+// A hook the watchdog found removed and reinstalled: keeps it with the hook's
+// latency at that moment for the report (FormatHookLatencyReport) and
+// notifies while locked
+void RecordHookIncident(HWND hwnd, HookWatchdogHook hook, DWORD silentFor, bool reinstalled, bool locked);
+
+// Plain-text percentile report for both hooks (microseconds) and recent incidents
+size_t FormatHookLatencyReport(char* buffer, size_t bufferSize);
+bool SaveHookLatencyReport(const char* path);
+
+// Tray command: show the report and offer to save it to a file
+void ShowHookLatencyReport(HWND hwnd);
@@ -0,0 +1,59 @@
+// src/features/lock_input/hook_policy.cpp
+// Hook policy compilation
+
+#include "hook_policy.h"
+#include "input_backend.h"
+#include <cstring>
+
+static const uint8_t MOUSE_MOVE_BIT = 1 << INPUT_EVENT_MOUSE_MOVE;
+static const uint8_t MOUSE_BUTTON_BITS = (1 << INPUT_EVENT_BUTTON_DOWN) | (1 << INPUT_EVENT_BUTTON_UP);
+static const uint8_t MOUSE_WHEEL_BIT = 1 << INPUT_EVENT_WHEEL;
+
+uint8_t MouseLockEventMask(int mode) {
+    switch (mode) {
+        case MOUSE_LOCK_CLICKS:  return MOUSE_BUTTON_BITS;
+        case MOUSE_LOCK_WHEEL:   return MOUSE_WHEEL_BIT;
+        case MOUSE_LOCK_CONFINE: return MOUSE_BUTTON_BITS | MOUSE_WHEEL_BIT;
+        default:                 return MOUSE_MOVE_BIT | MOUSE_BUTTON_BITS | MOUSE_WHEEL_BIT;
+    }
+}
+
+void CompileHookPolicy(const LockEngineConfig& config, HookPolicy& policy) {
+    memset(&policy, 0, sizeof(policy));
+
+    for (unsigned vk = 0; vk < 256; vk++) {
+        uint32_t down = config.keyPolicy.Lookup(KEY_POLICY_DOWN, vk);
+        HookKeyClass keyClass;
+        if (down & KEY_ACTION_PASS) {
+            keyClass = HOOK_KEY_PASS;
+        } else if (down & KEY_ACTION_QUEUE) {
+            keyClass = (down & KEY_ACTION_PASSWORD) ? HOOK_KEY_PASSWORD : HOOK_KEY_RESET;
+        } else {
+            keyClass = HOOK_KEY_BLOCK;
+        }
+        policy.downClass[vk >> 2] |= (uint8_t)(keyClass << ((vk & 3) * 2));
+
+        // Releases are never queued; they either pass or are swallowed
+        if (config.keyPolicy.Lookup(KEY_POLICY_UP, vk) & KEY_ACTION_PASS) {
+            policy.upPass[vk >> 6] |= 1ULL << (vk & 63);
+        }
+    }
+
+    for (int i = 0; i < LockEngineConfig::MAX_UNLOCK_CHORDS; i++) {
+        policy.unlockChords[i] = config.unlockChords[i];
+    }
+    policy.mouseBlock = config.mouseBlockMask;
+    if (config.failsafeEnabled) policy.flags |= HOOK_POLICY_FAILSAFE;
+}
+
+HookPolicy DefaultHookPolicy() {
+    LockEngineConfig config;
+    config.keyPolicy.Reset();
+    config.mouseBlockMask = 0;
+    config.failsafeEnabled = true;
+    memset(config.unlockChords, 0, sizeof(config.unlockChords));
+    
+    HookPolicy policy;
+    CompileHookPolicy(config, policy);
+    return policy;
+}
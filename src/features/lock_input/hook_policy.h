@@ -0,0 +1,88 @@
+// src/features/lock_input/hook_policy.h
+// Read-only lock policy snapshot for the hook, published by atomic pointer swap (portable)
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "key_policy.h"
+#include "../../utils/snapshot_publisher.h"
+
+// Modifier bits for unlock chords (same values as the RegisterHotKey MOD_* flags)
+enum LockModifier {
+    LOCK_MOD_ALT = 0x1,
+    LOCK_MOD_CONTROL = 0x2,
+    LOCK_MOD_SHIFT = 0x4,
+    LOCK_MOD_WIN = 0x8
+};
+
+struct UnlockChord {
+    uint8_t modifiers; // LockModifier bits that must be held (exactly)
+    uint8_t vkCode;    // 0 = unused slot
+};
+
+// What a mouse lock blocks (AppSettings::mouseLockMode)
+enum MouseLockMode {
+    MOUSE_LOCK_ALL = 0,     // Movement, buttons and wheel
+    MOUSE_LOCK_CLICKS = 1,  // Buttons only; the pointer still moves and scrolls
+    MOUSE_LOCK_WHEEL = 2,   // Wheel only
+    MOUSE_LOCK_CONFINE = 3, // Buttons and wheel; movement allowed inside a ClipCursor rectangle
+    MOUSE_LOCK_MODE_COUNT = 4
+};
+
+// Mouse events a mode blocks, one bit per InputEventType (unknown modes block everything)
+uint8_t MouseLockEventMask(int mode);
+
+// Settings snapshot a HookPolicy is compiled from (built on the UI thread)
+struct LockEngineConfig {
+    static const int MAX_UNLOCK_CHORDS = 2;
+
+    KeyPolicy keyPolicy;
+    uint8_t mouseBlockMask; // MouseLockEventMask(), 0 = mouse not locked
+    bool failsafeEnabled;
+    UnlockChord unlockChords[MAX_UNLOCK_CHORDS];
+};
+
+// What a key press resolves to (same values as the first four LockEventClass entries)
+enum HookKeyClass {
+    HOOK_KEY_PASS = 0,
+    HOOK_KEY_PASSWORD = 1,
+    HOOK_KEY_RESET = 2,
+    HOOK_KEY_BLOCK = 3
+};
+
+enum HookPolicyFlags {
+    HOOK_POLICY_FAILSAFE = 0x02
+};
+
+// Everything the hook needs per event, packed so a key press touches only
+// the first cache line and a key release only the second.
+struct alignas(64) HookPolicy {
+    uint8_t downClass[64];   // 2-bit HookKeyClass per virtual key
+    uint64_t upPass[4];      // Key releases that pass
+    UnlockChord unlockChords[LockEngineConfig::MAX_UNLOCK_CHORDS];
+    uint8_t flags;           // HookPolicyFlags
+    uint8_t mouseBlock;      // Bit per InputEventType: mouse events blocked while locked
+    uint8_t reserved[2];
+    uint32_t generation;     // Set by the publisher (0 = initial snapshot)
+
+    HookKeyClass DownClass(uint8_t vk) const {
+        return (HookKeyClass)((downClass[vk >> 2] >> ((vk & 3) * 2)) & 3);
+    }
+    bool UpPasses(uint8_t vk) const {
+        return ((upPass[vk >> 6] >> (vk & 63)) & 1) != 0;
+    }
+    bool BlocksMouse(uint8_t eventType) const {
+        return ((mouseBlock >> eventType) & 1) != 0;
+    }
+};
+
+static_assert(sizeof(HookPolicy) == 128, "HookPolicy should span exactly two cache lines");
+
+void CompileHookPolicy(const LockEngineConfig& config, HookPolicy& policy);
+
+// What the hook sees before the first Configure(): keyboard blocked while
+// locked, mouse free, failsafe on, no unlock chords
+HookPolicy DefaultHookPolicy();
+
+// Publication to the hook thread (see SnapshotPublisher for the protocol)
+typedef SnapshotPublisher<HookPolicy> HookPolicyPublisher;
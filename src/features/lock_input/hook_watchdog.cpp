@@ -0,0 +1,69 @@
+// src/features/lock_input/hook_watchdog.cpp
+// Hook loss detection
+
+#include "hook_watchdog.h"
+#include <cstring>
+
+HookWatchdog::HookWatchdog() {
+    Reset();
+}
+
+void HookWatchdog::Reset() {
+    memset(&previous, 0, sizeof(previous));
+    primed = false;
+    for (int hook = 0; hook < HOOK_WATCHDOG_HOOK_COUNT; hook++) Rearm(hook);
+}
+
+void HookWatchdog::Rearm(int hook) {
+    suspicion[hook] = 0;
+    firstUnexplained[hook] = 0;
+}
+
+uint8_t HookWatchdog::Check(const HookWatchdogSample& sample, uint32_t* silentFor) {
+    if (!primed) {
+        previous = sample;
+        primed = true;
+        return 0;
+    }
+
+    // Input nobody hooks still moves the cursor and the last input time
+    if (sample.unobservable || previous.unobservable) {
+        for (int hook = 0; hook < HOOK_WATCHDOG_HOOK_COUNT; hook++) Rearm(hook);
+        previous = sample;
+        return 0;
+    }
+
+    bool input = sample.lastInputTime != previous.lastInputTime;
+    bool cursorMoved = sample.cursorX != previous.cursorX || sample.cursorY != previous.cursorY;
+    bool mouseChanged = cursorMoved || sample.mouseButtons != previous.mouseButtons;
+    bool beat[HOOK_WATCHDOG_HOOK_COUNT];
+    bool unexplained[HOOK_WATCHDOG_HOOK_COUNT];
+    for (int hook = 0; hook < HOOK_WATCHDOG_HOOK_COUNT; hook++) {
+        beat[hook] = sample.heartbeats[hook] != previous.heartbeats[hook];
+    }
+    unexplained[HOOK_WATCHDOG_MOUSE] = cursorMoved && !beat[HOOK_WATCHDOG_MOUSE];
+    unexplained[HOOK_WATCHDOG_KEYBOARD] = input && !mouseChanged &&
+                                          !beat[HOOK_WATCHDOG_KEYBOARD] && !beat[HOOK_WATCHDOG_MOUSE];
+
+    uint8_t lost = 0;
+    for (int hook = 0; hook < HOOK_WATCHDOG_HOOK_COUNT; hook++) {
+        // Judge only hooks that were in for the whole interval
+        if (!sample.installed[hook] || !previous.installed[hook] || beat[hook]) {
+            Rearm(hook);
+            continue;
+        }
+        if (!unexplained[hook]) continue; // No evidence either way: keep the count
+
+        if (suspicion[hook]++ == 0) {
+            firstUnexplained[hook] = input ? sample.lastInputTime : sample.now;
+        }
+        if (suspicion[hook] >= CONFIRM_CHECKS) {
+            lost |= (uint8_t)(1 << hook);
+            if (silentFor) silentFor[hook] = sample.now - firstUnexplained[hook];
+            Rearm(hook);
+        }
+    }
+
+    previous = sample;
+    return lost;
+}
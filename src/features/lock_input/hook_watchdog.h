@@ -0,0 +1,62 @@
+// src/features/lock_input/hook_watchdog.h
+// Detects low-level hooks that Windows removed, from callback heartbeats versus system input activity (portable)
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+enum HookWatchdogHook {
+    HOOK_WATCHDOG_KEYBOARD = 0,
+    HOOK_WATCHDOG_MOUSE = 1,
+    HOOK_WATCHDOG_HOOK_COUNT = 2
+};
+
+// One observation, taken by the caller in this order: last input time first,
+// then the heartbeats. A hook runs before the system records the input, so
+// any input the time covers has already been counted by a live hook.
+struct HookWatchdogSample {
+    uint32_t now;           // Milliseconds, same clock as lastInputTime (GetTickCount)
+    uint32_t lastInputTime; // GetLastInputInfo: any keyboard or mouse input
+    uint32_t heartbeats[HOOK_WATCHDOG_HOOK_COUNT]; // Callbacks so far, per hook
+    bool installed[HOOK_WATCHDOG_HOOK_COUNT];      // Whether the hook should be in
+    int32_t cursorX;
+    int32_t cursorY;
+    uint8_t mouseButtons; // Buttons held (any bit order, compared only for change)
+    bool unobservable;    // Input may be going where our hooks are never called: an
+                          // elevated foreground window (UIPI) or another desktop (UAC, lock screen)
+};
+
+// Windows removes a low-level hook without notice once a callback overruns
+// LowLevelHooksTimeout. The only trace is that input keeps arriving while the
+// callbacks stop. Check() compares consecutive samples:
+//   mouse:    the cursor moved, but the mouse hook saw nothing
+//   keyboard: there was input, but neither hook saw anything and neither the
+//             cursor nor the buttons changed - so it was not mouse input
+// A hook is reported lost after CONFIRM_CHECKS such intervals in a row with no
+// heartbeat in between; a stray SetCursorPos or an unhooked click costs at
+// most one harmless reinstall. Intervals that begin or end unobservable are
+// no evidence and start every hook's count afresh. Callers reinstall and then
+// call Rearm().
+class HookWatchdog {
+public:
+    static const int CONFIRM_CHECKS = 2;
+
+private:
+    HookWatchdogSample previous;
+    bool primed;
+    int suspicion[HOOK_WATCHDOG_HOOK_COUNT];
+    uint32_t firstUnexplained[HOOK_WATCHDOG_HOOK_COUNT]; // Input time of the first interval without a heartbeat
+
+public:
+    HookWatchdog();
+
+    // Returns a mask of lost hooks (1 << HookWatchdogHook). silentFor, if not
+    // null, receives for each lost hook how long input has gone unhooked.
+    uint8_t Check(const HookWatchdogSample& sample, uint32_t* silentFor);
+
+    // After a reinstall (or any install/remove): judge the hook afresh
+    void Rearm(int hook);
+    void Reset();
+
+    int GetSuspicion(int hook) const { return suspicion[hook]; }
+};
@@ -0,0 +1,75 @@
+// src/features/lock_input/input_backend.h
+// Input source abstraction: backends deliver a normalized event stream to a sink (portable)
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+enum InputDevice {
+    INPUT_DEVICE_KEYBOARD = 0,
+    INPUT_DEVICE_MOUSE = 1
+};
+
+enum InputEventType {
+    INPUT_EVENT_KEY_DOWN = 0,
+    INPUT_EVENT_KEY_UP = 1,
+    INPUT_EVENT_MOUSE_MOVE = 2,
+    INPUT_EVENT_BUTTON_DOWN = 3,
+    INPUT_EVENT_BUTTON_UP = 4,
+    INPUT_EVENT_WHEEL = 5
+};
+
+enum InputEventFlags {
+    INPUT_FLAG_INJECTED = 0x0001,   // Synthesized by SendInput or similar
+    INPUT_FLAG_SYSTEM_KEY = 0x0002, // WM_SYSKEYDOWN / WM_SYSKEYUP (Alt held)
+    INPUT_FLAG_EXTENDED = 0x0004,   // Extended key (right Ctrl/Alt, arrows, ...)
+    INPUT_FLAG_RELATIVE = 0x0008,   // Mouse x/y are deltas rather than screen coordinates
+    INPUT_FLAG_HORIZONTAL = 0x0010  // Wheel event is horizontal
+};
+
+// Mouse button codes carried in InputEvent::code
+enum InputMouseButton {
+    INPUT_BUTTON_LEFT = 1,
+    INPUT_BUTTON_RIGHT = 2,
+    INPUT_BUTTON_MIDDLE = 3,
+    INPUT_BUTTON_X1 = 4,
+    INPUT_BUTTON_X2 = 5
+};
+
+// One keyboard or mouse event, independent of where it came from
+struct InputEvent {
+    uint8_t device;      // InputDevice
+    uint8_t type;        // InputEventType
+    uint16_t flags;      // InputEventFlags
+    uint16_t code;       // Virtual-key code or InputMouseButton
+    int16_t wheelDelta;  // WHEEL_DELTA units for INPUT_EVENT_WHEEL
+    int32_t x;
+    int32_t y;
+    uint32_t time;       // Milliseconds on the GetTickCount clock
+};
+
+enum InputVerdict {
+    INPUT_VERDICT_PASS = 0,
+    INPUT_VERDICT_BLOCK = 1
+};
+
+// Receives events on the thread the backend delivers them on. The verdict is
+// only honoured by backends that CanBlock(); observers return PASS.
+class InputEventSink {
+public:
+    virtual ~InputEventSink() {}
+    virtual InputVerdict OnInputEvent(const InputEvent& event) = 0;
+};
+
+// A source of input events. Start() begins delivery to the sink from the
+// calling thread's context; Stop() ends it. Backends are not thread-safe and
+// must be started and stopped on the same thread.
+class InputBackend {
+public:
+    virtual ~InputBackend() {}
+    virtual const char* GetName() const = 0;
+    virtual bool CanBlock() const = 0;
+    virtual bool Start(InputEventSink* sink) = 0;
+    virtual void Stop() = 0;
+    virtual bool IsRunning() const = 0;
+};
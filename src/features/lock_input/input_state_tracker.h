@@ -0,0 +1,79 @@
+// src/features/lock_input/input_state_tracker.h
+// Which keys and mouse buttons are down, kept up to date from the blocking backends' verdicts (portable)
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "input_backend.h"
+#include "key_policy.h"
+
+// Two views of every key (one bit per virtual key) and mouse button:
+//   held      - physically down, from every press and release seen
+//   delivered - down as far as the system knows, from the events that passed
+// A key that is delivered but no longer held had its release swallowed by
+// the lock and is logically stuck. Only the delivering thread writes (seeding
+// included), so updates are plain stores; another thread may take a snapshot.
+class InputStateTracker {
+private:
+    std::atomic<uint64_t> heldKeys[4];
+    std::atomic<uint64_t> deliveredKeys[4];
+    std::atomic<uint8_t> heldButtons;      // Bit (InputMouseButton - 1)
+    std::atomic<uint8_t> deliveredButtons;
+
+    template <typename T>
+    static void Assign(std::atomic<T>& word, T bit, bool down) {
+        T current = word.load(std::memory_order_relaxed);
+        T next = down ? (T)(current | bit) : (T)(current & ~bit);
+        if (next != current) word.store(next, std::memory_order_release); // Key repeat stores nothing
+    }
+
+public:
+    InputStateTracker() {
+        KeySet none;
+        none.Clear();
+        SeedKeys(none);
+        SeedButtons(0);
+    }
+
+    // Delivering thread, once the verdict is known
+    void Update(const InputEvent& event, InputVerdict verdict) {
+        bool passed = verdict == INPUT_VERDICT_PASS;
+        if (event.device == INPUT_DEVICE_KEYBOARD) {
+            uint8_t vk = (uint8_t)event.code;
+            uint64_t bit = 1ULL << (vk & 63);
+            bool down = event.type == INPUT_EVENT_KEY_DOWN;
+            Assign(heldKeys[vk >> 6], bit, down);
+            if (passed) Assign(deliveredKeys[vk >> 6], bit, down);
+        } else if ((event.type == INPUT_EVENT_BUTTON_DOWN || event.type == INPUT_EVENT_BUTTON_UP) &&
+                   event.code >= INPUT_BUTTON_LEFT && event.code <= INPUT_BUTTON_X2) {
+            uint8_t bit = (uint8_t)(1 << (event.code - 1));
+            bool down = event.type == INPUT_EVENT_BUTTON_DOWN;
+            Assign(heldButtons, bit, down);
+            if (passed) Assign(deliveredButtons, bit, down);
+        }
+    }
+
+    // Delivering thread: backends only see input from the moment they start,
+    // so begin from the system's state (nothing has been blocked yet)
+    void SeedKeys(const KeySet& down) {
+        for (int i = 0; i < 4; i++) {
+            heldKeys[i].store(down.words[i], std::memory_order_release);
+            deliveredKeys[i].store(down.words[i], std::memory_order_release);
+        }
+    }
+    void SeedButtons(uint8_t down) {
+        heldButtons.store(down, std::memory_order_release);
+        deliveredButtons.store(down, std::memory_order_release);
+    }
+
+    // Any thread: keys and buttons the system still thinks are down although
+    // they were released while blocked
+    void GetStuckKeys(KeySet& keys) const {
+        for (int i = 0; i < 4; i++) {
+            keys.words[i] = deliveredKeys[i].load(std::memory_order_acquire) & ~heldKeys[i].load(std::memory_order_acquire);
+        }
+    }
+    uint8_t GetStuckButtons() const {
+        return (uint8_t)(deliveredButtons.load(std::memory_order_acquire) & ~heldButtons.load(std::memory_order_acquire));
+    }
+};
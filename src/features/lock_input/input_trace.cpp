@@ -0,0 +1,316 @@
+// src/features/lock_input/input_trace.cpp
+// Input trace recorder and reader implementation
+
+#include "input_trace.h"
+#include <cstring>
+#include <fstream>
+
+// Tag byte layout
+static const uint8_t TAG_TYPE_MASK = 0x07;      // InputEventType, or one of the two below
+static const uint8_t TAG_LOCK = 6;
+static const uint8_t TAG_UNLOCK = 7;
+static const uint8_t TAG_MOUSE = 0x08;
+static const uint8_t TAG_INJECTED = 0x10;
+static const uint8_t TAG_SYSTEM_KEY = 0x20;
+static const uint8_t TAG_EXTENDED = 0x40;
+static const uint8_t TAG_RELATIVE_OR_HORIZONTAL = 0x80; // Relative move / horizontal wheel
+
+static const char TRACE_MAGIC[4] = { 'U', 'A', 'I', 'T' };
+static const size_t MAX_RECORD_SIZE = 16;
+
+static size_t WriteVarint(uint8_t* out, uint32_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+static bool ReadVarint(const uint8_t* data, size_t size, size_t& position, uint32_t& value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 35; shift += 7) {
+        if (position >= size) return false;
+        uint8_t byte = data[position++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+static uint32_t ZigZag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t UnZigZag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+InputKeyClass ClassifyKey(uint16_t vkCode) {
+    if (vkCode >= 'A' && vkCode <= 'Z') return INPUT_KEY_CLASS_ALPHA;
+    if ((vkCode >= '0' && vkCode <= '9') || (vkCode >= 0x60 && vkCode <= 0x69)) return INPUT_KEY_CLASS_DIGIT; // Numpad 0-9
+    if ((vkCode >= 0x10 && vkCode <= 0x12) ||   // Shift, Ctrl, Alt
+        (vkCode >= 0xA0 && vkCode <= 0xA5) ||   // Left/right variants
+        vkCode == 0x5B || vkCode == 0x5C) {     // Windows keys
+        return INPUT_KEY_CLASS_MODIFIER;
+    }
+    if (vkCode == 0x1B) return INPUT_KEY_CLASS_ESCAPE;
+    return INPUT_KEY_CLASS_OTHER;
+}
+
+uint16_t KeyClassRepresentative(InputKeyClass keyClass) {
+    switch (keyClass) {
+        case INPUT_KEY_CLASS_ALPHA:    return 'A';
+        case INPUT_KEY_CLASS_DIGIT:    return '0';
+        case INPUT_KEY_CLASS_MODIFIER: return 0x10; // VK_SHIFT
+        case INPUT_KEY_CLASS_ESCAPE:   return 0x1B;
+        default:                       return 0x20; // VK_SPACE
+    }
+}
+
+InputTraceRecorder::InputTraceRecorder()
+    : recording(false), droppedCount(0), capacity(0), recordCount(0), startTime(0),
+      lastTime(0), lastX(0), lastY(0), truncated(false) {}
+
+void InputTraceRecorder::Start(size_t maxBytes) {
+    pending.Clear(); // Nothing is pushed while not recording
+    droppedCount.store(0, std::memory_order_relaxed);
+    buffer.clear();
+    buffer.reserve(maxBytes);
+    capacity = maxBytes;
+    recordCount = 0;
+    startTime = lastTime = 0;
+    lastX = lastY = 0;
+    truncated = false;
+    recording.store(true, std::memory_order_release);
+}
+
+void InputTraceRecorder::Stop() {
+    Drain();
+    recording.store(false, std::memory_order_release);
+    Drain(); // Events pushed while the flag was being cleared
+}
+
+void InputTraceRecorder::Clear() {
+    recording.store(false, std::memory_order_release);
+    pending.Clear();
+    std::vector<uint8_t>().swap(buffer);
+    capacity = 0;
+    recordCount = 0;
+    truncated = false;
+}
+
+void InputTraceRecorder::Append(uint8_t tag, uint32_t time, const uint8_t* payload, size_t payloadSize) {
+    if (recordCount == 0) {
+        startTime = lastTime = time;
+    }
+
+    uint8_t record[MAX_RECORD_SIZE];
+    size_t length = 0;
+    record[length++] = tag;
+    length += WriteVarint(record + length, time - lastTime);
+    memcpy(record + length, payload, payloadSize);
+    length += payloadSize;
+
+    if (buffer.size() + length > capacity) {
+        truncated = true;
+        recording.store(false, std::memory_order_release);
+        return;
+    }
+    buffer.insert(buffer.end(), record, record + length);
+    lastTime = time;
+    recordCount++;
+}
+
+void InputTraceRecorder::Drain() {
+    InputEvent events[64];
+    size_t count;
+    while ((count = pending.PopBatch(events, sizeof(events) / sizeof(events[0]))) > 0) {
+        for (size_t i = 0; i < count && !truncated; i++) Encode(events[i]);
+    }
+}
+
+void InputTraceRecorder::Encode(const InputEvent& event) {
+    uint8_t tag = event.type & TAG_TYPE_MASK;
+    if (event.flags & INPUT_FLAG_INJECTED) tag |= TAG_INJECTED;
+    if (event.flags & INPUT_FLAG_SYSTEM_KEY) tag |= TAG_SYSTEM_KEY;
+    if (event.flags & INPUT_FLAG_EXTENDED) tag |= TAG_EXTENDED;
+
+    uint8_t payload[MAX_RECORD_SIZE - 6];
+    size_t payloadSize = 0;
+    if (event.device == INPUT_DEVICE_KEYBOARD) {
+        InputKeyClass keyClass = ClassifyKey(event.code);
+        payload[payloadSize++] = (uint8_t)keyClass;
+        if (keyClass == INPUT_KEY_CLASS_MODIFIER) {
+            payload[payloadSize++] = (uint8_t)event.code; // Which modifier is not sensitive
+        }
+    } else {
+        tag |= TAG_MOUSE;
+        switch (event.type) {
+            case INPUT_EVENT_MOUSE_MOVE: {
+                // Relative moves are already deltas and do not move the tracked position
+                int32_t dx = event.x, dy = event.y;
+                if (event.flags & INPUT_FLAG_RELATIVE) {
+                    tag |= TAG_RELATIVE_OR_HORIZONTAL;
+                } else {
+                    dx -= lastX;
+                    dy -= lastY;
+                    lastX = event.x;
+                    lastY = event.y;
+                }
+                payloadSize += WriteVarint(payload, ZigZag(dx));
+                payloadSize += WriteVarint(payload + payloadSize, ZigZag(dy));
+                break;
+            }
+            case INPUT_EVENT_WHEEL:
+                if (event.flags & INPUT_FLAG_HORIZONTAL) tag |= TAG_RELATIVE_OR_HORIZONTAL;
+                payloadSize += WriteVarint(payload, ZigZag(event.wheelDelta));
+                break;
+            default:
+                payload[payloadSize++] = (uint8_t)event.code;
+                break;
+        }
+    }
+    Append(tag, event.time, payload, payloadSize);
+}
+
+void InputTraceRecorder::RecordLockState(bool locked, uint32_t time) {
+    if (!recording.load(std::memory_order_relaxed)) return;
+    Drain();
+    if (!truncated) Append(locked ? TAG_LOCK : TAG_UNLOCK, time, NULL, 0);
+}
+
+void InputTraceRecorder::CopyTrace(std::vector<uint8_t>& out) const {
+    InputTraceHeader header;
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = INPUT_TRACE_VERSION;
+    header.reserved = 0;
+    header.recordCount = recordCount;
+    header.startTime = startTime;
+
+    out.resize(sizeof(header) + buffer.size());
+    memcpy(out.data(), &header, sizeof(header));
+    if (!buffer.empty()) {
+        memcpy(out.data() + sizeof(header), buffer.data(), buffer.size());
+    }
+}
+
+bool InputTraceRecorder::Save(const char* path) const {
+    std::vector<uint8_t> trace;
+    CopyTrace(trace);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write((const char*)trace.data(), (std::streamsize)trace.size());
+    return file.good();
+}
+
+InputTraceReader::InputTraceReader()
+    : data(NULL), size(0), position(0), recordCount(0), recordsRead(0), time(0), x(0), y(0) {}
+
+bool InputTraceReader::Open(const uint8_t* data, size_t size) {
+    InputTraceHeader header;
+    if (size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 || header.version != INPUT_TRACE_VERSION) {
+        return false;
+    }
+
+    this->data = data;
+    this->size = size;
+    position = sizeof(header);
+    recordCount = header.recordCount;
+    recordsRead = 0;
+    time = header.startTime;
+    x = y = 0;
+    return true;
+}
+
+bool InputTraceReader::Next(InputTraceRecord& record) {
+    if (recordsRead >= recordCount || position >= size) return false;
+
+    uint8_t tag = data[position++];
+    uint32_t delta;
+    if (!ReadVarint(data, size, position, delta)) return false;
+    time += delta;
+
+    memset(&record, 0, sizeof(record));
+    record.event.time = time;
+    uint8_t type = tag & TAG_TYPE_MASK;
+    if (type == TAG_LOCK || type == TAG_UNLOCK) {
+        record.kind = type == TAG_LOCK ? INPUT_TRACE_LOCK : INPUT_TRACE_UNLOCK;
+        recordsRead++;
+        return true;
+    }
+
+    record.kind = INPUT_TRACE_EVENT;
+    InputEvent& event = record.event;
+    event.type = type;
+    if (tag & TAG_INJECTED) event.flags |= INPUT_FLAG_INJECTED;
+    if (tag & TAG_SYSTEM_KEY) event.flags |= INPUT_FLAG_SYSTEM_KEY;
+    if (tag & TAG_EXTENDED) event.flags |= INPUT_FLAG_EXTENDED;
+
+    if (!(tag & TAG_MOUSE)) {
+        if (position >= size) return false;
+        InputKeyClass keyClass = (InputKeyClass)data[position++];
+        event.device = INPUT_DEVICE_KEYBOARD;
+        event.code = KeyClassRepresentative(keyClass);
+        if (keyClass == INPUT_KEY_CLASS_MODIFIER) {
+            if (position >= size) return false;
+            event.code = data[position++];
+        }
+    } else {
+        event.device = INPUT_DEVICE_MOUSE;
+        uint32_t value;
+        switch (type) {
+            case INPUT_EVENT_MOUSE_MOVE: {
+                uint32_t dy;
+                if (!ReadVarint(data, size, position, value) || !ReadVarint(data, size, position, dy)) return false;
+                if (tag & TAG_RELATIVE_OR_HORIZONTAL) {
+                    event.flags |= INPUT_FLAG_RELATIVE;
+                    event.x = UnZigZag(value);
+                    event.y = UnZigZag(dy);
+                } else {
+                    x += UnZigZag(value);
+                    y += UnZigZag(dy);
+                    event.x = x;
+                    event.y = y;
+                }
+                break;
+            }
+            case INPUT_EVENT_WHEEL:
+                if (tag & TAG_RELATIVE_OR_HORIZONTAL) event.flags |= INPUT_FLAG_HORIZONTAL;
+                if (!ReadVarint(data, size, position, value)) return false;
+                event.wheelDelta = (int16_t)UnZigZag(value);
+                event.x = x;
+                event.y = y;
+                break;
+            default:
+                if (position >= size) return false;
+                event.code = data[position++];
+                event.x = x;
+                event.y = y;
+                break;
+        }
+    }
+    recordsRead++;
+    return true;
+}
+
+bool LoadInputTrace(const char* path, std::vector<uint8_t>& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::streamoff length = file.tellg();
+    if (length < (std::streamoff)sizeof(InputTraceHeader)) {
+        return false;
+    }
+    out.resize((size_t)length);
+    file.seekg(0);
+    file.read((char*)out.data(), length);
+    return file.good();
+}
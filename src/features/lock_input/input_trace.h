@@ -0,0 +1,135 @@
+// src/features/lock_input/input_trace.h
+// Compact, scrubbed binary input traces for replaying real workloads (portable)
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "input_backend.h"
+#include "../../utils/spsc_ring.h"
+
+// File layout: InputTraceHeader followed by variable-length records. Each
+// record is a tag byte, the time since the previous record as a varint, then
+// a type-specific payload:
+//   key        class byte (+ virtual-key byte for modifiers)
+//   move       zigzag varint dx, dy from the previous position
+//   button     button byte
+//   wheel      zigzag varint delta
+//   lock state nothing
+// Typed text never reaches the trace: keys are reduced to their class.
+struct InputTraceHeader {
+    char magic[4];       // "UAIT"
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t recordCount;
+    uint32_t startTime;  // Time of the first record (GetTickCount clock)
+};
+
+const uint16_t INPUT_TRACE_VERSION = 1;
+
+// What a scrubbed key is reduced to
+enum InputKeyClass {
+    INPUT_KEY_CLASS_ALPHA = 0,
+    INPUT_KEY_CLASS_DIGIT = 1,
+    INPUT_KEY_CLASS_MODIFIER = 2,
+    INPUT_KEY_CLASS_ESCAPE = 3,   // Kept apart so replays exercise the failsafe
+    INPUT_KEY_CLASS_OTHER = 4
+};
+
+InputKeyClass ClassifyKey(uint16_t vkCode);
+
+// Key code a class is replayed as ('A', '0', Esc, Space; modifiers keep their own)
+uint16_t KeyClassRepresentative(InputKeyClass keyClass);
+
+enum InputTraceRecordKind {
+    INPUT_TRACE_EVENT = 0,
+    INPUT_TRACE_LOCK = 1,
+    INPUT_TRACE_UNLOCK = 2
+};
+
+struct InputTraceRecord {
+    uint8_t kind;        // InputTraceRecordKind
+    InputEvent event;    // Valid for INPUT_TRACE_EVENT; time is set for every kind
+};
+
+// Records scrubbed events into a preallocated buffer. Record() is the only
+// call made from the hook thread: it copies the event into a lock-free ring
+// and returns. Everything else, including Drain() which encodes the ring into
+// the buffer, runs on one other thread (the UI thread). Recording stops by
+// itself (IsTruncated) once the buffer is full; events the ring has no room
+// for between drains are counted (GetDroppedCount).
+class InputTraceRecorder {
+public:
+    static const size_t DEFAULT_CAPACITY = 4 * 1024 * 1024;
+    static const size_t PENDING_CAPACITY = 4096; // Events between drains (4 s of a 1 kHz mouse)
+
+private:
+    std::atomic<bool> recording;
+    SpscRing<InputEvent, PENDING_CAPACITY> pending;
+    std::atomic<uint32_t> droppedCount;
+    std::vector<uint8_t> buffer;
+    size_t capacity;
+    uint32_t recordCount;
+    uint32_t startTime;
+    uint32_t lastTime;
+    int32_t lastX;
+    int32_t lastY;
+    bool truncated;
+
+    void Append(uint8_t tag, uint32_t time, const uint8_t* payload, size_t payloadSize);
+    void Encode(const InputEvent& event);
+
+public:
+    InputTraceRecorder();
+
+    // Discards any previous trace
+    void Start(size_t maxBytes = DEFAULT_CAPACITY);
+    void Stop(); // Drains what the hook already recorded
+    void Clear(); // Stops and releases the buffer
+    bool IsRecording() const { return recording.load(std::memory_order_acquire); }
+
+    // Hook thread: wait-free, never allocates or blocks
+    void Record(const InputEvent& event) {
+        if (!recording.load(std::memory_order_relaxed)) return;
+        if (!pending.Push(event)) droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Encodes the events recorded since the last drain; call it regularly while
+    // recording. RecordLockState drains first so records stay in order.
+    void Drain();
+    void RecordLockState(bool locked, uint32_t time);
+
+    uint32_t GetRecordCount() const { return recordCount; }
+    uint32_t GetDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+    bool IsTruncated() const { return truncated; }
+
+    // Header plus records, ready to write out or replay
+    void CopyTrace(std::vector<uint8_t>& out) const;
+    bool Save(const char* path) const;
+};
+
+// Sequential decoder over a complete trace held in memory
+class InputTraceReader {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t position;
+    uint32_t recordCount;
+    uint32_t recordsRead;
+    uint32_t time;
+    int32_t x;
+    int32_t y;
+
+public:
+    InputTraceReader();
+
+    // Validates the header; the data must stay alive while reading
+    bool Open(const uint8_t* data, size_t size);
+    uint32_t GetRecordCount() const { return recordCount; }
+
+    // False at the end of the trace or on a malformed record
+    bool Next(InputTraceRecord& record);
+};
+
+bool LoadInputTrace(const char* path, std::vector<uint8_t>& out);
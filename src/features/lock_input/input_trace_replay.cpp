@@ -0,0 +1,149 @@
+// src/features/lock_input/input_trace_replay.cpp
+// Input trace replay implementation
+
+#include "input_trace_replay.h"
+#include "input_trace.h"
+#include "lock_pipeline.h"
+#include "password_matcher.h"
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+void BuildDefaultReplayConfig(LockEngineConfig& config) {
+    KeyPolicy& policy = config.keyPolicy;
+    policy.Reset();
+
+    KeySet& passDown = policy.PassSet(KEY_POLICY_DOWN);
+    KeySet& passUp = policy.PassSet(KEY_POLICY_UP);
+    passDown.Add(0x1B);             // Esc
+    passDown.AddRange(0x70, 0x7B);  // F1-F12
+    passUp.Merge(passDown);
+    passUp.AddRange(0x10, 0x12);    // Modifier releases
+    passUp.AddRange(0xA0, 0xA5);
+    passUp.Add(0x5B);
+    passUp.Add(0x5C);
+
+    KeySet& queueDown = policy.QueueSet(KEY_POLICY_DOWN);
+    queueDown.Fill();
+    queueDown.Subtract(passDown);
+
+    KeySet& password = policy.PasswordSet(KEY_POLICY_DOWN);
+    password.AddRange('0', '9');
+    password.AddRange('A', 'Z');
+
+    config.mouseBlockMask = 0;
+    config.failsafeEnabled = true;
+    config.unlockChords[0].modifiers = LOCK_MOD_CONTROL;
+    config.unlockChords[0].vkCode = 'O';
+    config.unlockChords[1].modifiers = LOCK_MOD_CONTROL | LOCK_MOD_SHIFT;
+    config.unlockChords[1].vkCode = 'I';
+}
+
+struct ReplayConsumer {
+    bool wakePending;
+    uint64_t failsafeTriggers;
+};
+
+static void OnReplayWake(void* context) {
+    ((ReplayConsumer*)context)->wakePending = true;
+}
+
+static void OnReplayFailsafe(void* context) {
+    ((ReplayConsumer*)context)->failsafeTriggers++;
+}
+
+bool ReplayInputTrace(const uint8_t* trace, size_t size, const TraceReplayOptions& options, TraceReplayStats& stats) {
+    memset(&stats, 0, sizeof(stats));
+
+    // Decode up front so the timed loop only measures the pipeline
+    std::vector<InputTraceRecord> records;
+    InputTraceReader reader;
+    if (!reader.Open(trace, size)) return false;
+    records.reserve(reader.GetRecordCount());
+    InputTraceRecord record;
+    while (reader.Next(record)) {
+        records.push_back(record);
+    }
+    if (records.size() != reader.GetRecordCount()) return false;
+
+    ReplayConsumer consumer = { false, 0 };
+    LockPipeline pipeline;
+    LockPipelineCallbacks callbacks = { OnReplayWake, OnReplayFailsafe, nullptr, nullptr, &consumer };
+    pipeline.SetCallbacks(callbacks);
+    pipeline.Configure(options.engine);
+
+    size_t passwordLength = options.password ? strlen(options.password) : 0;
+    PasswordMatcher matcher;
+    matcher.SetCandidateLengths(PasswordMatcher::LengthBit(passwordLength));
+    KeyEventRecord batch[KEY_EVENT_RING_CAPACITY];
+    PasswordCandidate candidates[PasswordMatcher::MAX_PASSWORD_LENGTH];
+
+    LatencyHistogram* latency = options.measureLatency ? new LatencyHistogram() : NULL;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (unsigned pass = 0; pass < options.iterations; pass++) {
+        for (size_t i = 0; i < records.size(); i++) {
+            const InputTraceRecord& current = records[i];
+            if (current.kind != INPUT_TRACE_EVENT) {
+                stats.lockChanges++;
+                bool locked = current.kind == INPUT_TRACE_LOCK;
+                if (locked != pipeline.IsLocked()) {
+                    pipeline.SetLocked(locked);
+                    pipeline.ClearKeyEvents();
+                    matcher.Reset();
+                }
+                continue;
+            }
+
+            InputVerdict verdict;
+            if (latency) {
+                std::chrono::steady_clock::time_point before = std::chrono::steady_clock::now();
+                verdict = pipeline.OnInputEvent(current.event);
+                latency->Record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - before).count());
+            } else {
+                verdict = pipeline.OnInputEvent(current.event);
+            }
+            stats.events++;
+            if (verdict == INPUT_VERDICT_BLOCK) stats.blocked++;
+
+            if (!consumer.wakePending) continue;
+
+            // Consumer side, as ProcessKeyEvents does it
+            consumer.wakePending = false;
+            pipeline.ConsumeWake();
+            if (pipeline.ConsumeOverflow()) {
+                stats.overflows++;
+                matcher.Reset();
+            }
+            size_t count;
+            while ((count = pipeline.PopKeyEvents(batch, KEY_EVENT_RING_CAPACITY)) > 0) {
+                stats.keysQueued += count;
+                for (size_t k = 0; k < count && pipeline.IsLocked(); k++) {
+                    if (batch[k].flags & KEY_EVENT_RESET) {
+                        matcher.Reset();
+                        continue;
+                    }
+                    matcher.Feed((char)batch[k].vkCode);
+                    size_t candidateCount = matcher.GetCandidates(candidates, PasswordMatcher::MAX_PASSWORD_LENGTH);
+                    for (size_t c = 0; c < candidateCount; c++) {
+                        if (memcmp(candidates[c].data, options.password, candidates[c].length) == 0) {
+                            stats.unlocks++;
+                            pipeline.SetLocked(false);
+                            matcher.Reset();
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.failsafeTriggers = consumer.failsafeTriggers;
+    if (latency) {
+        stats.eventLatency = latency->GetSummary();
+        delete latency;
+    }
+    return true;
+}
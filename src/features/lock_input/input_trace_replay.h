@@ -0,0 +1,36 @@
+// src/features/lock_input/input_trace_replay.h
+// Replays a recorded input trace through the lock pipeline at full speed (portable)
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "lock_engine.h"
+#include "../../utils/latency_histogram.h"
+
+struct TraceReplayOptions {
+    LockEngineConfig engine;
+    const char* password;   // Typed-password check on the consumer side (scrubbed keys replay as 'A' / '0')
+    unsigned iterations;    // Passes over the trace
+    bool measureLatency;    // Time every event (adds two clock reads per event)
+};
+
+struct TraceReplayStats {
+    uint64_t events;
+    uint64_t blocked;
+    uint64_t keysQueued;        // Records the consumer drained from the key ring
+    uint64_t overflows;
+    uint64_t lockChanges;       // Lock/unlock records in the trace
+    uint64_t unlocks;           // Password matches (unlock chords are swallowed while locked)
+    uint64_t failsafeTriggers;
+    double seconds;
+    LatencySummary eventLatency; // Nanoseconds per event in the pipeline (measureLatency only)
+};
+
+// What the app builds for the default settings: keyboard locked, password
+// unlock, Esc and F1-F12 whitelisted, failsafe on, Ctrl+O and Ctrl+Shift+I chords
+void BuildDefaultReplayConfig(LockEngineConfig& config);
+
+// Runs every record through LockPipeline (LockEngine, key ring) and
+// drains queued keys into PasswordMatcher whenever the pipeline wakes the
+// consumer, exactly as the UI thread does. Returns false if the trace is malformed.
+bool ReplayInputTrace(const uint8_t* trace, size_t size, const TraceReplayOptions& options, TraceReplayStats& stats);
@@ -0,0 +1,25 @@
+// src/features/lock_input/key_event_ring.h
+// Compact keystroke records passed from the keyboard hook to the UI thread
+
+#pragma once
+#include <cstdint>
+#include "../../utils/spsc_ring.h"
+
+// Record flags
+enum KeyEventFlags {
+    KEY_EVENT_DOWN  = 0x0001, // Key press that should be appended to the unlock buffer
+    KEY_EVENT_RESET = 0x0002  // Non-password key - clears the unlock buffer
+};
+
+// 8-byte record written by the hook for every key it forwards
+struct KeyEventRecord {
+    uint8_t vkCode;
+    uint8_t flags;      // KeyEventFlags
+    uint16_t character; // UTF-16 unit the key types in the active layout (0 = none or no table)
+    uint32_t time;      // KBDLLHOOKSTRUCT::time (milliseconds)
+};
+
+// 64 records is several seconds of very fast typing; the UI drains in batches
+const size_t KEY_EVENT_RING_CAPACITY = 64;
+
+typedef SpscRing<KeyEventRecord, KEY_EVENT_RING_CAPACITY> KeyEventRing;
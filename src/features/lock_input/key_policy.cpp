@@ -0,0 +1,151 @@
+// src/features/lock_input/key_policy.cpp
+// Key policy compilation from settings
+
+#include "key_policy.h"
+#include <cctype>
+
+const char DEFAULT_WHITELISTED_KEYS[] = "Esc,F1-F12";
+
+// Virtual-key codes (winuser.h values; this module builds without Windows headers)
+static const uint8_t VK_CODE_F1 = 0x70;
+static const uint8_t VK_CODE_SHIFT = 0x10;  // VK_SHIFT, VK_CONTROL, VK_MENU follow
+static const uint8_t VK_CODE_MENU = 0x12;
+static const uint8_t VK_CODE_CAPITAL = 0x14;
+static const uint8_t VK_CODE_LWIN = 0x5B;
+static const uint8_t VK_CODE_RWIN = 0x5C;
+static const uint8_t VK_CODE_NUMPAD0 = 0x60;
+static const uint8_t VK_CODE_NUMPAD9 = 0x69;
+static const uint8_t VK_CODE_LSHIFT = 0xA0; // Through VK_RMENU
+static const uint8_t VK_CODE_RMENU = 0xA5;
+
+// Resolves an upper-case key name to its virtual-key code: the same names
+// ParseHotkeyString accepts for the key after the modifiers
+static bool ParseKeyName(const std::string& name, unsigned& virtualKey) {
+    if (name.length() == 1 && (isupper((unsigned char)name[0]) || isdigit((unsigned char)name[0]))) {
+        virtualKey = (unsigned char)name[0];
+        return true;
+    }
+    if (name.length() >= 2 && name.length() <= 3 && name[0] == 'F' &&
+        isdigit((unsigned char)name[1]) && (name.length() == 2 || isdigit((unsigned char)name[2]))) {
+        int number = name.length() == 2 ? name[1] - '0' : (name[1] - '0') * 10 + (name[2] - '0');
+        if (number >= 1 && number <= 12) {
+            virtualKey = VK_CODE_F1 + number - 1;
+            return true;
+        }
+        return false;
+    }
+
+    static const struct {
+        const char* name;
+        uint8_t vk;
+    } namedKeys[] = {
+        {"ESC", 0x1B}, {"ESCAPE", 0x1B},
+        {"SPACE", 0x20}, {"ENTER", 0x0D}, {"RETURN", 0x0D},
+        {"TAB", 0x09}, {"BACKSPACE", 0x08}, {"DELETE", 0x2E},
+        {"DEL", 0x2E}, {"INSERT", 0x2D}, {"INS", 0x2D},
+        {"HOME", 0x24}, {"END", 0x23},
+        {"PAGEUP", 0x21}, {"PAGEDOWN", 0x22},
+        {"PGUP", 0x21}, {"PGDN", 0x22}
+    };
+    for (size_t i = 0; i < sizeof(namedKeys) / sizeof(namedKeys[0]); i++) {
+        if (name == namedKeys[i].name) {
+            virtualKey = namedKeys[i].vk;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ParseKeyList(const std::string& keyList, KeySet& keys) {
+    size_t parsed = 0;
+    size_t start = 0;
+
+    while (start <= keyList.length()) {
+        size_t end = keyList.find(',', start);
+        if (end == std::string::npos) end = keyList.length();
+
+        // Trim and normalise to the upper-case names the hotkey parser expects
+        std::string token;
+        for (size_t i = start; i < end; i++) {
+            if (!isspace((unsigned char)keyList[i])) {
+                token += (char)toupper((unsigned char)keyList[i]);
+            }
+        }
+        start = end + 1;
+        if (token.empty()) continue;
+
+        unsigned first = 0, last = 0;
+        size_t dash = token.find('-', 1);
+        if (dash != std::string::npos) {
+            if (ParseKeyName(token.substr(0, dash), first) &&
+                ParseKeyName(token.substr(dash + 1), last) && first <= last) {
+                keys.AddRange((uint8_t)first, (uint8_t)last);
+                parsed++;
+            }
+        } else if (ParseKeyName(token, first)) {
+            keys.Add((uint8_t)first);
+            parsed++;
+        }
+    }
+    return parsed;
+}
+
+void CompileKeyPolicy(const KeyPolicySettings& settings, bool typedPassword, KeyPolicy& policy) {
+    policy.Reset();
+
+    // Keyboard lock disabled: the keyboard is never blocked
+    if (!settings.keyboardLockEnabled) {
+        policy.PassSet(KEY_POLICY_DOWN).Fill();
+        policy.PassSet(KEY_POLICY_UP).Fill();
+        return;
+    }
+
+    // Modifier releases always pass so Ctrl/Shift/Alt/Win cannot stay stuck down
+    KeySet& passUp = policy.PassSet(KEY_POLICY_UP);
+    passUp.AddRange(VK_CODE_SHIFT, VK_CODE_MENU);
+    passUp.AddRange(VK_CODE_LSHIFT, VK_CODE_RMENU);
+    passUp.Add(VK_CODE_LWIN);
+    passUp.Add(VK_CODE_RWIN);
+
+    // Whitelisted keys pass in both directions
+    if (settings.whitelistEnabled) {
+        KeySet whitelist;
+        whitelist.Clear();
+        if (ParseKeyList(settings.whitelistedKeys, whitelist) == 0) {
+            ParseKeyList(DEFAULT_WHITELISTED_KEYS, whitelist);
+        }
+        policy.PassSet(KEY_POLICY_DOWN).Merge(whitelist);
+        passUp.Merge(whitelist);
+    }
+
+    // Password and one-time code unlock: every blocked key press goes to the
+    // matcher - password characters (or code digits) as input, anything else
+    // to reset the typed sequence
+    if (settings.unlockMethod == 0 || settings.unlockMethod == 2) {
+        KeySet& queueDown = policy.QueueSet(KEY_POLICY_DOWN);
+        queueDown.Fill();
+        queueDown.Subtract(policy.PassSet(KEY_POLICY_DOWN));
+
+        KeySet& passwordDown = policy.PasswordSet(KEY_POLICY_DOWN);
+        if (settings.unlockMethod == 2) {
+            passwordDown.AddRange('0', '9');
+            passwordDown.AddRange(VK_CODE_NUMPAD0, VK_CODE_NUMPAD9);
+        } else if (typedPassword) {
+            // Characters come from the layout table, so modifiers and Caps Lock
+            // only change what the next key types - they are neither input nor a reset
+            KeySet modifiers;
+            modifiers.Clear();
+            modifiers.AddRange(VK_CODE_SHIFT, VK_CODE_MENU);
+            modifiers.AddRange(VK_CODE_LSHIFT, VK_CODE_RMENU);
+            modifiers.Add(VK_CODE_LWIN);
+            modifiers.Add(VK_CODE_RWIN);
+            modifiers.Add(VK_CODE_CAPITAL);
+            queueDown.Subtract(modifiers);
+            passwordDown.Merge(queueDown);
+        } else {
+            passwordDown.AddRange('0', '9');
+            passwordDown.AddRange('A', 'Z');
+        }
+        passwordDown.Subtract(policy.PassSet(KEY_POLICY_DOWN));
+    }
+}
@@ -0,0 +1,98 @@
+// src/features/lock_input/key_policy.h
+// Compiled per-key lock policy - one table lookup per keyboard hook event
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Event types the policy distinguishes (index into the per-event bitmaps)
+enum KeyPolicyEvent {
+    KEY_POLICY_DOWN = 0,
+    KEY_POLICY_UP = 1,
+    KEY_POLICY_EVENT_COUNT = 2
+};
+
+// Decision bits returned by KeyPolicy::Lookup
+enum KeyPolicyAction {
+    KEY_ACTION_BLOCK    = 0x0,
+    KEY_ACTION_PASS     = 0x1, // Let the event through to the system
+    KEY_ACTION_QUEUE    = 0x2, // Forward to the unlock matcher (event is still blocked)
+    KEY_ACTION_PASSWORD = 0x4  // Queued key is a password character (otherwise it resets the input)
+};
+
+// 256-bit virtual-key set
+struct KeySet {
+    uint64_t words[4];
+
+    void Clear() { words[0] = words[1] = words[2] = words[3] = 0; }
+    void Add(uint8_t vk) { words[vk >> 6] |= 1ULL << (vk & 63); }
+    void AddRange(uint8_t first, uint8_t last) {
+        for (unsigned vk = first; vk <= last; vk++) Add((uint8_t)vk);
+    }
+    void Fill() { words[0] = words[1] = words[2] = words[3] = ~0ULL; }
+    void Subtract(const KeySet& other) {
+        for (int i = 0; i < 4; i++) words[i] &= ~other.words[i];
+    }
+    void Merge(const KeySet& other) {
+        for (int i = 0; i < 4; i++) words[i] |= other.words[i];
+    }
+    uint32_t Bit(uint8_t vk) const { return (uint32_t)(words[vk >> 6] >> (vk & 63)) & 1u; }
+    bool Contains(uint8_t vk) const { return Bit(vk) != 0; }
+};
+
+// Lock-time decision table for every (event type, virtual key) pair. Built on
+// the UI thread whenever settings change; the hook only calls Lookup().
+class KeyPolicy {
+private:
+    KeySet pass[KEY_POLICY_EVENT_COUNT];
+    KeySet queue[KEY_POLICY_EVENT_COUNT];
+    KeySet password[KEY_POLICY_EVENT_COUNT];
+
+public:
+    KeyPolicy() { Reset(); }
+
+    // Block everything
+    void Reset() {
+        for (int event = 0; event < KEY_POLICY_EVENT_COUNT; event++) {
+            pass[event].Clear();
+            queue[event].Clear();
+            password[event].Clear();
+        }
+    }
+
+    KeySet& PassSet(KeyPolicyEvent event) { return pass[event]; }
+    KeySet& QueueSet(KeyPolicyEvent event) { return queue[event]; }
+    KeySet& PasswordSet(KeyPolicyEvent event) { return password[event]; }
+
+    // Branch-free: combination of KeyPolicyAction bits
+    uint32_t Lookup(KeyPolicyEvent event, uint32_t vkCode) const {
+        uint8_t vk = (uint8_t)vkCode;
+        return pass[event].Bit(vk) |
+               (queue[event].Bit(vk) << 1) |
+               (password[event].Bit(vk) << 2);
+    }
+};
+
+// Default whitelist (also the settings default), used as well when the
+// configured list is empty or has no valid keys
+extern const char DEFAULT_WHITELISTED_KEYS[];
+
+// The lock settings the policy depends on (a copy of the AppSettings fields)
+struct KeyPolicySettings {
+    bool keyboardLockEnabled;
+    bool whitelistEnabled;
+    std::string whitelistedKeys;
+    int unlockMethod; // 0=password, 1=timer, 2=one-time code
+};
+
+// Parses a comma-separated key list such as "Esc, F1-F12, Space". Names are
+// the single keys of the hotkey syntax; "First-Last" adds a virtual-key range.
+// Returns the number of entries that were recognised.
+size_t ParseKeyList(const std::string& keyList, KeySet& keys);
+
+// Builds the lock policy from the keyboard lock, whitelist and unlock method
+// settings. A typed password (PASSWORD_ENCODING_TEXT) takes every key that
+// can make a character; otherwise only digits and letters are password keys,
+// and only digits (main row and keypad) for one-time codes.
+void CompileKeyPolicy(const KeyPolicySettings& settings, bool typedPassword, KeyPolicy& policy);
@@ -0,0 +1,86 @@
+// src/features/lock_input/key_translation.cpp
+// Layout table building and caching
+
+#include "key_translation.h"
+#include <cstring>
+
+KeyTranslationTable::KeyTranslationTable() : layout(0), capsLock(0), generation(0) {
+    memset(chars, 0, sizeof(chars));
+}
+
+// Keys that never type: mouse buttons, Shift/Ctrl/Alt (both sides), Win, Caps Lock
+static bool IsCharacterCandidate(unsigned vk) {
+    switch (vk) {
+        case 0x00: case 0x01: case 0x02: case 0x04: case 0x05: case 0x06:
+        case 0x10: case 0x11: case 0x12: case 0x14: case 0x5B: case 0x5C:
+            return false;
+        default:
+            return !(vk >= 0xA0 && vk <= 0xA5);
+    }
+}
+
+void BuildKeyTranslationTable(KeyCharLookup lookup, void* context, uint64_t layout, KeyTranslationTable& table) {
+    memset(table.chars, 0, sizeof(table.chars));
+    table.layout = layout;
+
+    for (unsigned plane = 0; plane < KEY_PLANE_COUNT; plane++) {
+        for (unsigned vk = 0; vk < 256; vk++) {
+            if (!IsCharacterCandidate(vk)) continue;
+
+            uint16_t buffer[4];
+            int count = lookup(context, (uint8_t)vk, (uint8_t)plane, buffer, 4);
+            if (count != 1) continue; // Dead key, nothing, or several units
+
+            uint16_t unit = buffer[0];
+            bool control = unit < 0x20 || unit == 0x7F;
+            bool surrogate = unit >= 0xD800 && unit <= 0xDFFF;
+            if (!control && !surrogate) table.chars[plane][vk] = unit;
+        }
+    }
+}
+
+KeyTranslationCache::KeyTranslationCache() : useClock(0), buildCount(0) {}
+
+const KeyTranslationTable& KeyTranslationCache::Get(uint64_t layout, KeyCharLookup lookup, void* context) {
+    useClock++;
+    size_t oldest = 0;
+    for (size_t i = 0; i < tables.size(); i++) {
+        if (tables[i].layout == layout) {
+            lastUse[i] = useClock;
+            return tables[i];
+        }
+        if (lastUse[i] < lastUse[oldest]) oldest = i;
+    }
+
+    size_t slot = oldest;
+    if (tables.size() < MAX_LAYOUTS) {
+        slot = tables.size();
+        tables.push_back(KeyTranslationTable());
+        lastUse.push_back(0);
+    }
+    BuildKeyTranslationTable(lookup, context, layout, tables[slot]);
+    lastUse[slot] = useClock;
+    buildCount++;
+    return tables[slot];
+}
+
+void KeyTranslationCache::Clear() {
+    tables.clear();
+    lastUse.clear();
+}
+
+size_t EncodeKeyCharUtf8(uint16_t character, char* out) {
+    if (character < 0x80) {
+        out[0] = (char)character;
+        return 1;
+    }
+    if (character < 0x800) {
+        out[0] = (char)(0xC0 | (character >> 6));
+        out[1] = (char)(0x80 | (character & 0x3F));
+        return 2;
+    }
+    out[0] = (char)(0xE0 | (character >> 12));
+    out[1] = (char)(0x80 | ((character >> 6) & 0x3F));
+    out[2] = (char)(0x80 | (character & 0x3F));
+    return 3;
+}
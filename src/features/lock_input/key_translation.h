@@ -0,0 +1,80 @@
+// src/features/lock_input/key_translation.h
+// Per-keyboard-layout virtual-key to character tables for password entry (portable)
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Plane bits: which modifier state a row of the table was built for
+enum KeyTranslationPlane {
+    KEY_PLANE_SHIFT = 0x1,
+    KEY_PLANE_ALTGR = 0x2, // Ctrl+Alt, which Windows treats as AltGr
+    KEY_PLANE_CAPS = 0x4,  // Caps Lock on
+    KEY_PLANE_COUNT = 8,
+    KEY_PLANE_NONE = 8     // Shortcut state (Ctrl or Alt alone, Win): an all-zero row
+};
+
+// Plane for a set of held LockModifier bits (same values as MOD_*)
+inline uint8_t KeyTranslationPlaneFor(uint8_t modifiers, bool capsLock) {
+    // Indexed by Alt | Ctrl << 1 | Shift << 2; Win always makes a shortcut
+    static const uint8_t PLANES[8] = {
+        0, KEY_PLANE_NONE, KEY_PLANE_NONE, KEY_PLANE_ALTGR,
+        KEY_PLANE_SHIFT, KEY_PLANE_NONE, KEY_PLANE_NONE, KEY_PLANE_SHIFT | KEY_PLANE_ALTGR
+    };
+    uint8_t plane = (modifiers & 0x8) ? (uint8_t)KEY_PLANE_NONE : PLANES[modifiers & 0x7];
+    return (capsLock && plane != KEY_PLANE_NONE) ? (uint8_t)(plane | KEY_PLANE_CAPS) : plane;
+}
+
+// What one layout produces for every key in every plane: a UTF-16 code unit,
+// or 0 for keys that make no single character (dead keys, control keys,
+// surrogate pairs, ligatures). Built on the UI thread, published to the hook,
+// which translates a password key with KeyTranslationPlaneFor() plus one load.
+struct KeyTranslationTable {
+    uint16_t chars[KEY_PLANE_COUNT + 1][256]; // Last row stays zero (KEY_PLANE_NONE)
+    uint64_t layout;     // Layout handle the table was built for (0 = empty table)
+    uint8_t capsLock;    // Caps Lock state to translate with; set by the publisher's caller
+    uint32_t generation; // Set by the publisher
+
+    KeyTranslationTable();
+
+    uint16_t Translate(uint8_t modifiers, uint8_t vkCode) const {
+        return chars[KeyTranslationPlaneFor(modifiers, capsLock != 0)][vkCode];
+    }
+};
+
+// Per-key lookup the table is built from (ToUnicodeEx on Windows, fixtures
+// elsewhere). Same contract as ToUnicodeEx: returns the number of UTF-16
+// units written to out, 0 if the key makes none, negative for a dead key.
+typedef int (*KeyCharLookup)(void* context, uint8_t vkCode, uint8_t plane, uint16_t* out, int capacity);
+
+// Queries every character key in every plane. Mouse buttons and modifier
+// keys are never looked up.
+void BuildKeyTranslationTable(KeyCharLookup lookup, void* context, uint64_t layout, KeyTranslationTable& table);
+
+// The last few layouts' tables, so switching between windows with different
+// layouts does not rebuild (about 2000 lookups each)
+class KeyTranslationCache {
+public:
+    static const size_t MAX_LAYOUTS = 4;
+
+private:
+    std::vector<KeyTranslationTable> tables;
+    std::vector<uint32_t> lastUse;
+    uint32_t useClock;
+    size_t buildCount;
+
+public:
+    KeyTranslationCache();
+
+    // The table for layout, built with lookup on a miss (replacing the least
+    // recently used). Valid until the next Get() or Clear().
+    const KeyTranslationTable& Get(uint64_t layout, KeyCharLookup lookup, void* context);
+    void Clear();
+
+    size_t GetBuildCount() const { return buildCount; }
+};
+
+// UTF-8 bytes of one translated character (the encoding passwords are hashed in);
+// returns the byte count, 1 to 3
+size_t EncodeKeyCharUtf8(uint16_t character, char* out);
@@ -0,0 +1,139 @@
+// src/features/lock_input/lock_engine.cpp
+// Lock state machine implementation
+
+#include "lock_engine.h"
+#include "key_event_ring.h"
+
+static const uint16_t ESCAPE_KEY = 0x1B; // VK_ESCAPE
+
+// Left and right modifier keys are tracked separately (bit per key) and
+// folded into LockModifier bits when a chord is checked
+enum HeldKeyBit {
+    HELD_SHIFT_LEFT = 0x01, HELD_SHIFT_RIGHT = 0x02,
+    HELD_CONTROL_LEFT = 0x04, HELD_CONTROL_RIGHT = 0x08,
+    HELD_ALT_LEFT = 0x10, HELD_ALT_RIGHT = 0x20,
+    HELD_WIN_LEFT = 0x40, HELD_WIN_RIGHT = 0x80
+};
+
+static uint8_t HeldKeyBitFor(uint16_t vkCode) {
+    switch (vkCode) {
+        case 0x10: case 0xA0: return HELD_SHIFT_LEFT;    // VK_SHIFT reports as left
+        case 0xA1:            return HELD_SHIFT_RIGHT;
+        case 0x11: case 0xA2: return HELD_CONTROL_LEFT;
+        case 0xA3:            return HELD_CONTROL_RIGHT;
+        case 0x12: case 0xA4: return HELD_ALT_LEFT;
+        case 0xA5:            return HELD_ALT_RIGHT;
+        case 0x5B:            return HELD_WIN_LEFT;
+        case 0x5C:            return HELD_WIN_RIGHT;
+        default:              return 0;
+    }
+}
+
+static uint8_t FoldModifiers(uint8_t held) {
+    uint8_t modifiers = 0;
+    if (held & (HELD_SHIFT_LEFT | HELD_SHIFT_RIGHT)) modifiers |= LOCK_MOD_SHIFT;
+    if (held & (HELD_CONTROL_LEFT | HELD_CONTROL_RIGHT)) modifiers |= LOCK_MOD_CONTROL;
+    if (held & (HELD_ALT_LEFT | HELD_ALT_RIGHT)) modifiers |= LOCK_MOD_ALT;
+    if (held & (HELD_WIN_LEFT | HELD_WIN_RIGHT)) modifiers |= LOCK_MOD_WIN;
+    return modifiers;
+}
+
+static_assert((int)HOOK_KEY_PASS == (int)LOCK_EVENT_KEY_PASS && (int)HOOK_KEY_PASSWORD == (int)LOCK_EVENT_KEY_PASSWORD &&
+              (int)HOOK_KEY_RESET == (int)LOCK_EVENT_KEY_RESET && (int)HOOK_KEY_BLOCK == (int)LOCK_EVENT_KEY_BLOCK,
+              "HookKeyClass must map directly onto LockEventClass");
+
+// What an event becomes when its device is outside the lock's scope
+static const uint8_t OUT_OF_SCOPE_CLASS[LOCK_EVENT_CLASS_COUNT] = {
+    LOCK_EVENT_KEY_PASS, LOCK_EVENT_KEY_PASS, LOCK_EVENT_KEY_PASS, LOCK_EVENT_KEY_PASS,
+    LOCK_EVENT_MOUSE_FREE, LOCK_EVENT_MOUSE_FREE,
+    LOCK_EVENT_FAILSAFE, LOCK_EVENT_UNLOCK_CHORD
+};
+
+LockEngine::LockEngine() : policy(DefaultHookPolicy()), heldModifiers(0), state(LOCK_STATE_UNLOCKED), scope(LOCK_SCOPE_ALL) {
+    BuildTables();
+}
+
+void LockEngine::BuildTables() {
+    // Unlocked: everything passes; the unlock chord is left to RegisterHotKey
+    for (int eventClass = 0; eventClass < LOCK_EVENT_CLASS_COUNT; eventClass++) {
+        transitions[LOCK_STATE_UNLOCKED][eventClass] = MakeEntry(LOCK_DECISION_PASS, 0);
+    }
+    transitions[LOCK_STATE_UNLOCKED][LOCK_EVENT_FAILSAFE] = MakeEntry(LOCK_DECISION_REQUEST_EXIT, 0);
+
+    // Locked: the policy decides, password keys are queued for the matcher
+    uint8_t (&locked)[LOCK_EVENT_CLASS_COUNT] = transitions[LOCK_STATE_LOCKED];
+    locked[LOCK_EVENT_KEY_PASS] = MakeEntry(LOCK_DECISION_PASS, 0);
+    locked[LOCK_EVENT_KEY_PASSWORD] = MakeEntry(LOCK_DECISION_BLOCK, KEY_EVENT_DOWN);
+    locked[LOCK_EVENT_KEY_RESET] = MakeEntry(LOCK_DECISION_BLOCK, KEY_EVENT_RESET);
+    locked[LOCK_EVENT_KEY_BLOCK] = MakeEntry(LOCK_DECISION_BLOCK, 0);
+    locked[LOCK_EVENT_MOUSE_LOCKED] = MakeEntry(LOCK_DECISION_BLOCK, 0);
+    locked[LOCK_EVENT_MOUSE_FREE] = MakeEntry(LOCK_DECISION_PASS, 0);
+    locked[LOCK_EVENT_FAILSAFE] = MakeEntry(LOCK_DECISION_REQUEST_EXIT, 0);
+    // Swallowed, as the hook always did: a hotkey that unlocked here would skip
+    // the password, PINs, recovery codes and one-time codes alike
+    locked[LOCK_EVENT_UNLOCK_CHORD] = MakeEntry(LOCK_DECISION_BLOCK, 0);
+}
+
+void LockEngine::Configure(const LockEngineConfig& config) {
+    HookPolicy compiled;
+    CompileHookPolicy(config, compiled);
+    policy.Publish(compiled);
+}
+
+uint8_t LockEngine::GetHeldModifiers() const {
+    return FoldModifiers(heldModifiers);
+}
+
+LockEventClass LockEngine::ClassifyKey(const HookPolicy& current, const InputEvent& event) {
+    bool down = event.type == INPUT_EVENT_KEY_DOWN;
+
+    uint8_t heldBit = HeldKeyBitFor(event.code);
+    if (heldBit) {
+        heldModifiers = down ? (uint8_t)(heldModifiers | heldBit) : (uint8_t)(heldModifiers & ~heldBit);
+    }
+
+    if (down) {
+        // Failsafe mechanism: ESC x3 within the window, in any state
+        if (event.code == ESCAPE_KEY && (current.flags & HOOK_POLICY_FAILSAFE) && !(event.flags & INPUT_FLAG_SYSTEM_KEY) &&
+            failsafe.recordEscPress(event.time)) {
+            return LOCK_EVENT_FAILSAFE;
+        }
+
+        uint8_t modifiers = FoldModifiers(heldModifiers);
+        for (int i = 0; i < LockEngineConfig::MAX_UNLOCK_CHORDS; i++) {
+            const UnlockChord& chord = current.unlockChords[i];
+            if (chord.vkCode != 0 && chord.vkCode == event.code && chord.modifiers == modifiers) {
+                return LOCK_EVENT_UNLOCK_CHORD;
+            }
+        }
+
+        return (LockEventClass)current.DownClass((uint8_t)event.code);
+    }
+    return current.UpPasses((uint8_t)event.code) ? LOCK_EVENT_KEY_PASS : LOCK_EVENT_KEY_BLOCK;
+}
+
+LockResult LockEngine::Process(const InputEvent& event) {
+    uint8_t currentState = state.load(std::memory_order_acquire);
+
+    const HookPolicy* current = policy.BeginRead();
+    LockEventClass eventClass;
+    uint8_t deviceScope;
+    if (event.device == INPUT_DEVICE_MOUSE) {
+        eventClass = current->BlocksMouse(event.type) ? LOCK_EVENT_MOUSE_LOCKED : LOCK_EVENT_MOUSE_FREE;
+        deviceScope = LOCK_SCOPE_MOUSE;
+    } else {
+        eventClass = ClassifyKey(*current, event);
+        deviceScope = LOCK_SCOPE_KEYBOARD;
+    }
+    policy.EndRead();
+
+    if (!(scope.load(std::memory_order_relaxed) & deviceScope)) {
+        eventClass = (LockEventClass)OUT_OF_SCOPE_CLASS[eventClass];
+    }
+
+    uint8_t entry = transitions[currentState][eventClass];
+    LockResult result;
+    result.decision = entry & 0x3;
+    result.queueFlags = (entry >> 2) & 0x3;
+    return result;
+}
@@ -0,0 +1,97 @@
+// src/features/lock_input/lock_engine.h
+// Table-driven lock state machine: normalized event in, decision out (portable, no Win32 dependencies)
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "input_backend.h"
+#include "hook_policy.h"
+#include "../../failsafe.h"
+
+enum LockState {
+    LOCK_STATE_UNLOCKED = 0,
+    LOCK_STATE_LOCKED = 1,
+    LOCK_STATE_COUNT = 2
+};
+
+// What the engine makes of one event before the state is considered
+enum LockEventClass {
+    LOCK_EVENT_KEY_PASS = 0,      // Policy lets the key through (whitelist, modifier release)
+    LOCK_EVENT_KEY_PASSWORD = 1,  // Password character for the matcher
+    LOCK_EVENT_KEY_RESET = 2,     // Other queued key - clears the typed input
+    LOCK_EVENT_KEY_BLOCK = 3,     // Blocked without being queued
+    LOCK_EVENT_MOUSE_LOCKED = 4,  // Mouse event the mouse lock mode blocks
+    LOCK_EVENT_MOUSE_FREE = 5,    // Mouse event it lets through (or mouse lock disabled)
+    LOCK_EVENT_FAILSAFE = 6,      // ESC press that completed ESC x3
+    LOCK_EVENT_UNLOCK_CHORD = 7,  // Lock / unlock hotkey pressed: blocked unqueued, never unlocks by itself
+    LOCK_EVENT_CLASS_COUNT = 8
+};
+
+// Devices a lock applies to (see AppLockRules); outside its scope a locked
+// engine lets input through, but the failsafe still works and the hotkeys are
+// still swallowed
+enum LockScope {
+    LOCK_SCOPE_NONE = 0,
+    LOCK_SCOPE_KEYBOARD = 1,
+    LOCK_SCOPE_MOUSE = 2,
+    LOCK_SCOPE_ALL = 3
+};
+
+enum LockDecision {
+    LOCK_DECISION_PASS = 0,
+    LOCK_DECISION_BLOCK = 1,
+    LOCK_DECISION_REQUEST_EXIT = 2    // Failsafe; the owner should close the app
+};
+
+// Result of one event: decision plus what, if anything, to queue for the matcher
+struct LockResult {
+    uint8_t decision;   // LockDecision
+    uint8_t queueFlags; // KEY_EVENT_DOWN / KEY_EVENT_RESET, 0 = nothing to queue
+};
+
+// Every event is reduced to a LockEventClass (one HookPolicy lookup plus the
+// failsafe and chord checks), then one entry of the [state][class] table
+// gives the decision and the queue flags. Only the owner changes the state:
+// no event unlocks, the unlock chords included. Process() never allocates
+// and makes no system calls.
+//
+// Threading: Process() runs on the thread that delivers input. Configure()
+// and SetLocked() may be called from another thread: settings arrive as an
+// immutable HookPolicy snapshot swapped in atomically, and the state is a
+// single atomic byte.
+class LockEngine {
+private:
+    // Table entry layout: decision in bits 0-1, queue flags in bits 2-3
+    uint8_t transitions[LOCK_STATE_COUNT][LOCK_EVENT_CLASS_COUNT];
+
+    HookPolicyPublisher policy;
+    Failsafe failsafe;
+    uint8_t heldModifiers; // Modifier keys held, left and right apart (tracked from every key event)
+    std::atomic<uint8_t> state;
+    std::atomic<uint8_t> scope; // LockScope, LOCK_SCOPE_ALL unless per-application rules narrow it
+
+    void BuildTables();
+    LockEventClass ClassifyKey(const HookPolicy& current, const InputEvent& event);
+
+public:
+    LockEngine();
+
+    // Delivering thread
+    LockResult Process(const InputEvent& event);
+    uint8_t GetHeldModifiers() const; // LockModifier bits, as of the last key event
+
+    // Any thread
+    void Configure(const LockEngineConfig& config);
+    uint32_t GetPolicyGeneration() { return policy.GetGeneration(); }
+    void SetLocked(bool locked) { state.store(locked ? LOCK_STATE_LOCKED : LOCK_STATE_UNLOCKED, std::memory_order_release); }
+    LockState GetState() const { return (LockState)state.load(std::memory_order_acquire); }
+    bool IsLocked() const { return GetState() == LOCK_STATE_LOCKED; }
+    void SetScope(uint8_t value) { scope.store(value, std::memory_order_relaxed); }
+    uint8_t GetScope() const { return scope.load(std::memory_order_relaxed); }
+
+    // Table access for diagnostics
+    static uint8_t MakeEntry(LockDecision decision, uint8_t queueFlags) {
+        return (uint8_t)(decision | (queueFlags << 2));
+    }
+    uint8_t GetEntry(LockState state, LockEventClass eventClass) const { return transitions[state][eventClass]; }
+};
@@ -7,11 +7,17 @@
 #include "hotkey_manager.h"
 #include "../../resource.h"  // For control IDs
 #include "../../utils/hotkey_utils.h"
+#include "../../input_blocker.h"
+#include "totp_manager.h"
 #include <commctrl.h>
 
 // External references
 extern HotkeyManager g_hotkeyManager;
 
+// Radio button of each unlockMethod value
+static const int UNLOCK_METHOD_RADIOS[] = { IDC_RADIO_PASSWORD, IDC_RADIO_TIMER, IDC_RADIO_TOTP };
+static const int UNLOCK_METHOD_COUNT = sizeof(UNLOCK_METHOD_RADIOS) / sizeof(UNLOCK_METHOD_RADIOS[0]);
+
 // Static callback for Windows dialog system
 INT_PTR CALLBACK LockInputTab::DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lParam) {
     LockInputTab* tab = nullptr;
@@ -112,10 +118,22 @@ void LockInputTab::InitializeControls() {
     // Initialize controls with current settings
     CheckDlgButton(hTabDialog, IDC_CHECK_KEYBOARD, tempSettings->keyboardLockEnabled ? BST_CHECKED : BST_UNCHECKED);
     CheckDlgButton(hTabDialog, IDC_CHECK_MOUSE, tempSettings->mouseLockEnabled ? BST_CHECKED : BST_UNCHECKED);
+    CheckDlgButton(hTabDialog, IDC_CHECK_HOOKS_WHILE_LOCKED, tempSettings->hooksOnlyWhileLocked ? BST_CHECKED : BST_UNCHECKED);
+
+    // Mouse lock modes, in MouseLockMode order
+    static const char* MOUSE_MODE_NAMES[] = { "Block everything", "Block clicks only", "Block wheel only", "Confine cursor" };
+    HWND mouseMode = GetDlgItem(hTabDialog, IDC_COMBO_MOUSE_MODE);
+    SendMessageA(mouseMode, CB_RESETCONTENT, 0, 0);
+    for (int i = 0; i < (int)(sizeof(MOUSE_MODE_NAMES) / sizeof(MOUSE_MODE_NAMES[0])); i++) {
+        SendMessageA(mouseMode, CB_ADDSTRING, 0, (LPARAM)MOUSE_MODE_NAMES[i]);
+    }
+    SendMessageA(mouseMode, CB_SETCURSEL, tempSettings->mouseLockMode, 0);
+    EnableWindow(mouseMode, tempSettings->mouseLockEnabled);
 
-    // Set unlock method radio buttons (only Password and Timer now)
-    CheckRadioButton(hTabDialog, IDC_RADIO_PASSWORD, IDC_RADIO_TIMER,
-                   IDC_RADIO_PASSWORD + tempSettings->unlockMethod);
+    // Set unlock method radio buttons (IDs are not contiguous, so one at a time)
+    for (int i = 0; i < UNLOCK_METHOD_COUNT; i++) {
+        CheckDlgButton(hTabDialog, UNLOCK_METHOD_RADIOS[i], tempSettings->unlockMethod == i ? BST_CHECKED : BST_UNCHECKED);
+    }
 
     // Set whitelist checkbox separately (it's now an addon feature)
     CheckDlgButton(hTabDialog, IDC_CHECK_WHITELIST, tempSettings->whitelistEnabled ? BST_CHECKED : BST_UNCHECKED);
@@ -141,6 +159,9 @@ void LockInputTab::HandleControlCommand(WPARAM wParam, LPARAM lParam) {
             tempSettings->keyboardLockEnabled = IsDlgButtonChecked(hTabDialog, IDC_CHECK_KEYBOARD) == BST_CHECKED;
             tempSettings->mouseLockEnabled = IsDlgButtonChecked(hTabDialog, IDC_CHECK_MOUSE) == BST_CHECKED;
 
+            // The mode only matters while the mouse is locked
+            EnableWindow(GetDlgItem(hTabDialog, IDC_COMBO_MOUSE_MODE), tempSettings->mouseLockEnabled);
+
             // Check if this created a pending change
             if (oldKeyboard != tempSettings->keyboardLockEnabled ||
                 oldMouse != tempSettings->mouseLockEnabled) {
@@ -156,10 +177,44 @@ void LockInputTab::HandleControlCommand(WPARAM wParam, LPARAM lParam) {
             break;
         }
 
+        case IDC_COMBO_MOUSE_MODE: {
+            if (HIWORD(wParam) != CBN_SELCHANGE) break;
+
+            int oldMode = tempSettings->mouseLockMode;
+            int selection = (int)SendDlgItemMessageA(hTabDialog, IDC_COMBO_MOUSE_MODE, CB_GETCURSEL, 0, 0);
+            if (selection != CB_ERR) tempSettings->mouseLockMode = selection;
+
+            if (oldMode != tempSettings->mouseLockMode) {
+                *hasUnsavedChanges = true;
+                // Notify parent dialog to update button states
+                if (parentDialog) {
+                    parentDialog->UpdateButtonStates();
+                }
+            }
+            break;
+        }
+
+        case IDC_CHECK_HOOKS_WHILE_LOCKED: {
+            bool oldValue = tempSettings->hooksOnlyWhileLocked;
+            tempSettings->hooksOnlyWhileLocked = (IsDlgButtonChecked(hTabDialog, IDC_CHECK_HOOKS_WHILE_LOCKED) == BST_CHECKED);
+
+            if (oldValue != tempSettings->hooksOnlyWhileLocked) {
+                *hasUnsavedChanges = true;
+                // Notify parent dialog to update button states
+                if (parentDialog) {
+                    parentDialog->UpdateButtonStates();
+                }
+            }
+            break;
+        }
+
         case IDC_RADIO_PASSWORD:
-        case IDC_RADIO_TIMER: {
+        case IDC_RADIO_TIMER:
+        case IDC_RADIO_TOTP: {
             int oldMethod = tempSettings->unlockMethod;
-            tempSettings->unlockMethod = LOWORD(wParam) - IDC_RADIO_PASSWORD;
+            for (int i = 0; i < UNLOCK_METHOD_COUNT; i++) {
+                if (UNLOCK_METHOD_RADIOS[i] == LOWORD(wParam)) tempSettings->unlockMethod = i;
+            }
 
             if (oldMethod != tempSettings->unlockMethod) {
                 *hasUnsavedChanges = true;
@@ -199,6 +254,11 @@ void LockInputTab::HandleControlCommand(WPARAM wParam, LPARAM lParam) {
             ShowTimerConfig();
             break;
 
+        case IDC_BTN_TOTP_CFG:
+            ShowTotpSetup(hTabDialog);
+            RefreshHooks(); // A new secret changes which keys the lock hands to the matcher
+            break;
+
         case IDC_BTN_WHITELIST_CFG:
             ShowWhitelistConfig();
             break;
@@ -220,7 +280,8 @@ void LockInputTab::UpdateWarnings() {
     // Get current settings from UI
     bool keyboardEnabled = IsDlgButtonChecked(hTabDialog, IDC_CHECK_KEYBOARD) == BST_CHECKED;
     bool mouseEnabled = IsDlgButtonChecked(hTabDialog, IDC_CHECK_MOUSE) == BST_CHECKED;
-    bool passwordSelected = IsDlgButtonChecked(hTabDialog, IDC_RADIO_PASSWORD) == BST_CHECKED;
+    bool passwordSelected = IsDlgButtonChecked(hTabDialog, IDC_RADIO_PASSWORD) == BST_CHECKED ||
+                            IsDlgButtonChecked(hTabDialog, IDC_RADIO_TOTP) == BST_CHECKED;
 
     // Get hotkey text and check if it's a single key
     char hotkeyBuffer[256];
@@ -230,7 +291,7 @@ void LockInputTab::UpdateWarnings() {
 
     // Warning 1: Password won't work if keyboard is unlocked
     if (hWarningKeyboardUnlock && !keyboardEnabled && passwordSelected) {
-        SetWindowTextA(hWarningKeyboardUnlock, "!!WARNING!!: Password unlock will not work with keyboard unlocked.");
+        SetWindowTextA(hWarningKeyboardUnlock, "!!WARNING!!: Password and code unlock will not work with keyboard unlocked.");
         ShowWindow(hWarningKeyboardUnlock, SW_SHOW);
     } else if (hWarningKeyboardUnlock) {
         ShowWindow(hWarningKeyboardUnlock, SW_HIDE);
@@ -0,0 +1,105 @@
+// src/features/lock_input/lock_pipeline.cpp
+// Lock pipeline implementation
+
+#include "lock_pipeline.h"
+
+LockPipeline::LockPipeline()
+    : chords(ChordTrie()), chordsEnabled(false), translation(KeyTranslationTable()), translationEnabled(false),
+      pending(false), overflow(false) {
+    callbacks.wake = nullptr;
+    callbacks.failsafe = nullptr;
+    callbacks.chord = nullptr;
+    callbacks.replay = nullptr;
+    callbacks.context = nullptr;
+}
+
+// Enqueue a record and wake the consumer if it is not already scheduled
+void LockPipeline::QueueKeyEvent(const KeyEventRecord& record) {
+    if (!ring.Push(record)) {
+        // Ring full - the consumer discards the partial input on its next drain
+        overflow.store(true, std::memory_order_release);
+    }
+    if (!pending.exchange(true, std::memory_order_acq_rel) && callbacks.wake) {
+        callbacks.wake(callbacks.context);
+    }
+}
+
+void LockPipeline::ConfigureChords(const ChordTrie& trie) {
+    chords.Publish(trie);
+    chordsEnabled.store(trie.GetChordCount() > 0, std::memory_order_release);
+}
+
+void LockPipeline::ConfigureKeyTranslation(const KeyTranslationTable* table) {
+    if (table) translation.Publish(*table);
+    translationEnabled.store(table != nullptr, std::memory_order_release);
+}
+
+// Swallows presses that start, continue or complete a chord, and their releases.
+// Presses swallowed as a prefix no chord follows are handed to replay.
+bool LockPipeline::MatchChord(const InputEvent& event) {
+    uint8_t vk = (uint8_t)event.code;
+    if (event.type != INPUT_EVENT_KEY_DOWN) return chordMatcher.ConsumeRelease(vk);
+
+    ChordStroke stroke;
+    stroke.modifiers = engine.GetHeldModifiers();
+    stroke.vkCode = vk;
+
+    uint16_t action = 0;
+    ChordReplay replay;
+    const ChordTrie* trie = chords.BeginRead();
+    ChordMatchResult match = chordMatcher.Feed(*trie, stroke, event.time, action, replay);
+    chords.EndRead();
+
+    if (replay.count > 0 && callbacks.replay) callbacks.replay(callbacks.context, replay.strokes, replay.count);
+    if (match == CHORD_MATCHED && callbacks.chord) callbacks.chord(callbacks.context, action);
+    return match != CHORD_NO_MATCH;
+}
+
+void LockPipeline::ExpireChord(uint32_t now) {
+    ChordReplay replay;
+    if (chordMatcher.Expire(now, replay) && callbacks.replay) {
+        callbacks.replay(callbacks.context, replay.strokes, replay.count);
+    }
+}
+
+InputVerdict LockPipeline::OnInputEvent(const InputEvent& event) {
+    LockResult result = engine.Process(event);
+
+    if (result.queueFlags) {
+        // Forward a compact record to the UI thread; matching happens there
+        KeyEventRecord record;
+        record.vkCode = (uint8_t)event.code;
+        record.flags = result.queueFlags;
+        record.character = 0;
+        record.time = event.time;
+        if (translationEnabled.load(std::memory_order_acquire)) {
+            const KeyTranslationTable* table = translation.BeginRead();
+            record.character = table->Translate(engine.GetHeldModifiers(), record.vkCode);
+            translation.EndRead();
+        }
+        QueueKeyEvent(record);
+    }
+
+    InputVerdict verdict;
+    switch (result.decision) {
+        case LOCK_DECISION_PASS:
+            verdict = INPUT_VERDICT_PASS;
+            break;
+        case LOCK_DECISION_REQUEST_EXIT:
+            if (callbacks.failsafe) callbacks.failsafe(callbacks.context);
+            verdict = INPUT_VERDICT_PASS;
+            break;
+        default:
+            verdict = INPUT_VERDICT_BLOCK;
+            break;
+    }
+
+    // Our own synthesized input (stuck key releases) is never a chord
+    if (verdict == INPUT_VERDICT_PASS && event.device == INPUT_DEVICE_KEYBOARD && !(event.flags & INPUT_FLAG_INJECTED) &&
+        chordsEnabled.load(std::memory_order_relaxed) && !engine.IsLocked() && MatchChord(event)) {
+        verdict = INPUT_VERDICT_BLOCK;
+    }
+
+    inputState.Update(event, verdict);
+    return verdict;
+}
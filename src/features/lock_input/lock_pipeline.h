@@ -0,0 +1,87 @@
+// src/features/lock_input/lock_pipeline.h
+// Connects blocking input backends to the LockEngine and the UI-thread key ring (portable, no Win32 dependencies)
+
+#pragma once
+#include <atomic>
+#include "input_backend.h"
+#include "lock_engine.h"
+#include "key_event_ring.h"
+#include "input_state_tracker.h"
+#include "chord_trie.h"
+#include "key_translation.h"
+#include "../../utils/snapshot_publisher.h"
+
+// Called from the delivering thread. Wake runs once per batch of queued keys
+// (when the pending flag flips to set); failsafe runs after ESC x3, chord
+// when a chord hotkey completes while unlocked and replay with the strokes
+// of a chord prefix no chord followed (see ChordReplay), which the caller
+// re-injects after the current event.
+struct LockPipelineCallbacks {
+    void (*wake)(void* context);
+    void (*failsafe)(void* context);
+    void (*chord)(void* context, uint16_t action);
+    void (*replay)(void* context, const ChordStroke* strokes, size_t count);
+    void* context;
+};
+
+// Connects the blocking backends to the LockEngine: turns its decisions into
+// verdicts and callbacks, and hands password keys to the UI thread through
+// the KeyEventRing, with the character they type in the published layout
+// table. While unlocked, key presses the engine lets through are
+// matched against the chord hotkeys. Every verdict also updates the key and
+// button state, so releases swallowed by the lock can be replayed on unlock. OnInputEvent()
+// runs on the backend's thread; the consumer side (ConsumeWake,
+// ConsumeOverflow, the ring's Pop side) belongs to one other thread.
+class LockPipeline : public InputEventSink {
+private:
+    LockEngine engine;
+    LockPipelineCallbacks callbacks;
+
+    InputStateTracker inputState;
+
+    SnapshotPublisher<ChordTrie> chords;
+    std::atomic<bool> chordsEnabled;
+    ChordMatcher chordMatcher; // Delivering thread
+
+    SnapshotPublisher<KeyTranslationTable> translation;
+    std::atomic<bool> translationEnabled;
+
+    KeyEventRing ring;
+    std::atomic<bool> pending;
+    std::atomic<bool> overflow;
+
+    void QueueKeyEvent(const KeyEventRecord& record);
+    bool MatchChord(const InputEvent& event);
+
+public:
+    LockPipeline();
+
+    // Before delivery starts
+    void SetCallbacks(const LockPipelineCallbacks& callbacks) { this->callbacks = callbacks; }
+
+    // Any thread (settings are published to the delivering thread atomically)
+    void Configure(const LockEngineConfig& config) { engine.Configure(config); }
+    void ConfigureChords(const ChordTrie& trie);
+    // Layout table queued keys are translated with; null stops translating
+    void ConfigureKeyTranslation(const KeyTranslationTable* table);
+    void SetLocked(bool value) { engine.SetLocked(value); }
+    bool IsLocked() const { return engine.IsLocked(); }
+    void SetLockScope(uint8_t scope) { engine.SetScope(scope); } // LockScope, see AppLockRules
+
+    InputVerdict OnInputEvent(const InputEvent& event) override;
+
+    // Delivering thread: a chord prefix is waiting for its next stroke, and
+    // ExpireChord() hands it back through replay once it timed out
+    bool IsChordPending() const { return chordMatcher.IsPending(); }
+    void ExpireChord(uint32_t now);
+
+    // Seeded by the delivering thread when a backend starts; GetStuck* from any thread
+    InputStateTracker& GetInputState() { return inputState; }
+
+    // Consumer thread: clear the wake-up flag before draining so keys queued
+    // during the drain schedule a new wake-up
+    void ConsumeWake() { pending.exchange(false, std::memory_order_acq_rel); }
+    bool ConsumeOverflow() { return overflow.exchange(false, std::memory_order_acq_rel); }
+    size_t PopKeyEvents(KeyEventRecord* out, size_t maxCount) { return ring.PopBatch(out, maxCount); }
+    void ClearKeyEvents() { ring.Clear(); }
+};
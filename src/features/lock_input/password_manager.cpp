@@ -3,9 +3,9 @@
 
 #include "password_manager.h"
 #include "../../resource.h"
-#include <sstream>
-#include <iomanip>
-#include <algorithm>
+#include <ntsecapi.h> // RtlGenRandom
+#include <cstdio>
+#include <cstring>
 
 // Global instance
 PasswordManager g_passwordManager;
@@ -13,14 +13,50 @@ PasswordManager g_passwordManager;
 // Registry constants
 const char* PasswordManager::REGISTRY_KEY = "SOFTWARE\\UtilityApp";
 const char* PasswordManager::PASSWORD_VALUE = "PasswordHash";
+const char* PasswordManager::PASSWORD_LENGTH_VALUE = "PasswordLength";
+const char* PasswordManager::PASSWORD_ENCODING_VALUE = "PasswordEncoding";
+const char* PasswordManager::CREDENTIALS_VALUE = "Credentials";
 
-PasswordManager::PasswordManager() : isPasswordSet(false) {
+PasswordManager::PasswordManager()
+    : isPasswordSet(false), passwordLength(0), encoding(PASSWORD_ENCODING_KEYS),
+      hasCredentials(false), candidateLengths(0), encodingSummary(PASSWORD_ENCODING_KEYS) {
+    memset(passwordDigest, 0, sizeof(passwordDigest));
     LoadFromRegistry();
 }
 
 PasswordManager::~PasswordManager() {
     // Secure cleanup
-    hashedPassword.clear();
+    SecureZeroMemory(passwordDigest, sizeof(passwordDigest));
+    credentials.Clear();
+}
+
+// The bytes a secret is hashed as. Key-code sets (saved by older versions)
+// hold letters as their upper-case virtual keys and digits as the digit keys,
+// so anything else could never be typed in that encoding.
+static bool EncodeSecret(const std::string& secret, PasswordEncoding encoding, std::string& encoded) {
+    encoded = secret;
+    if (encoding == PASSWORD_ENCODING_KEYS) {
+        for (size_t i = 0; i < encoded.length(); i++) {
+            char ch = encoded[i];
+            if (ch >= 'a' && ch <= 'z') {
+                encoded[i] = (char)(ch - 'a' + 'A');
+            } else if (!((ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9'))) {
+                return false;
+            }
+        }
+    }
+    return PasswordMatcher::LengthBit(encoded.length()) != 0; // Longer or shorter could never be matched
+}
+
+static void ScrubString(std::string& text) {
+    if (!text.empty()) SecureZeroMemory(&text[0], text.length());
+    text.clear();
+}
+
+void PasswordManager::RefreshSummary() {
+    hasCredentials.store(!credentials.IsEmpty(), std::memory_order_release);
+    candidateLengths.store(credentials.GetCandidateLengths(), std::memory_order_release);
+    encodingSummary.store(encoding, std::memory_order_release);
 }
 
 bool PasswordManager::SetPassword(const std::string& newPassword) {
@@ -29,57 +65,315 @@ bool PasswordManager::SetPassword(const std::string& newPassword) {
         return true;
     }
 
-    hashedPassword = HashPassword(newPassword);
+    std::lock_guard<std::mutex> lock(credentialMutex);
+
+    // A set holding nothing but the old password switches to typed text
+    size_t others = credentials.GetCount() - (isPasswordSet ? 1 : 0);
+    PasswordEncoding newEncoding = others == 0 ? PASSWORD_ENCODING_TEXT : encoding;
+
+    std::string encoded;
+    if (!EncodeSecret(newPassword, newEncoding, encoded)) {
+        ScrubString(encoded);
+        return false;
+    }
+    size_t length = encoded.length();
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    Sha256(encoded.data(), length, digest);
+    ScrubString(encoded);
+
+    if (isPasswordSet) credentials.Remove(passwordDigest);
+    credentials.Add(digest, length, CREDENTIAL_PASSWORD); // Already present if it repeats a PIN
+
+    memcpy(passwordDigest, digest, sizeof(digest));
+    SecureZeroMemory(digest, sizeof(digest));
     isPasswordSet = true;
-    return SaveToRegistry();
+    passwordLength = length;
+    encoding = newEncoding;
+    RefreshSummary();
+    return SaveLocked();
+}
+
+bool PasswordManager::AddPin(const std::string& pin) {
+    std::lock_guard<std::mutex> lock(credentialMutex);
+
+    PasswordEncoding newEncoding = credentials.IsEmpty() ? PASSWORD_ENCODING_TEXT : encoding;
+    std::string encoded;
+    if (!EncodeSecret(pin, newEncoding, encoded)) {
+        ScrubString(encoded);
+        return false;
+    }
+    size_t length = encoded.length();
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    Sha256(encoded.data(), length, digest);
+    ScrubString(encoded);
+
+    bool added = credentials.Add(digest, length, CREDENTIAL_PASSWORD);
+    SecureZeroMemory(digest, sizeof(digest));
+    if (!added) return false;
+
+    encoding = newEncoding;
+    RefreshSummary();
+    return SaveLocked();
+}
+
+bool PasswordManager::RemovePin(const std::string& pin) {
+    std::lock_guard<std::mutex> lock(credentialMutex);
+
+    std::string encoded;
+    bool valid = EncodeSecret(pin, encoding, encoded);
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    Sha256(encoded.data(), encoded.length(), digest);
+    ScrubString(encoded);
+
+    int index = valid ? credentials.Find(digest) : -1;
+    bool removed = index >= 0 && credentials.Get(index).kind == CREDENTIAL_PASSWORD && credentials.Remove(digest);
+    if (removed && isPasswordSet && Sha256DigestEquals(digest, passwordDigest)) {
+        SecureZeroMemory(passwordDigest, sizeof(passwordDigest));
+        isPasswordSet = false;
+        passwordLength = 0;
+    }
+    SecureZeroMemory(digest, sizeof(digest));
+    if (!removed) return false;
+
+    RefreshSummary();
+    return SaveLocked();
+}
+
+size_t PasswordManager::GetCredentialCount(CredentialKind kind) const {
+    std::lock_guard<std::mutex> lock(credentialMutex);
+    return credentials.GetCount(kind);
+}
+
+// Uniform decimal digits from the system CSPRNG
+static bool RandomDigits(char* out, size_t count) {
+    size_t written = 0;
+    while (written < count) {
+        uint8_t bytes[32];
+        if (!RtlGenRandom(bytes, sizeof(bytes))) return false;
+        for (size_t i = 0; i < sizeof(bytes) && written < count; i++) {
+            if (bytes[i] < 250) out[written++] = (char)('0' + bytes[i] % 10); // 250 = 25 * 10: no modulo bias
+        }
+        SecureZeroMemory(bytes, sizeof(bytes));
+    }
+    return true;
+}
+
+bool PasswordManager::GenerateRecoveryCodes(size_t count, std::vector<std::string>& codes) {
+    codes.clear();
+    std::lock_guard<std::mutex> lock(credentialMutex);
+
+    // Codes alone would replace the default password with nothing reusable
+    if (credentials.GetCount(CREDENTIAL_PASSWORD) == 0) return false;
+
+    credentials.RemoveKind(CREDENTIAL_RECOVERY_CODE);
+    for (size_t i = 0; i < count; i++) {
+        char code[RECOVERY_CODE_LENGTH];
+        if (!RandomDigits(code, sizeof(code))) break;
+
+        uint8_t digest[SHA256_DIGEST_SIZE];
+        Sha256(code, sizeof(code), digest);
+        if (credentials.Add(digest, sizeof(code), CREDENTIAL_RECOVERY_CODE)) {
+            codes.push_back(std::string(code, sizeof(code)));
+        }
+        SecureZeroMemory(code, sizeof(code));
+        SecureZeroMemory(digest, sizeof(digest));
+    }
+
+    RefreshSummary();
+    bool saved = SaveLocked();
+    if (!saved || codes.size() != count) {
+        // Never hand out codes that may not be stored
+        credentials.RemoveKind(CREDENTIAL_RECOVERY_CODE);
+        RefreshSummary();
+        SaveLocked();
+        for (size_t i = 0; i < codes.size(); i++) ScrubString(codes[i]);
+        codes.clear();
+        return false;
+    }
+    return true;
 }
 
 bool PasswordManager::ValidatePassword(const std::string& inputPassword) {
-    if (!isPasswordSet) return false; // No password set - validation should fail
-    return VerifyHash(inputPassword, hashedPassword);
+    return ValidatePassword(inputPassword.data(), inputPassword.length());
+}
+
+bool PasswordManager::ValidatePassword(const char* input, size_t length) {
+    PasswordCandidate candidate;
+    candidate.data = input;
+    candidate.length = length;
+    return ValidateCandidates(&candidate, 1) == 0;
+}
+
+int PasswordManager::ValidateCandidates(const PasswordCandidate* candidates, size_t count) {
+    // Cheap reject before hashing: only lengths some credential has
+    uint64_t lengthMask = GetCandidateLengths();
+    if (!HasPassword() || lengthMask == 0) return -1;
+
+    const uint8_t* messages[PasswordMatcher::MAX_PASSWORD_LENGTH];
+    size_t lengths[PasswordMatcher::MAX_PASSWORD_LENGTH];
+    size_t candidateIndex[PasswordMatcher::MAX_PASSWORD_LENGTH];
+    size_t batchCount = 0;
+
+    for (size_t i = 0; i < count && batchCount < PasswordMatcher::MAX_PASSWORD_LENGTH; i++) {
+        if (!(lengthMask & PasswordMatcher::LengthBit(candidates[i].length))) continue;
+        messages[batchCount] = (const uint8_t*)candidates[i].data;
+        lengths[batchCount] = candidates[i].length;
+        candidateIndex[batchCount] = i;
+        batchCount++;
+    }
+    if (batchCount == 0) return -1;
+
+    // One hash per candidate, however many credentials there are
+    uint8_t digests[PasswordMatcher::MAX_PASSWORD_LENGTH][SHA256_DIGEST_SIZE];
+    Sha256Batch(messages, lengths, batchCount, digests);
+
+    int found[PasswordMatcher::MAX_PASSWORD_LENGTH];
+    int match = -1;
+    {
+        std::lock_guard<std::mutex> lock(credentialMutex);
+        credentials.FindBatch(digests, batchCount, found);
+
+        size_t matched = 0;
+        while (matched < batchCount && found[matched] < 0) matched++;
+        if (matched < batchCount) {
+            match = (int)candidateIndex[matched];
+            const Credential& credential = credentials.Get(found[matched]);
+
+            // Lookup and revocation share the lock, so a code is spent exactly once
+            // even if the worker and a dialog check it at the same moment
+            bool changed = false;
+            if (credential.kind == CREDENTIAL_RECOVERY_CODE) {
+                credentials.Remove(digests[matched]);
+                changed = true;
+            } else if (credential.length == 0) {
+                // Hash saved without its length: later unlocks hash one suffix per key
+                credentials.SetLength(found[matched], lengths[matched]);
+                if (isPasswordSet && Sha256DigestEquals(digests[matched], passwordDigest)) {
+                    passwordLength = lengths[matched];
+                }
+                changed = true;
+            }
+            if (changed) {
+                RefreshSummary();
+                SaveLocked(); // On failure the code is still gone for this session
+            }
+        }
+    }
+    SecureZeroMemory(digests, sizeof(digests));
+    return match;
 }
 
 void PasswordManager::ClearPassword() {
-    hashedPassword.clear();
+    std::lock_guard<std::mutex> lock(credentialMutex);
+    SecureZeroMemory(passwordDigest, sizeof(passwordDigest));
+    credentials.Clear();
     isPasswordSet = false;
-    SaveToRegistry();
+    passwordLength = 0;
+    encoding = PASSWORD_ENCODING_KEYS;
+    RefreshSummary();
+    SaveLocked();
 }
 
 bool PasswordManager::LoadFromRegistry() {
+    std::lock_guard<std::mutex> lock(credentialMutex);
+
     HKEY hKey;
     if (RegOpenKeyExA(HKEY_CURRENT_USER, REGISTRY_KEY, 0, KEY_READ, &hKey) != ERROR_SUCCESS) {
         return false; // No saved password
     }
 
+    DWORD type;
+    DWORD blobSize = 0;
+    if (RegQueryValueExA(hKey, CREDENTIALS_VALUE, NULL, &type, NULL, &blobSize) == ERROR_SUCCESS &&
+        type == REG_BINARY && blobSize > 0) {
+        std::vector<uint8_t> blob(blobSize);
+        if (RegQueryValueExA(hKey, CREDENTIALS_VALUE, NULL, &type, blob.data(), &blobSize) == ERROR_SUCCESS) {
+            credentials.Deserialize(blob.data(), blobSize);
+        }
+    }
+
     char buffer[256];
     DWORD bufferSize = sizeof(buffer);
-    DWORD type;
 
     if (RegQueryValueExA(hKey, PASSWORD_VALUE, NULL, &type, (BYTE*)buffer, &bufferSize) == ERROR_SUCCESS) {
-        if (type == REG_SZ && bufferSize > 1) {
-            hashedPassword = std::string(buffer);
+        // Stored as lowercase hex, the format CryptoAPI-based versions wrote
+        buffer[sizeof(buffer) - 1] = '\0';
+        if (type == REG_SZ && bufferSize > 1 && Sha256FromHex(buffer, passwordDigest)) {
             isPasswordSet = true;
         }
     }
 
+    // Optional: older versions saved only the hash
+    DWORD length = 0;
+    DWORD lengthSize = sizeof(length);
+    if (isPasswordSet &&
+        RegQueryValueExA(hKey, PASSWORD_LENGTH_VALUE, NULL, &type, (BYTE*)&length, &lengthSize) == ERROR_SUCCESS &&
+        type == REG_DWORD) {
+        passwordLength = length;
+    }
+
+    // Saved by a version without credential sets (or changed there since): the
+    // main password joins the set
+    if (isPasswordSet && credentials.Find(passwordDigest) < 0) {
+        credentials.Add(passwordDigest, passwordLength, CREDENTIAL_PASSWORD);
+    }
+
+    // Optional: hashes without it were taken over virtual-key codes
+    DWORD storedEncoding = 0;
+    DWORD encodingSize = sizeof(storedEncoding);
+    if (!credentials.IsEmpty() &&
+        RegQueryValueExA(hKey, PASSWORD_ENCODING_VALUE, NULL, &type, (BYTE*)&storedEncoding, &encodingSize) == ERROR_SUCCESS &&
+        type == REG_DWORD && storedEncoding == PASSWORD_ENCODING_TEXT) {
+        encoding = PASSWORD_ENCODING_TEXT;
+    }
+
     RegCloseKey(hKey);
-    return isPasswordSet;
+    RefreshSummary();
+    return !credentials.IsEmpty();
 }
 
 bool PasswordManager::SaveToRegistry() {
+    std::lock_guard<std::mutex> lock(credentialMutex);
+    return SaveLocked();
+}
+
+bool PasswordManager::SaveLocked() {
     HKEY hKey;
     if (RegCreateKeyExA(HKEY_CURRENT_USER, REGISTRY_KEY, 0, NULL, 0, KEY_WRITE, NULL, &hKey, NULL) != ERROR_SUCCESS) {
         return false;
     }
 
     LONG result;
-    if (isPasswordSet && !hashedPassword.empty()) {
-        result = RegSetValueExA(hKey, PASSWORD_VALUE, 0, REG_SZ, 
-                               (const BYTE*)hashedPassword.c_str(), 
-                               hashedPassword.length() + 1);
+    if (!credentials.IsEmpty()) {
+        // The whole set in one value write: a revoked code is either still
+        // stored or gone, never half-written
+        std::vector<uint8_t> blob;
+        credentials.Serialize(blob);
+        result = RegSetValueExA(hKey, CREDENTIALS_VALUE, 0, REG_BINARY, blob.data(), (DWORD)blob.size());
+        if (result == ERROR_SUCCESS) {
+            DWORD storedEncoding = (DWORD)encoding;
+            result = RegSetValueExA(hKey, PASSWORD_ENCODING_VALUE, 0, REG_DWORD, (const BYTE*)&storedEncoding, sizeof(storedEncoding));
+        }
     } else {
-        result = RegDeleteValueA(hKey, PASSWORD_VALUE);
+        result = RegDeleteValueA(hKey, CREDENTIALS_VALUE);
         if (result == ERROR_FILE_NOT_FOUND) result = ERROR_SUCCESS; // OK if not found
+        RegDeleteValueA(hKey, PASSWORD_ENCODING_VALUE);
+    }
+
+    // The main password is also kept where older versions look for it
+    if (result == ERROR_SUCCESS && isPasswordSet) {
+        char hex[SHA256_DIGEST_SIZE * 2 + 1];
+        Sha256ToHex(passwordDigest, hex);
+        result = RegSetValueExA(hKey, PASSWORD_VALUE, 0, REG_SZ, 
+                               (const BYTE*)hex, 
+                               sizeof(hex));
+        if (result == ERROR_SUCCESS && passwordLength != 0) {
+            DWORD length = (DWORD)passwordLength;
+            result = RegSetValueExA(hKey, PASSWORD_LENGTH_VALUE, 0, REG_DWORD, (const BYTE*)&length, sizeof(length));
+        }
+    } else if (!isPasswordSet) {
+        RegDeleteValueA(hKey, PASSWORD_VALUE);
+        RegDeleteValueA(hKey, PASSWORD_LENGTH_VALUE);
     }
 
     RegCloseKey(hKey);
@@ -88,7 +382,7 @@ bool PasswordManager::SaveToRegistry() {
 
 void PasswordManager::InitializePasswordControls(HWND hDialog) {
     // Set placeholder text or current status
-    if (isPasswordSet) {
+    if (HasPassword()) {
         SetDlgItemTextA(hDialog, IDC_EDIT_PASSWORD, "••••••••");
         EnableWindow(GetDlgItem(hDialog, IDC_BUTTON_CLEAR_PASSWORD), TRUE);
     } else {
@@ -97,12 +391,24 @@ void PasswordManager::InitializePasswordControls(HWND hDialog) {
     }
 }
 
-bool PasswordManager::HandlePasswordChange(HWND hDialog, int editControlId) {
-    char buffer[256];
-    GetDlgItemTextA(hDialog, editControlId, buffer, sizeof(buffer));
+// Edit control text as UTF-8, the encoding typed passwords are hashed in
+static std::string ReadPasswordText(HWND hDialog, int editControlId) {
+    wchar_t wide[256];
+    char utf8[sizeof(wide) / sizeof(wide[0]) * 3];
+    GetDlgItemTextW(hDialog, editControlId, wide, sizeof(wide) / sizeof(wide[0]));
+    int length = WideCharToMultiByte(CP_UTF8, 0, wide, -1, utf8, sizeof(utf8), NULL, NULL);
     
-    std::string newPassword(buffer);
+    std::string text(utf8, length > 0 ? (size_t)length - 1 : 0);
+    SecureZeroMemory(wide, sizeof(wide));
+    SecureZeroMemory(utf8, sizeof(utf8));
+    return text;
+}
+
+bool PasswordManager::HandlePasswordChange(HWND hDialog, int editControlId) {
+    std::string newPassword = ReadPasswordText(hDialog, editControlId);
+    size_t bytes = newPassword.length();
     bool success = SetPassword(newPassword);
+    ScrubString(newPassword);
     
     // Clear the edit control for security
     SetDlgItemTextA(hDialog, editControlId, "");
@@ -110,14 +416,32 @@ bool PasswordManager::HandlePasswordChange(HWND hDialog, int editControlId) {
     // Update UI
     InitializePasswordControls(hDialog);
     
+    if (!success) {
+        // The limits are in UTF-8 bytes, which is what the matcher compares:
+        // letters outside A-Z take two or three bytes each
+        char message[320];
+        if (bytes > PasswordMatcher::MAX_PASSWORD_LENGTH || bytes < PasswordMatcher::MIN_PASSWORD_LENGTH) {
+            snprintf(message, sizeof(message),
+                     "The password is %u bytes long; it must be %u to %u bytes.\r\n\r\n"
+                     "A-Z, a-z, digits and symbols take 1 byte each, most other letters 2 or 3 "
+                     "(so 17 Cyrillic letters are already too long).",
+                     (unsigned)bytes, (unsigned)PasswordMatcher::MIN_PASSWORD_LENGTH,
+                     (unsigned)PasswordMatcher::MAX_PASSWORD_LENGTH);
+        } else if (encoding == PASSWORD_ENCODING_KEYS) {
+            snprintf(message, sizeof(message),
+                     "PINs saved by an older version are in use, so the password can only contain "
+                     "letters A-Z and digits.");
+        } else {
+            snprintf(message, sizeof(message), "The password could not be saved to the registry.");
+        }
+        MessageBoxA(hDialog, message, "Password Settings", MB_OK | MB_ICONWARNING);
+    }
+    
     return success;
 }
 
 bool PasswordManager::HandlePasswordValidation(HWND hDialog, int editControlId) {
-    char buffer[256];
-    GetDlgItemTextA(hDialog, editControlId, buffer, sizeof(buffer));
-    
-    std::string inputPassword(buffer);
+    std::string inputPassword = ReadPasswordText(hDialog, editControlId);
     bool valid = ValidatePassword(inputPassword);
     
     // Clear the edit control for security
@@ -126,46 +450,35 @@ bool PasswordManager::HandlePasswordValidation(HWND hDialog, int editControlId)
     return valid;
 }
 
-std::string PasswordManager::HashPassword(const std::string& password) {
-    // Use Windows CryptoAPI for secure hashing
-    HCRYPTPROV hProv = 0;
-    HCRYPTHASH hHash = 0;
-    
-    if (!CryptAcquireContext(&hProv, NULL, NULL, PROV_RSA_FULL, CRYPT_VERIFYCONTEXT)) {
-        return "";
+void ShowRecoveryCodes(HWND hwnd) {
+    if (g_passwordManager.GetCredentialCount(CREDENTIAL_PASSWORD) == 0) {
+        MessageBoxA(hwnd, "Set an unlock password before creating recovery codes.", "Recovery Codes", MB_OK | MB_ICONINFORMATION);
+        return;
     }
-    
-    if (!CryptCreateHash(hProv, CALG_SHA_256, 0, 0, &hHash)) {
-        CryptReleaseContext(hProv, 0);
-        return "";
-    }
-    
-    if (!CryptHashData(hHash, (const BYTE*)password.c_str(), password.length(), 0)) {
-        CryptDestroyHash(hHash);
-        CryptReleaseContext(hProv, 0);
-        return "";
+
+    size_t unused = g_passwordManager.GetCredentialCount(CREDENTIAL_RECOVERY_CODE);
+    if (unused > 0) {
+        char question[160];
+        snprintf(question, sizeof(question),
+                 "New codes replace the %u unused recovery code(s), which stop working.\r\nContinue?", (unsigned)unused);
+        if (MessageBoxA(hwnd, question, "Recovery Codes", MB_YESNO | MB_ICONQUESTION) != IDYES) {
+            return;
+        }
     }
-    
-    DWORD hashSize = 0;
-    DWORD dataSize = sizeof(DWORD);
-    CryptGetHashParam(hHash, HP_HASHSIZE, (BYTE*)&hashSize, &dataSize, 0);
-    
-    BYTE* hashData = new BYTE[hashSize];
-    CryptGetHashParam(hHash, HP_HASHVAL, hashData, &hashSize, 0);
-    
-    // Convert to hex string
-    std::stringstream ss;
-    for (DWORD i = 0; i < hashSize; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hashData[i];
+
+    std::vector<std::string> codes;
+    if (!g_passwordManager.GenerateRecoveryCodes(PasswordManager::RECOVERY_CODE_COUNT, codes)) {
+        MessageBoxA(hwnd, "Failed to create recovery codes.", "Recovery Codes", MB_OK | MB_ICONERROR);
+        return;
     }
-    
-    delete[] hashData;
-    CryptDestroyHash(hHash);
-    CryptReleaseContext(hProv, 0);
-    
-    return ss.str();
-}
 
-bool PasswordManager::VerifyHash(const std::string& password, const std::string& hash) {
-    return HashPassword(password) == hash;
+    std::string text = "Each code unlocks once: type its digits while input is locked.\r\n"
+                       "Write them down now - they are not shown again.\r\n\r\n";
+    for (size_t i = 0; i < codes.size(); i++) {
+        text += codes[i];
+        text += "\r\n";
+        ScrubString(codes[i]);
+    }
+    MessageBoxA(hwnd, text.c_str(), "Recovery Codes", MB_OK | MB_ICONINFORMATION);
+    ScrubString(text);
 }
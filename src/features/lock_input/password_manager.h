@@ -3,24 +3,71 @@
 
 #pragma once
 #include <windows.h>
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <vector>
+#include "credential_set.h"
+#include "password_matcher.h"
+#include "../../utils/sha256.h"
 
+// What the stored hash was taken over, and so how typed keys are matched
+enum PasswordEncoding {
+    PASSWORD_ENCODING_KEYS = 0, // Virtual-key codes of digits and letters (hashes saved by older versions)
+    PASSWORD_ENCODING_TEXT = 1  // UTF-8 text as typed in the active keyboard layout
+};
+
+// Every credential that unlocks: the main password, extra staff PINs and
+// single-use recovery codes. The verification worker validates while the UI
+// thread may change credentials or validate too, so every member below is
+// guarded by credentialMutex (hashing happens outside it); other threads read
+// only the atomic summaries.
 class PasswordManager {
 private:
-    std::string hashedPassword;
+    CredentialSet credentials;
+    mutable std::mutex credentialMutex;
+    uint8_t passwordDigest[SHA256_DIGEST_SIZE]; // Main password, also kept in the legacy values
     bool isPasswordSet;
+    size_t passwordLength; // Bytes; 0 = unknown (hash saved by an older version)
+    PasswordEncoding encoding; // Shared by all credentials
+    std::atomic<bool> hasCredentials;       // Summaries the input thread reads per key
+    std::atomic<uint64_t> candidateLengths; // without taking the lock
+    std::atomic<int> encodingSummary;
     static const char* REGISTRY_KEY;
     static const char* PASSWORD_VALUE;
+    static const char* PASSWORD_LENGTH_VALUE;
+    static const char* PASSWORD_ENCODING_VALUE;
+    static const char* CREDENTIALS_VALUE;
 
 public:
+    static const size_t RECOVERY_CODE_LENGTH = 10; // Digits, so they type the same in every encoding
+    static const size_t RECOVERY_CODE_COUNT = 8;
+
     PasswordManager();
     ~PasswordManager();
 
-    // Password operations
+    // Password operations (newPassword is UTF-8 and is matched as typed text).
+    // SetPassword replaces the main password and keeps other credentials.
     bool SetPassword(const std::string& newPassword);
     bool ValidatePassword(const std::string& inputPassword);
-    bool HasPassword() const { return isPasswordSet; }
-    void ClearPassword();
+    bool ValidatePassword(const char* input, size_t length);
+    // Hash all candidates in one batch and look each digest up once; returns
+    // the index of the first match or -1. A matching recovery code is revoked
+    // in the registry before this returns, so it can never unlock twice.
+    int ValidateCandidates(const PasswordCandidate* candidates, size_t count);
+    bool HasPassword() const { return hasCredentials.load(std::memory_order_acquire); }
+    PasswordEncoding GetEncoding() const { return (PasswordEncoding)encodingSummary.load(std::memory_order_acquire); }
+    // PasswordMatcher mask covering every credential
+    uint64_t GetCandidateLengths() const { return candidateLengths.load(std::memory_order_acquire); }
+    void ClearPassword(); // Removes every credential (back to the default password)
+
+    // Additional PINs (one per member of staff); false if invalid or already present
+    bool AddPin(const std::string& pin);
+    bool RemovePin(const std::string& pin);
+    size_t GetCredentialCount(CredentialKind kind) const;
+
+    // Replaces all recovery codes with new random ones; needs a password or PIN
+    bool GenerateRecoveryCodes(size_t count, std::vector<std::string>& codes);
 
     // Registry operations
     bool LoadFromRegistry();
@@ -32,8 +79,12 @@ public:
     bool HandlePasswordValidation(HWND hDialog, int editControlId);
 
 private:
-    std::string HashPassword(const std::string& password);
-    bool VerifyHash(const std::string& password, const std::string& hash);
+    // Caller holds credentialMutex
+    void RefreshSummary();
+    bool SaveLocked();
 };
 
+// Tray command: create recovery codes and show them once
+void ShowRecoveryCodes(HWND hwnd);
+
 extern PasswordManager g_passwordManager;
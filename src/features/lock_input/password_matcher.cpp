@@ -0,0 +1,41 @@
+// src/features/lock_input/password_matcher.cpp
+// Streaming password matcher implementation
+
+#include "password_matcher.h"
+#include <cstring>
+
+PasswordMatcher::PasswordMatcher() : windowLength(0), lengthMask(0) {
+}
+
+uint64_t PasswordMatcher::LegacyLengthMask() {
+    uint64_t mask = 0;
+    for (size_t length = MIN_PASSWORD_LENGTH; length <= LEGACY_MAX_LENGTH; length++) {
+        mask |= LengthBit(length);
+    }
+    return mask;
+}
+
+void PasswordMatcher::Feed(char key) {
+    if (windowLength == sizeof(window)) {
+        // Slide: only the last MAX_PASSWORD_LENGTH characters can still be part of a match
+        memmove(window, window + sizeof(window) - MAX_PASSWORD_LENGTH, MAX_PASSWORD_LENGTH);
+        windowLength = MAX_PASSWORD_LENGTH;
+    }
+    window[windowLength++] = key;
+}
+
+size_t PasswordMatcher::GetCandidates(PasswordCandidate* out, size_t maxCandidates) const {
+    // Only lengths that fit in the typed input are candidates
+    size_t usable = windowLength < MAX_PASSWORD_LENGTH ? windowLength : MAX_PASSWORD_LENGTH;
+    uint64_t mask = lengthMask & ((2ULL << usable) - 1);
+
+    size_t count = 0;
+    while (mask && count < maxCandidates) {
+        size_t length = (size_t)__builtin_ctzll(mask);
+        mask &= mask - 1;
+        out[count].data = window + windowLength - length;
+        out[count].length = length;
+        count++;
+    }
+    return count;
+}
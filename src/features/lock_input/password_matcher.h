@@ -0,0 +1,59 @@
+// src/features/lock_input/password_matcher.h
+// Streaming password matcher - bounded work per keystroke, no allocations
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// A suffix of the typed input that could be the unlock password
+struct PasswordCandidate {
+    const char* data;
+    size_t length;
+};
+
+// Keeps the most recent keystrokes in a sliding window and reports only the
+// suffixes whose length matches a configured password length. With a known
+// password length every key yields at most one candidate, so unlock checking
+// costs one hash per key instead of one per suffix.
+class PasswordMatcher {
+public:
+    static const size_t MIN_PASSWORD_LENGTH = 3;
+    static const size_t MAX_PASSWORD_LENGTH = 32;
+    static const size_t LEGACY_MAX_LENGTH = 20; // Longest input the old rolling buffer could match
+
+private:
+    // Twice the longest password so the window only slides every 32 keys
+    char window[MAX_PASSWORD_LENGTH * 2];
+    size_t windowLength;
+    uint64_t lengthMask; // Bit n set: a password of length n may match
+
+public:
+    PasswordMatcher();
+
+    // Configure which suffix lengths are checked
+    void SetCandidateLengths(uint64_t mask) { lengthMask = mask; }
+    uint64_t GetCandidateLengths() const { return lengthMask; }
+
+    static uint64_t LengthBit(size_t length) {
+        return (length >= MIN_PASSWORD_LENGTH && length <= MAX_PASSWORD_LENGTH) ? (1ULL << length) : 0;
+    }
+    // Every length the legacy rolling matcher could accept (used when the
+    // stored hash carries no length information)
+    static uint64_t LegacyLengthMask();
+
+    // Append one typed character (amortized O(1))
+    void Feed(char key);
+    void Reset() { windowLength = 0; }
+    size_t GetInputLength() const { return windowLength; }
+
+    // The last characters that can still take part in a match (at most
+    // MAX_PASSWORD_LENGTH); lets callers snapshot the input for later checks
+    const char* GetRecentInput(size_t* length) const {
+        *length = windowLength < MAX_PASSWORD_LENGTH ? windowLength : MAX_PASSWORD_LENGTH;
+        return window + windowLength - *length;
+    }
+
+    // Writes the suffixes that should be verified after the last Feed(),
+    // shortest first. Returns the number written.
+    size_t GetCandidates(PasswordCandidate* out, size_t maxCandidates) const;
+};
@@ -0,0 +1,111 @@
+// src/features/lock_input/raw_input_backend.cpp
+// Raw Input backend implementation
+
+#include "raw_input_backend.h"
+
+// Raw mouse button transitions, in the order they are reported
+static const struct {
+    uint16_t flag;
+    uint8_t type;
+    uint16_t button;
+} RAW_BUTTON_FLAGS[] = {
+    { RI_MOUSE_LEFT_BUTTON_DOWN,   INPUT_EVENT_BUTTON_DOWN, INPUT_BUTTON_LEFT },
+    { RI_MOUSE_LEFT_BUTTON_UP,     INPUT_EVENT_BUTTON_UP,   INPUT_BUTTON_LEFT },
+    { RI_MOUSE_RIGHT_BUTTON_DOWN,  INPUT_EVENT_BUTTON_DOWN, INPUT_BUTTON_RIGHT },
+    { RI_MOUSE_RIGHT_BUTTON_UP,    INPUT_EVENT_BUTTON_UP,   INPUT_BUTTON_RIGHT },
+    { RI_MOUSE_MIDDLE_BUTTON_DOWN, INPUT_EVENT_BUTTON_DOWN, INPUT_BUTTON_MIDDLE },
+    { RI_MOUSE_MIDDLE_BUTTON_UP,   INPUT_EVENT_BUTTON_UP,   INPUT_BUTTON_MIDDLE },
+    { RI_MOUSE_BUTTON_4_DOWN,      INPUT_EVENT_BUTTON_DOWN, INPUT_BUTTON_X1 },
+    { RI_MOUSE_BUTTON_4_UP,        INPUT_EVENT_BUTTON_UP,   INPUT_BUTTON_X1 },
+    { RI_MOUSE_BUTTON_5_DOWN,      INPUT_EVENT_BUTTON_DOWN, INPUT_BUTTON_X2 },
+    { RI_MOUSE_BUTTON_5_UP,        INPUT_EVENT_BUTTON_UP,   INPUT_BUTTON_X2 },
+};
+
+RawInputBackend::RawInputBackend()
+    : targetWindow(NULL), includeMouse(false), registered(false), sink(NULL) {}
+
+RawInputBackend::~RawInputBackend() {
+    Stop();
+}
+
+bool RawInputBackend::Register(bool add) {
+    RAWINPUTDEVICE devices[2] = {};
+    UINT count = includeMouse ? 2 : 1;
+    for (UINT i = 0; i < count; i++) {
+        devices[i].usUsagePage = 0x01;               // Generic desktop
+        devices[i].usUsage = i == 0 ? 0x06 : 0x02;   // Keyboard, mouse
+        devices[i].dwFlags = add ? RIDEV_INPUTSINK : RIDEV_REMOVE;
+        devices[i].hwndTarget = add ? targetWindow : NULL;
+    }
+    return RegisterRawInputDevices(devices, count, sizeof(RAWINPUTDEVICE)) != FALSE;
+}
+
+bool RawInputBackend::Start(InputEventSink* sink) {
+    if (!sink || !targetWindow) return false;
+    this->sink = sink;
+    if (!registered) {
+        registered = Register(true);
+    }
+    return registered;
+}
+
+void RawInputBackend::Stop() {
+    if (registered && Register(false)) {
+        registered = false;
+    }
+    sink = NULL;
+}
+
+bool RawInputBackend::HandleMessage(LPARAM lParam) {
+    if (!sink) return false;
+
+    RAWINPUT raw;
+    UINT size = sizeof(raw);
+    if (GetRawInputData((HRAWINPUT)lParam, RID_INPUT, &raw, &size, sizeof(RAWINPUTHEADER)) == (UINT)-1) {
+        return false;
+    }
+
+    InputEvent event = {};
+    event.time = GetTickCount(); // Raw Input carries no timestamp of its own
+
+    if (raw.header.dwType == RIM_TYPEKEYBOARD) {
+        const RAWKEYBOARD& keyboard = raw.data.keyboard;
+        event.device = INPUT_DEVICE_KEYBOARD;
+        event.type = (keyboard.Flags & RI_KEY_BREAK) ? INPUT_EVENT_KEY_UP : INPUT_EVENT_KEY_DOWN;
+        if (keyboard.Flags & RI_KEY_E0) event.flags |= INPUT_FLAG_EXTENDED;
+        if (keyboard.Message == WM_SYSKEYDOWN || keyboard.Message == WM_SYSKEYUP) event.flags |= INPUT_FLAG_SYSTEM_KEY;
+        event.code = keyboard.VKey;
+        sink->OnInputEvent(event);
+        return true;
+    }
+
+    if (raw.header.dwType != RIM_TYPEMOUSE || !includeMouse) return false;
+
+    // One WM_INPUT can carry motion, several button transitions and a wheel step
+    const RAWMOUSE& mouse = raw.data.mouse;
+    event.device = INPUT_DEVICE_MOUSE;
+    if (mouse.lLastX != 0 || mouse.lLastY != 0) {
+        event.type = INPUT_EVENT_MOUSE_MOVE;
+        event.x = mouse.lLastX;
+        event.y = mouse.lLastY;
+        if (!(mouse.usFlags & MOUSE_MOVE_ABSOLUTE)) event.flags |= INPUT_FLAG_RELATIVE;
+        sink->OnInputEvent(event);
+        event.x = event.y = 0;
+        event.flags = 0;
+    }
+    for (size_t i = 0; i < sizeof(RAW_BUTTON_FLAGS) / sizeof(RAW_BUTTON_FLAGS[0]); i++) {
+        if (mouse.usButtonFlags & RAW_BUTTON_FLAGS[i].flag) {
+            event.type = RAW_BUTTON_FLAGS[i].type;
+            event.code = RAW_BUTTON_FLAGS[i].button;
+            sink->OnInputEvent(event);
+        }
+    }
+    if (mouse.usButtonFlags & (RI_MOUSE_WHEEL | RI_MOUSE_HWHEEL)) {
+        event.type = INPUT_EVENT_WHEEL;
+        event.code = 0;
+        event.wheelDelta = (int16_t)mouse.usButtonData;
+        if (mouse.usButtonFlags & RI_MOUSE_HWHEEL) event.flags |= INPUT_FLAG_HORIZONTAL;
+        sink->OnInputEvent(event);
+    }
+    return true;
+}
@@ -0,0 +1,37 @@
+// src/features/lock_input/raw_input_backend.h
+// Raw Input (WM_INPUT) observation-only input backend
+
+#pragma once
+#include <windows.h>
+#include "input_backend.h"
+
+// Registers for background Raw Input (RIDEV_INPUTSINK) on a window and turns
+// WM_INPUT into events for the sink. Raw Input cannot block, so verdicts are
+// ignored - this backend is for the failsafe and activity tracking while no
+// hook is installed. Events arrive on the window's thread via HandleMessage().
+class RawInputBackend : public InputBackend {
+private:
+    HWND targetWindow;
+    bool includeMouse;
+    bool registered;
+    InputEventSink* sink;
+
+    bool Register(bool add);
+
+public:
+    RawInputBackend();
+    ~RawInputBackend();
+
+    // Must be set before Start(); mouse events are only requested when asked for
+    void SetTargetWindow(HWND hwnd) { targetWindow = hwnd; }
+    void SetIncludeMouse(bool include) { includeMouse = include; }
+
+    const char* GetName() const override { return "Raw Input"; }
+    bool CanBlock() const override { return false; }
+    bool Start(InputEventSink* sink) override;
+    void Stop() override;
+    bool IsRunning() const override { return registered; }
+
+    // Call from the target window's WM_INPUT handler; returns true if an event was delivered
+    bool HandleMessage(LPARAM lParam);
+};
@@ -0,0 +1,43 @@
+// src/features/lock_input/synthetic_input_backend.cpp
+// Synthetic input backend implementation
+
+#include "synthetic_input_backend.h"
+
+SyntheticInputBackend::SyntheticInputBackend()
+    : events(nullptr), eventCount(0), position(0), looping(false),
+      sink(nullptr), delivered(0), blocked(0) {}
+
+void SyntheticInputBackend::SetEvents(const InputEvent* events, size_t count, bool loop) {
+    this->events = events;
+    eventCount = count;
+    position = 0;
+    looping = loop;
+}
+
+bool SyntheticInputBackend::Start(InputEventSink* sink) {
+    if (!sink) return false;
+    this->sink = sink;
+    return true;
+}
+
+void SyntheticInputBackend::Stop() {
+    sink = nullptr;
+}
+
+size_t SyntheticInputBackend::Pump(size_t maxEvents) {
+    if (!sink || eventCount == 0) return 0;
+
+    size_t count = 0;
+    while (count < maxEvents) {
+        if (position >= eventCount) {
+            if (!looping) break;
+            position = 0;
+        }
+        if (sink->OnInputEvent(events[position++]) == INPUT_VERDICT_BLOCK) {
+            blocked++;
+        }
+        count++;
+    }
+    delivered += count;
+    return count;
+}
@@ -0,0 +1,39 @@
+// src/features/lock_input/synthetic_input_backend.h
+// Input backend that replays events from memory (portable, no Win32 dependencies)
+
+#pragma once
+#include "input_backend.h"
+
+// Delivers a caller-owned event array to the sink when pumped, so the lock
+// pipeline can be driven without an input device or a message loop - from a
+// benchmark, a recorded trace or a scripted scenario.
+class SyntheticInputBackend : public InputBackend {
+private:
+    const InputEvent* events;
+    size_t eventCount;
+    size_t position;
+    bool looping;
+    InputEventSink* sink;
+    uint64_t delivered;
+    uint64_t blocked;
+
+public:
+    SyntheticInputBackend();
+
+    // The array must outlive the backend; looping restarts it at the end
+    void SetEvents(const InputEvent* events, size_t count, bool loop = false);
+    void Rewind() { position = 0; }
+
+    const char* GetName() const override { return "Synthetic"; }
+    bool CanBlock() const override { return true; }
+    bool Start(InputEventSink* sink) override;
+    void Stop() override;
+    bool IsRunning() const override { return sink != nullptr; }
+
+    // Delivers up to maxEvents events; returns how many were delivered
+    size_t Pump(size_t maxEvents);
+    bool IsFinished() const { return !looping && position >= eventCount; }
+
+    uint64_t GetDeliveredCount() const { return delivered; }
+    uint64_t GetBlockedCount() const { return blocked; }
+};
@@ -0,0 +1,130 @@
+// src/features/lock_input/totp.cpp
+// HOTP/TOTP codes, base32 secrets and the precomputed code window
+
+#include "totp.h"
+#include <cstring>
+
+static const uint32_t POWERS_OF_TEN[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+uint32_t HotpValue(const uint8_t* key, size_t keyLength, uint64_t counter,
+                   HmacAlgorithm algorithm, uint32_t digits) {
+    uint8_t message[8];
+    for (int i = 0; i < 8; i++) message[i] = (uint8_t)(counter >> (56 - 8 * i));
+
+    uint8_t tag[HMAC_MAX_SIZE];
+    Hmac(algorithm, key, keyLength, message, sizeof(message), tag);
+
+    // Dynamic truncation: the low nibble of the last byte picks four bytes
+    size_t offset = tag[HmacSize(algorithm) - 1] & 0x0F;
+    uint32_t binary = ((uint32_t)(tag[offset] & 0x7F) << 24) | ((uint32_t)tag[offset + 1] << 16) |
+                      ((uint32_t)tag[offset + 2] << 8) | (uint32_t)tag[offset + 3];
+    memset(tag, 0, sizeof(tag));
+
+    if (digits > TotpCodeWindow::MAX_DIGITS) digits = TotpCodeWindow::MAX_DIGITS;
+    return binary % POWERS_OF_TEN[digits];
+}
+
+void FormatOtpCode(uint32_t value, uint32_t digits, char* out) {
+    for (uint32_t i = digits; i > 0; i--) {
+        out[i - 1] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+static const char BASE32_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+
+std::string Base32Encode(const uint8_t* data, size_t length) {
+    std::string text;
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (size_t i = 0; i < length; i++) {
+        buffer = (buffer << 8) | data[i];
+        bits += 8;
+        while (bits >= 5) {
+            text += BASE32_ALPHABET[(buffer >> (bits - 5)) & 0x1F];
+            bits -= 5;
+        }
+    }
+    if (bits > 0) text += BASE32_ALPHABET[(buffer << (5 - bits)) & 0x1F];
+    return text;
+}
+
+bool Base32Decode(const std::string& text, std::vector<uint8_t>& out) {
+    out.clear();
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (size_t i = 0; i < text.length(); i++) {
+        char ch = text[i];
+        if (ch == ' ' || ch == '-' || ch == '=') continue;
+        if (ch >= 'a' && ch <= 'z') ch = (char)(ch - 'a' + 'A');
+
+        uint32_t value;
+        if (ch >= 'A' && ch <= 'Z') {
+            value = (uint32_t)(ch - 'A');
+        } else if (ch >= '2' && ch <= '7') {
+            value = (uint32_t)(ch - '2' + 26);
+        } else {
+            out.clear();
+            return false;
+        }
+        buffer = (buffer << 5) | value;
+        bits += 5;
+        if (bits >= 8) {
+            out.push_back((uint8_t)(buffer >> (bits - 8)));
+            bits -= 8;
+        }
+    }
+    return !out.empty();
+}
+
+TotpCodeWindow::TotpCodeWindow() : centerStep(0), lastUsedStep(0), digits(0), valid(false) {
+    memset(codes, 0, sizeof(codes));
+}
+
+void TotpCodeWindow::Refresh(const uint8_t* key, size_t keyLength, const TotpParameters& parameters, uint64_t unixTime) {
+    uint32_t newDigits = parameters.digits;
+    if (newDigits > MAX_DIGITS) newDigits = MAX_DIGITS;
+    uint64_t step = StepAt(unixTime, parameters.period);
+    if (step < (uint64_t)SKEW_STEPS) step = SKEW_STEPS; // Clock before 1970 + one step: keep counters unsigned
+
+    // Moved forward by less than the window: keep the slots that overlap
+    size_t reuse = 0;
+    if (valid && newDigits == digits && step >= centerStep && step - centerStep < SLOT_COUNT) {
+        reuse = SLOT_COUNT - (size_t)(step - centerStep);
+        memmove(codes[0], codes[SLOT_COUNT - reuse], reuse * MAX_DIGITS);
+    }
+
+    for (size_t slot = reuse; slot < SLOT_COUNT; slot++) {
+        uint64_t counter = step - SKEW_STEPS + slot;
+        FormatOtpCode(HotpValue(key, keyLength, counter, parameters.algorithm, newDigits), newDigits, codes[slot]);
+    }
+    centerStep = step;
+    digits = newDigits;
+    valid = true;
+}
+
+void TotpCodeWindow::Clear() {
+    volatile char* scrub = &codes[0][0];
+    for (size_t i = 0; i < sizeof(codes); i++) scrub[i] = 0;
+    valid = false;
+}
+
+bool TotpCodeWindow::Match(const char* input, size_t length) {
+    if (!valid || length < digits) return false;
+    const char* typed = input + length - digits;
+
+    // Every slot is compared in full so timing does not tell which step (or
+    // how many leading digits) matched
+    int matchedSlot = -1;
+    for (size_t slot = 0; slot < SLOT_COUNT; slot++) {
+        uint8_t difference = 0;
+        for (uint32_t i = 0; i < digits; i++) difference |= (uint8_t)(typed[i] ^ codes[slot][i]);
+        if (difference == 0 && matchedSlot < 0) matchedSlot = (int)slot;
+    }
+    if (matchedSlot < 0) return false;
+
+    uint64_t step = centerStep - SKEW_STEPS + (uint64_t)matchedSlot;
+    if (step <= lastUsedStep) return false; // Replayed (RFC 6238 section 5.2)
+    lastUsedStep = step;
+    return true;
+}
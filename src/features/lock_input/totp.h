@@ -0,0 +1,66 @@
+// src/features/lock_input/totp.h
+// Time-based one-time codes (RFC 6238) with the accepted codes precomputed per time step (portable)
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../../utils/hmac.h"
+
+struct TotpParameters {
+    HmacAlgorithm algorithm; // HMAC_SHA1 for authenticator apps
+    uint32_t digits;         // 6 to 8
+    uint32_t period;         // Seconds per time step
+
+    TotpParameters() : algorithm(HMAC_SHA1), digits(6), period(30) {}
+};
+
+// RFC 4226 HOTP value for one counter: HMAC, dynamic truncation, modulo 10^digits
+uint32_t HotpValue(const uint8_t* key, size_t keyLength, uint64_t counter,
+                   HmacAlgorithm algorithm, uint32_t digits);
+
+// Zero-padded decimal code (out holds digits characters, no terminator)
+void FormatOtpCode(uint32_t value, uint32_t digits, char* out);
+
+// RFC 4648 base32, the form authenticator apps take secrets in. Decoding
+// ignores case, spaces, dashes and '=' padding.
+std::string Base32Encode(const uint8_t* data, size_t length);
+bool Base32Decode(const std::string& text, std::vector<uint8_t>& out);
+
+// The codes accepted right now: the current time step and SKEW_STEPS either
+// side, for clocks that drift or a code typed just as it rolls over. Refresh()
+// runs from a timer and computes one HMAC per new time step; Match() runs per
+// key and only compares the typed digits against the fixed array.
+class TotpCodeWindow {
+public:
+    static const int SKEW_STEPS = 1;
+    static const size_t SLOT_COUNT = 2 * SKEW_STEPS + 1;
+    static const size_t MAX_DIGITS = 8;
+
+private:
+    char codes[SLOT_COUNT][MAX_DIGITS]; // Oldest step first
+    uint64_t centerStep;
+    uint64_t lastUsedStep; // A code unlocks once: its step and older ones are refused
+    uint32_t digits;
+    bool valid;
+
+public:
+    TotpCodeWindow();
+    ~TotpCodeWindow() { Clear(); }
+
+    static uint64_t StepAt(uint64_t unixTime, uint32_t period) { return period ? unixTime / period : 0; }
+
+    // Recomputes the slots that changed since the last call (all of them after
+    // Clear(), a jump in time or different parameters)
+    void Refresh(const uint8_t* key, size_t keyLength, const TotpParameters& parameters, uint64_t unixTime);
+    void Clear();
+
+    // input is the typed text so far; its last digits characters are compared
+    // with every slot (no early exit). True if one matches and was not used yet.
+    bool Match(const char* input, size_t length);
+
+    bool IsValid() const { return valid; }
+    uint32_t GetDigits() const { return digits; }
+    uint64_t GetCenterStep() const { return centerStep; }
+};
@@ -0,0 +1,148 @@
+// src/features/lock_input/totp_manager.cpp
+// One-time code secret storage and setup
+
+#include "totp_manager.h"
+#include <wincrypt.h>
+#include <ntsecapi.h> // RtlGenRandom
+#include <cstring>
+
+// Global instance
+TotpManager g_totpManager;
+
+// Registry constants
+const char* TotpManager::REGISTRY_KEY = "SOFTWARE\\UtilityApp";
+const char* TotpManager::SECRET_VALUE = "TotpSecret";
+
+TotpManager::TotpManager() {
+    LoadFromRegistry();
+}
+
+TotpManager::~TotpManager() {
+    // Secure cleanup
+    if (!secret.empty()) SecureZeroMemory(secret.data(), secret.size());
+    window.Clear();
+}
+
+uint64_t TotpManager::GetUnixTimeMs() {
+    FILETIME fileTime;
+    GetSystemTimeAsFileTime(&fileTime);
+    uint64_t ticks = ((uint64_t)fileTime.dwHighDateTime << 32) | fileTime.dwLowDateTime;
+    return (ticks - 116444736000000000ULL) / 10000; // 100 ns ticks since 1601 to ms since 1970
+}
+
+bool TotpManager::GenerateSecret(std::string& base32) {
+    std::vector<uint8_t> bytes(SECRET_SIZE);
+    if (!RtlGenRandom(bytes.data(), (ULONG)bytes.size())) return false;
+
+    // The old secret stays in use unless the new one is stored
+    secret.swap(bytes);
+    if (!SaveToRegistry()) {
+        secret.swap(bytes);
+        SecureZeroMemory(bytes.data(), bytes.size());
+        return false;
+    }
+    if (!bytes.empty()) SecureZeroMemory(bytes.data(), bytes.size());
+    window.Clear();
+
+    base32 = Base32Encode(secret.data(), secret.size());
+    return true;
+}
+
+void TotpManager::ClearSecret() {
+    if (!secret.empty()) SecureZeroMemory(secret.data(), secret.size());
+    secret.clear();
+    window.Clear();
+    SaveToRegistry();
+}
+
+UINT TotpManager::RefreshCodes() {
+    uint64_t now = GetUnixTimeMs();
+    if (HasSecret()) {
+        window.Refresh(secret.data(), secret.size(), parameters, now / 1000);
+    }
+    uint64_t periodMs = (uint64_t)parameters.period * 1000;
+    return (UINT)(periodMs - now % periodMs);
+}
+
+bool TotpManager::LoadFromRegistry() {
+    HKEY hKey;
+    if (RegOpenKeyExA(HKEY_CURRENT_USER, REGISTRY_KEY, 0, KEY_READ, &hKey) != ERROR_SUCCESS) {
+        return false; // No saved secret
+    }
+
+    BYTE buffer[512];
+    DWORD bufferSize = sizeof(buffer);
+    DWORD type;
+    LONG result = RegQueryValueExA(hKey, SECRET_VALUE, NULL, &type, buffer, &bufferSize);
+    RegCloseKey(hKey);
+    if (result != ERROR_SUCCESS || type != REG_BINARY || bufferSize == 0) {
+        return false;
+    }
+
+    // Protected for the current user, so a copied registry hive is useless elsewhere
+    DATA_BLOB input = { bufferSize, buffer };
+    DATA_BLOB output = { 0, NULL };
+    if (!CryptUnprotectData(&input, NULL, NULL, NULL, NULL, CRYPTPROTECT_UI_FORBIDDEN, &output)) {
+        return false;
+    }
+    secret.assign(output.pbData, output.pbData + output.cbData);
+    SecureZeroMemory(output.pbData, output.cbData);
+    LocalFree(output.pbData);
+    return HasSecret();
+}
+
+bool TotpManager::SaveToRegistry() {
+    HKEY hKey;
+    if (RegCreateKeyExA(HKEY_CURRENT_USER, REGISTRY_KEY, 0, NULL, 0, KEY_WRITE, NULL, &hKey, NULL) != ERROR_SUCCESS) {
+        return false;
+    }
+
+    LONG result;
+    if (HasSecret()) {
+        DATA_BLOB input = { (DWORD)secret.size(), secret.data() };
+        DATA_BLOB output = { 0, NULL };
+        if (CryptProtectData(&input, L"UtilityApp one-time code secret", NULL, NULL, NULL,
+                             CRYPTPROTECT_UI_FORBIDDEN, &output)) {
+            result = RegSetValueExA(hKey, SECRET_VALUE, 0, REG_BINARY, output.pbData, output.cbData);
+            LocalFree(output.pbData);
+        } else {
+            result = (LONG)GetLastError();
+        }
+    } else {
+        result = RegDeleteValueA(hKey, SECRET_VALUE);
+        if (result == ERROR_FILE_NOT_FOUND) result = ERROR_SUCCESS; // OK if not found
+    }
+
+    RegCloseKey(hKey);
+    return result == ERROR_SUCCESS;
+}
+
+void ShowTotpSetup(HWND hwnd) {
+    if (g_totpManager.HasSecret() &&
+        MessageBoxA(hwnd, "A one-time code secret is already set up.\r\n"
+                          "Create a new one? Codes from the old secret stop working.",
+                    "One-Time Code", MB_YESNO | MB_ICONQUESTION) != IDYES) {
+        return;
+    }
+
+    std::string base32;
+    if (!g_totpManager.GenerateSecret(base32)) {
+        MessageBoxA(hwnd, "Failed to create a one-time code secret.", "One-Time Code", MB_OK | MB_ICONERROR);
+        return;
+    }
+
+    // Groups of four are easier to type into a phone
+    std::string grouped;
+    for (size_t i = 0; i < base32.length(); i++) {
+        if (i > 0 && i % 4 == 0) grouped += ' ';
+        grouped += base32[i];
+    }
+
+    std::string text = "Add this key to your authenticator app (time-based, 6 digits):\r\n\r\n" + grouped +
+                       "\r\n\r\notpauth://totp/UtilityApp?secret=" + base32 + "&issuer=UtilityApp" +
+                       "\r\n\r\nWhile locked, type the current code to unlock. Press Ctrl+C to copy this message.";
+    MessageBoxA(hwnd, text.c_str(), "One-Time Code", MB_OK | MB_ICONINFORMATION);
+    SecureZeroMemory(&base32[0], base32.length());
+    SecureZeroMemory(&grouped[0], grouped.length());
+    SecureZeroMemory(&text[0], text.length());
+}
@@ -0,0 +1,52 @@
+// src/features/lock_input/totp_manager.h
+// One-time code unlock: the shared secret and the codes accepted while locked
+
+#pragma once
+#include <windows.h>
+#include <string>
+#include <vector>
+#include "totp.h"
+
+// The secret is stored DPAPI-protected (current user) in the registry and
+// kept decrypted in memory for the code refreshes. Codes are computed on a
+// timer while locked and forgotten on unlock; the key path only compares.
+class TotpManager {
+private:
+    std::vector<uint8_t> secret;
+    TotpParameters parameters;
+    TotpCodeWindow window;
+    static const char* REGISTRY_KEY;
+    static const char* SECRET_VALUE;
+
+    static uint64_t GetUnixTimeMs();
+
+public:
+    static const size_t SECRET_SIZE = 20; // 160 bits, the size RFC 4226 recommends
+
+    TotpManager();
+    ~TotpManager();
+
+    bool HasSecret() const { return !secret.empty(); }
+    uint32_t GetDigits() const { return parameters.digits; }
+
+    // Creates and saves a new random secret; base32 receives it for the authenticator app
+    bool GenerateSecret(std::string& base32);
+    void ClearSecret();
+
+    // Timer tick: codes for the current time step; returns the milliseconds
+    // until the next step begins
+    UINT RefreshCodes();
+    void ForgetCodes() { window.Clear(); }
+
+    // input is the typed digits so far
+    bool MatchCode(const char* input, size_t length) { return window.Match(input, length); }
+
+    // Registry operations
+    bool LoadFromRegistry();
+    bool SaveToRegistry();
+};
+
+// "Configure..." next to the one-time code unlock method
+void ShowTotpSetup(HWND hwnd);
+
+extern TotpManager g_totpManager;
@@ -0,0 +1,170 @@
+// src/features/lock_input/verification_worker.cpp
+// Password verification worker implementation
+
+#include "verification_worker.h"
+#include <cstring>
+
+// Zeroes a request's copy of the typed input; volatile so the stores are not elided
+static void ScrubRequest(VerificationRequest& request) {
+    volatile char* scrub = request.input;
+    for (size_t i = 0; i < sizeof(request.input); i++) scrub[i] = 0;
+    request.inputLength = 0;
+}
+
+VerificationWorker::VerificationWorker()
+    : queueHead(0), queueCount(0), stopRequested(false), generation(0),
+      verifyProc(nullptr), completeProc(nullptr), callbackContext(nullptr),
+      submittedCount(0), droppedCount(0), cancelledCount(0), verifiedCount(0), matchedCount(0) {
+}
+
+VerificationWorker::~VerificationWorker() {
+    Stop();
+}
+
+bool VerificationWorker::Start(VerifyCandidatesProc verify, VerificationCompleteProc complete, void* context) {
+    if (IsRunning() || !verify || !complete) return false;
+
+    verifyProc = verify;
+    completeProc = complete;
+    callbackContext = context;
+    stopRequested = false;
+    queueHead = 0;
+    queueCount = 0;
+
+    try {
+        thread = std::thread(&VerificationWorker::Run, this);
+    } catch (...) {
+        return false; // Caller falls back to verifying synchronously
+    }
+    return true;
+}
+
+void VerificationWorker::Stop() {
+    if (!IsRunning()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopRequested = true;
+        DiscardQueued();
+    }
+    generation.fetch_add(1, std::memory_order_acq_rel); // Drop the result of a check in progress
+    queueSignal.notify_one();
+    thread.join();
+}
+
+bool VerificationWorker::Submit(const char* input, size_t inputLength, uint64_t candidateLengths) {
+    if (inputLength > PasswordMatcher::MAX_PASSWORD_LENGTH) {
+        // Only the tail can contain a candidate
+        input += inputLength - PasswordMatcher::MAX_PASSWORD_LENGTH;
+        inputLength = PasswordMatcher::MAX_PASSWORD_LENGTH;
+    }
+    candidateLengths &= (2ULL << inputLength) - 1;
+    if (!candidateLengths || !IsRunning()) return true; // Nothing to verify
+
+    bool dropped = false;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (queueCount == QUEUE_CAPACITY) {
+            queueHead = (queueHead + 1) % QUEUE_CAPACITY;
+            queueCount--;
+            dropped = true;
+        }
+
+        // The slot may still hold a dropped request, longer than this one
+        VerificationRequest& request = queue[(queueHead + queueCount) % QUEUE_CAPACITY];
+        ScrubRequest(request);
+        memcpy(request.input, input, inputLength);
+        request.inputLength = (uint32_t)inputLength;
+        request.generation = generation.load(std::memory_order_acquire);
+        request.candidateLengths = candidateLengths;
+        queueCount++;
+    }
+    queueSignal.notify_one();
+
+    submittedCount.fetch_add(1, std::memory_order_relaxed);
+    if (dropped) droppedCount.fetch_add(1, std::memory_order_relaxed);
+    return !dropped;
+}
+
+uint32_t VerificationWorker::Cancel() {
+    size_t discarded;
+    uint32_t newGeneration;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        discarded = DiscardQueued();
+        newGeneration = generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
+    cancelledCount.fetch_add(discarded, std::memory_order_relaxed);
+    return newGeneration;
+}
+
+size_t VerificationWorker::DiscardQueued() {
+    size_t discarded = queueCount;
+    for (size_t i = 0; i < QUEUE_CAPACITY; i++) ScrubRequest(queue[i]);
+    queueHead = 0;
+    queueCount = 0;
+    return discarded;
+}
+
+VerificationStats VerificationWorker::GetStats() const {
+    VerificationStats stats;
+    stats.submitted = submittedCount.load(std::memory_order_relaxed);
+    stats.dropped = droppedCount.load(std::memory_order_relaxed);
+    stats.cancelled = cancelledCount.load(std::memory_order_relaxed);
+    stats.verified = verifiedCount.load(std::memory_order_relaxed);
+    stats.matched = matchedCount.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void VerificationWorker::Run() {
+    for (;;) {
+        VerificationRequest request;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueSignal.wait(lock, [this] { return stopRequested || queueCount > 0; });
+            if (stopRequested) return;
+
+            request = queue[queueHead];
+            ScrubRequest(queue[queueHead]);
+            queueHead = (queueHead + 1) % QUEUE_CAPACITY;
+            queueCount--;
+        }
+
+        // Requests queued before a Cancel() are stale
+        if (request.generation != generation.load(std::memory_order_acquire)) {
+            ScrubRequest(request);
+            continue;
+        }
+
+        size_t matchedLength = 0;
+        bool matched = Verify(request, &matchedLength);
+        verifiedCount.fetch_add(1, std::memory_order_relaxed);
+
+        // Scrub the copied input before it goes back on the stack
+        ScrubRequest(request);
+
+        if (matched && request.generation == generation.load(std::memory_order_acquire)) {
+            matchedCount.fetch_add(1, std::memory_order_relaxed);
+            completeProc(request.generation, matchedLength, callbackContext);
+        }
+    }
+}
+
+bool VerificationWorker::Verify(const VerificationRequest& request, size_t* matchedLength) {
+    PasswordCandidate candidates[PasswordMatcher::MAX_PASSWORD_LENGTH];
+    size_t count = 0;
+
+    uint64_t mask = request.candidateLengths;
+    while (mask && count < PasswordMatcher::MAX_PASSWORD_LENGTH) {
+        size_t length = (size_t)__builtin_ctzll(mask);
+        mask &= mask - 1;
+        candidates[count].data = request.input + request.inputLength - length;
+        candidates[count].length = length;
+        count++;
+    }
+
+    int match = verifyProc(candidates, count, callbackContext);
+    if (match < 0) return false;
+    *matchedLength = candidates[match].length;
+    return true;
+}
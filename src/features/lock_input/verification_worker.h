@@ -0,0 +1,92 @@
+// src/features/lock_input/verification_worker.h
+// Background password verification with a bounded, cancellable request queue
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include "password_matcher.h"
+
+// Snapshot of the typed input after one key, plus the suffix lengths to verify
+struct VerificationRequest {
+    char input[PasswordMatcher::MAX_PASSWORD_LENGTH];
+    uint32_t inputLength;
+    uint32_t generation;
+    uint64_t candidateLengths; // Bit n set: verify the last n characters
+};
+
+// Runs on the worker thread; returns the index of the matching candidate or -1
+typedef int (*VerifyCandidatesProc)(const PasswordCandidate* candidates, size_t count, void* context);
+
+// Runs on the worker thread after a match; the receiver must check the
+// generation against GetGeneration() because a cancel can race the callback
+typedef void (*VerificationCompleteProc)(uint32_t generation, size_t matchedLength, void* context);
+
+// Counters for diagnostics (monotonic since Start)
+struct VerificationStats {
+    uint64_t submitted;
+    uint64_t dropped;    // Oldest queued request evicted by a newer one
+    uint64_t cancelled;  // Queued requests discarded by Cancel()
+    uint64_t verified;   // Requests the worker actually checked
+    uint64_t matched;
+};
+
+// Verification is deliberately kept off the thread that owns the input hooks
+// so a slow (key-stretched) hash never delays message processing. Submit()
+// only copies the request under a short lock and never waits for a check in
+// progress. When the queue is full the oldest request is dropped - under
+// sustained typing the newest input is the one that can still unlock.
+// Typed input is zeroed wherever it is copied once the slot is done with:
+// taken, dropped, cancelled or stopped.
+class VerificationWorker {
+public:
+    static const size_t QUEUE_CAPACITY = 8;
+
+private:
+    std::thread thread;
+    std::mutex queueMutex;
+    std::condition_variable queueSignal;
+    VerificationRequest queue[QUEUE_CAPACITY];
+    size_t queueHead;
+    size_t queueCount;
+    bool stopRequested;
+
+    std::atomic<uint32_t> generation;
+    VerifyCandidatesProc verifyProc;
+    VerificationCompleteProc completeProc;
+    void* callbackContext;
+
+    std::atomic<uint64_t> submittedCount;
+    std::atomic<uint64_t> droppedCount;
+    std::atomic<uint64_t> cancelledCount;
+    std::atomic<uint64_t> verifiedCount;
+    std::atomic<uint64_t> matchedCount;
+
+public:
+    VerificationWorker();
+    ~VerificationWorker();
+
+    bool Start(VerifyCandidatesProc verify, VerificationCompleteProc complete, void* context);
+    void Stop();
+    bool IsRunning() const { return thread.joinable(); }
+
+    // Queue the suffixes of input selected by candidateLengths. Returns false
+    // if an older request had to be dropped to make room.
+    bool Submit(const char* input, size_t inputLength, uint64_t candidateLengths);
+
+    // Discard queued work and invalidate any result still in flight.
+    // Returns the new generation.
+    uint32_t Cancel();
+    uint32_t GetGeneration() const { return generation.load(std::memory_order_acquire); }
+
+    VerificationStats GetStats() const;
+
+private:
+    void Run();
+    // Empties the queue and zeroes every slot; the caller holds queueMutex
+    size_t DiscardQueued();
+    bool Verify(const VerificationRequest& request, size_t* matchedLength);
+};
@@ -3,6 +3,7 @@
 
 #include "privacy_manager.h"
 #include "../../notifications.h"
+#include "../../resource.h"
 #include <shlobj.h>
 
 // Registry constants
@@ -101,7 +102,7 @@ bool PrivacyManager::EnableBossKey(UINT modifiers, UINT virtualKey) {
     bossKeyVirtualKey = virtualKey;
     
     // Register global hotkey for boss key with main window
-    if (!RegisterHotKey(mainWindow, 9001, modifiers, virtualKey)) {
+    if (!RegisterHotKey(mainWindow, HOTKEY_ID_BOSS_KEY, modifiers, virtualKey)) {
         return false;
     }
     
@@ -113,20 +114,20 @@ bool PrivacyManager::DisableBossKey() {
         DeactivateBossKey();
     }
     
-    UnregisterHotKey(mainWindow, 9001);
+    UnregisterHotKey(mainWindow, HOTKEY_ID_BOSS_KEY);
     return true;
 }
 
 bool PrivacyManager::SetBossKeyHotkey(UINT modifiers, UINT virtualKey) {
     // Unregister old hotkey
-    UnregisterHotKey(mainWindow, 9001);
+    UnregisterHotKey(mainWindow, HOTKEY_ID_BOSS_KEY);
     
     // Update the hotkey values
     bossKeyModifiers = modifiers;
     bossKeyVirtualKey = virtualKey;
     
     // Re-register with new hotkey
-    if (!RegisterHotKey(mainWindow, 9001, modifiers, virtualKey)) {
+    if (!RegisterHotKey(mainWindow, HOTKEY_ID_BOSS_KEY, modifiers, virtualKey)) {
         return false;
     }
     
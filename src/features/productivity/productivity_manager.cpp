@@ -6,6 +6,7 @@
 #include "../../custom_notifications.h"
 #include "../../audio_manager.h"
 #include "../../settings.h"
+#include "../../resource.h"
 #include <dbt.h>
 #include <setupapi.h>
 #include <cfgmgr32.h>
@@ -190,7 +191,7 @@ bool ProductivityManager::RegisterQuickLaunchHotkeys() {
     // Register hotkeys for quick launch apps
     for (size_t i = 0; i < quickLaunchApps.size(); i++) {
         if (quickLaunchApps[i].enabled) {
-            RegisterHotKey(mainWindow, 5000 + i, quickLaunchApps[i].modifiers, quickLaunchApps[i].hotkey);
+            RegisterHotKey(mainWindow, HOTKEY_ID_QUICK_LAUNCH_FIRST + i, quickLaunchApps[i].modifiers, quickLaunchApps[i].hotkey);
         }
     }
     return true;
@@ -200,7 +201,7 @@ void ProductivityManager::UnregisterQuickLaunchHotkeys() {
     if (!mainWindow) return;
     
     for (size_t i = 0; i < quickLaunchApps.size(); i++) {
-        UnregisterHotKey(mainWindow, 5000 + i);
+        UnregisterHotKey(mainWindow, HOTKEY_ID_QUICK_LAUNCH_FIRST + i);
     }
 }
 
@@ -243,8 +244,8 @@ bool ProductivityManager::RemoveQuickLaunchApp(const std::string& name) {
 }
 
 bool ProductivityManager::ExecuteQuickLaunchApp(UINT hotkeyId) {
-    // Convert hotkey ID (5000-5099) to app index
-    int appIndex = hotkeyId - 5000;
+    // Convert hotkey ID to app index
+    int appIndex = hotkeyId - HOTKEY_ID_QUICK_LAUNCH_FIRST;
     
     if (appIndex >= 0 && appIndex < quickLaunchApps.size()) {
         const auto& app = quickLaunchApps[appIndex];
@@ -7,177 +7,861 @@
 #include "overlay.h"
 #include "features/lock_input/timer_manager.h"
 #include "features/lock_input/password_manager.h"
+#include "features/lock_input/key_event_ring.h"
+#include "features/lock_input/password_matcher.h"
+#include "features/lock_input/verification_worker.h"
+#include "features/lock_input/key_policy.h"
+#include "features/lock_input/hook_latency.h"
+#include "features/lock_input/lock_pipeline.h"
+#include "features/lock_input/hook_input_backend.h"
+#include "features/lock_input/raw_input_backend.h"
+#include "features/lock_input/input_trace.h"
+#include "features/lock_input/chord_trie.h"
+#include "features/lock_input/app_lock_rules.h"
+#include "features/lock_input/key_translation.h"
+#include "features/lock_input/totp_manager.h"
+#include "features/lock_input/hook_watchdog.h"
+#include "utils/hotkey_utils.h"
 #include <string>
-#include <vector>
+#include <cstring>
+#include <atomic>
+#include <mutex>
 
 // Global state variables
-static HHOOK g_keyboardHook = NULL;
-static HHOOK g_mouseHook = NULL;
-static bool g_isLocked = false;
-std::wstring g_passwordBuffer = L""; // Remove static to match extern declaration
-const std::wstring UNLOCK_PASSWORD = L"10203040";
+const char UNLOCK_PASSWORD[] = "10203040";
 static HWND g_cachedHwnd = NULL; // Cache window handle to avoid FindWindow calls
 
+// Which hooks the hook thread should keep installed, built on the UI thread.
+// The lock decisions themselves are published straight to the engine.
+struct HookConfig {
+    bool mouseLockEnabled;
+    bool mouseMovesPass;      // The mouse lock mode never blocks movement
+    bool hooksOnlyWhileLocked;
+    bool chordHotkeysEnabled; // Chords are matched in the keyboard hook, so it stays in while unlocked
+};
+
+// Hook thread state. The low-level hooks are serviced by a dedicated
+// time-critical thread that only runs hook callbacks, so modal dialogs,
+// notification painting or ShellExecute on the UI thread cannot delay input.
+static HANDLE g_hookThread = NULL;
+static DWORD g_hookThreadId = 0;
+static const UINT HOOK_THREAD_APPLY_CONFIG = WM_APP + 1; // Applies g_pendingHookConfig
+static const UINT HOOK_THREAD_UNINSTALL = WM_APP + 2;
+static const UINT HOOK_THREAD_SET_LOCKED = WM_APP + 3;   // wParam = lock state, lParam = sequence; signals g_hookAckEvent
+static const UINT HOOK_THREAD_REINSTALL = WM_APP + 4;    // wParam = lost hook mask; answers with WM_USER + 104
+static HANDLE g_hookAckEvent = NULL;
+static uint32_t g_hookLockSequence = 0;                  // Last HOOK_THREAD_SET_LOCKED sent (UI thread)
+static std::atomic<uint32_t> g_hookLockAckSequence(0);   // Last one the hook thread handled
+static const DWORD HOOK_LOCK_ACK_TIMEOUT = 500;          // ms per attempt
+static const int HOOK_LOCK_ATTEMPTS = 2;
+
+// Latest configuration for the hook thread, one slot the UI thread overwrites.
+// The hook thread applies it before handling any message once the flag is set,
+// so repeated applies coalesce, nothing is left to free if the thread quits
+// first, and a lost HOOK_THREAD_APPLY_CONFIG is only a delay.
+static std::mutex g_hookConfigMutex;
+static HookConfig g_pendingHookConfig;
+static std::atomic<bool> g_hookConfigPending(false);
+
+// Owned by whichever thread services the hooks
+static bool g_mouseLockEnabled = false;
+static bool g_hooksOnlyWhileLocked = false;
+static bool g_chordHotkeysEnabled = false;
+static bool g_hooksWanted = false;    // Cleared by UninstallHook (shutdown)
+static bool g_hookThreadLocked = false;
+
+// Lock decisions for the blocking backends. The pipeline holds the lock state
+// and the published hook policy (both updated from the UI thread, read by the
+// hook thread) and the ring keystrokes travel through to the UI thread. It
+// posts a single WM_USER + 101 wake-up per batch.
+static LockPipeline g_lockPipeline;
+
+// UI-side streaming matcher (only touched by the thread that owns the main window)
+static PasswordMatcher g_passwordMatcher;
+static void ConfigurePasswordMatcher();
+
+// One-time codes need a secret; until one is set up the password unlocks instead
+static int GetEffectiveUnlockMethod() {
+    if (g_appSettings.unlockMethod == 2 && !g_totpManager.HasSecret()) return 0;
+    return g_appSettings.unlockMethod;
+}
+
+// Hashes saved by this version are matched against typed text (see PasswordEncoding)
+static bool UsesTypedPassword() {
+    return GetEffectiveUnlockMethod() == 0 &&
+           g_passwordManager.HasPassword() && g_passwordManager.GetEncoding() == PASSWORD_ENCODING_TEXT;
+}
+
+// While locked for one-time codes, the accepted codes are recomputed as each
+// time step begins, so a key press only compares digits
+static const UINT_PTR TOTP_TIMER_ID = 3002;
+
+// Custom passwords are hashed on a background thread; a match comes back as
+// WM_USER + 103 (wParam = request generation, lParam = matched length)
+static VerificationWorker g_verificationWorker;
+
 // Reference to the main window and failsafe handler (declared in main.cpp)
 extern Failsafe failsafeHandler;
 extern const char CLASS_NAME[];
 
-// Low-level keyboard hook procedure
-LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
-    // CRITICAL: Process only HC_ACTION and return immediately for others
-    if (nCode != HC_ACTION) {
-        return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam);
+// Per-application locks (UI thread). While locked with rules configured, a
+// WinEvent hook follows the foreground window and stores the scope its
+// process has in the engine; the hooks only ever read that one byte.
+static AppLockRules g_appLockRules;
+static HWINEVENTHOOK g_foregroundEventHook = NULL;
+static bool g_cursorConfined = false; // ClipCursor applied for MOUSE_LOCK_CONFINE
+
+// Typed passwords: the layout of the foreground window's thread is turned
+// into a translation table here (UI thread) whenever it or Caps Lock changes,
+// so the hook never calls ToUnicodeEx
+static KeyTranslationCache g_keyTranslationCache;
+static HKL g_translationLayout = NULL;
+static bool g_translationCapsLock = false;
+
+// Opt-in capture of what the hooks see (key classes only) for offline replay.
+// The hook only queues events; this timer encodes them on the UI thread.
+static InputTraceRecorder g_inputTraceRecorder;
+static const UINT_PTR TRACE_DRAIN_TIMER_ID = 3004;
+static const UINT TRACE_DRAIN_INTERVAL = 100; // ms
+
+static void CALLBACK DrainInputTrace(HWND hwnd, UINT message, UINT_PTR timerId, DWORD time) {
+    g_inputTraceRecorder.Drain();
+    if (!g_inputTraceRecorder.IsRecording()) KillTimer(hwnd, TRACE_DRAIN_TIMER_ID); // Buffer filled up
+}
+
+// Hooks' thread: a chord prefix nothing follows is handed back for replay
+// once it times out. A thread timer (no window), so it fires on whichever
+// thread runs the hooks; only set while a prefix is pending.
+static UINT_PTR g_chordExpiryTimer = 0;
+static const UINT CHORD_EXPIRY_SLACK = 50; // ms past ChordMatcher::STROKE_TIMEOUT_MS
+
+static void CALLBACK OnChordExpiryTimer(HWND hwnd, UINT message, UINT_PTR id, DWORD time);
+
+static void ArmChordExpiry() {
+    if (g_chordExpiryTimer || !g_lockPipeline.IsChordPending()) return;
+    g_chordExpiryTimer = SetTimer(NULL, 0, ChordMatcher::STROKE_TIMEOUT_MS + CHORD_EXPIRY_SLACK, OnChordExpiryTimer);
+}
+
+static void CALLBACK OnChordExpiryTimer(HWND hwnd, UINT message, UINT_PTR id, DWORD time) {
+    KillTimer(NULL, g_chordExpiryTimer);
+    g_chordExpiryTimer = 0;
+    g_lockPipeline.ExpireChord(GetTickCount());
+    ArmChordExpiry(); // A later prefix is still waiting
+}
+
+// Counts hook callbacks per lock state for the latency report, then lets the
+// pipeline decide
+class CountingHookSink : public InputEventSink {
+public:
+    InputVerdict OnInputEvent(const InputEvent& event) override {
+        CountInputCallback(event.device == INPUT_DEVICE_KEYBOARD ? INPUT_COUNTER_KEYBOARD_HOOK : INPUT_COUNTER_MOUSE_HOOK,
+                           g_lockPipeline.IsLocked());
+        g_inputTraceRecorder.Record(event);
+        InputVerdict verdict = g_lockPipeline.OnInputEvent(event);
+        if (g_lockPipeline.IsChordPending()) ArmChordExpiry();
+        return verdict;
     }
-    
-    KBDLLHOOKSTRUCT* pkbhs = (KBDLLHOOKSTRUCT*)lParam;
+};
 
-    // Failsafe mechanism: Check for ESC presses (minimal processing)
-    if (pkbhs->vkCode == VK_ESCAPE && wParam == WM_KEYDOWN) {
-        if (failsafeHandler.recordEscPress()) {
-            // Use cached window handle to avoid FindWindow call
-            if (g_cachedHwnd) {
+static CountingHookSink g_hookSink;
+static HookInputBackend g_keyboardBackend(INPUT_DEVICE_KEYBOARD, &g_keyboardHookLatency);
+static HookInputBackend g_mouseBackend(INPUT_DEVICE_MOUSE, &g_mouseHookLatency);
+
+// While the keyboard hook is out (unlocked, hooks-only-while-locked mode) the
+// ESC x3 failsafe is fed from Raw Input on the UI thread instead
+static std::atomic<bool> g_keyboardHookActive(false);
+static std::atomic<bool> g_mouseHookActive(false);
+
+// Hook loss detection (UI thread): sampled every WATCHDOG_LOCKED_INTERVAL ms
+// while locked, when a lost hook means input gets through, and less often
+// otherwise, when it only costs the failsafe and chord hotkeys
+static HookWatchdog g_hookWatchdog;
+static const UINT_PTR WATCHDOG_TIMER_ID = 3003;
+static const UINT WATCHDOG_LOCKED_INTERVAL = 50;
+static const UINT WATCHDOG_UNLOCKED_INTERVAL = 1000;
+static uint8_t g_watchdogPending = 0; // Reinstalls posted to the hook thread and not yet answered
+static uint8_t g_watchdogRetry = 0;   // Reinstalls whose post failed, tried again next tick
+static DWORD g_watchdogSilentFor[HOOK_WATCHDOG_HOOK_COUNT];
+
+class RawInputFailsafeSink : public InputEventSink {
+public:
+    InputVerdict OnInputEvent(const InputEvent& event) override {
+        CountInputCallback(INPUT_COUNTER_RAW_INPUT, g_lockPipeline.IsLocked());
+        
+        // The keyboard hook handles the failsafe whenever it is installed
+        if (g_keyboardHookActive.load(std::memory_order_acquire)) return INPUT_VERDICT_PASS;
+        
+        if (event.code == VK_ESCAPE && event.type == INPUT_EVENT_KEY_DOWN && !(event.flags & INPUT_FLAG_SYSTEM_KEY) &&
+            g_appSettings.enableFailsafe) {
+            if (failsafeHandler.recordEscPress(event.time) && g_cachedHwnd) {
                 PostMessage(g_cachedHwnd, WM_CLOSE, 0, 0);
             }
         }
+        return INPUT_VERDICT_PASS;
     }
+};
+
+static RawInputFailsafeSink g_rawInputSink;
+static RawInputBackend g_rawInputBackend;
+
+// Hook thread: wake the UI thread to drain the key ring
+static void WakeKeyEventConsumer(void* context) {
+    PostMessage((HWND)context, WM_USER + 101, 0, 0);
+}
+
+// Hook thread: ESC pressed three times
+static void OnFailsafeTriggered(void* context) {
+    PostMessage((HWND)context, WM_CLOSE, 0, 0);
+}
+
+// Hook thread: a chord hotkey completed; dispatch it like a registered hotkey
+static void OnChordMatched(void* context, uint16_t action) {
+    PostMessage((HWND)context, WM_HOTKEY, (WPARAM)action, 0);
+}
+
+// Hook thread: keys swallowed as a chord prefix no chord followed. SendInput
+// from inside a hook callback would wait on this very thread, so the UI
+// thread injects them: two strokes per parameter (modifiers << 8 | vkCode),
+// vkCode 0 ends the list.
+static void OnChordReplay(void* context, const ChordStroke* strokes, size_t count) {
+    uint32_t packed[2] = { 0, 0 };
+    for (size_t i = 0; i < count && i < 4; i++) {
+        packed[i / 2] |= (uint32_t)((strokes[i].modifiers << 8) | strokes[i].vkCode) << ((i % 2) * 16);
+    }
+    PostMessage((HWND)context, WM_USER + 105, (WPARAM)packed[0], (LPARAM)packed[1]);
+}
+
+// Snapshot of the lock settings for the engine, built on the UI thread
+static void BuildLockEngineConfig(LockEngineConfig& config) {
+    KeyPolicySettings policySettings;
+    policySettings.keyboardLockEnabled = g_appSettings.keyboardLockEnabled;
+    policySettings.whitelistEnabled = g_appSettings.whitelistEnabled;
+    policySettings.whitelistedKeys = g_appSettings.whitelistedKeys;
+    policySettings.unlockMethod = GetEffectiveUnlockMethod();
+    CompileKeyPolicy(policySettings, UsesTypedPassword(), config.keyPolicy);
+    config.mouseBlockMask = g_appSettings.mouseLockEnabled ? MouseLockEventMask(g_appSettings.mouseLockMode) : 0;
+    config.failsafeEnabled = g_appSettings.enableFailsafe;
+    
+    // Ctrl+O and the lock/unlock toggle hotkey (see RegisterHotkeys in main.cpp)
+    // are swallowed while the keyboard is locked, so only a credential unlocks.
+    // With keyboard lock off (a mouse-only lock, which guards nothing typed)
+    // they reach RegisterHotKey and unlock directly, as they always have.
+    memset(config.unlockChords, 0, sizeof(config.unlockChords));
+    if (g_appSettings.keyboardLockEnabled) {
+        config.unlockChords[0].modifiers = LOCK_MOD_CONTROL;
+        config.unlockChords[0].vkCode = 'O';
+        config.unlockChords[1].modifiers = (uint8_t)(g_appSettings.hotkeyModifiers & 0xF);
+        config.unlockChords[1].vkCode = (uint8_t)g_appSettings.hotkeyVirtualKey;
+    }
+}
+
+// Worker thread: check candidate suffixes against every stored credential
+static int VerifyCandidatesOnWorker(const PasswordCandidate* candidates, size_t count, void* context) {
+    (void)context;
+    return g_passwordManager.ValidateCandidates(candidates, count);
+}
+
+// Worker thread: hand the result back to the window thread
+static void OnVerificationComplete(uint32_t generation, size_t matchedLength, void* context) {
+    HWND hwnd = (HWND)context;
+    PostMessage(hwnd, WM_USER + 103, (WPARAM)generation, (LPARAM)matchedLength);
+}
+
+// Virtual keys of the mouse buttons, in InputMouseButton order
+static const int MOUSE_BUTTON_KEYS[] = { VK_LBUTTON, VK_RBUTTON, VK_MBUTTON, VK_XBUTTON1, VK_XBUTTON2 };
+
+// Hook thread, before a hook goes in: the hooks only see transitions, so start
+// from the keys and buttons that are already down. Runs once per install.
+static void SeedInputState(InputDevice device) {
+    InputStateTracker& state = g_lockPipeline.GetInputState();
     
-    // If locked, check individual keyboard/mouse settings before blocking
-    if (g_isLocked) {
-        // Only block keyboard input if keyboard lock is enabled
-        if (!g_appSettings.keyboardLockEnabled) {
-            return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam);
+    if (device == INPUT_DEVICE_MOUSE) {
+        uint8_t buttons = 0;
+        for (int i = 0; i < 5; i++) {
+            if (GetAsyncKeyState(MOUSE_BUTTON_KEYS[i]) & 0x8000) buttons |= (uint8_t)(1 << i);
         }
-        
-        // CRITICAL: Allow modifier key releases and certain system keys to pass through
-        // This prevents the "sticky keys" issue where Ctrl/Shift remain pressed
-        if (wParam == WM_KEYUP || wParam == WM_SYSKEYUP) {
-            // Always allow key releases for modifier keys to maintain proper keyboard state
-            if (pkbhs->vkCode == VK_CONTROL || pkbhs->vkCode == VK_LCONTROL || pkbhs->vkCode == VK_RCONTROL ||
-                pkbhs->vkCode == VK_SHIFT || pkbhs->vkCode == VK_LSHIFT || pkbhs->vkCode == VK_RSHIFT ||
-                pkbhs->vkCode == VK_MENU || pkbhs->vkCode == VK_LMENU || pkbhs->vkCode == VK_RMENU ||
-                pkbhs->vkCode == VK_LWIN || pkbhs->vkCode == VK_RWIN) {
-                return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam); // Allow modifier releases
+        state.SeedButtons(buttons);
+        return;
+    }
+    
+    // Skip the mouse buttons and the generic Shift/Ctrl/Alt codes, which the
+    // keyboard hook never reports (it sends the left/right variants)
+    KeySet down;
+    down.Clear();
+    for (int vk = VK_BACK; vk < 0xFF; vk++) {
+        if (vk >= VK_SHIFT && vk <= VK_MENU) continue;
+        if (GetAsyncKeyState(vk) & 0x8000) down.Add((uint8_t)vk);
+    }
+    state.SeedKeys(down);
+}
+
+// Keys that need KEYEVENTF_EXTENDEDKEY to be released as the right physical key
+static bool IsExtendedKey(int vk) {
+    switch (vk) {
+        case VK_RCONTROL: case VK_RMENU: case VK_LWIN: case VK_RWIN: case VK_APPS:
+        case VK_INSERT: case VK_DELETE: case VK_HOME: case VK_END: case VK_PRIOR: case VK_NEXT:
+        case VK_LEFT: case VK_UP: case VK_RIGHT: case VK_DOWN:
+        case VK_NUMLOCK: case VK_DIVIDE: case VK_SNAPSHOT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// UI thread, right after unlocking: keys and buttons released while the lock
+// swallowed their release are still down as far as the system knows. Release
+// all of them in one batch, built from the hook-maintained state (no polling).
+static void ReleaseStuckInput() {
+    InputStateTracker& state = g_lockPipeline.GetInputState();
+    KeySet keys;
+    state.GetStuckKeys(keys);
+    uint8_t buttons = state.GetStuckButtons();
+    
+    INPUT inputs[256 + 5];
+    UINT count = 0;
+    for (int vk = 0; vk < 256; vk++) {
+        if (!keys.Contains((uint8_t)vk)) continue;
+        INPUT& input = inputs[count++];
+        memset(&input, 0, sizeof(input));
+        input.type = INPUT_KEYBOARD;
+        input.ki.wVk = (WORD)vk;
+        input.ki.dwFlags = KEYEVENTF_KEYUP | (IsExtendedKey(vk) ? KEYEVENTF_EXTENDEDKEY : 0);
+    }
+    
+    static const DWORD BUTTON_UP_FLAGS[] = { MOUSEEVENTF_LEFTUP, MOUSEEVENTF_RIGHTUP, MOUSEEVENTF_MIDDLEUP, MOUSEEVENTF_XUP, MOUSEEVENTF_XUP };
+    for (int i = 0; i < 5; i++) {
+        if (!(buttons & (1 << i))) continue;
+        INPUT& input = inputs[count++];
+        memset(&input, 0, sizeof(input));
+        input.type = INPUT_MOUSE;
+        input.mi.dwFlags = BUTTON_UP_FLAGS[i];
+        if (i == 3) input.mi.mouseData = XBUTTON1;
+        if (i == 4) input.mi.mouseData = XBUTTON2;
+    }
+    
+    if (count > 0) {
+        SendInput(count, inputs, sizeof(INPUT));
+    }
+}
+
+static void AppendKeyInput(INPUT* inputs, UINT& count, WORD vk, bool up) {
+    INPUT& input = inputs[count++];
+    memset(&input, 0, sizeof(input));
+    input.type = INPUT_KEYBOARD;
+    input.ki.wVk = vk;
+    input.ki.dwFlags = (up ? KEYEVENTF_KEYUP : 0) | (IsExtendedKey(vk) ? KEYEVENTF_EXTENDEDKEY : 0);
+}
+
+void HandleChordReplay(HWND hwnd, WPARAM first, LPARAM second) {
+    // Locking in between made them password keys; the lock would only swallow them
+    if (IsInputLocked()) return;
+
+    static const uint8_t MODIFIER_BITS[] = { LOCK_MOD_CONTROL, LOCK_MOD_ALT, LOCK_MOD_SHIFT, LOCK_MOD_WIN };
+    static const WORD MODIFIER_KEYS[] = { VK_CONTROL, VK_MENU, VK_SHIFT, VK_LWIN };
+    bool held[4];
+    held[0] = (GetAsyncKeyState(VK_CONTROL) & 0x8000) != 0;
+    held[1] = (GetAsyncKeyState(VK_MENU) & 0x8000) != 0;
+    held[2] = (GetAsyncKeyState(VK_SHIFT) & 0x8000) != 0;
+    held[3] = ((GetAsyncKeyState(VK_LWIN) | GetAsyncKeyState(VK_RWIN)) & 0x8000) != 0;
+
+    uint32_t packed[2] = { (uint32_t)first, (uint32_t)second };
+    INPUT inputs[4 * (2 + 4 * 2)];
+    UINT count = 0;
+    for (int i = 0; i < 4; i++) {
+        uint16_t stroke = (uint16_t)(packed[i / 2] >> ((i % 2) * 16));
+        WORD vk = (WORD)(stroke & 0xFF);
+        uint8_t modifiers = (uint8_t)(stroke >> 8);
+        if (vk == 0) break;
+
+        // Hold exactly the stroke's modifiers around it, then put back what the user holds
+        uint8_t toggled = 0;
+        for (int m = 0; m < 4; m++) {
+            if (held[m] != ((modifiers & MODIFIER_BITS[m]) != 0)) {
+                toggled |= 1 << m;
+                AppendKeyInput(inputs, count, MODIFIER_KEYS[m], held[m]);
             }
         }
-        
-        if (wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN) {
-            // First check whitelist if enabled (addon feature)
-            if (g_appSettings.whitelistEnabled) {
-                // Check if this key is whitelisted
-                // For now, allow ESC and function keys through for emergency access
-                if (pkbhs->vkCode == VK_ESCAPE || 
-                    (pkbhs->vkCode >= VK_F1 && pkbhs->vkCode <= VK_F12)) {
-                    return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam);
-                }
-            }
-            
-            // Handle unlock methods based on current settings (Password or Timer only)
-            switch (g_appSettings.unlockMethod) {
-                case 0: { // Password unlock method
-                    // Handle alphanumeric input for flexible passwords
-                    if ((pkbhs->vkCode >= '0' && pkbhs->vkCode <= '9') ||
-                        (pkbhs->vkCode >= 'A' && pkbhs->vkCode <= 'Z')) {
-                        
-                        g_passwordBuffer += (wchar_t)pkbhs->vkCode;
-                        
-                        // Optimized buffer management - keep reasonable size
-                        const size_t MAX_BUFFER_SIZE = 20;
-                        if (g_passwordBuffer.length() > MAX_BUFFER_SIZE) {
-                            g_passwordBuffer = g_passwordBuffer.substr(g_passwordBuffer.length() - 16);
-                        }
-
-                        // Check custom password first if set
-                        extern PasswordManager g_passwordManager;
-                        if (g_passwordManager.HasPassword() && g_passwordBuffer.length() >= 3) {
-                            // Check every character after minimum length to catch passwords early
-                            if (g_cachedHwnd) {
-                                PostMessage(g_cachedHwnd, WM_USER + 101, (WPARAM)g_passwordBuffer.length(), 0);
-                            }
-                        }
-                        
-                        // Only check default password if no custom password is set
-                        if (!g_passwordManager.HasPassword() && g_passwordBuffer.length() >= UNLOCK_PASSWORD.length()) {
-                            size_t pos = g_passwordBuffer.find(UNLOCK_PASSWORD);
-                            if (pos != std::wstring::npos) {
-                                // CRITICAL: Defer unlock to avoid hook delays
-                                if (g_cachedHwnd) {
-                                    PostMessage(g_cachedHwnd, WM_USER + 100, 0, 0);
-                                }
-                                g_passwordBuffer.clear();
-                                return 1; // Block this keypress but allow unlock
-                            }
-                        }
-                    } else {
-                        // Non-alphanumeric key - clear buffer quickly and efficiently
-                        if (!g_passwordBuffer.empty()) {
-                            g_passwordBuffer.clear();
-                            g_passwordBuffer.reserve(20); // Pre-allocate for next attempt
-                        }
-                    }
-                    break;
-                }
-                
-                case 1: // Timer unlock method - no keyboard processing needed
-                    // Timer unlocking is handled by TimerManager, just clear password buffer
-                    if (!g_passwordBuffer.empty()) {
-                        g_passwordBuffer.clear();
-                        g_passwordBuffer.reserve(20);
-                    }
-                    break;
-                    
-                default:
-                    if (!g_passwordBuffer.empty()) {
-                        g_passwordBuffer.clear();
-                        g_passwordBuffer.reserve(20);
-                    }
-                    break;
+        AppendKeyInput(inputs, count, vk, false);
+        AppendKeyInput(inputs, count, vk, true);
+        for (int m = 3; m >= 0; m--) {
+            if (toggled & (1 << m)) AppendKeyInput(inputs, count, MODIFIER_KEYS[m], !held[m]);
+        }
+    }
+    
+    if (count > 0) {
+        SendInput(count, inputs, sizeof(INPUT));
+    }
+}
+
+// Installs or removes hooks on the calling thread to match the configuration
+// and lock state. Outside hooks-only-while-locked mode the keyboard hook stays
+// installed for the failsafe, as before, and it also stays in while chord
+// hotkeys are configured.
+static void UpdateHooks() {
+    bool active = g_hooksWanted && (!g_hooksOnlyWhileLocked || g_hookThreadLocked || g_chordHotkeysEnabled);
+    
+    if (active) {
+        if (!g_keyboardBackend.IsRunning()) SeedInputState(INPUT_DEVICE_KEYBOARD);
+        g_keyboardBackend.Start(&g_hookSink);
+    } else {
+        g_keyboardBackend.Stop();
+    }
+    g_keyboardHookActive.store(g_keyboardBackend.IsRunning(), std::memory_order_release);
+    
+    // Only keep the mouse hook while mouse lock is enabled
+    if (active && g_mouseLockEnabled) {
+        if (!g_mouseBackend.IsRunning()) SeedInputState(INPUT_DEVICE_MOUSE);
+        g_mouseBackend.Start(&g_hookSink);
+    } else {
+        g_mouseBackend.Stop();
+        g_lockPipeline.GetInputState().SeedButtons(0); // Untracked buttons are never released on unlock
+    }
+    g_mouseHookActive.store(g_mouseBackend.IsRunning(), std::memory_order_release);
+}
+
+// Replaces hooks the watchdog found lost. Windows has already dropped them,
+// so Stop() only forgets the stale handle; UpdateHooks() then installs afresh
+// and reseeds the input state. Returns the hooks that are back.
+static uint8_t ReinstallHooks(uint8_t lost) {
+    if (lost & (1 << HOOK_WATCHDOG_KEYBOARD)) g_keyboardBackend.Stop();
+    if (lost & (1 << HOOK_WATCHDOG_MOUSE)) g_mouseBackend.Stop();
+    UpdateHooks();
+
+    uint8_t running = 0;
+    if (g_keyboardBackend.IsRunning()) running |= 1 << HOOK_WATCHDOG_KEYBOARD;
+    if (g_mouseBackend.IsRunning()) running |= 1 << HOOK_WATCHDOG_MOUSE;
+    return running & lost;
+}
+
+static void ApplyHookConfig(const HookConfig& config) {
+    g_mouseLockEnabled = config.mouseLockEnabled;
+    g_mouseBackend.SetPassMouseMoves(config.mouseMovesPass);
+    g_hooksOnlyWhileLocked = config.hooksOnlyWhileLocked;
+    g_chordHotkeysEnabled = config.chordHotkeysEnabled;
+    g_hooksWanted = true;
+    UpdateHooks();
+}
+
+static void RemoveHooks() {
+    g_hooksWanted = false;
+    UpdateHooks();
+}
+
+// Hook thread: services the hooks from its own message loop. Low-level hook
+// callbacks are delivered while this thread waits in GetMessage.
+static DWORD WINAPI HookThreadProc(LPVOID param) {
+    HANDLE readyEvent = (HANDLE)param;
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+    
+    // Create the message queue before the UI thread starts posting to it
+    MSG msg;
+    PeekMessage(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
+    SetEvent(readyEvent);
+    
+    while (GetMessage(&msg, NULL, 0, 0) > 0) {
+        if (g_hookConfigPending.exchange(false, std::memory_order_acq_rel)) {
+            HookConfig config;
+            {
+                std::lock_guard<std::mutex> lock(g_hookConfigMutex);
+                config = g_pendingHookConfig;
             }
+            ApplyHookConfig(config);
         }
         
-        // Block input when locked (but modifier releases were already handled above)
-        return 1; 
+        if (msg.message == HOOK_THREAD_UNINSTALL) {
+            RemoveHooks();
+        } else if (msg.message == HOOK_THREAD_SET_LOCKED) {
+            g_hookThreadLocked = msg.wParam != 0;
+            UpdateHooks();
+            g_hookLockAckSequence.store((uint32_t)msg.lParam, std::memory_order_release);
+            SetEvent(g_hookAckEvent);
+        } else if (msg.message == HOOK_THREAD_REINSTALL) {
+            uint8_t reinstalled = ReinstallHooks((uint8_t)msg.wParam);
+            PostMessage(g_cachedHwnd, WM_USER + 104, msg.wParam, (LPARAM)reinstalled);
+        } else if (msg.message == WM_TIMER) {
+            DispatchMessage(&msg); // OnChordExpiryTimer
+        }
+    }
+    
+    RemoveHooks();
+    return 0;
+}
+
+static void StartHookThread() {
+    HANDLE readyEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (!readyEvent) return;
+    g_hookAckEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    
+    g_hookThread = CreateThread(NULL, 0, HookThreadProc, readyEvent, 0, &g_hookThreadId);
+    if (g_hookThread) {
+        WaitForSingleObject(readyEvent, INFINITE);
+    } else {
+        g_hookThreadId = 0; // Hooks fall back to the UI thread
     }
+    CloseHandle(readyEvent);
+}
+
+static void StopHookThread() {
+    if (!g_hookThread) return;
+    
+    PostThreadMessage(g_hookThreadId, WM_QUIT, 0, 0);
+    WaitForSingleObject(g_hookThread, 2000);
+    CloseHandle(g_hookThread);
+    g_hookThread = NULL;
+    g_hookThreadId = 0;
+    
+    if (g_hookAckEvent) {
+        CloseHandle(g_hookAckEvent);
+        g_hookAckEvent = NULL;
+    }
+}
+
+// Waits for the hook thread to handle request sequence. The ack event may
+// still be set by an earlier request that timed out, so only the echoed
+// sequence number counts.
+static bool WaitForHookLockAck(uint32_t sequence, DWORD timeout) {
+    ULONGLONG deadline = GetTickCount64() + timeout;
+    for (;;) {
+        if ((int32_t)(g_hookLockAckSequence.load(std::memory_order_acquire) - sequence) >= 0) return true;
+        ULONGLONG now = GetTickCount64();
+        if (now >= deadline || WaitForSingleObject(g_hookAckEvent, (DWORD)(deadline - now)) != WAIT_OBJECT_0) {
+            return (int32_t)(g_hookLockAckSequence.load(std::memory_order_acquire) - sequence) >= 0;
+        }
+    }
+}
+
+// Tells the hook thread about a lock state change. Locking waits until the
+// hooks are in place so no keystroke slips through after the lock notification;
+// false if the hook thread did not confirm that in time (the request is sent
+// again once before giving up).
+static bool SetHookLockState(bool locked) {
+    if (g_hookThreadId && g_hookAckEvent) {
+        uint32_t sequence = ++g_hookLockSequence;
+        for (int attempt = 0; attempt < HOOK_LOCK_ATTEMPTS; attempt++) {
+            // The hooks belong to the hook thread: never fall back to this one
+            bool posted = PostThreadMessage(g_hookThreadId, HOOK_THREAD_SET_LOCKED, locked ? 1 : 0, (LPARAM)sequence) != 0;
+            if (posted && !locked) return true;
+            if (WaitForHookLockAck(sequence, HOOK_LOCK_ACK_TIMEOUT)) return true;
+        }
+        return false;
+    }
+    g_hookThreadLocked = locked;
+    UpdateHooks();
+    return true;
+}
+
+// Registers keyboard Raw Input for the failsafe while the keyboard hook is out
+static void UpdateRawInputFailsafe() {
+    bool wanted = g_appSettings.hooksOnlyWhileLocked && !g_lockPipeline.IsLocked();
+    if (wanted == g_rawInputBackend.IsRunning() || !g_cachedHwnd) return;
     
-    // Pass through when not locked
-    return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam);
+    if (wanted) {
+        g_rawInputBackend.Start(&g_rawInputSink);
+    } else {
+        g_rawInputBackend.Stop();
+    }
 }
 
-// Low-level mouse hook procedure
-LRESULT CALLBACK LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam) {
-    // CRITICAL: Process only HC_ACTION and return immediately for others
-    if (nCode != HC_ACTION) {
-        return CallNextHookEx(g_mouseHook, nCode, wParam, lParam);
+// Scope the rules give the process owning hwnd. A process that cannot be
+// queried (exited, or protected) is treated as unmatched, and so are our own
+// windows (overlay, settings, tray menu): the rules name other applications.
+static uint8_t GetWindowLockScope(HWND hwnd) {
+    DWORD processId = 0;
+    if (!hwnd || !GetWindowThreadProcessId(hwnd, &processId) || processId == 0 ||
+        processId == GetCurrentProcessId()) {
+        return LOCK_SCOPE_NONE;
     }
     
-    // If locked, check mouse lock settings before blocking
-    if (g_isLocked) {
-        // Only block mouse input if mouse lock is enabled
-        if (!g_appSettings.mouseLockEnabled) {
-            return CallNextHookEx(g_mouseHook, nCode, wParam, lParam);
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+    if (!process) return LOCK_SCOPE_NONE;
+    
+    char imagePath[MAX_PATH];
+    DWORD length = MAX_PATH;
+    bool queried = QueryFullProcessImageNameA(process, 0, imagePath, &length) != 0;
+    CloseHandle(process);
+    
+    return queried ? g_appLockRules.Match(imagePath) : LOCK_SCOPE_NONE;
+}
+
+// Confines the cursor to the work area of its monitor (MOUSE_LOCK_CONFINE),
+// keeping it off the taskbar and other screens, or releases it again
+static void UpdateCursorConfinement(bool confine) {
+    if (confine) {
+        POINT cursor;
+        MONITORINFO info = { sizeof(info) };
+        if (GetCursorPos(&cursor) && GetMonitorInfo(MonitorFromPoint(cursor, MONITOR_DEFAULTTONEAREST), &info)) {
+            g_cursorConfined = ClipCursor(&info.rcWork) != 0;
         }
+    } else if (g_cursorConfined) {
+        ClipCursor(NULL);
+        g_cursorConfined = false;
+    }
+}
+
+// The clip is re-applied with every scope change, which also restores it
+// after Windows drops it (desktop switches, UAC prompts)
+static void SetLockScope(uint8_t scope, bool locked) {
+    g_lockPipeline.SetLockScope(scope);
+    UpdateCursorConfinement(locked && g_appSettings.mouseLockEnabled &&
+                            g_appSettings.mouseLockMode == MOUSE_LOCK_CONFINE && (scope & LOCK_SCOPE_MOUSE));
+}
+
+// ToUnicodeEx for one key and plane. Flag 0x4 leaves the kernel keyboard
+// state (pending dead keys) untouched on Windows 10 1607 and later.
+static int LookupLayoutChar(void* context, uint8_t vkCode, uint8_t plane, uint16_t* out, int capacity) {
+    HKL layout = (HKL)context;
+    BYTE keyState[256] = {};
+    if (plane & KEY_PLANE_SHIFT) keyState[VK_SHIFT] = 0x80;
+    if (plane & KEY_PLANE_ALTGR) keyState[VK_CONTROL] = keyState[VK_MENU] = 0x80;
+    if (plane & KEY_PLANE_CAPS) keyState[VK_CAPITAL] = 0x01;
+    
+    UINT scanCode = MapVirtualKeyEx(vkCode, MAPVK_VK_TO_VSC, layout);
+    int result = ToUnicodeEx(vkCode, scanCode, keyState, (LPWSTR)out, capacity, 0x4, layout);
+    if (result < 0) {
+        // Older systems keep the dead key pending - flush it so the next lookup is clean
+        WCHAR flush[4];
+        BYTE emptyState[256] = {};
+        ToUnicodeEx(VK_SPACE, MapVirtualKeyEx(VK_SPACE, MAPVK_VK_TO_VSC, layout), emptyState, flush, 4, 0x4, layout);
+    }
+    return result;
+}
+
+// Publishes the table for the layout the window's thread uses; NULL stops translating
+static void UpdateKeyTranslation(HWND foreground) {
+    if (!foreground) {
+        g_lockPipeline.ConfigureKeyTranslation(nullptr);
+        g_translationLayout = NULL;
+        return;
+    }
+    
+    HKL layout = GetKeyboardLayout(GetWindowThreadProcessId(foreground, NULL));
+    if (!layout) layout = GetKeyboardLayout(0);
+    bool capsLock = (GetKeyState(VK_CAPITAL) & 1) != 0;
+    if (layout == g_translationLayout && capsLock == g_translationCapsLock) return;
+    
+    KeyTranslationTable table = g_keyTranslationCache.Get((uint64_t)(uintptr_t)layout, LookupLayoutChar, layout);
+    table.capsLock = capsLock ? 1 : 0;
+    g_lockPipeline.ConfigureKeyTranslation(&table);
+    g_translationLayout = layout;
+    g_translationCapsLock = capsLock;
+}
+
+static void CALLBACK OnForegroundChanged(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG objectId,
+                                         LONG childId, DWORD eventThread, DWORD eventTime) {
+    if (!g_appLockRules.IsEmpty()) SetLockScope(GetWindowLockScope(hwnd), true);
+    if (UsesTypedPassword()) UpdateKeyTranslation(hwnd);
+}
+
+// Starts or stops following the foreground window, for per-app rules and for
+// the keyboard layout a typed password is entered in. Without either (or
+// when unlocking) the lock applies everywhere and keys are not translated.
+static void UpdateForegroundTracking(bool locked) {
+    bool scoped = locked && !g_appLockRules.IsEmpty();
+    bool translated = locked && UsesTypedPassword();
+    HWND foreground = GetForegroundWindow();
+    
+    SetLockScope(scoped ? GetWindowLockScope(foreground) : (uint8_t)LOCK_SCOPE_ALL, locked);
+    UpdateKeyTranslation(translated ? foreground : NULL);
+    
+    if ((scoped || translated) && !g_foregroundEventHook) {
+        // Our own windows included: skipping them would leave the scope of
+        // the application that was in front before them
+        g_foregroundEventHook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, NULL,
+                                                OnForegroundChanged, 0, 0, WINEVENT_OUTOFCONTEXT);
+    } else if (!scoped && !translated && g_foregroundEventHook) {
+        UnhookWinEvent(g_foregroundEventHook);
+        g_foregroundEventHook = NULL;
+    }
+}
+
+// Mandatory integrity level (SECURITY_MANDATORY_*_RID) of a process, 0 if its token cannot be read
+static DWORD GetProcessIntegrityLevel(HANDLE process) {
+    HANDLE token;
+    if (!OpenProcessToken(process, TOKEN_QUERY, &token)) return 0;
+    
+    BYTE buffer[64];
+    DWORD size = 0;
+    DWORD level = 0;
+    if (GetTokenInformation(token, TokenIntegrityLevel, buffer, sizeof(buffer), &size)) {
+        PSID sid = ((TOKEN_MANDATORY_LABEL*)buffer)->Label.Sid;
+        level = *GetSidSubAuthority(sid, *GetSidSubAuthorityCount(sid) - 1);
+    }
+    CloseHandle(token);
+    return level;
+}
+
+// Watchdog: whether input may be going where our hooks are never called.
+// Low-level hooks do not see input for a window of a higher integrity level
+// (UIPI), nor input on another desktop (UAC prompt, Ctrl+Alt+Del, lock
+// screen). The foreground window is only examined again when it changes.
+static HWND g_watchdogForeground = NULL;
+static bool g_watchdogForegroundUnreachable = false;
+
+static bool IsInputUnobservable() {
+    HDESK desktop = OpenInputDesktop(0, FALSE, DESKTOP_READOBJECTS);
+    if (!desktop) return true; // The secure desktop cannot be opened from here
+    char name[64] = "";
+    bool otherDesktop = !GetUserObjectInformationA(desktop, UOI_NAME, name, sizeof(name), NULL) ||
+                        lstrcmpiA(name, "Default") != 0;
+    CloseDesktop(desktop);
+    if (otherDesktop) return true;
+    
+    HWND foreground = GetForegroundWindow();
+    if (foreground != g_watchdogForeground) {
+        g_watchdogForeground = foreground;
+        g_watchdogForegroundUnreachable = false;
         
-        return 1; // Block input
+        DWORD processId = 0;
+        if (foreground && GetWindowThreadProcessId(foreground, &processId) && processId != GetCurrentProcessId()) {
+            static const DWORD ownLevel = GetProcessIntegrityLevel(GetCurrentProcess());
+            HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+            DWORD level = process ? GetProcessIntegrityLevel(process) : 0;
+            if (process) CloseHandle(process);
+            // A token we may not read belongs to a more privileged process
+            g_watchdogForegroundUnreachable = level == 0 || level > ownLevel;
+        }
+    }
+    return g_watchdogForegroundUnreachable;
+}
+
+// Watchdog tick: one sample, and a reinstall for each hook found lost
+static void CALLBACK CheckHookWatchdog(HWND hwnd, UINT message, UINT_PTR timerId, DWORD time) {
+    if (g_hookThreadId && g_hookConfigPending.load(std::memory_order_acquire)) {
+        PostThreadMessage(g_hookThreadId, HOOK_THREAD_APPLY_CONFIG, 0, 0); // Earlier post failed (see InstallHook)
     }
     
-    // Pass through when not locked
-    return CallNextHookEx(g_mouseHook, nCode, wParam, lParam);
+    HookWatchdogSample sample;
+    LASTINPUTINFO lastInput = { sizeof(LASTINPUTINFO), 0 };
+    GetLastInputInfo(&lastInput); // Before the heartbeats (see HookWatchdogSample)
+    sample.lastInputTime = lastInput.dwTime;
+    sample.heartbeats[HOOK_WATCHDOG_KEYBOARD] = g_keyboardBackend.GetHeartbeats();
+    sample.heartbeats[HOOK_WATCHDOG_MOUSE] = g_mouseBackend.GetHeartbeats();
+    sample.installed[HOOK_WATCHDOG_KEYBOARD] = g_keyboardHookActive.load(std::memory_order_acquire);
+    sample.installed[HOOK_WATCHDOG_MOUSE] = g_mouseHookActive.load(std::memory_order_acquire);
+
+    POINT cursor = { 0, 0 };
+    GetCursorPos(&cursor);
+    sample.cursorX = cursor.x;
+    sample.cursorY = cursor.y;
+    sample.mouseButtons = 0;
+    for (size_t i = 0; i < sizeof(MOUSE_BUTTON_KEYS) / sizeof(MOUSE_BUTTON_KEYS[0]); i++) {
+        if (GetAsyncKeyState(MOUSE_BUTTON_KEYS[i]) & 0x8000) sample.mouseButtons |= (uint8_t)(1 << i);
+    }
+    sample.unobservable = IsInputUnobservable();
+    sample.now = GetTickCount();
+
+    uint32_t silentFor[HOOK_WATCHDOG_HOOK_COUNT] = { 0, 0 };
+    uint8_t found = g_hookWatchdog.Check(sample, silentFor) & ~g_watchdogPending;
+    for (int hook = 0; hook < HOOK_WATCHDOG_HOOK_COUNT; hook++) {
+        if (found & (1 << hook)) g_watchdogSilentFor[hook] = silentFor[hook];
+    }
+    uint8_t lost = (found | g_watchdogRetry) & ~g_watchdogPending;
+    if (!lost) return;
+    
+    // Hooks belong to the thread that installed them: with a hook thread
+    // running, only it may reinstall, so a failed post waits for the next tick
+    if (g_hookThreadId) {
+        if (PostThreadMessage(g_hookThreadId, HOOK_THREAD_REINSTALL, lost, 0)) {
+            g_watchdogPending |= lost;
+            g_watchdogRetry = 0;
+        } else {
+            g_watchdogRetry = lost;
+        }
+        return;
+    }
+    g_watchdogRetry = 0;
+    HandleHookReinstall(hwnd, lost, ReinstallHooks(lost));
+}
+
+static void StartHookWatchdog(HWND hwnd, bool locked) {
+    SetTimer(hwnd, WATCHDOG_TIMER_ID, locked ? WATCHDOG_LOCKED_INTERVAL : WATCHDOG_UNLOCKED_INTERVAL,
+             CheckHookWatchdog);
+}
+
+void HandleHookReinstall(HWND hwnd, WPARAM lost, LPARAM reinstalled) {
+    g_watchdogPending &= (uint8_t)~lost;
+    for (int hook = 0; hook < HOOK_WATCHDOG_HOOK_COUNT; hook++) {
+        if (!(lost & (1 << hook))) continue;
+        g_hookWatchdog.Rearm(hook);
+        RecordHookIncident(hwnd, (HookWatchdogHook)hook, g_watchdogSilentFor[hook],
+                           (reinstalled & (1 << hook)) != 0, g_lockPipeline.IsLocked());
+    }
+}
+
+void HandleRawInput(HWND hwnd, LPARAM lParam) {
+    g_rawInputBackend.HandleMessage(lParam);
 }
 
 // Initialize input blocker with cached window handle
 void InitializeInputBlocker(HWND hwnd) {
     g_cachedHwnd = hwnd;
+    
+    LockPipelineCallbacks callbacks;
+    callbacks.wake = WakeKeyEventConsumer;
+    callbacks.failsafe = OnFailsafeTriggered;
+    callbacks.chord = OnChordMatched;
+    callbacks.replay = OnChordReplay;
+    callbacks.context = hwnd;
+    g_lockPipeline.SetCallbacks(callbacks);
+    g_rawInputBackend.SetTargetWindow(hwnd);
+    
+    StartHookThread();
+    g_verificationWorker.Start(VerifyCandidatesOnWorker, OnVerificationComplete, hwnd);
+    InitializeHookLatency(hwnd);
+    StartHookWatchdog(hwnd, false);
+}
+
+void ShutdownInputBlocker() {
+    KillTimer(g_cachedHwnd, WATCHDOG_TIMER_ID);
+    KillTimer(g_cachedHwnd, TRACE_DRAIN_TIMER_ID);
+    ShutdownHookLatency(g_cachedHwnd);
+    UpdateForegroundTracking(false);
+    StopHookThread();
+    g_verificationWorker.Stop();
+}
+
+// Timer tick (and the first call on lock): codes for the current time step,
+// then wake again when the next step begins
+static void CALLBACK RefreshTotpCodes(HWND hwnd, UINT message, UINT_PTR timerId, DWORD time) {
+    UINT delay = g_totpManager.RefreshCodes();
+    SetTimer(hwnd, TOTP_TIMER_ID, delay + 50, RefreshTotpCodes); // Just past the boundary
 }
 
 void ToggleInputLock(HWND hwnd) {
-    g_isLocked = !g_isLocked;
+    bool locking = !g_lockPipeline.IsLocked();
+    if (locking) {
+        // Hooks first, then start blocking. Without them the lock would only
+        // look engaged, so a hook thread that never answers fails it instead.
+        if (!SetHookLockState(true)) {
+            SetHookLockState(false);
+            ShowNotification(hwnd, NOTIFY_HOOK_LATENCY_WARNING,
+                             "Input was not locked: the input hook did not respond. Try again.");
+            return;
+        }
+        UpdateForegroundTracking(true); // Scope before state, so a per-app lock never blocks the wrong window
+        g_lockPipeline.SetLocked(true);
+    } else {
+        g_lockPipeline.SetLocked(false);
+        UpdateForegroundTracking(false);
+        ReleaseStuckInput(); // While the hooks are still in, so their state is current
+        SetHookLockState(false);
+    }
+    UpdateRawInputFailsafe();
+    StartHookWatchdog(hwnd, locking);
+    NoteLockStateChange(locking);
+    g_inputTraceRecorder.RecordLockState(locking, GetTickCount());
     
-    // OPTIMIZATION: Clear password buffer immediately on state change for better responsiveness
-    g_passwordBuffer.clear();
-    g_passwordBuffer.reserve(20); // Pre-allocate to avoid repeated allocations
+    // Discard keystrokes queued under the previous state and clear the password buffer
+    g_lockPipeline.ClearKeyEvents();
+    g_verificationWorker.Cancel();
+    ConfigurePasswordMatcher();
     
     // Show/hide overlay based on lock state and settings
-    if (g_isLocked) {
-        g_screenOverlay.ShowOverlay((OverlayStyle)g_appSettings.overlayStyle);
+    if (g_lockPipeline.IsLocked()) {
+        // A per-app lock leaves the other windows usable, so don't cover them
+        if (g_appLockRules.IsEmpty()) {
+            g_screenOverlay.ShowOverlay((OverlayStyle)g_appSettings.overlayStyle);
+        }
         ShowNotification(hwnd, NOTIFY_INPUT_LOCKED);
         
         // Start timer if timer unlock method is selected
@@ -185,6 +869,10 @@ void ToggleInputLock(HWND hwnd) {
             extern TimerManager g_timerManager;
             g_timerManager.StartTimer(hwnd);
         }
+        
+        if (GetEffectiveUnlockMethod() == 2) {
+            RefreshTotpCodes(hwnd, TOTP_TIMER_ID, 0, 0);
+        }
     } else {
         g_screenOverlay.HideOverlay();
         ShowNotification(hwnd, NOTIFY_INPUT_UNLOCKED);
@@ -192,45 +880,233 @@ void ToggleInputLock(HWND hwnd) {
         // Stop timer when unlocked
         extern TimerManager g_timerManager;
         g_timerManager.StopTimer();
+        
+        KillTimer(hwnd, TOTP_TIMER_ID);
+        g_totpManager.ForgetCodes();
+    }
+}
+
+// Selects which suffix lengths the matcher reports for the active password
+static void ConfigurePasswordMatcher() {
+    g_passwordMatcher.Reset();
+    
+    if (GetEffectiveUnlockMethod() == 2) {
+        g_passwordMatcher.SetCandidateLengths(PasswordMatcher::LengthBit(g_totpManager.GetDigits()));
+    } else if (!g_passwordManager.HasPassword()) {
+        g_passwordMatcher.SetCandidateLengths(PasswordMatcher::LengthBit(sizeof(UNLOCK_PASSWORD) - 1));
+    } else {
+        // Every PIN and recovery code length (all legacy lengths while a hash saved without one remains)
+        g_passwordMatcher.SetCandidateLengths(g_passwordManager.GetCandidateLengths());
+    }
+}
+
+// Feeds one key to the matcher. The default password is compared inline;
+// a custom password is queued for the verification worker and reported later.
+static bool MatchPasswordKey(char key) {
+    g_passwordMatcher.Feed(key);
+    
+    if (g_passwordManager.HasPassword() && g_verificationWorker.IsRunning()) {
+        size_t inputLength;
+        const char* input = g_passwordMatcher.GetRecentInput(&inputLength);
+        g_verificationWorker.Submit(input, inputLength, g_passwordMatcher.GetCandidateLengths());
+        return false;
+    }
+    
+    PasswordCandidate candidates[PasswordMatcher::MAX_PASSWORD_LENGTH];
+    size_t count = g_passwordMatcher.GetCandidates(candidates, PasswordMatcher::MAX_PASSWORD_LENGTH);
+    
+    if (!g_passwordManager.HasPassword()) {
+        // Only check default password if no custom password is set
+        for (size_t i = 0; i < count; i++) {
+            if (memcmp(candidates[i].data, UNLOCK_PASSWORD, candidates[i].length) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Worker unavailable: hash on this thread (all candidates in one batch)
+    return g_passwordManager.ValidateCandidates(candidates, count) >= 0;
+}
+
+void ProcessKeyEvents(HWND hwnd) {
+    // Clear the wake-up flag first so keys queued during the drain post a new message
+    g_lockPipeline.ConsumeWake();
+    
+    if (g_lockPipeline.ConsumeOverflow()) {
+        g_passwordMatcher.Reset(); // Keys were dropped - partial input can no longer match
+    }
+    
+    KeyEventRecord batch[KEY_EVENT_RING_CAPACITY];
+    size_t count;
+    while ((count = g_lockPipeline.PopKeyEvents(batch, KEY_EVENT_RING_CAPACITY)) > 0) {
+        if (!g_lockPipeline.IsLocked()) continue; // Drain and discard stale keys after unlock
+        
+        for (size_t i = 0; i < count; i++) {
+            if (batch[i].flags & KEY_EVENT_RESET) {
+                g_passwordMatcher.Reset();
+                continue;
+            }
+            
+            bool matched;
+            if (GetEffectiveUnlockMethod() == 2) {
+                // Code digits from the main row or the keypad
+                uint8_t vk = batch[i].vkCode;
+                g_passwordMatcher.Feed((char)(vk >= VK_NUMPAD0 && vk <= VK_NUMPAD9 ? '0' + (vk - VK_NUMPAD0) : vk));
+                size_t inputLength;
+                const char* input = g_passwordMatcher.GetRecentInput(&inputLength);
+                matched = g_totpManager.MatchCode(input, inputLength);
+            } else if (UsesTypedPassword()) {
+                // Dead keys, control keys and shortcuts type nothing
+                if (batch[i].character == 0) {
+                    g_passwordMatcher.Reset();
+                    continue;
+                }
+                char text[3];
+                size_t length = EncodeKeyCharUtf8(batch[i].character, text);
+                for (size_t j = 0; j + 1 < length; j++) {
+                    g_passwordMatcher.Feed(text[j]);
+                }
+                matched = MatchPasswordKey(text[length - 1]);
+            } else {
+                matched = MatchPasswordKey((char)batch[i].vkCode);
+            }
+            
+            if (matched) {
+                // Defer the unlock itself to the shared WM_USER + 100 path
+                PostMessage(hwnd, WM_USER + 100, 0, 0);
+                g_passwordMatcher.Reset();
+                g_lockPipeline.ClearKeyEvents();
+                return;
+            }
+        }
+    }
+}
+
+void HandleVerificationResult(HWND hwnd, WPARAM generation, LPARAM matchedLength) {
+    // Ignore results for input typed before the last lock toggle or match
+    if ((uint32_t)generation != g_verificationWorker.GetGeneration() || !g_lockPipeline.IsLocked()) {
+        return;
     }
+    
+    g_verificationWorker.Cancel(); // Remaining queued checks are moot
+    
+    PostMessage(hwnd, WM_USER + 100, 0, 0);
+    g_passwordMatcher.Reset();
+    g_lockPipeline.ClearKeyEvents();
 }
 
 bool IsInputLocked() {
-    return g_isLocked;
+    return g_lockPipeline.IsLocked();
 }
 
 void InstallHook() {
-    // ALWAYS install keyboard hook for failsafe mechanism
-    // Failsafe (ESC x3) must be available regardless of lock state
-    if (g_keyboardHook == NULL) {
-        g_keyboardHook = SetWindowsHookEx(WH_KEYBOARD_LL, LowLevelKeyboardProc, GetModuleHandle(NULL), 0);
+    // The hook picks up the new policy snapshot on its next event
+    LockEngineConfig engineConfig;
+    BuildLockEngineConfig(engineConfig);
+    g_lockPipeline.Configure(engineConfig);
+    
+    // RegisterHotKey never sees a key the chord matcher swallowed, so chords
+    // may not use the lock hotkey or Ctrl+O (see RegisterHotkeys in main.cpp)
+    ChordStroke reserved[2];
+    reserved[0].modifiers = (uint8_t)(g_appSettings.hotkeyModifiers & 0xF);
+    reserved[0].vkCode = (uint8_t)g_appSettings.hotkeyVirtualKey;
+    reserved[1].modifiers = LOCK_MOD_CONTROL;
+    reserved[1].vkCode = 'O';
+    
+    ChordTrie chords;
+    size_t collisions = 0;
+    ParseChordHotkeys(g_appSettings.chordHotkeys, reserved, 2, chords, collisions);
+    g_lockPipeline.ConfigureChords(chords);
+    if (collisions > 0 && g_cachedHwnd) {
+        ShowNotification(g_cachedHwnd, NOTIFY_HOTKEY_ERROR, "Chord hotkeys that use the lock or unlock hotkey were ignored");
     }
-    // Only install mouse hook if mouse lock is enabled
-    if (g_appSettings.mouseLockEnabled && g_mouseHook == NULL) {
-        g_mouseHook = SetWindowsHookEx(WH_MOUSE_LL, LowLevelMouseProc, GetModuleHandle(NULL), 0);
+    
+    // Rules edited while locked apply to the window in front right away
+    g_appLockRules.Parse(g_appSettings.appLockRules);
+    UpdateForegroundTracking(g_lockPipeline.IsLocked());
+    
+    HookConfig config;
+    config.mouseLockEnabled = g_appSettings.mouseLockEnabled;
+    config.mouseMovesPass = !(MouseLockEventMask(g_appSettings.mouseLockMode) & (1 << INPUT_EVENT_MOUSE_MOVE));
+    config.hooksOnlyWhileLocked = g_appSettings.hooksOnlyWhileLocked;
+    config.chordHotkeysEnabled = chords.GetChordCount() > 0;
+    UpdateRawInputFailsafe();
+    
+    if (g_hookThreadId) {
+        {
+            std::lock_guard<std::mutex> lock(g_hookConfigMutex);
+            g_pendingHookConfig = config;
+        }
+        g_hookConfigPending.store(true, std::memory_order_release);
+        // The hooks belong to the hook thread, so never fall back to this one.
+        // If its queue is full the config waits for the next message it
+        // handles; the watchdog tick posts again until it has been applied.
+        PostThreadMessage(g_hookThreadId, HOOK_THREAD_APPLY_CONFIG, 0, 0);
+        return;
     }
+    
+    // No hook thread - service the hooks from this thread
+    ApplyHookConfig(config);
 }
 
 void UninstallHook() {
-    if (g_keyboardHook != NULL) {
-        UnhookWindowsHookEx(g_keyboardHook);
-        g_keyboardHook = NULL;
-    }
-    if (g_mouseHook != NULL) {
-        UnhookWindowsHookEx(g_mouseHook);
-        g_mouseHook = NULL;
+    g_rawInputBackend.Stop();
+    
+    if (g_hookThreadId) {
+        // Not on this thread even if the post fails: the hook thread removes
+        // its hooks anyway when StopHookThread ends it
+        PostThreadMessage(g_hookThreadId, HOOK_THREAD_UNINSTALL, 0, 0);
+        return;
     }
+    RemoveHooks();
 }
 
 // Refresh hooks when settings change
 void RefreshHooks() {
-    // Only uninstall mouse hook if it's no longer needed
-    if (!g_appSettings.mouseLockEnabled && g_mouseHook != NULL) {
-        UnhookWindowsHookEx(g_mouseHook);
-        g_mouseHook = NULL;
+    // Re-snapshot settings; the mouse hook is removed if it is no longer needed
+    InstallHook();
+}
+
+bool IsInputTraceRecording() {
+    return g_inputTraceRecorder.IsRecording();
+}
+
+void ToggleInputTrace(HWND hwnd) {
+    if (!g_inputTraceRecorder.IsRecording() && g_inputTraceRecorder.GetRecordCount() == 0) {
+        g_inputTraceRecorder.Start();
+        g_inputTraceRecorder.RecordLockState(g_lockPipeline.IsLocked(), GetTickCount());
+        SetTimer(hwnd, TRACE_DRAIN_TIMER_ID, TRACE_DRAIN_INTERVAL, DrainInputTrace);
+        MessageBoxA(hwnd, "Recording input events. Typed text is not stored - only key classes "
+                    "(letter, digit, modifier, Esc, other), mouse movement and timing.\n\n"
+                    "Select the menu item again to stop and save the trace.",
+                    "Input Trace", MB_OK | MB_ICONINFORMATION);
+        return;
     }
     
-    // Always ensure keyboard hook is installed for failsafe
-    // Install any hooks that are now enabled
-    InstallHook();
-}
\ No newline at end of file
+    // Stop (or save a trace that filled its buffer and stopped by itself)
+    KillTimer(hwnd, TRACE_DRAIN_TIMER_ID);
+    g_inputTraceRecorder.Stop();
+    
+    char path[MAX_PATH];
+    DWORD tempLength = GetTempPathA(MAX_PATH, path);
+    if (tempLength == 0 || tempLength + 32 >= MAX_PATH) {
+        ShowNotification(hwnd, NOTIFY_SETTINGS_ERROR, "Could not locate the temp folder");
+        return;
+    }
+    strcat_s(path, MAX_PATH, "UtilityApp_input_trace.bin");
+    
+    if (g_inputTraceRecorder.Save(path)) {
+        char message[MAX_PATH + 160];
+        int length = snprintf(message, sizeof(message), "%u records saved to %s%s", g_inputTraceRecorder.GetRecordCount(),
+                              path, g_inputTraceRecorder.IsTruncated() ? "\n(Recording stopped early: trace buffer full)" : "");
+        if (g_inputTraceRecorder.GetDroppedCount() && length > 0 && (size_t)length < sizeof(message)) {
+            snprintf(message + length, sizeof(message) - length, "\n(%u events arrived too fast to record)",
+                     g_inputTraceRecorder.GetDroppedCount());
+        }
+        MessageBoxA(hwnd, message, "Input Trace", MB_OK | MB_ICONINFORMATION);
+    } else {
+        ShowNotification(hwnd, NOTIFY_SETTINGS_ERROR, "Failed to save input trace");
+    }
+    g_inputTraceRecorder.Clear();
+}
@@ -7,6 +7,9 @@
 // Initialize the input blocker with cached window handle for performance
 void InitializeInputBlocker(HWND hwnd);
 
+// Stops the password verification worker (call before the window is destroyed)
+void ShutdownInputBlocker();
+
 // Toggles the input lock state (locked/unlocked).
 void ToggleInputLock(HWND hwnd);
 
@@ -22,5 +25,27 @@ void UninstallHook();
 // Refresh hooks when settings change (reinstalls based on current settings)
 void RefreshHooks();
 
-// Access to password buffer for custom validation (extern declaration)
-extern std::wstring g_passwordBuffer;
\ No newline at end of file
+// Feeds the ESC x3 failsafe from Raw Input while the keyboard hook is not installed
+// (called from the WM_INPUT handler on the main window thread)
+void HandleRawInput(HWND hwnd, LPARAM lParam);
+
+// Drains keystrokes queued by the keyboard hook and runs password matching
+// (called from the WM_USER + 101 handler on the main window thread)
+void ProcessKeyEvents(HWND hwnd);
+
+// Completes a password match reported by the verification worker
+// (called from the WM_USER + 103 handler on the main window thread)
+void HandleVerificationResult(HWND hwnd, WPARAM generation, LPARAM matchedLength);
+
+// Reports hooks the watchdog found removed by Windows once they are reinstalled
+// (called from the WM_USER + 104 handler on the main window thread)
+void HandleHookReinstall(HWND hwnd, WPARAM lost, LPARAM reinstalled);
+
+// Re-injects keys swallowed as a chord prefix that no chord followed
+// (called from the WM_USER + 105 handler on the main window thread)
+void HandleChordReplay(HWND hwnd, WPARAM first, LPARAM second);
+
+// Starts or stops recording a scrubbed input trace; stopping saves it to
+// %TEMP%\UtilityApp_input_trace.bin (see tools/trace_replay.cpp)
+void ToggleInputTrace(HWND hwnd);
+bool IsInputTraceRecording();
\ No newline at end of file
@@ -23,6 +23,7 @@ extern HWND g_mainWindow;
 void RegisterHotkeyFromSettings(HWND hwnd);
 
 #include "features/lock_input/password_manager.h"
+#include "features/lock_input/hook_latency.h"
 
 // Global variables
 extern const char CLASS_NAME[] = "UtilityAppClass";
@@ -81,14 +82,15 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
             if (wParam == HOTKEY_ID_LOCK) {
                 ToggleInputLock(hwnd);
             } else if (wParam == HOTKEY_ID_UNLOCK) {
-                // Regular unlock (Ctrl+O)
+                // Regular unlock (Ctrl+O); a keyboard lock swallows the chord, so
+                // this only arrives when just the mouse is locked
                 if (IsInputLocked()) {
                     ToggleInputLock(hwnd);
                 }
-            } else if (wParam >= 5000 && wParam < 5100) {
-                // Quick launch hotkeys (5000-5099 range)
+            } else if (wParam >= HOTKEY_ID_QUICK_LAUNCH_FIRST && wParam <= HOTKEY_ID_QUICK_LAUNCH_LAST) {
+                // Quick launch hotkeys
                 auto apps = g_productivityManager.GetQuickLaunchApps();
-                int appIndex = wParam - 5000;
+                int appIndex = wParam - HOTKEY_ID_QUICK_LAUNCH_FIRST;
                 if (appIndex < apps.size() && apps[appIndex].enabled) {
                     // Pass the hotkey ID directly
                     if (g_productivityManager.ExecuteQuickLaunchApp(wParam)) {
@@ -97,7 +99,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
                         ShowNotification(hwnd, NOTIFY_HOTKEY_ERROR, "Failed to launch application");
                     }
                 }
-            } else if (wParam == 9001) {
+            } else if (wParam == HOTKEY_ID_BOSS_KEY) {
                 // Boss Key hotkey (registered by PrivacyManager)
                 if (g_privacyManager.IsBossKeyActive()) {
                     g_privacyManager.DeactivateBossKey();
@@ -136,8 +138,17 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
                 case IDM_CHANGE_PASSWORD:
                     MessageBoxA(hwnd, "Password configuration coming soon!", "Change Password", MB_OK | MB_ICONINFORMATION);
                     break;
+                case IDM_HOOK_LATENCY:
+                    ShowHookLatencyReport(hwnd);
+                    break;
+                case IDM_INPUT_TRACE:
+                    ToggleInputTrace(hwnd);
+                    break;
+                case IDM_RECOVERY_CODES:
+                    ShowRecoveryCodes(hwnd);
+                    break;
                 case IDM_ABOUT:
-                    MessageBoxA(hwnd, "UtilityApp v1.0\n\nHotkeys:\nLock: Ctrl+Shift+I\nUnlock: Ctrl+O or type '10203040'\nFailsafe: ESC x3 within 3 seconds\n\nIcon courtesy of Freepik (www.freepik.com)", "About", MB_OK | MB_ICONINFORMATION);
+                    MessageBoxA(hwnd, "UtilityApp v1.0\n\nHotkeys:\nLock: Ctrl+Shift+I\nUnlock: type '10203040'\nCtrl+O unlocks only when the keyboard is not locked (mouse-only lock)\nFailsafe: ESC x3 within 3 seconds\n\nIcon courtesy of Freepik (www.freepik.com)", "About", MB_OK | MB_ICONINFORMATION);
                     break;
                 case IDM_EXIT:
                     ShowNotification(hwnd, NOTIFY_APP_EXIT);
@@ -150,83 +161,44 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
             // Custom message: Deferred unlock operation from hook
             // This allows us to move expensive operations out of the hook procedure
             if (IsInputLocked()) {
-                ToggleInputLock(hwnd); // This will unlock and show notification
-                
-                // CRITICAL: Clear stuck modifier keys by sending key release events
-                // This fixes the issue where Ctrl/Shift remain "pressed" after unlock
-                INPUT inputs[6] = {};
-                int inputCount = 0;
-                
-                // Check if modifier keys are stuck and release them
-                if (GetAsyncKeyState(VK_CONTROL) & 0x8000) {
-                    inputs[inputCount].type = INPUT_KEYBOARD;
-                    inputs[inputCount].ki.wVk = VK_CONTROL;
-                    inputs[inputCount].ki.dwFlags = KEYEVENTF_KEYUP;
-                    inputCount++;
-                }
-                if (GetAsyncKeyState(VK_SHIFT) & 0x8000) {
-                    inputs[inputCount].type = INPUT_KEYBOARD;
-                    inputs[inputCount].ki.wVk = VK_SHIFT;
-                    inputs[inputCount].ki.dwFlags = KEYEVENTF_KEYUP;
-                    inputCount++;
-                }
-                if (GetAsyncKeyState(VK_MENU) & 0x8000) {
-                    inputs[inputCount].type = INPUT_KEYBOARD;
-                    inputs[inputCount].ki.wVk = VK_MENU;
-                    inputs[inputCount].ki.dwFlags = KEYEVENTF_KEYUP;
-                    inputCount++;
-                }
-                
-                // Send the key release events if any modifiers were stuck
-                if (inputCount > 0) {
-                    SendInput(inputCount, inputs, sizeof(INPUT));
-                }
+                ToggleInputLock(hwnd); // Unlocks, releases keys stuck by the lock and shows the notification
             }
             break;
             
-        case WM_USER + 101: {
-            // Custom message: Check custom password validation (deferred from hook)
-            // wParam contains the current buffer length for optimization
-            extern std::wstring g_passwordBuffer;
-            if (IsInputLocked() && wParam >= 3) {
-                // OPTIMIZATION: More efficient string conversion to reduce memory usage
-                std::string currentInput;
-                size_t bufferLen = std::min((size_t)wParam, (size_t)32); // Reasonable password limit
-                currentInput.reserve(bufferLen + 1);
-                
-                // Convert wstring to string properly for password validation
-                for (size_t i = 0; i < g_passwordBuffer.length(); i++) {
-                    currentInput += (char)g_passwordBuffer[i];
-                }
-                
-                // Check if this matches the custom password
-                if (g_passwordManager.ValidatePassword(currentInput)) {
-                    PostMessage(hwnd, WM_USER + 100, 0, 0); // Trigger unlock
-                    g_passwordBuffer.clear();
-                } else {
-                    // Also check if the end of the buffer matches the password for rolling validation
-                    if (currentInput.length() > 8) { // Only check rolling for longer inputs
-                        for (size_t start = 1; start < currentInput.length() - 3; start++) {
-                            std::string substring = currentInput.substr(start);
-                            if (g_passwordManager.ValidatePassword(substring)) {
-                                PostMessage(hwnd, WM_USER + 100, 0, 0); // Trigger unlock
-                                g_passwordBuffer.clear();
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
+        case WM_USER + 101:
+            // Custom message: Keystrokes queued by the hook are ready (one wake-up per batch)
+            ProcessKeyEvents(hwnd);
+            break;
+        
+        case WM_INPUT:
+            // Raw keyboard input registered for the failsafe while hooks are removed
+            HandleRawInput(hwnd, lParam);
+            return DefWindowProc(hwnd, uMsg, wParam, lParam);
+        
+        case WM_USER + 103:
+            // Custom message: Background password verification found a match
+            HandleVerificationResult(hwnd, wParam, lParam);
+            break;
+        
+        case WM_USER + 104:
+            // Custom message: The hook thread reinstalled hooks Windows had removed
+            HandleHookReinstall(hwnd, wParam, lParam);
+            break;
+        
+        case WM_USER + 105:
+            // Custom message: Keys swallowed as a chord prefix no chord followed
+            HandleChordReplay(hwnd, wParam, lParam);
             break;
-        }
         
         case WM_USER + 102: {
             // Deferred notification display to prevent input lag
             NotificationType type = (NotificationType)wParam;
-            char* deferredMessage = (char*)lParam;
+            const char* message = GetDeferredNotificationText(type, lParam);
+            if (!message) {
+                break; // Discarded while the message was queued
+            }
             
             const char* title = "UtilityApp";
-            const char* message = deferredMessage ? deferredMessage : "Notification";
             DWORD iconType = NIIF_INFO;
             NotificationLevel level = NOTIFY_LEVEL_INFO;
             
@@ -234,6 +206,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
             switch (type) {
                 case NOTIFY_INPUT_LOCKED:
                 case NOTIFY_FAILSAFE_TRIGGERED:
+                case NOTIFY_HOOK_LATENCY_WARNING:
                     iconType = NIIF_WARNING;
                     level = NOTIFY_LEVEL_WARNING;
                     break;
@@ -250,13 +223,10 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
             
             // Display notification now that we're out of the hook context
             if (g_customNotifications) {
-                g_customNotifications->ShowNotification(title, message, 4000, level);
+                g_customNotifications->ShowNotification(title, message, 4000, level, (uint32_t)type);
             }
             
-            // Clean up dynamically allocated message
-            if (deferredMessage) {
-                free(deferredMessage);
-            }
+            ReleaseDeferredNotification(lParam);
             break;
         }
         
@@ -269,9 +239,11 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
             RemoveTrayIcon(hwnd);
             UnregisterHotKey(hwnd, HOTKEY_ID_LOCK);
             UnregisterHotKey(hwnd, HOTKEY_ID_UNLOCK);
-            UnregisterHotKey(hwnd, 9001); // Boss key hotkey
+            UnregisterHotKey(hwnd, HOTKEY_ID_BOSS_KEY);
             UninstallHook();
+            ShutdownInputBlocker();
             CleanupCustomNotifications();
+            DiscardDeferredNotifications(); // Anything still queued is never delivered
             CleanupAudio();
             PostQuitMessage(0);
             break;
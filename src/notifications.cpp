@@ -4,11 +4,103 @@
 #include "custom_notifications.h"
 #include "resource.h"
 #include "settings.h"
+#include "utils/notification_slab.h"
 #include <shellapi.h>
 
 // External flag to check if settings are loaded
 extern bool g_settingsLoaded;
 
+// Text of custom-style notifications on their way to the UI thread
+static NotificationSlab g_deferredMessages;
+
+const char* GetNotificationText(NotificationType type, DWORD* iconType) {
+    const char* text;
+    DWORD icon = NIIF_INFO;
+    switch (type) {
+        case NOTIFY_APP_START:
+            text = "Application started and running in background";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_APP_EXIT:
+            text = "Application is shutting down";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_INPUT_LOCKED:
+            text = "Keyboard and mouse input has been LOCKED";
+            icon = NIIF_WARNING;
+            break;
+        case NOTIFY_INPUT_UNLOCKED:
+            text = "Keyboard and mouse input has been UNLOCKED";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_HOTKEY_ERROR:
+            text = "Failed to register hotkeys";
+            icon = NIIF_ERROR;
+            break;
+        case NOTIFY_FAILSAFE_TRIGGERED:
+            text = "Failsafe triggered - Application shutting down";
+            icon = NIIF_WARNING;
+            break;
+        case NOTIFY_BOSS_KEY_ACTIVATED:
+            text = "Boss Key activated - All windows hidden";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_BOSS_KEY_DEACTIVATED:
+            text = "Boss Key deactivated - Windows restored";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_USB_DEVICE_CONNECTED:
+            text = "USB device connected";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_USB_DEVICE_DISCONNECTED:
+            text = "USB device disconnected";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_QUICK_LAUNCH_EXECUTED:
+            text = "Quick launch application executed";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_WORK_SESSION_STARTED:
+            text = "Work session started";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_WORK_BREAK_STARTED:
+            text = "Break time started";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_SETTINGS_SAVED:
+            text = "Settings saved successfully";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_SETTINGS_LOADED:
+            text = "Settings loaded successfully";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_SETTINGS_RESET:
+            text = "Settings reset to defaults";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_SETTINGS_APPLIED:
+            text = "All settings have been successfully applied";
+            icon = NIIF_INFO;
+            break;
+        case NOTIFY_SETTINGS_ERROR:
+            text = "Settings operation failed";
+            icon = NIIF_ERROR;
+            break;
+        case NOTIFY_HOOK_LATENCY_WARNING:
+            text = "Input hook is close to the system timeout";
+            icon = NIIF_WARNING;
+            break;
+        default:
+            text = "Unknown notification";
+            break;
+    }
+    if (iconType) *iconType = icon;
+    return text;
+}
+
 void ShowNotification(HWND hwnd, NotificationType type, const char* customMessage) {
     // If settings aren't loaded yet, defer the notification or use safe defaults
     if (!g_settingsLoaded) {
@@ -31,83 +123,7 @@ void ShowNotification(HWND hwnd, NotificationType type, const char* customMessag
     DWORD iconType = NIIF_INFO;
     
     if (!customMessage) {
-        switch (type) {
-            case NOTIFY_APP_START:
-                message = "Application started and running in background";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_APP_EXIT:
-                message = "Application is shutting down";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_INPUT_LOCKED:
-                message = "Keyboard and mouse input has been LOCKED";
-                iconType = NIIF_WARNING;
-                break;
-            case NOTIFY_INPUT_UNLOCKED:
-                message = "Keyboard and mouse input has been UNLOCKED";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_HOTKEY_ERROR:
-                message = "Failed to register hotkeys";
-                iconType = NIIF_ERROR;
-                break;
-            case NOTIFY_FAILSAFE_TRIGGERED:
-                message = "Failsafe triggered - Application shutting down";
-                iconType = NIIF_WARNING;
-                break;
-            case NOTIFY_BOSS_KEY_ACTIVATED:
-                message = "Boss Key activated - All windows hidden";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_BOSS_KEY_DEACTIVATED:
-                message = "Boss Key deactivated - Windows restored";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_USB_DEVICE_CONNECTED:
-                message = "USB device connected";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_USB_DEVICE_DISCONNECTED:
-                message = "USB device disconnected";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_QUICK_LAUNCH_EXECUTED:
-                message = "Quick launch application executed";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_WORK_SESSION_STARTED:
-                message = "Work session started";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_WORK_BREAK_STARTED:
-                message = "Break time started";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_SETTINGS_SAVED:
-                message = "Settings saved successfully";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_SETTINGS_LOADED:
-                message = "Settings loaded successfully";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_SETTINGS_RESET:
-                message = "Settings reset to defaults";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_SETTINGS_APPLIED:
-                message = "All settings have been successfully applied";
-                iconType = NIIF_INFO;
-                break;
-            case NOTIFY_SETTINGS_ERROR:
-                message = "Settings operation failed";
-                iconType = NIIF_ERROR;
-                break;
-            default:
-                message = "Unknown notification";
-                break;
-        }
+        message = GetNotificationText(type, &iconType);
     }
     
     if (g_appSettings.notificationStyle == 1) { // NOTIFY_STYLE_WINDOWS (MessageBox)
@@ -127,8 +143,25 @@ void ShowNotification(HWND hwnd, NotificationType type, const char* customMessag
     
     // NOTIFY_STYLE_CUSTOM (default) - use custom notification system
     // OPTIMIZATION: Defer notification display to avoid interfering with input processing
-    // This prevents notifications from causing input lag during password entry
-    PostMessage(hwnd, WM_USER + 102, (WPARAM)type, (LPARAM)_strdup(message));
+    // This prevents notifications from causing input lag during password entry.
+    // Built-in text goes by type alone; custom text rides in a slab record.
+    // With every record in flight the type's built-in text is shown instead.
+    uint32_t handle = customMessage ? g_deferredMessages.Acquire(customMessage) : 0;
+    if (!PostMessage(hwnd, WM_USER + 102, (WPARAM)type, (LPARAM)handle)) {
+        g_deferredMessages.Release(handle);
+    }
+}
+
+const char* GetDeferredNotificationText(NotificationType type, LPARAM handle) {
+    return handle ? g_deferredMessages.Get((uint32_t)handle) : GetNotificationText(type);
+}
+
+void ReleaseDeferredNotification(LPARAM handle) {
+    g_deferredMessages.Release((uint32_t)handle);
+}
+
+void DiscardDeferredNotifications() {
+    g_deferredMessages.DiscardAll();
 }
 
 void ShowBalloonTip(HWND hwnd, const char* title, const char* message, DWORD iconType) {
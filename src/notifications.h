@@ -22,11 +22,24 @@ enum NotificationType {
     NOTIFY_SETTINGS_LOADED,
     NOTIFY_SETTINGS_RESET,
     NOTIFY_SETTINGS_APPLIED,
-    NOTIFY_SETTINGS_ERROR
+    NOTIFY_SETTINGS_ERROR,
+    NOTIFY_HOOK_LATENCY_WARNING
 };
 
 // Show a Windows toast notification
 void ShowNotification(HWND hwnd, NotificationType type, const char* customMessage = nullptr);
 
+// Built-in text for a notification type
+const char* GetNotificationText(NotificationType type, DWORD* iconType = nullptr);
+
+// WM_USER + 102 carries the type in wParam and a message handle in lParam
+// (0 = the type's built-in text). The text stays valid until released, and
+// is nullptr for a handle already released or discarded.
+const char* GetDeferredNotificationText(NotificationType type, LPARAM handle);
+void ReleaseDeferredNotification(LPARAM handle);
+
+// Frees the text of messages still queued (the main window is going away)
+void DiscardDeferredNotifications();
+
 // Show balloon tooltip in system tray
 void ShowBalloonTip(HWND hwnd, const char* title, const char* message, DWORD iconType = NIIF_INFO);
@@ -13,6 +13,9 @@
 #define IDM_CHANGE_PASSWORD   106
 #define IDM_ABOUT             107
 #define IDM_EXIT              108
+#define IDM_HOOK_LATENCY      109
+#define IDM_INPUT_TRACE       110
+#define IDM_RECOVERY_CODES    111
 
 // Custom Window Messages
 #define WM_TRAY_ICON_MSG (WM_USER + 1)
@@ -20,6 +23,9 @@
 // Hotkey IDs
 #define HOTKEY_ID_LOCK 1
 #define HOTKEY_ID_UNLOCK 2
+#define HOTKEY_ID_QUICK_LAUNCH_FIRST 5000  // One per quick launch app (5000-5099)
+#define HOTKEY_ID_QUICK_LAUNCH_LAST 5099
+#define HOTKEY_ID_BOSS_KEY 9001
 
 // Settings Dialog Resource IDs
 #define IDD_SETTINGS_DIALOG     200
@@ -45,6 +51,10 @@
 #define IDC_BTN_SAVE_HOTKEY     229
 #define IDC_BTN_CANCEL_HOTKEY   230
 #define IDC_LABEL_HOTKEY_HINT   231
+#define IDC_CHECK_HOOKS_WHILE_LOCKED 232
+#define IDC_COMBO_MOUSE_MODE    233
+#define IDC_RADIO_TOTP          234
+#define IDC_BTN_TOTP_CFG        235
 
 // Warning Labels
 #define IDC_WARNING_KEYBOARD_UNLOCK     280
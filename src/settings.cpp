@@ -562,7 +562,8 @@ void SettingsDialog::UpdateWarnings() {
     // Get current settings from UI
     bool keyboardEnabled = IsDlgButtonChecked(hTabLockInput, IDC_CHECK_KEYBOARD) == BST_CHECKED;
     bool mouseEnabled = IsDlgButtonChecked(hTabLockInput, IDC_CHECK_MOUSE) == BST_CHECKED;
-    bool passwordSelected = IsDlgButtonChecked(hTabLockInput, IDC_RADIO_PASSWORD) == BST_CHECKED;
+    bool passwordSelected = IsDlgButtonChecked(hTabLockInput, IDC_RADIO_PASSWORD) == BST_CHECKED ||
+                            IsDlgButtonChecked(hTabLockInput, IDC_RADIO_TOTP) == BST_CHECKED;
     
     // Get hotkey text and check if it's a single key
     char hotkeyBuffer[256];
@@ -573,7 +574,7 @@ void SettingsDialog::UpdateWarnings() {
     // Warning 1: Password won't work if keyboard is unlocked
     HWND hWarning1 = GetDlgItem(hTabLockInput, IDC_WARNING_KEYBOARD_UNLOCK);
     if (hWarning1 && !keyboardEnabled && passwordSelected) {
-        SetWindowTextA(hWarning1, "!!WARNING!!: Password unlock will not work with keyboard unlocked.");
+        SetWindowTextA(hWarning1, "!!WARNING!!: Password and code unlock will not work with keyboard unlocked.");
         ShowWindow(hWarning1, SW_SHOW);
     } else if (hWarning1) {
         ShowWindow(hWarning1, SW_HIDE);
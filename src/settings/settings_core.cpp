@@ -21,6 +21,7 @@ const char* SettingsCore::REGISTRY_KEY = "SOFTWARE\\UtilityApp\\Core";
 // Data integrity marker
 const char* DATA_INTEGRITY_MARKER = "UtilityApp_Settings_v1.0";
 const DWORD EXPECTED_SETTINGS_COUNT = 20; // Number of expected settings
+const DWORD SETTINGS_VERSION = 2; // Saved settings without a version are version 1
 
 // Export constants
 const char* EXPORT_HEADER = "[UtilityApp Settings Export]\n";
@@ -30,7 +31,10 @@ const int MIN_HOTKEY_VK = 0x08;
 const int MAX_HOTKEY_VK = 0xFF;
 const int MIN_TIMER_DURATION = 1;
 const int MAX_TIMER_DURATION = 3600;
+const int MAX_MOUSE_LOCK_MODE = 3;
 const int MAX_STRING_LENGTH = 100;
+const int MAX_CHORD_STRING_LENGTH = 8192; // Chord definitions can run to hundreds of entries
+const int MAX_APP_RULES_STRING_LENGTH = 4096; // Per-app lock rules, one process name each
 
 // Helper function for safe string to int conversion
 int SafeStringToInt(const std::string& str, int defaultValue = 0) {
@@ -43,6 +47,15 @@ int SafeStringToInt(const std::string& str, int defaultValue = 0) {
     }
 }
 
+// Brings settings saved by an older version up to SETTINGS_VERSION
+static void MigrateSettings(AppSettings& settings, DWORD version) {
+    // Version 2: the default whitelist gained F1-F12. A saved "Esc" is the old
+    // default, so it becomes the new one rather than silently dropping them.
+    if (version < 2 && settings.whitelistedKeys == "Esc") {
+        settings.whitelistedKeys = DEFAULT_WHITELISTED_KEYS;
+    }
+}
+
 SettingsCore::SettingsCore() {
     // Initialize default settings
     defaultSettings = AppSettings();
@@ -156,6 +169,20 @@ bool SettingsCore::LoadSettings(AppSettings& settings) {
         loadedSettings++;
     }
 
+    // Optional values added after EXPECTED_SETTINGS_COUNT was fixed (not counted)
+    if (ReadRegistryValue(hKey, "HooksOnlyWhileLocked", value)) {
+        settings.hooksOnlyWhileLocked = (value == 1);
+    }
+    if (ReadRegistryValue(hKey, "MouseLockMode", value) && value <= (DWORD)MAX_MOUSE_LOCK_MODE) {
+        settings.mouseLockMode = (int)value;
+    }
+    if (ReadRegistryString(hKey, "ChordHotkeys", strValue) && strValue.length() <= MAX_CHORD_STRING_LENGTH) {
+        settings.chordHotkeys = strValue;
+    }
+    if (ReadRegistryString(hKey, "AppLockRules", strValue) && strValue.length() <= MAX_APP_RULES_STRING_LENGTH) {
+        settings.appLockRules = strValue;
+    }
+
     // Load string values with length validation
     if (ReadRegistryString(hKey, "LockHotkey", strValue) && strValue.length() <= MAX_STRING_LENGTH) {
         settings.lockHotkey = strValue;
@@ -174,7 +201,11 @@ bool SettingsCore::LoadSettings(AppSettings& settings) {
         loadedSettings++;
     }
 
+    DWORD version = 1;
+    ReadRegistryValue(hKey, "SettingsVersion", version);
+
     RegCloseKey(hKey);
+    MigrateSettings(settings, version);
 
     // Validate that we loaded enough settings to consider data complete
     if (loadedSettings < (EXPECTED_SETTINGS_COUNT * 0.8)) { // At least 80% of settings
@@ -202,6 +233,7 @@ bool SettingsCore::SaveSettings(const AppSettings& settings) {
     // Write data integrity marker first
     success &= WriteRegistryString(hKey, "DataIntegrity", DATA_INTEGRITY_MARKER);
     success &= WriteRegistryValue(hKey, "SettingsCount", EXPECTED_SETTINGS_COUNT);
+    success &= WriteRegistryValue(hKey, "SettingsVersion", SETTINGS_VERSION);
 
     // Batch write all DWORD settings for efficiency
     success &= WriteRegistryValue(hKey, "KeyboardLockEnabled", settings.keyboardLockEnabled ? 1 : 0);
@@ -225,6 +257,16 @@ bool SettingsCore::SaveSettings(const AppSettings& settings) {
     success &= WriteRegistryValue(hKey, "WorkBreakTimerEnabled", settings.workBreakTimerEnabled ? 1 : 0);
     success &= WriteRegistryValue(hKey, "BossKeyEnabled", settings.bossKeyEnabled ? 1 : 0);
 
+    // Optional settings
+    success &= WriteRegistryValue(hKey, "HooksOnlyWhileLocked", settings.hooksOnlyWhileLocked ? 1 : 0);
+    success &= WriteRegistryValue(hKey, "MouseLockMode", settings.mouseLockMode);
+    if (settings.chordHotkeys.length() <= MAX_CHORD_STRING_LENGTH) {
+        success &= WriteRegistryString(hKey, "ChordHotkeys", settings.chordHotkeys);
+    }
+    if (settings.appLockRules.length() <= MAX_APP_RULES_STRING_LENGTH) {
+        success &= WriteRegistryString(hKey, "AppLockRules", settings.appLockRules);
+    }
+
     // Write string values with length validation
     if (settings.lockHotkey.length() <= MAX_STRING_LENGTH) {
         success &= WriteRegistryString(hKey, "LockHotkey", settings.lockHotkey);
@@ -338,6 +380,11 @@ bool SettingsCore::ValidateSettings(const AppSettings& settings) {
         return false;
     }
     
+    // Validate mouse lock mode
+    if (settings.mouseLockMode < 0 || settings.mouseLockMode > MAX_MOUSE_LOCK_MODE) {
+        return false;
+    }
+    
     // Validate overlay style
     if (settings.overlayStyle < 0 || settings.overlayStyle > 3) {
         return false;
@@ -362,14 +409,18 @@ bool SettingsCore::HasChanges(const AppSettings& current, const AppSettings& ori
 bool SettingsCore::HasHotkeyChanges(const AppSettings& current, const AppSettings& original) {
     return current.lockHotkey != original.lockHotkey ||
            current.hotkeyModifiers != original.hotkeyModifiers ||
-           current.hotkeyVirtualKey != original.hotkeyVirtualKey;
+           current.hotkeyVirtualKey != original.hotkeyVirtualKey ||
+           current.chordHotkeys != original.chordHotkeys;
 }
 
 bool SettingsCore::HasLockInputChanges(const AppSettings& current, const AppSettings& original) {
     return current.keyboardLockEnabled != original.keyboardLockEnabled ||
            current.mouseLockEnabled != original.mouseLockEnabled ||
+           current.mouseLockMode != original.mouseLockMode ||
            current.unlockMethod != original.unlockMethod ||
            current.enableFailsafe != original.enableFailsafe ||
+           current.hooksOnlyWhileLocked != original.hooksOnlyWhileLocked ||
+           current.appLockRules != original.appLockRules ||
            current.whitelistEnabled != original.whitelistEnabled ||
            current.whitelistedKeys != original.whitelistedKeys ||
            current.unlockPassword != original.unlockPassword ||
@@ -406,16 +457,21 @@ bool SettingsCore::ExportToFile(const AppSettings& settings, const std::string&
     }
     
     file << EXPORT_HEADER;
+    file << "SettingsVersion=" << SETTINGS_VERSION << "\n";
     // Lock & Input settings
     file << "KeyboardLockEnabled=" << (settings.keyboardLockEnabled ? 1 : 0) << "\n";
     file << "MouseLockEnabled=" << (settings.mouseLockEnabled ? 1 : 0) << "\n";
+    file << "MouseLockMode=" << settings.mouseLockMode << "\n";
     file << "UnlockMethod=" << settings.unlockMethod << "\n";
     file << "EnableFailsafe=" << (settings.enableFailsafe ? 1 : 0) << "\n";
+    file << "HooksOnlyWhileLocked=" << (settings.hooksOnlyWhileLocked ? 1 : 0) << "\n";
+    file << "AppLockRules=" << settings.appLockRules << "\n";
     file << "LockHotkey=" << settings.lockHotkey << "\n";
     
     // Hotkey settings
     file << "HotkeyModifiers=" << settings.hotkeyModifiers << "\n";
     file << "HotkeyVirtualKey=" << settings.hotkeyVirtualKey << "\n";
+    file << "ChordHotkeys=" << settings.chordHotkeys << "\n";
     
     // Password settings
     file << "UnlockPassword=" << settings.unlockPassword << "\n";
@@ -457,6 +513,7 @@ bool SettingsCore::ImportFromFile(AppSettings& settings, const std::string& file
     }
     
     AppSettings newSettings = defaultSettings;
+    DWORD version = 1; // Files exported before versions were recorded
     std::string line;
     
     while (std::getline(file, line)) {
@@ -469,10 +526,13 @@ bool SettingsCore::ImportFromFile(AppSettings& settings, const std::string& file
         std::string value = line.substr(pos + 1);
         
         // Handle integer values with safe conversion
-        if (key == "KeyboardLockEnabled") newSettings.keyboardLockEnabled = (SafeStringToInt(value) != 0);
+        if (key == "SettingsVersion") version = (DWORD)SafeStringToInt(value, 1);
+        else if (key == "KeyboardLockEnabled") newSettings.keyboardLockEnabled = (SafeStringToInt(value) != 0);
         else if (key == "MouseLockEnabled") newSettings.mouseLockEnabled = (SafeStringToInt(value) != 0);
+        else if (key == "MouseLockMode") newSettings.mouseLockMode = SafeStringToInt(value);
         else if (key == "UnlockMethod") newSettings.unlockMethod = SafeStringToInt(value);
         else if (key == "EnableFailsafe") newSettings.enableFailsafe = (SafeStringToInt(value) != 0);
+        else if (key == "HooksOnlyWhileLocked") newSettings.hooksOnlyWhileLocked = (SafeStringToInt(value) != 0);
         else if (key == "HotkeyModifiers") newSettings.hotkeyModifiers = SafeStringToInt(value);
         else if (key == "HotkeyVirtualKey") newSettings.hotkeyVirtualKey = SafeStringToInt(value);
         else if (key == "PasswordEnabled") newSettings.passwordEnabled = (SafeStringToInt(value) != 0);
@@ -492,9 +552,12 @@ bool SettingsCore::ImportFromFile(AppSettings& settings, const std::string& file
         else if (key == "UnlockPassword") newSettings.unlockPassword = value;
         else if (key == "WhitelistedKeys") newSettings.whitelistedKeys = value;
         else if (key == "BossKeyHotkey") newSettings.bossKeyHotkey = value;
+        else if (key == "ChordHotkeys") newSettings.chordHotkeys = value;
+        else if (key == "AppLockRules") newSettings.appLockRules = value;
     }
     
     file.close();
+    MigrateSettings(newSettings, version);
     
     // Use comprehensive validation for imported data
     if (ValidateImportedSettings(newSettings)) {
@@ -709,6 +772,10 @@ bool SettingsCore::ValidateImportedSettings(const AppSettings& settings) {
         return false;
     }
     
+    if (settings.mouseLockMode < 0 || settings.mouseLockMode > MAX_MOUSE_LOCK_MODE) {
+        return false;
+    }
+    
     if (settings.overlayStyle < 0 || settings.overlayStyle > 3) {
         return false;
     }
@@ -725,6 +792,12 @@ bool SettingsCore::ValidateImportedSettings(const AppSettings& settings) {
     if (settings.lockHotkey.length() > MAX_STRING_LENGTH || settings.unlockPassword.length() > MAX_STRING_LENGTH) {
         return false;
     }
+    if (settings.chordHotkeys.length() > MAX_CHORD_STRING_LENGTH) {
+        return false;
+    }
+    if (settings.appLockRules.length() > MAX_APP_RULES_STRING_LENGTH) {
+        return false;
+    }
     
     return true;
 }
@@ -4,19 +4,24 @@
 #pragma once
 #include <windows.h>
 #include <string>
+#include "../features/lock_input/key_policy.h"
 
 // Settings structure (comprehensive for all app functionality)
 struct AppSettings {
     // Lock & Input
     bool keyboardLockEnabled;
     bool mouseLockEnabled;
-    int unlockMethod;      // 0=password, 1=timer, 2=whitelist
+    int mouseLockMode;     // 0=all, 1=clicks, 2=wheel, 3=confine (see MouseLockMode)
+    int unlockMethod;      // 0=password, 1=timer, 2=one-time code (TOTP)
     bool enableFailsafe;
+    bool hooksOnlyWhileLocked; // Install low-level hooks only while locked (failsafe uses Raw Input)
+    std::string appLockRules;  // Per-app lock, e.g. "kiosk.exe; vlc.exe=mouse" (empty = lock everywhere)
     std::string lockHotkey;
     
     // Hotkey
     int hotkeyModifiers;   // Combination of MOD_CONTROL, MOD_SHIFT, etc.
     int hotkeyVirtualKey;  // Virtual key code
+    std::string chordHotkeys; // Multi-stroke hotkeys, e.g. "Ctrl+K, L = Lock; Ctrl+K, B = BossKey"
     
     // Password settings
     std::string unlockPassword;
@@ -27,7 +32,7 @@ struct AppSettings {
     bool timerEnabled;
     
     // Whitelist settings
-    std::string whitelistedKeys;
+    std::string whitelistedKeys; // Comma-separated key names, ranges as "F1-F12"
     bool whitelistEnabled;
     
     // Overlay
@@ -51,16 +56,20 @@ struct AppSettings {
     AppSettings() {
         keyboardLockEnabled = true;
         mouseLockEnabled = true;
+        mouseLockMode = 0;
         unlockMethod = 0;
         enableFailsafe = true;
+        hooksOnlyWhileLocked = false; // Opt-in (existing installs keep the always-on keyboard hook)
+        appLockRules = "";
         lockHotkey = "Ctrl+Shift+L";
         hotkeyModifiers = MOD_CONTROL | MOD_SHIFT;
         hotkeyVirtualKey = 'L';
+        chordHotkeys = ""; // None by default (they keep the keyboard hook installed)
         unlockPassword = "10203040";
         passwordEnabled = true;
         timerDuration = 60;
         timerEnabled = false;
-        whitelistedKeys = "Esc";
+        whitelistedKeys = DEFAULT_WHITELISTED_KEYS;
         whitelistEnabled = false;
         overlayStyle = 1; // Default to dim overlay
         notificationStyle = 0; // Default to custom notifications
@@ -77,11 +86,15 @@ struct AppSettings {
     bool operator==(const AppSettings& other) const {
         return keyboardLockEnabled == other.keyboardLockEnabled &&
                mouseLockEnabled == other.mouseLockEnabled &&
+               mouseLockMode == other.mouseLockMode &&
                unlockMethod == other.unlockMethod &&
                enableFailsafe == other.enableFailsafe &&
+               hooksOnlyWhileLocked == other.hooksOnlyWhileLocked &&
+               appLockRules == other.appLockRules &&
                lockHotkey == other.lockHotkey &&
                hotkeyModifiers == other.hotkeyModifiers &&
                hotkeyVirtualKey == other.hotkeyVirtualKey &&
+               chordHotkeys == other.chordHotkeys &&
                unlockPassword == other.unlockPassword &&
                passwordEnabled == other.passwordEnabled &&
                timerDuration == other.timerDuration &&
@@ -42,6 +42,7 @@ void ShowContextMenu(HWND hwnd) {
             // Update menu item text based on lock state
             UINT uFlags = IsInputLocked() ? MF_STRING | MF_CHECKED : MF_STRING | MF_UNCHECKED;
             ModifyMenuA(hSubMenu, IDM_LOCK_UNLOCK, uFlags, IDM_LOCK_UNLOCK, IsInputLocked() ? "Unlock Input" : "Lock Input");
+            CheckMenuItem(hSubMenu, IDM_INPUT_TRACE, MF_BYCOMMAND | (IsInputTraceRecording() ? MF_CHECKED : MF_UNCHECKED));
             
             // Display the menu
             TrackPopupMenu(hSubMenu, TPM_LEFTALIGN | TPM_BOTTOMALIGN | TPM_RIGHTBUTTON, pt.x, pt.y, 0, hwnd, NULL);
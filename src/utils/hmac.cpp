@@ -0,0 +1,59 @@
+// src/utils/hmac.cpp
+// HMAC implementation on top of the one-shot hash functions
+
+#include "hmac.h"
+#include <cstring>
+#include <vector>
+
+static const size_t HMAC_BLOCK_SIZE = 64; // Same for SHA-1 and SHA-256
+
+size_t HmacSize(HmacAlgorithm algorithm) {
+    return algorithm == HMAC_SHA256 ? SHA256_DIGEST_SIZE : SHA1_DIGEST_SIZE;
+}
+
+static void Hash(HmacAlgorithm algorithm, const void* data, size_t length, uint8_t* digest) {
+    if (algorithm == HMAC_SHA256) {
+        Sha256(data, length, digest);
+    } else {
+        Sha1(data, length, digest);
+    }
+}
+
+static void Scrub(void* data, size_t length) {
+    volatile uint8_t* bytes = (volatile uint8_t*)data;
+    for (size_t i = 0; i < length; i++) bytes[i] = 0;
+}
+
+void Hmac(HmacAlgorithm algorithm, const uint8_t* key, size_t keyLength,
+          const void* message, size_t messageLength, uint8_t* tag) {
+    size_t hashSize = HmacSize(algorithm);
+
+    uint8_t block[HMAC_BLOCK_SIZE];
+    memset(block, 0, sizeof(block));
+    if (keyLength > HMAC_BLOCK_SIZE) {
+        Hash(algorithm, key, keyLength, block);
+    } else if (keyLength > 0) {
+        memcpy(block, key, keyLength);
+    }
+
+    // The hashes are one-shot, so each pass hashes the padded key and its input
+    // as one buffer (one-time code messages are 8 bytes: a stack buffer suffices)
+    uint8_t stackBuffer[HMAC_BLOCK_SIZE + 64];
+    std::vector<uint8_t> heapBuffer;
+    uint8_t* inner = stackBuffer;
+    if (messageLength > sizeof(stackBuffer) - HMAC_BLOCK_SIZE) {
+        heapBuffer.resize(HMAC_BLOCK_SIZE + messageLength);
+        inner = heapBuffer.data();
+    }
+    for (size_t i = 0; i < HMAC_BLOCK_SIZE; i++) inner[i] = block[i] ^ 0x36;
+    if (messageLength > 0) memcpy(inner + HMAC_BLOCK_SIZE, message, messageLength);
+
+    uint8_t outer[HMAC_BLOCK_SIZE + HMAC_MAX_SIZE];
+    for (size_t i = 0; i < HMAC_BLOCK_SIZE; i++) outer[i] = block[i] ^ 0x5C;
+    Hash(algorithm, inner, HMAC_BLOCK_SIZE + messageLength, outer + HMAC_BLOCK_SIZE);
+    Hash(algorithm, outer, HMAC_BLOCK_SIZE + hashSize, tag);
+
+    Scrub(block, sizeof(block));
+    Scrub(inner, HMAC_BLOCK_SIZE);
+    Scrub(outer, sizeof(outer));
+}
@@ -0,0 +1,22 @@
+// src/utils/hmac.h
+// HMAC (RFC 2104) over SHA-1 and SHA-256
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "sha1.h"
+#include "sha256.h"
+
+enum HmacAlgorithm {
+    HMAC_SHA1 = 0,  // 20-byte tag
+    HMAC_SHA256 = 1 // 32-byte tag
+};
+
+const size_t HMAC_MAX_SIZE = SHA256_DIGEST_SIZE;
+
+size_t HmacSize(HmacAlgorithm algorithm);
+
+// Writes HmacSize(algorithm) bytes to tag. Keys longer than the 64-byte
+// block are hashed first, as the RFC requires.
+void Hmac(HmacAlgorithm algorithm, const uint8_t* key, size_t keyLength,
+          const void* message, size_t messageLength, uint8_t* tag);
@@ -2,6 +2,10 @@
 // Hotkey parsing and utility functions implementation
 
 #include "hotkey_utils.h"
+#include "../resource.h"
+#include "../features/lock_input/chord_trie.h"
+#include <cctype>
+#include <cstdlib>
 
 // Utility function to parse hotkey strings (e.g., "Ctrl+Alt+F12")
 bool ParseHotkeyString(const std::string& hotkeyStr, UINT& modifiers, UINT& virtualKey) {
@@ -91,3 +95,114 @@ bool ParseHotkeyString(const std::string& hotkeyStr, UINT& modifiers, UINT& virt
 
     return false;
 }
+
+// "Lock", "BossKey" or "LaunchN" (1-based) to the hotkey ID WM_HOTKEY dispatches on
+static uint16_t ParseChordAction(const std::string& name) {
+    if (name == "LOCK") return HOTKEY_ID_LOCK;
+    if (name == "BOSSKEY") return HOTKEY_ID_BOSS_KEY;
+    if (name.compare(0, 6, "LAUNCH") == 0 && name.length() > 6 && name.length() <= 9) {
+        int index = atoi(name.c_str() + 6);
+        if (index >= 1 && index <= HOTKEY_ID_QUICK_LAUNCH_LAST - HOTKEY_ID_QUICK_LAUNCH_FIRST + 1) {
+            return (uint16_t)(HOTKEY_ID_QUICK_LAUNCH_FIRST + index - 1);
+        }
+    }
+    return 0;
+}
+
+// Upper-cases a token and drops whitespace
+static std::string NormalizeToken(const std::string& text, size_t start, size_t end) {
+    std::string token;
+    for (size_t i = start; i < end; i++) {
+        if (!isspace((unsigned char)text[i])) {
+            token += (char)toupper((unsigned char)text[i]);
+        }
+    }
+    return token;
+}
+
+// One stroke such as "ctrl + k": modifier names are case-insensitive here,
+// but the hotkey parser expects "Ctrl+Alt+Shift+Win+KEY"
+static bool ParseChordStroke(const std::string& token, ChordStroke& stroke) {
+    static const char* const MODIFIER_NAMES[] = { "CTRL", "ALT", "SHIFT", "WIN" };
+    static const char* const CANONICAL_NAMES[] = { "Ctrl+", "Alt+", "Shift+", "Win+" };
+
+    std::string hotkey;
+    size_t start = 0;
+    while (start < token.length()) {
+        size_t plus = token.find('+', start);
+        if (plus == std::string::npos || plus == token.length() - 1) break;
+
+        std::string part = token.substr(start, plus - start);
+        bool isModifier = false;
+        for (int i = 0; i < 4; i++) {
+            if (part == MODIFIER_NAMES[i]) {
+                hotkey += CANONICAL_NAMES[i];
+                isModifier = true;
+            }
+        }
+        if (!isModifier) return false;
+        start = plus + 1;
+    }
+    hotkey += token.substr(start);
+
+    UINT modifiers = 0, virtualKey = 0;
+    if (!ParseHotkeyString(hotkey, modifiers, virtualKey) || virtualKey == 0 || virtualKey > 0xFF) {
+        return false;
+    }
+    stroke.modifiers = (uint8_t)(modifiers & 0xF);
+    stroke.vkCode = (uint8_t)virtualKey;
+    return true;
+}
+
+static bool IsReservedStroke(const ChordStroke& stroke, const ChordStroke* reserved, size_t reservedCount) {
+    for (size_t i = 0; i < reservedCount; i++) {
+        if (reserved[i].modifiers == stroke.modifiers && reserved[i].vkCode == stroke.vkCode) return true;
+    }
+    return false;
+}
+
+size_t ParseChordHotkeys(const std::string& text, const ChordStroke* reserved, size_t reservedCount,
+                         ChordTrie& trie, size_t& collisions) {
+    size_t added = 0;
+    collisions = 0;
+    size_t start = 0;
+
+    while (start < text.length()) {
+        size_t end = text.find(';', start);
+        if (end == std::string::npos) end = text.length();
+
+        size_t equals = text.find('=', start);
+        if (equals != std::string::npos && equals < end) {
+            ChordStroke strokes[ChordTrie::MAX_STROKES];
+            size_t count = 0;
+            bool valid = true;
+
+            size_t strokeStart = start;
+            while (valid && strokeStart < equals) {
+                size_t comma = text.find(',', strokeStart);
+                if (comma == std::string::npos || comma > equals) comma = equals;
+
+                std::string token = NormalizeToken(text, strokeStart, comma);
+                valid = count < ChordTrie::MAX_STROKES && ParseChordStroke(token, strokes[count]);
+                count++;
+                strokeStart = comma + 1;
+            }
+
+            bool collides = false;
+            for (size_t i = 0; valid && i < count; i++) {
+                collides |= IsReservedStroke(strokes[i], reserved, reservedCount);
+            }
+            if (collides) {
+                collisions++;
+                valid = false;
+            }
+
+            uint16_t action = ParseChordAction(NormalizeToken(text, equals + 1, end));
+            if (valid && action != 0 && trie.Add(strokes, count, action)) {
+                added++;
+            }
+        }
+        start = end + 1;
+    }
+    return added;
+}
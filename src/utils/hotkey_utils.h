@@ -5,5 +5,16 @@
 #include <string>
 #include <windows.h>
 
+class ChordTrie;
+struct ChordStroke;
+
 // Utility function to parse hotkey strings (e.g., "Ctrl+Alt+F12")
 bool ParseHotkeyString(const std::string& hotkeyStr, UINT& modifiers, UINT& virtualKey);
+
+// Parses chord definitions such as "Ctrl+K, L = Lock; Ctrl+K, B = BossKey;
+// Ctrl+K, 1 = Launch1". Strokes use the hotkey syntax, up to ChordTrie::MAX_STROKES per
+// chord. Actions: Lock, BossKey, LaunchN (quick launch app N). Returns the
+// number of chords added; invalid or conflicting entries are skipped, and so
+// are chords using one of the reserved strokes (counted in collisions).
+size_t ParseChordHotkeys(const std::string& text, const ChordStroke* reserved, size_t reservedCount,
+                         ChordTrie& trie, size_t& collisions);
@@ -0,0 +1,106 @@
+// src/utils/latency_histogram.cpp
+// Latency histogram implementation
+
+#include "latency_histogram.h"
+
+LatencyHistogram::LatencyHistogram() {
+    Reset();
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(unsigned index) {
+    if (index < SUB_BUCKET_COUNT) return index;
+    unsigned shift = index / SUB_BUCKET_COUNT - 1;
+    uint64_t sub = index % SUB_BUCKET_COUNT;
+    return (SUB_BUCKET_COUNT + sub) << shift;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(unsigned index) {
+    if (index < SUB_BUCKET_COUNT) return index;
+    unsigned shift = index / SUB_BUCKET_COUNT - 1;
+    return BucketLowerBound(index) + ((1ULL << shift) - 1);
+}
+
+void LatencyHistogram::Reset() {
+    for (unsigned i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+    totalCount.store(0, std::memory_order_relaxed);
+    totalSum.store(0, std::memory_order_relaxed);
+    maxValue.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetPercentile(double fraction) const {
+    // Sum the buckets rather than trusting totalCount, which may be a few
+    // samples ahead of the buckets while the hook is recording
+    uint64_t count = 0;
+    for (unsigned i = 0; i < BUCKET_COUNT; i++) {
+        count += buckets[i].load(std::memory_order_relaxed);
+    }
+    if (count == 0) return 0;
+
+    if (fraction < 0.0) fraction = 0.0;
+    if (fraction > 1.0) fraction = 1.0;
+    uint64_t rank = (uint64_t)(fraction * (double)count + 0.5);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    uint64_t max = GetMax();
+    for (unsigned i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t upper = BucketUpperBound(i);
+            return upper < max ? upper : max;
+        }
+    }
+    return max;
+}
+
+LatencySummary LatencyHistogram::GetSummary() const {
+    LatencySummary summary = {};
+    summary.count = GetCount();
+    if (summary.count == 0) return summary;
+
+    for (unsigned i = 0; i < BUCKET_COUNT; i++) {
+        if (buckets[i].load(std::memory_order_relaxed) != 0) {
+            summary.min = BucketLowerBound(i);
+            break;
+        }
+    }
+    summary.max = GetMax();
+    summary.mean = (double)totalSum.load(std::memory_order_relaxed) / (double)summary.count;
+    summary.p50 = GetPercentile(0.50);
+    summary.p90 = GetPercentile(0.90);
+    summary.p99 = GetPercentile(0.99);
+    summary.p999 = GetPercentile(0.999);
+    return summary;
+}
+
+void LatencyHistogram::TakeSnapshot(Snapshot& snapshot) const {
+    snapshot.count = 0;
+    for (unsigned i = 0; i < BUCKET_COUNT; i++) {
+        snapshot.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[i];
+    }
+    snapshot.max = GetMax();
+}
+
+uint64_t LatencyHistogram::GetPercentileBetween(const Snapshot& before, const Snapshot& after, double fraction) {
+    // Buckets only grow between snapshots unless the histogram was Reset()
+    if (after.count <= before.count) return 0;
+    uint64_t count = after.count - before.count;
+
+    if (fraction < 0.0) fraction = 0.0;
+    if (fraction > 1.0) fraction = 1.0;
+    uint64_t rank = (uint64_t)(fraction * (double)count + 0.5);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < BUCKET_COUNT; i++) {
+        if (after.buckets[i] > before.buckets[i]) seen += after.buckets[i] - before.buckets[i];
+        if (seen >= rank) {
+            uint64_t upper = BucketUpperBound(i);
+            return upper < after.max ? upper : after.max;
+        }
+    }
+    return after.max;
+}
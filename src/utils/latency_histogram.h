@@ -0,0 +1,85 @@
+// src/utils/latency_histogram.h
+// Lock-free log-linear latency histogram (portable, no Win32 dependencies)
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Summary computed from a histogram snapshot; values are in the recorded unit
+struct LatencySummary {
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    double mean;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+};
+
+// Values below 2^SUB_BUCKET_BITS get one bucket each; above that every power
+// of two is split into 2^SUB_BUCKET_BITS linear buckets, so any recorded value
+// is reported within ~6% without storing samples. Record() is wait-free and
+// safe to call from a hook callback while another thread reads.
+class LatencyHistogram {
+public:
+    static const unsigned SUB_BUCKET_BITS = 4;
+    static const unsigned SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+    static const unsigned BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    // Plain copy of the bucket counts; two of them give the percentiles of
+    // just the samples recorded in between
+    struct Snapshot {
+        uint64_t buckets[BUCKET_COUNT];
+        uint64_t count; // Sum of the buckets
+        uint64_t max;   // Lifetime maximum when taken
+    };
+
+private:
+    std::atomic<uint64_t> buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> totalCount;
+    std::atomic<uint64_t> totalSum;
+    std::atomic<uint64_t> maxValue;
+
+public:
+    LatencyHistogram();
+
+    static unsigned BucketIndex(uint64_t value) {
+        if (value < SUB_BUCKET_COUNT) return (unsigned)value;
+        unsigned exponent = 63u - (unsigned)__builtin_clzll(value);
+        unsigned shift = exponent - SUB_BUCKET_BITS;
+        return (shift + 1) * SUB_BUCKET_COUNT + (unsigned)((value >> shift) & (SUB_BUCKET_COUNT - 1));
+    }
+
+    // Smallest / largest value that maps to a bucket
+    static uint64_t BucketLowerBound(unsigned index);
+    static uint64_t BucketUpperBound(unsigned index);
+
+    void Record(uint64_t value) {
+        buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        totalCount.fetch_add(1, std::memory_order_relaxed);
+        totalSum.fetch_add(value, std::memory_order_relaxed);
+        uint64_t currentMax = maxValue.load(std::memory_order_relaxed);
+        while (value > currentMax &&
+               !maxValue.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void Reset();
+
+    uint64_t GetCount() const { return totalCount.load(std::memory_order_relaxed); }
+    uint64_t GetMax() const { return maxValue.load(std::memory_order_relaxed); }
+
+    // Value at or below which the given fraction (0..1) of samples fall.
+    // Reports the bucket's upper bound, capped at the recorded maximum.
+    uint64_t GetPercentile(double fraction) const;
+
+    LatencySummary GetSummary() const;
+
+    void TakeSnapshot(Snapshot& snapshot) const;
+
+    // GetPercentile over the samples recorded between two snapshots of the
+    // same histogram (0 if there were none)
+    static uint64_t GetPercentileBetween(const Snapshot& before, const Snapshot& after, double fraction);
+};
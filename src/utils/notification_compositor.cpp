@@ -0,0 +1,119 @@
+// src/utils/notification_compositor.cpp
+// Notification layout and compositing implementation
+
+#include "notification_compositor.h"
+#include "pixel_kernels.h"
+
+int NotificationStackHeight(const NotificationLayout& layout, size_t count) {
+    return count ? (int)count * (layout.height + layout.gap) - layout.gap : 0;
+}
+
+int NotificationSlotTop(const NotificationLayout& layout, size_t index) {
+    return (int)index * (layout.height + layout.gap);
+}
+
+NotificationBand NotificationProgressBand(const NotificationLayout& layout, uint32_t elapsed, uint32_t duration,
+                                          uint32_t color) {
+    NotificationBand band;
+    band.top = layout.progressTop;
+    band.height = layout.progressHeight;
+    band.width = (duration && elapsed < duration) ? (int)((uint64_t)layout.width * elapsed / duration) : 0;
+    band.color = color;
+    return band;
+}
+
+uint32_t NotificationIdleTime(uint32_t elapsed, uint32_t duration, uint32_t fade) {
+    if (elapsed < fade || duration <= fade) return 0;
+    uint32_t fadeOut = duration - fade; // Fading once elapsed passes this
+    return elapsed > fadeOut ? 0 : fadeOut - elapsed + 1;
+}
+
+int NotificationSlide(int position, int target) {
+    int diff = target - position;
+    if (diff > -2 && diff < 2) return target;
+    int step = diff / 8;
+    if (step == 0) step = diff > 0 ? 1 : -1;
+    return position + step;
+}
+
+uint8_t NotificationAlpha(float opacity) {
+    if (!(opacity > 0.0f)) return 0;
+    if (opacity >= 1.0f) return 255;
+    return (uint8_t)(opacity * 255.0f);
+}
+
+void FillSurface(PixelSurface& surface, uint32_t pixel) {
+    for (int row = 0; row < surface.height; row++) {
+        PixelFillRow(surface.pixels + (size_t)row * surface.stride, pixel, (size_t)surface.width);
+    }
+}
+
+// Share of pixel (x, y) inside a quarter circle of radius centred on
+// (radius, radius), from 4x4 samples, as a 0..255 alpha
+static uint8_t CornerCoverage(int x, int y, int radius) {
+    int inside = 0;
+    for (int sy = 0; sy < 4; sy++) {
+        for (int sx = 0; sx < 4; sx++) {
+            int dx = 8 * x + 2 * sx + 1 - 8 * radius; // Eighths of a pixel
+            int dy = 8 * y + 2 * sy + 1 - 8 * radius;
+            inside += dx * dx + dy * dy <= 64 * radius * radius;
+        }
+    }
+    return (uint8_t)((inside * 255 + 8) / 16);
+}
+
+void SetSurfaceOpaque(PixelSurface& surface, int cornerRadius) {
+    for (int row = 0; row < surface.height; row++) {
+        uint32_t* out = surface.pixels + (size_t)row * surface.stride;
+        for (int column = 0; column < surface.width; column++) out[column] |= 0xFF000000u;
+    }
+
+    int radius = cornerRadius;
+    if (radius > surface.width / 2) radius = surface.width / 2;
+    if (radius > surface.height / 2) radius = surface.height / 2;
+    for (int y = 0; y < radius; y++) {
+        for (int x = 0; x < radius; x++) {
+            uint8_t coverage = CornerCoverage(x, y, radius);
+            if (coverage == 255) continue;
+            // Same pixel mirrored into all four corners
+            int columns[2] = { x, surface.width - 1 - x };
+            int rows[2] = { y, surface.height - 1 - y };
+            for (int i = 0; i < 4; i++) {
+                uint32_t* pixel = surface.pixels + (size_t)rows[i / 2] * surface.stride + columns[i % 2];
+                PixelScaleRow(pixel, pixel, 1, coverage);
+            }
+        }
+    }
+}
+
+void CompositeNotification(PixelSurface& dest, int x, int y, const PixelSurface& body,
+                           const NotificationBand& band, uint8_t alpha) {
+    // Clip the body rectangle to dest
+    int left = x < 0 ? -x : 0;
+    int top = y < 0 ? -y : 0;
+    int right = body.width;
+    int bottom = body.height;
+    if (x + right > dest.width) right = dest.width - x;
+    if (y + bottom > dest.height) bottom = dest.height - y;
+    if (left >= right || top >= bottom) return;
+
+    uint32_t bandPixel;
+    PixelScaleRow(&bandPixel, &band.color, 1, alpha);
+
+    for (int row = top; row < bottom; row++) {
+        uint32_t* out = dest.pixels + (size_t)(y + row) * dest.stride + x;
+        const uint32_t* in = body.pixels + (size_t)row * body.stride;
+
+        int bandEnd = left;
+        if (row >= band.top && row < band.top + band.height && band.width > left) {
+            bandEnd = band.width < right ? band.width : right;
+            PixelFillRow(out + left, bandPixel, (size_t)(bandEnd - left));
+            // Where the body is cut away (rounded corners) the band is too
+            for (int column = left; column < bandEnd; column++) {
+                uint8_t coverage = (uint8_t)(in[column] >> 24);
+                if (coverage != 255) PixelScaleRow(out + column, &bandPixel, 1, coverage);
+            }
+        }
+        PixelScaleRow(out + bandEnd, in + bandEnd, (size_t)(right - bandEnd), alpha);
+    }
+}
@@ -0,0 +1,71 @@
+// src/utils/notification_compositor.h
+// Notification stack layout and premultiplied-alpha compositing (portable, no Win32 dependencies)
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 32-bit pixels as a top-down BGRA DIB section holds them: 0xAARRGGBB,
+// colour channels premultiplied by alpha
+inline uint32_t MakePixel(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+    return ((uint32_t)a << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+}
+
+// Window of pixels; does not own them. stride is in pixels.
+struct PixelSurface {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int stride;
+};
+
+// Geometry of one notification in the stack window, in pixels
+struct NotificationLayout {
+    int width;
+    int height;
+    int gap;           // Between stacked notifications
+    int progressTop;   // Rows of the progress line
+    int progressHeight;
+    int cornerRadius;  // Outside the rounded corners the window is transparent
+};
+
+// Span over the left of a notification's body (the progress line), opaque
+// wherever the body is
+struct NotificationBand {
+    int top;
+    int height;
+    int width; // 0 = no band this frame
+    uint32_t color;
+};
+
+int NotificationStackHeight(const NotificationLayout& layout, size_t count);
+int NotificationSlotTop(const NotificationLayout& layout, size_t index);
+
+// Progress line after elapsed of duration milliseconds, grown left to right
+NotificationBand NotificationProgressBand(const NotificationLayout& layout, uint32_t elapsed, uint32_t duration,
+                                          uint32_t color);
+
+// Milliseconds until a notification shown elapsed ms ago next needs frames:
+// 0 while it fades in or out, otherwise the time left until its fade-out
+uint32_t NotificationIdleTime(uint32_t elapsed, uint32_t duration, uint32_t fade);
+
+// One frame of the slide towards target: an eighth of the way, at least a
+// pixel, so it always arrives (a plain diff / 8 stops 7 px short)
+int NotificationSlide(int position, int target);
+
+// Window opacity 0..1 as a blend factor
+uint8_t NotificationAlpha(float opacity);
+
+void FillSurface(PixelSurface& surface, uint32_t pixel);
+
+// GDI drawing leaves the alpha byte undefined; an opaque body gets 255 back,
+// except outside rounded corners of cornerRadius (antialiased, fading to 0)
+void SetSurfaceOpaque(PixelSurface& surface, int cornerRadius = 0);
+
+// Writes body at (x, y) into dest, with band replacing the body's pixels it
+// covers, all scaled by alpha (premultiplied), replacing what dest held there:
+// each frame starts transparent and notifications never overlap, so this is
+// the fade alone, no blend. Clipped to dest. This is the only per-frame pixel
+// work besides clearing the frame.
+void CompositeNotification(PixelSurface& dest, int x, int y, const PixelSurface& body,
+                           const NotificationBand& band, uint8_t alpha);
@@ -0,0 +1,123 @@
+// src/utils/notification_queue.cpp
+// Notification queue implementation
+
+#include "notification_queue.h"
+#include <cstring>
+
+static const uint32_t RATE_CAPACITY = NotificationQueue::RATE_BURST * NotificationQueue::RATE_INTERVAL;
+
+NotificationQueue::NotificationQueue() {
+    memset(&stats, 0, sizeof(stats));
+    memset(buckets, 0, sizeof(buckets));
+    Clear();
+}
+
+void NotificationQueue::Clear() {
+    head = 0;
+    count = 0;
+    usedSlots = 0;
+    memset(entries, 0, sizeof(entries));
+}
+
+void NotificationQueue::RemoveAt(size_t position) {
+    usedSlots &= ~(1u << ring[RingIndex(position)]);
+    if (position == 0) {
+        head = RingIndex(1); // Expiry is almost always the oldest
+    } else {
+        for (size_t i = position; i + 1 < count; i++) {
+            ring[RingIndex(i)] = ring[RingIndex(i + 1)];
+        }
+    }
+    count--;
+}
+
+void NotificationQueue::Remove(int slot) {
+    for (size_t position = 0; position < count; position++) {
+        if (ring[RingIndex(position)] == slot) {
+            RemoveAt(position);
+            return;
+        }
+    }
+}
+
+NotificationOffer NotificationQueue::Offer(uint64_t key, uint32_t source, uint8_t level, uint32_t now) {
+    NotificationOffer offer = { NOTIFY_ADMIT_DROPPED, -1, false, 0, 0 };
+    stats.offered++;
+
+    // A repeat of something on screen
+    for (size_t position = 0; position < count; position++) {
+        int slot = ring[RingIndex(position)];
+        Entry& entry = entries[slot];
+        if (entry.key == key && entry.level == level && now - entry.lastTime <= COALESCE_WINDOW) {
+            entry.count++;
+            entry.lastTime = now;
+            stats.coalesced++;
+            offer.admission = NOTIFY_ADMIT_COALESCED;
+            offer.slot = slot;
+            offer.count = entry.count;
+            return offer;
+        }
+    }
+
+    // Token bucket, refilled for the time since this source was last seen
+    Bucket& bucket = buckets[source % MAX_SOURCES];
+    if (!bucket.used) {
+        bucket.used = true;
+        bucket.credit = RATE_CAPACITY;
+    } else {
+        uint32_t elapsed = now - bucket.lastTime;
+        bucket.credit = elapsed >= RATE_CAPACITY - bucket.credit ? RATE_CAPACITY : bucket.credit + elapsed;
+    }
+    bucket.lastTime = now;
+    if (bucket.credit < RATE_INTERVAL) {
+        bucket.suppressed++;
+        stats.rateLimited++;
+        offer.admission = NOTIFY_ADMIT_RATE_LIMITED;
+        return offer;
+    }
+
+    // Full: the oldest of the lowest level goes, unless it outranks this one
+    bool evicted = false;
+    if (count == CAPACITY) {
+        size_t victim = 0;
+        for (size_t position = 1; position < count; position++) {
+            if (entries[ring[RingIndex(position)]].level < entries[ring[RingIndex(victim)]].level) victim = position;
+        }
+        if (entries[ring[RingIndex(victim)]].level > level) {
+            stats.dropped++;
+            return offer; // Keeps its token: nothing was shown
+        }
+        RemoveAt(victim);
+        evicted = true;
+        stats.evicted++;
+    }
+
+    bucket.credit -= RATE_INTERVAL;
+    int slot = __builtin_ctz(~usedSlots);
+    usedSlots |= 1u << slot;
+    ring[RingIndex(count)] = (uint8_t)slot;
+    count++;
+
+    Entry& entry = entries[slot];
+    entry.key = key;
+    entry.lastTime = now;
+    entry.count = 1;
+    entry.level = level;
+
+    stats.admitted++;
+    offer.admission = NOTIFY_ADMIT_NEW;
+    offer.slot = slot;
+    offer.evicted = evicted;
+    offer.suppressed = bucket.suppressed;
+    bucket.suppressed = 0;
+    return offer;
+}
+
+uint64_t NotificationKey(uint8_t level, const char* title, const char* message) {
+    uint64_t hash = 1469598103934665603ULL;
+    hash = (hash ^ level) * 1099511628211ULL;
+    for (const char* p = title; *p; p++) hash = (hash ^ (uint8_t)*p) * 1099511628211ULL;
+    hash = (hash ^ 0xFF) * 1099511628211ULL; // Separator: "ab"+"c" differs from "a"+"bc"
+    for (const char* p = message; *p; p++) hash = (hash ^ (uint8_t)*p) * 1099511628211ULL;
+    return hash;
+}
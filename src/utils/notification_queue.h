@@ -0,0 +1,96 @@
+// src/utils/notification_queue.h
+// Fixed-capacity notification queue: priority eviction, coalescing and per-source rate limits (portable)
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+enum NotificationAdmission {
+    NOTIFY_ADMIT_NEW = 0,          // Fill the returned slot
+    NOTIFY_ADMIT_COALESCED = 1,    // The slot already shows this message; its count went up
+    NOTIFY_ADMIT_RATE_LIMITED = 2, // The source is over its rate; counted towards its next notification
+    NOTIFY_ADMIT_DROPPED = 3       // Full, and everything queued outranks it
+};
+
+struct NotificationOffer {
+    NotificationAdmission admission;
+    int slot;            // NEW and COALESCED, otherwise -1
+    bool evicted;        // NEW: the slot's previous notification was dropped to make room
+    uint32_t count;      // COALESCED: occurrences so far, this one included
+    uint32_t suppressed; // NEW: notifications from this source rate limited since the last one shown
+};
+
+// Counters for diagnostics (monotonic since construction)
+struct NotificationQueueStats {
+    uint64_t offered;
+    uint64_t admitted;
+    uint64_t coalesced;
+    uint64_t rateLimited;
+    uint64_t dropped;
+    uint64_t evicted;
+};
+
+// Bookkeeping for at most CAPACITY notifications; the caller keeps the
+// notifications themselves in an array indexed by slot. Slots are kept in a
+// ring in arrival order. Every operation is bounded by CAPACITY, so a storm
+// costs the same per event however long it lasts, and memory never grows.
+//   - An identical message (same key) within COALESCE_WINDOW of its last
+//     occurrence only raises that notification's count.
+//   - Each source has a token bucket of RATE_BURST notifications, refilled
+//     one per RATE_INTERVAL ms; coalesced repeats cost no token.
+//   - When full, the oldest notification of the lowest level makes room,
+//     provided its level is not above the new one's.
+class NotificationQueue {
+public:
+    static const size_t CAPACITY = 8;
+    static const size_t MAX_SOURCES = 32;
+    static const uint32_t SOURCE_OTHER = MAX_SOURCES - 1; // For callers without a source of their own
+    static const uint32_t COALESCE_WINDOW = 4000;         // ms
+    static const uint32_t RATE_BURST = 3;
+    static const uint32_t RATE_INTERVAL = 2000;           // ms per token
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint32_t lastTime;
+        uint32_t count;
+        uint8_t level;
+    };
+    struct Bucket {
+        uint32_t credit; // ms of refill banked, up to RATE_BURST * RATE_INTERVAL
+        uint32_t lastTime;
+        uint32_t suppressed;
+        bool used;
+    };
+
+    Entry entries[CAPACITY]; // By slot
+    uint8_t ring[CAPACITY];  // Slots, oldest first from head
+    size_t head;
+    size_t count;
+    uint32_t usedSlots;      // Bit per slot
+    Bucket buckets[MAX_SOURCES];
+    NotificationQueueStats stats;
+
+    size_t RingIndex(size_t position) const { return (head + position) % CAPACITY; }
+    void RemoveAt(size_t position);
+
+public:
+    NotificationQueue();
+
+    // level: higher outranks lower (NotificationLevel). now: ms, any epoch.
+    NotificationOffer Offer(uint64_t key, uint32_t source, uint8_t level, uint32_t now);
+
+    // The slot's notification is gone (expired or dismissed)
+    void Remove(int slot);
+    void Clear();
+
+    size_t GetCount() const { return count; }
+    // Slot of the position-th notification, oldest first
+    int GetSlot(size_t position) const { return ring[RingIndex(position)]; }
+    uint32_t GetRepeatCount(int slot) const { return entries[slot].count; }
+
+    NotificationQueueStats GetStats() const { return stats; }
+};
+
+// Coalescing key: FNV-1a over the level, title and message
+uint64_t NotificationKey(uint8_t level, const char* title, const char* message);
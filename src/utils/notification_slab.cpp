@@ -0,0 +1,105 @@
+// src/utils/notification_slab.cpp
+// Notification slab implementation
+
+#include "notification_slab.h"
+#include <cstring>
+
+NotificationSlab::NotificationSlab() : exhaustedCount(0) {
+    for (uint32_t i = 0; i < CAPACITY; i++) {
+        records[i].state.store(1u << 1, std::memory_order_relaxed); // Generation 1, free
+        records[i].nextFree.store(i + 1, std::memory_order_relaxed);
+        records[i].message[0] = '\0';
+    }
+    freeHead.store(0, std::memory_order_release);
+}
+
+bool NotificationSlab::Pop(uint32_t* index) {
+    uint64_t head = freeHead.load(std::memory_order_acquire);
+    for (;;) {
+        uint32_t top = (uint32_t)head;
+        if (top >= CAPACITY) return false;
+        // The tag changes on every pop, so a head that was popped and pushed
+        // back in between fails the exchange (no ABA)
+        uint64_t next = ((head >> 32) + 1) << 32 | records[top].nextFree.load(std::memory_order_relaxed);
+        if (freeHead.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            *index = top;
+            return true;
+        }
+    }
+}
+
+void NotificationSlab::Push(uint32_t index) {
+    uint64_t head = freeHead.load(std::memory_order_relaxed);
+    for (;;) {
+        records[index].nextFree.store((uint32_t)head, std::memory_order_relaxed);
+        uint64_t next = (head & 0xFFFFFFFF00000000ULL) | index;
+        if (freeHead.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed)) return;
+    }
+}
+
+uint32_t NotificationSlab::Acquire(const char* text) {
+    uint32_t index;
+    if (!Pop(&index)) {
+        exhaustedCount.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    Record& record = records[index];
+    size_t length = text ? strlen(text) : 0;
+    if (length >= MESSAGE_SIZE) length = MESSAGE_SIZE - 1;
+    if (length) memcpy(record.message, text, length);
+    record.message[length] = '\0';
+
+    uint32_t state = record.state.load(std::memory_order_relaxed) | 1u;
+    record.state.store(state, std::memory_order_release); // Publishes the text with the handle
+    return (index + 1) | (((state >> 1) & GENERATION_MASK) << INDEX_BITS);
+}
+
+NotificationSlab::Record* NotificationSlab::Lookup(uint32_t handle, uint32_t* state) {
+    uint32_t index = (handle & ((1u << INDEX_BITS) - 1)) - 1;
+    if (handle == 0 || index >= CAPACITY) return nullptr;
+
+    Record& record = records[index];
+    *state = record.state.load(std::memory_order_acquire);
+    bool live = (*state & 1u) && ((*state >> 1) & GENERATION_MASK) == (handle >> INDEX_BITS);
+    return live ? &record : nullptr;
+}
+
+const char* NotificationSlab::Get(uint32_t handle) {
+    uint32_t state;
+    Record* record = Lookup(handle, &state);
+    return record ? record->message : nullptr;
+}
+
+// Moves a record from state to the next generation, free. Only one caller
+// can win, so a handle released twice (or discarded meanwhile) is pushed once.
+bool NotificationSlab::Free(uint32_t index, uint32_t state) {
+    uint32_t next = ((state >> 1) + 1) << 1;
+    if (((next >> 1) & GENERATION_MASK) == 0) next += 1u << 1; // Generation 0 never matches a fresh record
+    if (!records[index].state.compare_exchange_strong(state, next, std::memory_order_acq_rel)) return false;
+    Push(index);
+    return true;
+}
+
+bool NotificationSlab::Release(uint32_t handle) {
+    uint32_t state;
+    Record* record = Lookup(handle, &state);
+    return record && Free((uint32_t)(record - records), state);
+}
+
+size_t NotificationSlab::DiscardAll() {
+    size_t discarded = 0;
+    for (uint32_t i = 0; i < CAPACITY; i++) {
+        uint32_t state = records[i].state.load(std::memory_order_acquire);
+        if ((state & 1u) && Free(i, state)) discarded++;
+    }
+    return discarded;
+}
+
+size_t NotificationSlab::GetInUseCount() const {
+    size_t inUse = 0;
+    for (size_t i = 0; i < CAPACITY; i++) {
+        inUse += records[i].state.load(std::memory_order_relaxed) & 1u;
+    }
+    return inUse;
+}
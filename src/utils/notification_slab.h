@@ -0,0 +1,59 @@
+// src/utils/notification_slab.h
+// Preallocated notification message records handed between threads by index and generation (portable)
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed records for notification text posted to the UI thread. A message
+// carries a 32-bit handle (index and generation) instead of a heap pointer,
+// so posting allocates nothing, and a message that is never delivered costs
+// a record until DiscardAll() rather than a leak. Releasing bumps the
+// generation, so a stale or repeated handle is refused instead of reading
+// reused text. Acquire() and Release() are lock-free and may be called from
+// any thread; the free list is a tagged stack.
+class NotificationSlab {
+public:
+    static const size_t CAPACITY = 64;
+    static const size_t MESSAGE_SIZE = 256; // Longer text is truncated
+
+private:
+    static const uint32_t INDEX_BITS = 8;
+    static const uint32_t GENERATION_MASK = (1u << 23) - 1;
+
+    struct Record {
+        std::atomic<uint32_t> state; // generation << 1 | in use
+        std::atomic<uint32_t> nextFree;
+        char message[MESSAGE_SIZE];
+    };
+
+    Record records[CAPACITY];
+    std::atomic<uint64_t> freeHead; // Tag << 32 | index (CAPACITY = empty)
+    std::atomic<uint64_t> exhaustedCount;
+
+    bool Pop(uint32_t* index);
+    void Push(uint32_t index);
+    bool Free(uint32_t index, uint32_t state);
+    Record* Lookup(uint32_t handle, uint32_t* state);
+
+public:
+    NotificationSlab();
+
+    // Copies text into a free record; returns its handle, never 0, or 0 if
+    // all records are in flight
+    uint32_t Acquire(const char* text);
+
+    // The text for a live handle, or nullptr if it was released or discarded.
+    // Valid until the handle is released.
+    const char* Get(uint32_t handle);
+
+    // Returns the record; false if the handle was already stale
+    bool Release(uint32_t handle);
+
+    // Frees every record still in flight (the receiving window is going away)
+    size_t DiscardAll();
+
+    size_t GetInUseCount() const;
+    uint64_t GetExhaustedCount() const { return exhaustedCount.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,374 @@
+// src/utils/pixel_kernels.cpp
+// Premultiplied-alpha row kernels with runtime kernel dispatch
+
+#include "pixel_kernels.h"
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PIXEL_X86_KERNELS 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+typedef void (*BlendRowFn)(uint32_t* out, const uint32_t* in, size_t count, uint32_t alpha);
+typedef void (*BlendSolidRowFn)(uint32_t* out, uint32_t pixel, size_t count, uint32_t alpha);
+typedef void (*FillRowFn)(uint32_t* out, uint32_t pixel, size_t count);
+
+// ----------------------------------------------------------------------------
+// Scalar kernels (reference results; also the tails of the vector kernels)
+// ----------------------------------------------------------------------------
+
+// Red and blue are handled together in one word, alpha and green in another;
+// each channel is divided by 255 with rounding as (x + 128 + ((x + 128) >> 8)) >> 8
+static inline uint32_t ScalePixel(uint32_t source, uint32_t alpha) {
+    uint32_t rb = (source & 0x00FF00FFu) * alpha + 0x00800080u;
+    uint32_t ag = ((source >> 8) & 0x00FF00FFu) * alpha + 0x00800080u;
+    rb = ((rb + ((rb >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+    ag = ((ag + ((ag >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+    return rb | (ag << 8);
+}
+
+// source scaled by alpha, then over destination
+static inline uint32_t BlendPixel(uint32_t source, uint32_t destination, uint32_t alpha) {
+    uint32_t scaled = ScalePixel(source, alpha);
+    return scaled + ScalePixel(destination, 255 - (scaled >> 24));
+}
+
+static void BlendRowScalar(uint32_t* out, const uint32_t* in, size_t count, uint32_t alpha) {
+    if (alpha == 255) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t source = in[i];
+            uint32_t sourceAlpha = source >> 24;
+            if (sourceAlpha == 255) {
+                out[i] = source;
+            } else if (source != 0) {
+                out[i] = BlendPixel(source, out[i], 255);
+            }
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; i++) out[i] = BlendPixel(in[i], out[i], alpha);
+}
+
+static void BlendSolidRowScalar(uint32_t* out, uint32_t pixel, size_t count, uint32_t alpha) {
+    uint32_t scaled = ScalePixel(pixel, alpha);
+    uint32_t keep = 255 - (scaled >> 24);
+    for (size_t i = 0; i < count; i++) out[i] = scaled + ScalePixel(out[i], keep);
+}
+
+static void ScaleRowScalar(uint32_t* out, const uint32_t* in, size_t count, uint32_t alpha) {
+    for (size_t i = 0; i < count; i++) out[i] = ScalePixel(in[i], alpha);
+}
+
+static void FillRowScalar(uint32_t* out, uint32_t pixel, size_t count) {
+    for (size_t i = 0; i < count; i++) out[i] = pixel;
+}
+
+#ifdef PIXEL_X86_KERNELS
+
+// ----------------------------------------------------------------------------
+// SSE2 kernels: four pixels per step, each channel widened to 16 bits
+// (255 * 255 + 255 still fits, so the rounding matches the scalar code)
+// ----------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+static inline __m128i Div255Sse2(__m128i product) {
+    __m128i x = _mm_add_epi16(product, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// Each pixel's alpha copied to its four channels
+__attribute__((target("sse2")))
+static inline __m128i AlphaSse2(__m128i widened) {
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(widened, 0xFF), 0xFF);
+}
+
+// Two widened pixels: source (already scaled) over destination
+__attribute__((target("sse2")))
+static inline __m128i OverSse2(__m128i source, __m128i destination) {
+    __m128i keep = _mm_sub_epi16(_mm_set1_epi16(255), AlphaSse2(source));
+    return _mm_add_epi16(source, Div255Sse2(_mm_mullo_epi16(destination, keep)));
+}
+
+__attribute__((target("sse2")))
+static void BlendRowSse2(uint32_t* out, const uint32_t* in, size_t count, uint32_t alpha) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000u);
+    const __m128i factor = _mm_set1_epi16((short)alpha);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i source = _mm_loadu_si128((const __m128i*)(in + i));
+        if (alpha == 255) {
+            // Bodies are mostly opaque: copy those runs, skip empty ones
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(source, alphaMask), alphaMask)) == 0xFFFF) {
+                _mm_storeu_si128((__m128i*)(out + i), source);
+                continue;
+            }
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(source, zero)) == 0xFFFF) continue;
+        }
+        __m128i destination = _mm_loadu_si128((const __m128i*)(out + i));
+        __m128i low = Div255Sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(source, zero), factor));
+        __m128i high = Div255Sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(source, zero), factor));
+        low = OverSse2(low, _mm_unpacklo_epi8(destination, zero));
+        high = OverSse2(high, _mm_unpackhi_epi8(destination, zero));
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(low, high));
+    }
+    BlendRowScalar(out + i, in + i, count - i, alpha);
+}
+
+__attribute__((target("sse2")))
+static void BlendSolidRowSse2(uint32_t* out, uint32_t pixel, size_t count, uint32_t alpha) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i scaled = _mm_unpacklo_epi8(_mm_set1_epi32((int)ScalePixel(pixel, alpha)), zero);
+    __m128i keep = _mm_sub_epi16(_mm_set1_epi16(255), AlphaSse2(scaled));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i destination = _mm_loadu_si128((const __m128i*)(out + i));
+        __m128i low = Div255Sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(destination, zero), keep));
+        __m128i high = Div255Sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(destination, zero), keep));
+        low = _mm_add_epi16(scaled, low);
+        high = _mm_add_epi16(scaled, high);
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(low, high));
+    }
+    BlendSolidRowScalar(out + i, pixel, count - i, alpha);
+}
+
+__attribute__((target("sse2")))
+static void ScaleRowSse2(uint32_t* out, const uint32_t* in, size_t count, uint32_t alpha) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i factor = _mm_set1_epi16((short)alpha);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i source = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i low = Div255Sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(source, zero), factor));
+        __m128i high = Div255Sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(source, zero), factor));
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(low, high));
+    }
+    ScaleRowScalar(out + i, in + i, count - i, alpha);
+}
+
+__attribute__((target("sse2")))
+static void FillRowSse2(uint32_t* out, uint32_t pixel, size_t count) {
+    const __m128i value = _mm_set1_epi32((int)pixel);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) _mm_storeu_si128((__m128i*)(out + i), value);
+    FillRowScalar(out + i, pixel, count - i);
+}
+
+// ----------------------------------------------------------------------------
+// AVX2 kernels: the SSE2 steps on eight pixels. Unpack and pack both work
+// within 128-bit halves, so pixels come back out in order. The last one to
+// seven pixels go to the SSE2 kernels, which are legacy-encoded: running
+// them with the upper YMM halves dirty costs a state transition or a false
+// dependency on every instruction, so each tail clears them first.
+// ----------------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+static inline __m256i Div255Avx2(__m256i product) {
+    __m256i x = _mm256_add_epi16(product, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i AlphaAvx2(__m256i widened) {
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(widened, 0xFF), 0xFF);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i OverAvx2(__m256i source, __m256i destination) {
+    __m256i keep = _mm256_sub_epi16(_mm256_set1_epi16(255), AlphaAvx2(source));
+    return _mm256_add_epi16(source, Div255Avx2(_mm256_mullo_epi16(destination, keep)));
+}
+
+__attribute__((target("avx2")))
+static void BlendRowAvx2(uint32_t* out, const uint32_t* in, size_t count, uint32_t alpha) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alphaMask = _mm256_set1_epi32((int)0xFF000000u);
+    const __m256i factor = _mm256_set1_epi16((short)alpha);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i source = _mm256_loadu_si256((const __m256i*)(in + i));
+        if (alpha == 255) {
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(source, alphaMask), alphaMask)) == -1) {
+                _mm256_storeu_si256((__m256i*)(out + i), source);
+                continue;
+            }
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(source, zero)) == -1) continue;
+        }
+        __m256i destination = _mm256_loadu_si256((const __m256i*)(out + i));
+        __m256i low = Div255Avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(source, zero), factor));
+        __m256i high = Div255Avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(source, zero), factor));
+        low = OverAvx2(low, _mm256_unpacklo_epi8(destination, zero));
+        high = OverAvx2(high, _mm256_unpackhi_epi8(destination, zero));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_packus_epi16(low, high));
+    }
+    _mm256_zeroupper();
+    BlendRowSse2(out + i, in + i, count - i, alpha);
+}
+
+__attribute__((target("avx2")))
+static void BlendSolidRowAvx2(uint32_t* out, uint32_t pixel, size_t count, uint32_t alpha) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i scaled = _mm256_unpacklo_epi8(_mm256_set1_epi32((int)ScalePixel(pixel, alpha)), zero);
+    __m256i keep = _mm256_sub_epi16(_mm256_set1_epi16(255), AlphaAvx2(scaled));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i destination = _mm256_loadu_si256((const __m256i*)(out + i));
+        __m256i low = Div255Avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(destination, zero), keep));
+        __m256i high = Div255Avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(destination, zero), keep));
+        low = _mm256_add_epi16(scaled, low);
+        high = _mm256_add_epi16(scaled, high);
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_packus_epi16(low, high));
+    }
+    _mm256_zeroupper();
+    BlendSolidRowSse2(out + i, pixel, count - i, alpha);
+}
+
+__attribute__((target("avx2")))
+static void ScaleRowAvx2(uint32_t* out, const uint32_t* in, size_t count, uint32_t alpha) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i factor = _mm256_set1_epi16((short)alpha);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i source = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i low = Div255Avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(source, zero), factor));
+        __m256i high = Div255Avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(source, zero), factor));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_packus_epi16(low, high));
+    }
+    _mm256_zeroupper();
+    ScaleRowSse2(out + i, in + i, count - i, alpha);
+}
+
+__attribute__((target("avx2")))
+static void FillRowAvx2(uint32_t* out, uint32_t pixel, size_t count) {
+    const __m256i value = _mm256_set1_epi32((int)pixel);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) _mm256_storeu_si256((__m256i*)(out + i), value);
+    _mm256_zeroupper();
+    FillRowSse2(out + i, pixel, count - i);
+}
+
+#endif // PIXEL_X86_KERNELS
+
+// ----------------------------------------------------------------------------
+// Runtime dispatch
+// ----------------------------------------------------------------------------
+
+struct PixelDispatch {
+    PixelKernel kernel;
+    BlendRowFn blend;
+    BlendSolidRowFn blendSolid;
+    BlendRowFn scale;
+    FillRowFn fill;
+};
+
+// One table per kernel preference, built once from the CPU's features and
+// never written again; ForcePixelKernel() only switches which one is read
+struct PixelDispatchTables {
+    PixelDispatch byPreference[3]; // Indexed by PixelKernel
+};
+
+static PixelDispatch SelectKernels(PixelKernel preferred, bool hasSse2, bool hasAvx2) {
+    PixelDispatch dispatch = { PIXEL_KERNEL_SCALAR, BlendRowScalar, BlendSolidRowScalar, ScaleRowScalar, FillRowScalar };
+#ifdef PIXEL_X86_KERNELS
+    if (hasAvx2 && preferred == PIXEL_KERNEL_AVX2) {
+        dispatch.kernel = PIXEL_KERNEL_AVX2;
+        dispatch.blend = BlendRowAvx2;
+        dispatch.blendSolid = BlendSolidRowAvx2;
+        dispatch.scale = ScaleRowAvx2;
+        dispatch.fill = FillRowAvx2;
+    } else if (hasSse2 && preferred != PIXEL_KERNEL_SCALAR) {
+        dispatch.kernel = PIXEL_KERNEL_SSE2;
+        dispatch.blend = BlendRowSse2;
+        dispatch.blendSolid = BlendSolidRowSse2;
+        dispatch.scale = ScaleRowSse2;
+        dispatch.fill = FillRowSse2;
+    }
+#endif
+    return dispatch;
+}
+
+static PixelDispatchTables DetectCpuFeatures() {
+    bool hasSse2 = false;
+    bool hasAvx2 = false;
+#ifdef PIXEL_X86_KERNELS
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        hasSse2 = (edx & (1u << 26)) != 0;
+        bool osxsave = (ecx & (1u << 27)) != 0;
+        bool avxState = false;
+        if (osxsave) {
+            unsigned int xcr0Low, xcr0High;
+            __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+            avxState = (xcr0Low & 0x6) == 0x6; // XMM and YMM state enabled by the OS
+        }
+        if (__get_cpuid_max(0, nullptr) >= 7) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            hasAvx2 = avxState && (ebx & (1u << 5)) != 0;
+        }
+    }
+#endif
+    PixelDispatchTables tables;
+    for (int kernel = PIXEL_KERNEL_SCALAR; kernel <= PIXEL_KERNEL_AVX2; kernel++) {
+        tables.byPreference[kernel] = SelectKernels((PixelKernel)kernel, hasSse2, hasAvx2);
+    }
+    return tables;
+}
+
+static std::atomic<int> g_pixelPreference(PIXEL_KERNEL_AVX2); // Best available
+
+static inline const PixelDispatch& GetDispatch() {
+    // Initialized exactly once, however many threads composite first together
+    static const PixelDispatchTables tables = DetectCpuFeatures();
+    return tables.byPreference[g_pixelPreference.load(std::memory_order_relaxed)];
+}
+
+PixelKernel GetPixelKernel() {
+    return GetDispatch().kernel;
+}
+
+const char* PixelKernelName(PixelKernel kernel) {
+    switch (kernel) {
+        case PIXEL_KERNEL_SSE2: return "SSE2";
+        case PIXEL_KERNEL_AVX2: return "AVX2";
+        default: return "scalar";
+    }
+}
+
+void ForcePixelKernel(PixelKernel kernel) {
+    if (kernel < PIXEL_KERNEL_SCALAR || kernel > PIXEL_KERNEL_AVX2) return;
+    g_pixelPreference.store(kernel, std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+// Public API
+// ----------------------------------------------------------------------------
+
+void PixelBlendRow(uint32_t* out, const uint32_t* in, size_t count, uint8_t alpha) {
+    if (alpha == 0 || count == 0) return;
+    GetDispatch().blend(out, in, count, alpha);
+}
+
+void PixelBlendSolidRow(uint32_t* out, uint32_t pixel, size_t count, uint8_t alpha) {
+    if (alpha == 0 || count == 0) return;
+    const PixelDispatch& dispatch = GetDispatch();
+    if (alpha == 255 && (pixel >> 24) == 255) {
+        dispatch.fill(out, pixel, count);
+    } else {
+        dispatch.blendSolid(out, pixel, count, alpha);
+    }
+}
+
+void PixelScaleRow(uint32_t* out, const uint32_t* in, size_t count, uint8_t alpha) {
+    if (count == 0) return;
+    const PixelDispatch& dispatch = GetDispatch();
+    if (alpha == 0) {
+        dispatch.fill(out, 0, count);
+    } else {
+        dispatch.scale(out, in, count, alpha);
+    }
+}
+
+void PixelFillRow(uint32_t* out, uint32_t pixel, size_t count) {
+    GetDispatch().fill(out, pixel, count);
+}
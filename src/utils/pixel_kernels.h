@@ -0,0 +1,33 @@
+// src/utils/pixel_kernels.h
+// Premultiplied-alpha row kernels with runtime-selected scalar / SSE2 / AVX2 code (portable)
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Pixels are 0xAARRGGBB with colour premultiplied by alpha. Every kernel
+// divides by 255 with rounding, and all of them give bit-identical results
+// for premultiplied input (colour channels never above alpha).
+enum PixelKernel {
+    PIXEL_KERNEL_SCALAR = 0,
+    PIXEL_KERNEL_SSE2 = 1, // 4 pixels per step
+    PIXEL_KERNEL_AVX2 = 2  // 8 pixels per step
+};
+
+// out = in scaled by alpha, over out (source-over; alpha 255 = plain over)
+void PixelBlendRow(uint32_t* out, const uint32_t* in, size_t count, uint8_t alpha);
+
+// out = pixel scaled by alpha, over out
+void PixelBlendSolidRow(uint32_t* out, uint32_t pixel, size_t count, uint8_t alpha);
+
+// out = in scaled by alpha, replacing out (a fade onto a transparent frame)
+void PixelScaleRow(uint32_t* out, const uint32_t* in, size_t count, uint8_t alpha);
+
+void PixelFillRow(uint32_t* out, uint32_t pixel, size_t count);
+
+// Kernel in use on this CPU
+PixelKernel GetPixelKernel();
+const char* PixelKernelName(PixelKernel kernel);
+
+// Restrict dispatch (e.g. to compare kernels); requests the CPU cannot run are ignored
+void ForcePixelKernel(PixelKernel kernel);
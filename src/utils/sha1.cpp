@@ -0,0 +1,74 @@
+// src/utils/sha1.cpp
+// SHA-1 implementation (FIPS 180-4), scalar only
+
+#include "sha1.h"
+#include <cstring>
+
+static inline uint32_t LoadBE32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline uint32_t Rotl(uint32_t x, int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+static void Compress(uint32_t* state, const uint8_t* block) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) w[i] = LoadBE32(block + i * 4);
+    for (int i = 16; i < 80; i++) w[i] = Rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (int i = 0; i < 80; i++) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t t = Rotl(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = Rotl(b, 30);
+        b = a;
+        a = t;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+void Sha1(const void* data, size_t length, uint8_t* digest) {
+    uint32_t state[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    const uint8_t* bytes = (const uint8_t*)data;
+
+    size_t full = length / 64;
+    for (size_t i = 0; i < full; i++) Compress(state, bytes + i * 64);
+
+    // Final one or two blocks: tail, 0x80, zeros, bit length
+    uint8_t tail[128];
+    size_t tailLength = length - full * 64;
+    size_t blocks = (tailLength < 56) ? 1 : 2;
+    memset(tail, 0, sizeof(tail));
+    memcpy(tail, bytes + full * 64, tailLength);
+    tail[tailLength] = 0x80;
+    uint64_t bits = (uint64_t)length * 8;
+    for (int i = 0; i < 8; i++) tail[blocks * 64 - 1 - i] = (uint8_t)(bits >> (8 * i));
+    for (size_t i = 0; i < blocks; i++) Compress(state, tail + i * 64);
+
+    for (int i = 0; i < 5; i++) {
+        digest[i * 4] = (uint8_t)(state[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t)(state[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t)(state[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t)state[i];
+    }
+}
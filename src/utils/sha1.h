@@ -0,0 +1,12 @@
+// src/utils/sha1.h
+// Self-contained SHA-1, only for HMAC-SHA1 one-time codes (RFC 6238 defaults)
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+const size_t SHA1_DIGEST_SIZE = 20;
+
+// Hash one message into digest (20 bytes). SHA-1 is broken for collision
+// resistance; HMAC-SHA1 is not, which is the only use it has here.
+void Sha1(const void* data, size_t length, uint8_t* digest);
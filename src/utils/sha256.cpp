@@ -0,0 +1,387 @@
+// src/utils/sha256.cpp
+// SHA-256 implementation (FIPS 180-4) with runtime kernel dispatch
+
+#include "sha256.h"
+#include <atomic>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHA256_X86_KERNELS 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t INITIAL_STATE[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+typedef void (*CompressFn)(uint32_t* state, const uint8_t* blocks, size_t blockCount);
+
+static inline uint32_t LoadBE32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline void StoreBE32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static inline uint32_t Rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+// Pads the tail of a message into one or two final blocks; returns the block count
+static size_t PadFinalBlocks(const uint8_t* tail, size_t tailLength, uint64_t totalLength, uint8_t* out) {
+    size_t blocks = (tailLength < 56) ? 1 : 2;
+    memset(out, 0, blocks * 64);
+    memcpy(out, tail, tailLength);
+    out[tailLength] = 0x80;
+    uint64_t bits = totalLength * 8;
+    for (int i = 0; i < 8; i++) {
+        out[blocks * 64 - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+    return blocks;
+}
+
+// ----------------------------------------------------------------------------
+// Scalar kernel
+// ----------------------------------------------------------------------------
+
+static void CompressScalar(uint32_t* state, const uint8_t* blocks, size_t blockCount) {
+    uint32_t w[64];
+    for (size_t block = 0; block < blockCount; block++, blocks += 64) {
+        for (int t = 0; t < 16; t++) {
+            w[t] = LoadBE32(blocks + t * 4);
+        }
+        for (int t = 16; t < 64; t++) {
+            uint32_t s0 = Rotr(w[t - 15], 7) ^ Rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+            uint32_t s1 = Rotr(w[t - 2], 17) ^ Rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int t = 0; t < 64; t++) {
+            uint32_t s1 = Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t t1 = h + s1 + ch + K[t] + w[t];
+            uint32_t s0 = Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t t2 = s0 + maj;
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+#ifdef SHA256_X86_KERNELS
+
+// ----------------------------------------------------------------------------
+// SHA-NI kernel (Intel SHA extensions)
+// ----------------------------------------------------------------------------
+
+__attribute__((target("sha,sse4.1,ssse3")))
+static void CompressShaNi(uint32_t* state, const uint8_t* blocks, size_t blockCount) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // Rearrange state into the ABEF / CDGH layout the instructions expect
+    __m128i tmp = _mm_loadu_si128((const __m128i*)&state[0]);
+    __m128i state1 = _mm_loadu_si128((const __m128i*)&state[4]);
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);            // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1B);      // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);   // CDGH
+
+    for (size_t block = 0; block < blockCount; block++, blocks += 64) {
+        __m128i abefSave = state0;
+        __m128i cdghSave = state1;
+
+        __m128i w[4];
+        for (int i = 0; i < 4; i++) {
+            w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks + i * 16)), byteSwap);
+        }
+
+        for (int group = 0; group < 16; group++) {
+            __m128i msg = _mm_add_epi32(w[group & 3], _mm_loadu_si128((const __m128i*)&K[group * 4]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+            if (group < 12) {
+                // W[g+4] = msg2(msg1(W[g], W[g+1]) + W[g+2..g+3] shifted by one word, W[g+3])
+                __m128i next = _mm_sha256msg1_epu32(w[group & 3], w[(group + 1) & 3]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(w[(group + 3) & 3], w[(group + 2) & 3], 4));
+                w[group & 3] = _mm_sha256msg2_epu32(next, w[(group + 3) & 3]);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);         // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);      // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);   // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);      // HGFE
+    _mm_storeu_si128((__m128i*)&state[0], state0);
+    _mm_storeu_si128((__m128i*)&state[4], state1);
+}
+
+// ----------------------------------------------------------------------------
+// AVX2 multi-buffer kernel: eight independent single-block messages per pass
+// ----------------------------------------------------------------------------
+
+#define SHA256_ROTR8(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+
+__attribute__((target("avx2")))
+static void CompressAvx2x8(const uint8_t (*blocks)[64], uint8_t (*digests)[SHA256_DIGEST_SIZE], size_t lanes) {
+    __m256i w[64];
+    for (int t = 0; t < 16; t++) {
+        uint32_t words[8] = {0};
+        for (size_t lane = 0; lane < lanes; lane++) {
+            words[lane] = LoadBE32(blocks[lane] + t * 4);
+        }
+        w[t] = _mm256_loadu_si256((const __m256i*)words);
+    }
+    for (int t = 16; t < 64; t++) {
+        __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROTR8(w[t - 15], 7), SHA256_ROTR8(w[t - 15], 18)),
+                                      _mm256_srli_epi32(w[t - 15], 3));
+        __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROTR8(w[t - 2], 17), SHA256_ROTR8(w[t - 2], 19)),
+                                      _mm256_srli_epi32(w[t - 2], 10));
+        w[t] = _mm256_add_epi32(_mm256_add_epi32(w[t - 16], s0), _mm256_add_epi32(w[t - 7], s1));
+    }
+
+    __m256i a = _mm256_set1_epi32((int)INITIAL_STATE[0]), b = _mm256_set1_epi32((int)INITIAL_STATE[1]);
+    __m256i c = _mm256_set1_epi32((int)INITIAL_STATE[2]), d = _mm256_set1_epi32((int)INITIAL_STATE[3]);
+    __m256i e = _mm256_set1_epi32((int)INITIAL_STATE[4]), f = _mm256_set1_epi32((int)INITIAL_STATE[5]);
+    __m256i g = _mm256_set1_epi32((int)INITIAL_STATE[6]), h = _mm256_set1_epi32((int)INITIAL_STATE[7]);
+
+    for (int t = 0; t < 64; t++) {
+        __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROTR8(e, 6), SHA256_ROTR8(e, 11)), SHA256_ROTR8(e, 25));
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, s1),
+                                      _mm256_add_epi32(ch, _mm256_add_epi32(_mm256_set1_epi32((int)K[t]), w[t])));
+        __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROTR8(a, 2), SHA256_ROTR8(a, 13)), SHA256_ROTR8(a, 22));
+        __m256i maj = _mm256_xor_si256(_mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(a, c)),
+                                       _mm256_and_si256(b, c));
+        __m256i t2 = _mm256_add_epi32(s0, maj);
+        h = g; g = f; f = e; e = _mm256_add_epi32(d, t1);
+        d = c; c = b; b = a; a = _mm256_add_epi32(t1, t2);
+    }
+
+    __m256i finalState[8] = { a, b, c, d, e, f, g, h };
+    for (int i = 0; i < 8; i++) {
+        uint32_t words[8];
+        _mm256_storeu_si256((__m256i*)words, _mm256_add_epi32(finalState[i], _mm256_set1_epi32((int)INITIAL_STATE[i])));
+        for (size_t lane = 0; lane < lanes; lane++) {
+            StoreBE32(digests[lane] + i * 4, words[lane]);
+        }
+    }
+}
+
+#undef SHA256_ROTR8
+
+#endif // SHA256_X86_KERNELS
+
+// ----------------------------------------------------------------------------
+// Dispatch
+// ----------------------------------------------------------------------------
+
+struct Sha256Dispatch {
+    Sha256Kernel singleKernel;
+    Sha256Kernel batchKernel;
+    CompressFn compress;
+};
+
+// One table per kernel preference, built once from the CPU's features and
+// never written again; ForceSha256Kernel() only switches which one is read
+struct Sha256DispatchTables {
+    Sha256Dispatch byPreference[3]; // Indexed by Sha256Kernel
+};
+
+static Sha256Dispatch SelectKernels(Sha256Kernel preferred, bool hasShaNi, bool hasAvx2) {
+    Sha256Dispatch dispatch = { SHA256_KERNEL_SCALAR, SHA256_KERNEL_SCALAR, CompressScalar };
+#ifdef SHA256_X86_KERNELS
+    if (hasShaNi && preferred != SHA256_KERNEL_SCALAR) {
+        dispatch.singleKernel = SHA256_KERNEL_SHANI;
+        dispatch.compress = CompressShaNi;
+    }
+#endif
+    dispatch.batchKernel = (hasAvx2 && preferred != SHA256_KERNEL_SCALAR &&
+                            preferred != SHA256_KERNEL_SHANI) ? SHA256_KERNEL_AVX2 : dispatch.singleKernel;
+    return dispatch;
+}
+
+static Sha256DispatchTables DetectCpuFeatures() {
+    bool hasShaNi = false;
+    bool hasAvx2 = false;
+#ifdef SHA256_X86_KERNELS
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        bool ssse3 = (ecx & (1u << 9)) != 0;
+        bool sse41 = (ecx & (1u << 19)) != 0;
+        bool osxsave = (ecx & (1u << 27)) != 0;
+        bool avxState = false;
+        if (osxsave) {
+            unsigned int xcr0Low, xcr0High;
+            __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+            avxState = (xcr0Low & 0x6) == 0x6; // XMM and YMM state enabled by the OS
+        }
+        if (__get_cpuid_max(0, nullptr) >= 7) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            hasShaNi = ssse3 && sse41 && (ebx & (1u << 29)) != 0;
+            hasAvx2 = avxState && (ebx & (1u << 5)) != 0;
+        }
+    }
+#endif
+    Sha256DispatchTables tables;
+    for (int kernel = SHA256_KERNEL_SCALAR; kernel <= SHA256_KERNEL_AVX2; kernel++) {
+        tables.byPreference[kernel] = SelectKernels((Sha256Kernel)kernel, hasShaNi, hasAvx2);
+    }
+    return tables;
+}
+
+static std::atomic<int> g_sha256Preference(SHA256_KERNEL_AVX2); // Best available
+
+static inline const Sha256Dispatch& GetDispatch() {
+    // Initialized exactly once, even when the UI thread and the verification
+    // worker hash for the first time together
+    static const Sha256DispatchTables tables = DetectCpuFeatures();
+    return tables.byPreference[g_sha256Preference.load(std::memory_order_relaxed)];
+}
+
+Sha256Kernel GetSha256Kernel() {
+    return GetDispatch().singleKernel;
+}
+
+Sha256Kernel GetSha256BatchKernel() {
+    return GetDispatch().batchKernel;
+}
+
+const char* Sha256KernelName(Sha256Kernel kernel) {
+    switch (kernel) {
+        case SHA256_KERNEL_SHANI: return "SHA-NI";
+        case SHA256_KERNEL_AVX2: return "AVX2 x8";
+        default: return "scalar";
+    }
+}
+
+void ForceSha256Kernel(Sha256Kernel kernel) {
+    if (kernel < SHA256_KERNEL_SCALAR || kernel > SHA256_KERNEL_AVX2) return;
+    g_sha256Preference.store(kernel, std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+// Public API
+// ----------------------------------------------------------------------------
+
+void Sha256(const void* data, size_t length, uint8_t* digest) {
+    const Sha256Dispatch& dispatch = GetDispatch();
+    const uint8_t* bytes = (const uint8_t*)data;
+
+    uint32_t state[8];
+    memcpy(state, INITIAL_STATE, sizeof(state));
+
+    size_t fullBlocks = length / 64;
+    if (fullBlocks) {
+        dispatch.compress(state, bytes, fullBlocks);
+    }
+
+    uint8_t tail[128];
+    size_t tailBlocks = PadFinalBlocks(bytes + fullBlocks * 64, length % 64, length, tail);
+    dispatch.compress(state, tail, tailBlocks);
+
+    for (int i = 0; i < 8; i++) {
+        StoreBE32(digest + i * 4, state[i]);
+    }
+}
+
+void Sha256Batch(const uint8_t* const* messages, const size_t* lengths, size_t count,
+                 uint8_t (*digests)[SHA256_DIGEST_SIZE]) {
+    const Sha256Dispatch& dispatch = GetDispatch();
+
+#ifdef SHA256_X86_KERNELS
+    if (dispatch.batchKernel == SHA256_KERNEL_AVX2 && count > 1) {
+        uint8_t blocks[8][64];
+        size_t laneIndex[8];
+        size_t lanes = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            if (lengths[i] > SHA256_BATCH_MAX_LENGTH) {
+                Sha256(messages[i], lengths[i], digests[i]); // Multi-block: hash on its own
+                continue;
+            }
+            PadFinalBlocks(messages[i], lengths[i], lengths[i], blocks[lanes]);
+            laneIndex[lanes++] = i;
+
+            if (lanes == 8 || i + 1 == count) {
+                uint8_t laneDigests[8][SHA256_DIGEST_SIZE];
+                CompressAvx2x8(blocks, laneDigests, lanes);
+                for (size_t lane = 0; lane < lanes; lane++) {
+                    memcpy(digests[laneIndex[lane]], laneDigests[lane], SHA256_DIGEST_SIZE);
+                }
+                lanes = 0;
+            }
+        }
+        if (lanes > 0) {
+            uint8_t laneDigests[8][SHA256_DIGEST_SIZE];
+            CompressAvx2x8(blocks, laneDigests, lanes);
+            for (size_t lane = 0; lane < lanes; lane++) {
+                memcpy(digests[laneIndex[lane]], laneDigests[lane], SHA256_DIGEST_SIZE);
+            }
+        }
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < count; i++) {
+        Sha256(messages[i], lengths[i], digests[i]);
+    }
+}
+
+bool Sha256DigestEquals(const uint8_t* a, const uint8_t* b) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        diff |= (uint8_t)(a[i] ^ b[i]);
+    }
+    return diff == 0;
+}
+
+void Sha256ToHex(const uint8_t* digest, char* out) {
+    static const char HEX[] = "0123456789abcdef";
+    for (size_t i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        out[i * 2] = HEX[digest[i] >> 4];
+        out[i * 2 + 1] = HEX[digest[i] & 0x0F];
+    }
+    out[SHA256_DIGEST_SIZE * 2] = '\0';
+}
+
+bool Sha256FromHex(const char* hex, uint8_t* digest) {
+    for (size_t i = 0; i < SHA256_DIGEST_SIZE * 2; i++) {
+        char ch = hex[i];
+        uint8_t nibble;
+        if (ch >= '0' && ch <= '9') nibble = (uint8_t)(ch - '0');
+        else if (ch >= 'a' && ch <= 'f') nibble = (uint8_t)(ch - 'a' + 10);
+        else if (ch >= 'A' && ch <= 'F') nibble = (uint8_t)(ch - 'A' + 10);
+        else return false;
+
+        if (i & 1) digest[i / 2] |= nibble;
+        else digest[i / 2] = (uint8_t)(nibble << 4);
+    }
+    return hex[SHA256_DIGEST_SIZE * 2] == '\0';
+}
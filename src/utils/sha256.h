@@ -0,0 +1,41 @@
+// src/utils/sha256.h
+// Self-contained SHA-256 with runtime-selected scalar / SHA-NI / AVX2 kernels
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+const size_t SHA256_DIGEST_SIZE = 32;
+
+// Longest message the AVX2 multi-buffer kernel hashes in a single block
+// (64-byte block minus the 0x80 terminator and the 8-byte length field)
+const size_t SHA256_BATCH_MAX_LENGTH = 55;
+
+enum Sha256Kernel {
+    SHA256_KERNEL_SCALAR = 0,
+    SHA256_KERNEL_SHANI = 1,   // Intel SHA extensions, one message at a time
+    SHA256_KERNEL_AVX2 = 2     // 8 short messages per pass (batch hashing only)
+};
+
+// Hash one message into digest (32 bytes)
+void Sha256(const void* data, size_t length, uint8_t* digest);
+
+// Hash count independent messages. Messages up to SHA256_BATCH_MAX_LENGTH
+// bytes are processed eight at a time when AVX2 is available.
+void Sha256Batch(const uint8_t* const* messages, const size_t* lengths, size_t count,
+                 uint8_t (*digests)[SHA256_DIGEST_SIZE]);
+
+// Kernel picked for single messages / batches on this CPU
+Sha256Kernel GetSha256Kernel();
+Sha256Kernel GetSha256BatchKernel();
+const char* Sha256KernelName(Sha256Kernel kernel);
+
+// Restrict dispatch (e.g. to compare kernels); requests the CPU cannot run are ignored
+void ForceSha256Kernel(Sha256Kernel kernel);
+
+// Constant-time digest comparison
+bool Sha256DigestEquals(const uint8_t* a, const uint8_t* b);
+
+// Lowercase hex encoding used for persisted hashes (out must hold 65 chars)
+void Sha256ToHex(const uint8_t* digest, char* out);
+bool Sha256FromHex(const char* hex, uint8_t* digest);
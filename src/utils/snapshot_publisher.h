@@ -0,0 +1,109 @@
+// src/utils/snapshot_publisher.h
+// Publishes immutable snapshots to one reader thread by atomic pointer swap, with deferred reclamation
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// Single-writer-at-a-time, single-reader publication of immutable snapshots.
+// The reader brackets each use with BeginRead()/EndRead(), which bump a
+// counter (odd while inside). Publish() swaps the pointer and retires the old
+// snapshot together with the counter value it saw; a retired snapshot is
+// freed once the counter was even or has moved on, so the reader never sees
+// freed memory and never waits. The reader must be one thread at a time.
+//
+// T needs a copy constructor and a uint32_t generation member, which the
+// publisher sets (the initial snapshot is generation 0).
+template <typename T>
+class SnapshotPublisher {
+private:
+    static const int MAX_RETIRED = 4;
+
+    struct Retired {
+        T* snapshot;
+        uint32_t readerState;
+    };
+
+    std::atomic<T*> current;
+    std::atomic<uint32_t> readerState;
+    std::mutex publishMutex;
+    Retired retired[MAX_RETIRED];
+    int retiredCount;
+    uint32_t generation;
+
+    bool CanReclaim(const Retired& entry) const {
+        // Even: the reader was outside a read section when the pointer moved, so
+        // its next section loads the new snapshot. Odd: wait for it to leave.
+        return (entry.readerState & 1) == 0 || readerState.load(std::memory_order_seq_cst) != entry.readerState;
+    }
+
+    // Caller holds publishMutex
+    void ReclaimRetired(bool wait) {
+        int kept = 0;
+        for (int i = 0; i < retiredCount; i++) {
+            while (wait && !CanReclaim(retired[i])) {
+                std::this_thread::yield(); // A read section is a few instructions long
+            }
+            if (CanReclaim(retired[i])) {
+                delete retired[i].snapshot;
+            } else {
+                retired[kept++] = retired[i];
+            }
+        }
+        retiredCount = kept;
+    }
+
+public:
+    explicit SnapshotPublisher(const T& initial) : readerState(0), retiredCount(0), generation(0) {
+        T* snapshot = new T(initial);
+        snapshot->generation = 0;
+        current.store(snapshot, std::memory_order_release);
+    }
+
+    ~SnapshotPublisher() {
+        // No reader may be active once the owner is destroyed
+        for (int i = 0; i < retiredCount; i++) {
+            delete retired[i].snapshot;
+        }
+        delete current.load(std::memory_order_acquire);
+    }
+
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+    // Writer (any thread)
+    void Publish(const T& value) {
+        T* snapshot = new T(value);
+
+        std::lock_guard<std::mutex> lock(publishMutex);
+        snapshot->generation = ++generation;
+
+        // Make room before retiring another snapshot
+        ReclaimRetired(retiredCount == MAX_RETIRED);
+
+        Retired entry;
+        entry.snapshot = current.exchange(snapshot, std::memory_order_seq_cst);
+        entry.readerState = readerState.load(std::memory_order_seq_cst);
+        retired[retiredCount++] = entry;
+
+        ReclaimRetired(false);
+    }
+
+    // Reader: the returned snapshot is valid until EndRead()
+    const T* BeginRead() {
+        readerState.fetch_add(1, std::memory_order_seq_cst);
+        return current.load(std::memory_order_seq_cst);
+    }
+    void EndRead() {
+        // Only the reader writes the counter, so leaving needs no locked instruction
+        readerState.store(readerState.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Snapshots published so far
+    uint32_t GetGeneration() {
+        std::lock_guard<std::mutex> lock(publishMutex);
+        return generation;
+    }
+};
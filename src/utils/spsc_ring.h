@@ -0,0 +1,62 @@
+// src/utils/spsc_ring.h
+// Fixed-capacity, allocation-free single-producer/single-consumer ring buffer
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free ring shared between exactly one producer thread and one consumer
+// thread. Storage is inline, so pushing never allocates and is safe to call
+// from a low-level hook callback. Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+private:
+    static const uint32_t MASK = (uint32_t)(Capacity - 1);
+
+    // Producer and consumer indices live on separate cache lines to avoid
+    // false sharing between the hook thread and the UI thread
+    alignas(64) std::atomic<uint32_t> head; // next slot to write (producer)
+    alignas(64) std::atomic<uint32_t> tail; // next slot to read (consumer)
+    alignas(64) T slots[Capacity];
+
+public:
+    SpscRing() : head(0), tail(0) {}
+
+    // Producer side: returns false (and drops the item) if the ring is full
+    bool Push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+        slots[h & MASK] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: copies up to maxItems entries into out, returns the count
+    size_t PopBatch(T* out, size_t maxItems) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        uint32_t available = head.load(std::memory_order_acquire) - t;
+        size_t count = available < maxItems ? available : maxItems;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = slots[(t + (uint32_t)i) & MASK];
+        }
+        tail.store(t + (uint32_t)count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side: discards everything currently queued
+    void Clear() {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    bool Empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    static size_t GetCapacity() { return Capacity; }
+};
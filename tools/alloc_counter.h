@@ -0,0 +1,143 @@
+// tools/alloc_counter.h
+// Counts heap allocations by replacing the global operator new (include in one tool source only)
+
+#pragma once
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+static std::atomic<unsigned long long> g_allocationCount(0);
+
+inline unsigned long long GetAllocationCount() {
+    return g_allocationCount.load(std::memory_order_relaxed);
+}
+
+// Every replaced operator new goes through these two, and every operator
+// delete through the matching release, so plain and over-aligned blocks
+// never reach the wrong free. The releases stay out of line: inlined into a
+// delete expression, GCC's -Wmismatched-new-delete sees free() called on
+// the result of operator new and warns, although the pair is ours.
+#ifdef __GNUC__
+#define ALLOC_COUNTER_NOINLINE __attribute__((noinline))
+#else
+#define ALLOC_COUNTER_NOINLINE
+#endif
+
+static void* CountedAllocate(std::size_t size) noexcept {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+static void* CountedAllocateAligned(std::size_t size, std::align_val_t alignment) noexcept {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = (std::size_t)alignment;
+    std::size_t rounded = (size + align - 1) / align * align; // aligned_alloc wants a multiple
+#ifdef _WIN32
+    return _aligned_malloc(rounded ? rounded : align, align);
+#else
+    return std::aligned_alloc(align, rounded ? rounded : align);
+#endif
+}
+
+ALLOC_COUNTER_NOINLINE static void Release(void* block) noexcept {
+    std::free(block);
+}
+
+ALLOC_COUNTER_NOINLINE static void ReleaseAligned(void* block) noexcept {
+#ifdef _WIN32
+    _aligned_free(block);
+#else
+    std::free(block);
+#endif
+}
+
+void* operator new(std::size_t size) {
+    void* block = CountedAllocate(size);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+
+void* operator new[](std::size_t size) {
+    void* block = CountedAllocate(size);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* block = CountedAllocateAligned(size, alignment);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    void* block = CountedAllocateAligned(size, alignment);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocateAligned(size, alignment);
+}
+
+void operator delete(void* block) noexcept {
+    Release(block);
+}
+
+void operator delete[](void* block) noexcept {
+    Release(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept {
+    Release(block);
+}
+
+void operator delete[](void* block, std::size_t) noexcept {
+    Release(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) noexcept {
+    Release(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept {
+    Release(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept {
+    ReleaseAligned(block);
+}
+
+void operator delete[](void* block, std::align_val_t) noexcept {
+    ReleaseAligned(block);
+}
+
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept {
+    ReleaseAligned(block);
+}
+
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept {
+    ReleaseAligned(block);
+}
+
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept {
+    ReleaseAligned(block);
+}
+
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept {
+    ReleaseAligned(block);
+}
@@ -0,0 +1,195 @@
+// tools/app_lock_rules_tests.cpp
+// AppLockRules parsing and matching, and how a locked LockEngine treats events outside the rule's scope
+//
+// From the repository root: g++ -std=c++17 -O2 -Isrc tools/app_lock_rules_tests.cpp
+//   src/features/lock_input/app_lock_rules.cpp src/features/lock_input/lock_engine.cpp
+//   src/features/lock_input/hook_policy.cpp src/features/lock_input/key_policy.cpp
+// Also times Match() on full image paths against a few hundred rules.
+
+#include "features/lock_input/app_lock_rules.h"
+#include "features/lock_input/key_event_ring.h"
+#include "tool_check.h"
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+static const uint16_t VK_CONTROL_KEY = 0x11;
+static const uint16_t VK_ESCAPE_KEY = 0x1B;
+
+static void CheckEmpty() {
+    AppLockRules rules;
+    CHECK(rules.IsEmpty() && rules.Match("C:\\Windows\\notepad.exe") == LOCK_SCOPE_NONE);
+    CHECK(rules.Parse("") == 0 && rules.IsEmpty());
+    CHECK(rules.Parse(" ;  ; ") == 0 && rules.IsEmpty());
+    CHECK(rules.Match("") == LOCK_SCOPE_NONE && rules.Match(nullptr) == LOCK_SCOPE_NONE);
+
+    // Parsing replaces the rules; Clear() drops them
+    CHECK(rules.Parse("kiosk.exe") == 1 && rules.Match("kiosk.exe") == LOCK_SCOPE_ALL);
+    CHECK(rules.Parse("vlc.exe") == 1 && rules.Match("kiosk.exe") == LOCK_SCOPE_NONE);
+    rules.Clear();
+    CHECK(rules.IsEmpty() && rules.Match("vlc.exe") == LOCK_SCOPE_NONE);
+}
+
+static void CheckParsing() {
+    AppLockRules rules;
+    CHECK(rules.Parse("kiosk.exe; vlc.exe = mouse;notepad.exe=KEYBOARD ; game.exe= All") == 4);
+    CHECK(rules.Match("kiosk.exe") == LOCK_SCOPE_ALL);
+    CHECK(rules.Match("vlc.exe") == LOCK_SCOPE_MOUSE);
+    CHECK(rules.Match("notepad.exe") == LOCK_SCOPE_KEYBOARD);
+    CHECK(rules.Match("game.exe") == LOCK_SCOPE_ALL);
+    CHECK(rules.Match("calc.exe") == LOCK_SCOPE_NONE);
+
+    // Unknown scopes, paths, empty names and trailing separators are skipped
+    CHECK(rules.Parse("a.exe=screen; b.exe=; C:\\apps\\c.exe; d/e.exe=mouse; =mouse; f.exe;") == 1);
+    CHECK(rules.Match("a.exe") == LOCK_SCOPE_NONE && rules.Match("b.exe") == LOCK_SCOPE_NONE);
+    CHECK(rules.Match("c.exe") == LOCK_SCOPE_NONE && rules.Match("e.exe") == LOCK_SCOPE_NONE);
+    CHECK(rules.Match("f.exe") == LOCK_SCOPE_ALL);
+
+    // Only the first '=' splits; the rest makes the scope unknown
+    CHECK(rules.Parse("g.exe=mouse=keyboard") == 0);
+
+    // A name listed twice keeps its first rule, in either order
+    CHECK(rules.Parse("dup.exe=mouse; DUP.EXE=keyboard; dup.exe") == 1);
+    CHECK(rules.Match("dup.exe") == LOCK_SCOPE_MOUSE);
+    CHECK(rules.Parse("dup.exe=keyboard; dup.exe=mouse") == 1 && rules.Match("dup.exe") == LOCK_SCOPE_KEYBOARD);
+}
+
+static void CheckMatching() {
+    AppLockRules rules;
+    CHECK(rules.Parse("Kiosk.EXE=keyboard; *.exe=mouse; vlc*=mouse; ?otepad.exe") == 4);
+
+    // Case never matters, on either side; the directory is ignored, with either separator
+    CHECK(rules.Match("kiosk.exe") == LOCK_SCOPE_KEYBOARD);
+    CHECK(rules.Match("KIOSK.exe") == LOCK_SCOPE_KEYBOARD);
+    CHECK(rules.Match("C:\\Program Files\\Kiosk\\KIOSK.EXE") == LOCK_SCOPE_KEYBOARD);
+    CHECK(rules.Match("\\\\?\\D:\\kiosk\\kiosk.exe") == LOCK_SCOPE_KEYBOARD);
+    CHECK(rules.Match("/opt/kiosk/kiosk.exe") == LOCK_SCOPE_KEYBOARD);
+    CHECK(rules.Match("C:\\kiosk.exe\\") == LOCK_SCOPE_NONE); // Directory, no file name
+
+    // Whole names only: no prefix, suffix or extension-less matches
+    CHECK(rules.Match("kiosk") == LOCK_SCOPE_NONE);
+    CHECK(rules.Match("kiosk.exe2") == LOCK_SCOPE_NONE);
+    CHECK(rules.Match("mykiosk.exe") == LOCK_SCOPE_NONE);
+
+    // No wildcards: '*' and '?' are literal characters of the name
+    CHECK(rules.Match("other.exe") == LOCK_SCOPE_NONE);
+    CHECK(rules.Match("vlc.exe") == LOCK_SCOPE_NONE);
+    CHECK(rules.Match("notepad.exe") == LOCK_SCOPE_NONE);
+    CHECK(rules.Match("*.exe") == LOCK_SCOPE_MOUSE);
+    CHECK(rules.Match("C:\\x\\VLC*") == LOCK_SCOPE_MOUSE);
+    CHECK(rules.Match("?otepad.exe") == LOCK_SCOPE_ALL);
+
+    // Many rules: every one found, names that only share a prefix are not
+    std::vector<std::string> names;
+    std::string text;
+    for (int i = 0; i < 300; i++) {
+        names.push_back("app" + std::to_string(i) + ".exe");
+        text += names.back() + (i % 3 == 0 ? "=mouse;" : i % 3 == 1 ? "=keyboard;" : ";");
+    }
+    CHECK(rules.Parse(text) == names.size());
+    size_t wrong = 0;
+    for (size_t i = 0; i < names.size(); i++) {
+        uint8_t expected = i % 3 == 0 ? LOCK_SCOPE_MOUSE : i % 3 == 1 ? LOCK_SCOPE_KEYBOARD : LOCK_SCOPE_ALL;
+        wrong += rules.Match(("C:\\Apps\\" + names[i]).c_str()) != expected;
+        wrong += rules.Match(("app" + std::to_string(i) + ".ex").c_str()) != LOCK_SCOPE_NONE;
+    }
+    CHECK(wrong == 0);
+}
+
+static InputEvent Event(InputDevice device, InputEventType type, uint16_t code, uint32_t time) {
+    InputEvent event;
+    memset(&event, 0, sizeof(event));
+    event.device = device;
+    event.type = type;
+    event.code = code;
+    event.time = time;
+    return event;
+}
+
+// A locked engine with keyboard and mouse locking on, under each scope
+static void CheckOutOfScopeRemap() {
+    LockEngineConfig config;
+    KeyPolicySettings settings;
+    settings.keyboardLockEnabled = true;
+    settings.whitelistEnabled = true;
+    settings.whitelistedKeys = DEFAULT_WHITELISTED_KEYS;
+    settings.unlockMethod = 0;
+    CompileKeyPolicy(settings, false, config.keyPolicy);
+    config.mouseBlockMask = MouseLockEventMask(MOUSE_LOCK_ALL);
+    config.failsafeEnabled = true;
+    config.unlockChords[0].modifiers = LOCK_MOD_CONTROL;
+    config.unlockChords[0].vkCode = 'O';
+
+    LockEngine engine;
+    engine.Configure(config);
+    engine.SetLocked(true);
+
+    static const uint8_t SCOPES[] = { LOCK_SCOPE_ALL, LOCK_SCOPE_KEYBOARD, LOCK_SCOPE_MOUSE, LOCK_SCOPE_NONE };
+    uint32_t time = 0;
+    for (size_t s = 0; s < sizeof(SCOPES); s++) {
+        engine.SetScope(SCOPES[s]);
+        bool keyboard = (SCOPES[s] & LOCK_SCOPE_KEYBOARD) != 0, mouse = (SCOPES[s] & LOCK_SCOPE_MOUSE) != 0;
+
+        // A password key is blocked and queued in scope; out of it, it passes unqueued
+        LockResult key = engine.Process(Event(INPUT_DEVICE_KEYBOARD, INPUT_EVENT_KEY_DOWN, 'A', time += 10));
+        CHECK(key.decision == (keyboard ? LOCK_DECISION_BLOCK : LOCK_DECISION_PASS));
+        CHECK(key.queueFlags == (keyboard ? KEY_EVENT_DOWN : 0));
+        LockResult release = engine.Process(Event(INPUT_DEVICE_KEYBOARD, INPUT_EVENT_KEY_UP, 'A', time += 10));
+        CHECK(release.decision == (keyboard ? LOCK_DECISION_BLOCK : LOCK_DECISION_PASS));
+
+        LockResult move = engine.Process(Event(INPUT_DEVICE_MOUSE, INPUT_EVENT_MOUSE_MOVE, 0, time += 10));
+        LockResult click = engine.Process(Event(INPUT_DEVICE_MOUSE, INPUT_EVENT_BUTTON_DOWN, INPUT_BUTTON_LEFT, time += 10));
+        CHECK(move.decision == (mouse ? LOCK_DECISION_BLOCK : LOCK_DECISION_PASS));
+        CHECK(click.decision == (mouse ? LOCK_DECISION_BLOCK : LOCK_DECISION_PASS));
+
+        // In any scope the unlock chord is swallowed and does not unlock
+        engine.Process(Event(INPUT_DEVICE_KEYBOARD, INPUT_EVENT_KEY_DOWN, VK_CONTROL_KEY, time += 10));
+        LockResult chord = engine.Process(Event(INPUT_DEVICE_KEYBOARD, INPUT_EVENT_KEY_DOWN, 'O', time += 10));
+        engine.Process(Event(INPUT_DEVICE_KEYBOARD, INPUT_EVENT_KEY_UP, 'O', time += 10));
+        engine.Process(Event(INPUT_DEVICE_KEYBOARD, INPUT_EVENT_KEY_UP, VK_CONTROL_KEY, time += 10));
+        CHECK(chord.decision == LOCK_DECISION_BLOCK && chord.queueFlags == 0);
+        CHECK(engine.GetState() == LOCK_STATE_LOCKED);
+
+        // ... and the failsafe still fires
+        time += 5000;
+        uint8_t decisions[3];
+        for (int i = 0; i < 3; i++) {
+            decisions[i] = engine.Process(Event(INPUT_DEVICE_KEYBOARD, INPUT_EVENT_KEY_DOWN, VK_ESCAPE_KEY, time += 100)).decision;
+        }
+        CHECK(decisions[0] == LOCK_DECISION_PASS && decisions[1] == LOCK_DECISION_PASS);
+        CHECK(decisions[2] == LOCK_DECISION_REQUEST_EXIT);
+        time += 5000;
+    }
+}
+
+static volatile uint64_t g_sink;
+
+int main() {
+    CheckEmpty();
+    CheckParsing();
+    CheckMatching();
+    CheckOutOfScopeRemap();
+
+    // A foreground change with 300 rules: full paths, three quarters unmatched
+    AppLockRules rules;
+    std::string text;
+    for (int i = 0; i < 300; i++) text += "app" + std::to_string(i) + ".exe;";
+    rules.Parse(text);
+    std::mt19937 random(15);
+    std::vector<std::string> paths;
+    for (int i = 0; i < 1024; i++) {
+        int n = (int)(random() % 1200);
+        paths.push_back("C:\\Program Files\\Vendor " + std::to_string(n) + "\\app" + std::to_string(n) + ".exe");
+    }
+    const int LOOKUPS = 2000000;
+    uint64_t matched = 0;
+    ToolClock::time_point start = ToolClock::now();
+    for (int i = 0; i < LOOKUPS; i++) matched += rules.Match(paths[i & 1023].c_str()) != LOCK_SCOPE_NONE;
+    double seconds = SecondsSince(start);
+    g_sink = matched;
+    printf("Match() against %zu rules: %.1f ns per full path (%.0f%% matched)\n", rules.GetRuleCount(),
+           seconds * 1e9 / LOOKUPS, matched * 100.0 / LOOKUPS);
+
+    return CheckResult("app_lock_rules_tests");
+}
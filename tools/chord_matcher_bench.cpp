@@ -0,0 +1,309 @@
+// tools/chord_matcher_bench.cpp
+// Chord matching cost per key press, and checks that a prefix no chord follows is given back
+//
+// From the repository root: g++ -std=c++17 -O2 -Isrc tools/chord_matcher_bench.cpp
+//   src/features/lock_input/chord_trie.cpp src/features/lock_input/lock_pipeline.cpp
+//   src/features/lock_input/lock_engine.cpp src/features/lock_input/hook_policy.cpp
+//   src/features/lock_input/key_policy.cpp src/features/lock_input/key_translation.cpp
+// Builds a few thousand random 2-4 stroke chords, then times the matcher on
+// its own and the unlocked pipeline with and without chords configured.
+
+#include "features/lock_input/lock_pipeline.h"
+#include "tool_check.h"
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const uint8_t VK_CONTROL_KEY = 0xA2; // VK_LCONTROL
+static const uint8_t VK_SHIFT_KEY = 0xA0;   // VK_LSHIFT
+static const uint8_t VK_MENU_KEY = 0xA4;    // VK_LMENU
+static const uint8_t VK_WIN_KEY = 0x5B;     // VK_LWIN
+
+static const uint16_t ACTION_LOCK = 1;
+static const uint16_t ACTION_BOSS_KEY = 2;
+
+static ChordStroke Stroke(uint8_t modifiers, uint8_t vkCode) {
+    ChordStroke stroke;
+    stroke.modifiers = modifiers;
+    stroke.vkCode = vkCode;
+    return stroke;
+}
+
+static bool SameStrokes(const ChordReplay& replay, const ChordStroke* expected, size_t count) {
+    if (replay.count != count) return false;
+    for (size_t i = 0; i < count; i++) {
+        if (replay.strokes[i].modifiers != expected[i].modifiers || replay.strokes[i].vkCode != expected[i].vkCode) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Ctrl+K, L = Lock and Ctrl+K, B = BossKey, plus Alt+Q, F5 = BossKey
+static void BuildSampleTrie(ChordTrie& trie) {
+    ChordStroke lock[] = { Stroke(LOCK_MOD_CONTROL, 'K'), Stroke(0, 'L') };
+    ChordStroke bossKey[] = { Stroke(LOCK_MOD_CONTROL, 'K'), Stroke(0, 'B') };
+    ChordStroke launch[] = { Stroke(LOCK_MOD_ALT, 'Q'), Stroke(0, 0x74) }; // VK_F5
+    CHECK(trie.Add(lock, 2, ACTION_LOCK));
+    CHECK(trie.Add(bossKey, 2, ACTION_BOSS_KEY));
+    CHECK(trie.Add(launch, 2, ACTION_BOSS_KEY));
+    CHECK(!trie.Add(lock, 1, ACTION_LOCK)); // Prefix of an existing chord
+    trie.generation = 1;
+}
+
+static void CheckMatcher() {
+    ChordTrie trie;
+    BuildSampleTrie(trie);
+    const ChordStroke ctrlK = Stroke(LOCK_MOD_CONTROL, 'K');
+    const ChordStroke altQ = Stroke(LOCK_MOD_ALT, 'Q');
+    uint16_t action = 0;
+    ChordReplay replay;
+
+    // A complete chord runs its action and gives nothing back
+    ChordMatcher matcher;
+    CHECK(matcher.Feed(trie, ctrlK, 0, action, replay) == CHORD_PREFIX && replay.count == 0);
+    CHECK(matcher.Feed(trie, Stroke(0, 'L'), 10, action, replay) == CHORD_MATCHED && action == ACTION_LOCK);
+    CHECK(replay.count == 0 && !matcher.IsPending());
+    CHECK(matcher.ConsumeRelease('K') && matcher.ConsumeRelease('L') && !matcher.ConsumeRelease('L'));
+
+    // Mismatch: the prefix and then the key are replayed, in typing order
+    CHECK(matcher.Feed(trie, ctrlK, 100, action, replay) == CHORD_PREFIX);
+    CHECK(matcher.Feed(trie, Stroke(0, 'X'), 110, action, replay) == CHORD_BROKEN);
+    const ChordStroke brokenExpected[] = { ctrlK, Stroke(0, 'X') };
+    CHECK(SameStrokes(replay, brokenExpected, 2));
+    CHECK(!matcher.IsPending());
+
+    // A key that starts another chord only gives the old prefix back
+    CHECK(matcher.Feed(trie, ctrlK, 200, action, replay) == CHORD_PREFIX);
+    CHECK(matcher.Feed(trie, altQ, 210, action, replay) == CHORD_PREFIX);
+    CHECK(SameStrokes(replay, &ctrlK, 1));
+    CHECK(matcher.Feed(trie, Stroke(0, 0x74), 220, action, replay) == CHORD_MATCHED && replay.count == 0);
+
+    // Timeout: Expire() hands the prefix back only once STROKE_TIMEOUT_MS passed
+    CHECK(matcher.Feed(trie, ctrlK, 1000, action, replay) == CHORD_PREFIX);
+    CHECK(!matcher.Expire(1000 + ChordMatcher::STROKE_TIMEOUT_MS, replay) && replay.count == 0);
+    CHECK(matcher.Expire(1001 + ChordMatcher::STROKE_TIMEOUT_MS, replay));
+    CHECK(SameStrokes(replay, &ctrlK, 1) && !matcher.IsPending());
+    CHECK(!matcher.Expire(9000, replay));
+
+    // A timed-out prefix noticed on the next press goes back ahead of it
+    CHECK(matcher.Feed(trie, ctrlK, 10000, action, replay) == CHORD_PREFIX);
+    CHECK(matcher.Feed(trie, Stroke(0, 'L'), 10001 + ChordMatcher::STROKE_TIMEOUT_MS, action, replay) == CHORD_BROKEN);
+    const ChordStroke lateExpected[] = { ctrlK, Stroke(0, 'L') };
+    CHECK(SameStrokes(replay, lateExpected, 2));
+
+    // A newly published trie drops the old node but still gives the prefix back
+    CHECK(matcher.Feed(trie, ctrlK, 20000, action, replay) == CHORD_PREFIX);
+    trie.generation = 2;
+    CHECK(matcher.Feed(trie, Stroke(0, 'L'), 20010, action, replay) == CHORD_BROKEN);
+    CHECK(SameStrokes(replay, lateExpected, 2));
+
+    // Modifiers pass and never disturb a pending prefix
+    CHECK(matcher.Feed(trie, ctrlK, 30000, action, replay) == CHORD_PREFIX);
+    CHECK(matcher.Feed(trie, Stroke(LOCK_MOD_CONTROL, VK_SHIFT_KEY), 30010, action, replay) == CHORD_NO_MATCH);
+    CHECK(matcher.IsPending() && replay.count == 0);
+    matcher.Reset();
+
+    // An auto-repeat of a replayed key passes, so its release must pass too
+    CHECK(matcher.Feed(trie, ctrlK, 40000, action, replay) == CHORD_PREFIX);
+    CHECK(matcher.Feed(trie, Stroke(0, 'X'), 40010, action, replay) == CHORD_BROKEN);
+    CHECK(matcher.Feed(trie, Stroke(0, 'X'), 40040, action, replay) == CHORD_NO_MATCH && replay.count == 0);
+    CHECK(!matcher.ConsumeRelease('X'));
+    CHECK(matcher.ConsumeRelease('K'));
+}
+
+static InputEvent KeyEvent(uint16_t code, bool down, uint32_t time) {
+    InputEvent event;
+    memset(&event, 0, sizeof(event));
+    event.device = INPUT_DEVICE_KEYBOARD;
+    event.type = down ? INPUT_EVENT_KEY_DOWN : INPUT_EVENT_KEY_UP;
+    event.code = code;
+    event.time = time;
+    return event;
+}
+
+// The app's defaults with the keyboard lock on (see BuildLockEngineConfig)
+static void BuildConfig(LockEngineConfig& config) {
+    KeyPolicySettings settings;
+    settings.keyboardLockEnabled = true;
+    settings.whitelistEnabled = true;
+    settings.whitelistedKeys = DEFAULT_WHITELISTED_KEYS;
+    settings.unlockMethod = 0;
+    CompileKeyPolicy(settings, false, config.keyPolicy);
+    config.mouseBlockMask = 0;
+    config.failsafeEnabled = true;
+    config.unlockChords[0].modifiers = LOCK_MOD_CONTROL;
+    config.unlockChords[0].vkCode = 'O';
+    config.unlockChords[1].modifiers = LOCK_MOD_CONTROL | LOCK_MOD_SHIFT;
+    config.unlockChords[1].vkCode = 'I';
+}
+
+struct PipelineObserver {
+    size_t actions;
+    size_t replays;
+    ChordStroke replayed[16];
+    size_t replayedCount;
+};
+
+static void OnChord(void* context, uint16_t action) {
+    (void)action;
+    ((PipelineObserver*)context)->actions++;
+}
+
+static void OnReplay(void* context, const ChordStroke* strokes, size_t count) {
+    PipelineObserver* observer = (PipelineObserver*)context;
+    observer->replays++;
+    for (size_t i = 0; i < count && observer->replayedCount < 16; i++) {
+        observer->replayed[observer->replayedCount++] = strokes[i];
+    }
+}
+
+static void CheckPipeline() {
+    ChordTrie trie;
+    BuildSampleTrie(trie);
+    LockEngineConfig config;
+    BuildConfig(config);
+
+    PipelineObserver observer;
+    memset(&observer, 0, sizeof(observer));
+    LockPipeline pipeline;
+    pipeline.Configure(config);
+    LockPipelineCallbacks callbacks = { nullptr, nullptr, OnChord, OnReplay, &observer };
+    pipeline.SetCallbacks(callbacks);
+    pipeline.ConfigureChords(trie);
+
+    // Ctrl held for K only, then X: both swallowed, then replayed with Ctrl+K first
+    CHECK(pipeline.OnInputEvent(KeyEvent(VK_CONTROL_KEY, true, 0)) == INPUT_VERDICT_PASS);
+    CHECK(pipeline.OnInputEvent(KeyEvent('K', true, 1)) == INPUT_VERDICT_BLOCK);
+    CHECK(pipeline.IsChordPending());
+    CHECK(pipeline.OnInputEvent(KeyEvent('K', false, 2)) == INPUT_VERDICT_BLOCK);
+    CHECK(pipeline.OnInputEvent(KeyEvent(VK_CONTROL_KEY, false, 3)) == INPUT_VERDICT_PASS);
+    CHECK(pipeline.OnInputEvent(KeyEvent('X', true, 4)) == INPUT_VERDICT_BLOCK);
+    CHECK(pipeline.OnInputEvent(KeyEvent('X', false, 5)) == INPUT_VERDICT_BLOCK);
+    CHECK(observer.replays == 1 && observer.replayedCount == 2);
+    CHECK(observer.replayed[0].modifiers == LOCK_MOD_CONTROL && observer.replayed[0].vkCode == 'K');
+    CHECK(observer.replayed[1].modifiers == 0 && observer.replayed[1].vkCode == 'X');
+
+    // The replay comes back injected and passes untouched
+    InputEvent injected = KeyEvent('X', true, 6);
+    injected.flags = INPUT_FLAG_INJECTED;
+    CHECK(pipeline.OnInputEvent(injected) == INPUT_VERDICT_PASS);
+
+    // A lone prefix expires through the timer path
+    observer.replayedCount = 0;
+    pipeline.OnInputEvent(KeyEvent(VK_CONTROL_KEY, true, 100));
+    CHECK(pipeline.OnInputEvent(KeyEvent('K', true, 101)) == INPUT_VERDICT_BLOCK);
+    pipeline.ExpireChord(102);
+    CHECK(observer.replays == 1 && pipeline.IsChordPending());
+    pipeline.ExpireChord(102 + ChordMatcher::STROKE_TIMEOUT_MS);
+    CHECK(observer.replays == 2 && observer.replayedCount == 1 && !pipeline.IsChordPending());
+
+    // A full chord still runs its action
+    CHECK(pipeline.OnInputEvent(KeyEvent('K', true, 5000)) == INPUT_VERDICT_BLOCK);
+    pipeline.OnInputEvent(KeyEvent(VK_CONTROL_KEY, false, 5001));
+    CHECK(pipeline.OnInputEvent(KeyEvent('L', true, 5002)) == INPUT_VERDICT_BLOCK);
+    CHECK(observer.actions == 1 && observer.replays == 2);
+}
+
+static volatile size_t g_sink;
+
+int main() {
+    CheckMatcher();
+    CheckPipeline();
+
+    // Random chords of 2-4 strokes: a modified first stroke, then mostly plain keys
+    static const uint8_t KEYS[] = { 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R',
+                                    'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    const size_t KEY_COUNT = sizeof(KEYS) / sizeof(KEYS[0]);
+    const size_t CHORD_COUNT = 5000;
+    std::mt19937 random(14);
+    ChordTrie trie;
+    std::vector<std::vector<ChordStroke> > chords;
+    ToolClock::time_point start = ToolClock::now();
+    while (trie.GetChordCount() < CHORD_COUNT) {
+        std::vector<ChordStroke> strokes(2 + random() % 3);
+        for (size_t i = 0; i < strokes.size(); i++) {
+            uint8_t modifiers = i == 0 ? (uint8_t)(1 + random() % 15) : (uint8_t)(random() % 4 == 0 ? LOCK_MOD_CONTROL : 0);
+            strokes[i] = Stroke(modifiers, KEYS[random() % KEY_COUNT]);
+        }
+        if (trie.Add(strokes.data(), strokes.size(), (uint16_t)(1 + chords.size() % 60000))) chords.push_back(strokes);
+    }
+    printf("%zu chords, table %zu KB, built in %.1f ms\n", trie.GetChordCount(), trie.GetMemoryUsage() / 1024,
+           SecondsSince(start) * 1e3);
+
+    // A third of the presses type a chord, the rest are plain keys
+    std::vector<ChordStroke> stream;
+    for (size_t i = 0; i < 200000; i++) {
+        if (i % 3 == 0) {
+            const std::vector<ChordStroke>& chord = chords[random() % chords.size()];
+            stream.insert(stream.end(), chord.begin(), chord.end());
+        } else {
+            stream.push_back(Stroke(0, KEYS[random() % KEY_COUNT]));
+        }
+    }
+
+    const int ROUNDS = 20;
+    ChordMatcher matcher;
+    ChordReplay replay;
+    uint16_t action = 0;
+    size_t matched = 0, replayed = 0;
+    uint32_t time = 0;
+    start = ToolClock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < stream.size(); i++) {
+            if (matcher.Feed(trie, stream[i], time++, action, replay) == CHORD_MATCHED) matched++;
+            replayed += replay.count;
+            matcher.ConsumeRelease(stream[i].vkCode);
+        }
+    }
+    double seconds = SecondsSince(start);
+    size_t presses = ROUNDS * stream.size();
+    printf("matcher: %.2f ns per key press (%zu presses, %zu chords matched, %zu strokes replayed)\n",
+           seconds * 1e9 / presses, presses, matched, replayed);
+    CHECK(matched >= ROUNDS * 66666);
+    g_sink = matched + replayed;
+
+    // The whole unlocked pipeline, so the chord cost is seen next to the engine's
+    static const uint8_t MODIFIER_KEYS[] = { VK_MENU_KEY, VK_CONTROL_KEY, VK_SHIFT_KEY, VK_WIN_KEY };
+    std::vector<InputEvent> events;
+    for (size_t i = 0; i < stream.size(); i++) {
+        for (int m = 0; m < 4; m++) {
+            if (stream[i].modifiers & (1 << m)) events.push_back(KeyEvent(MODIFIER_KEYS[m], true, 0));
+        }
+        events.push_back(KeyEvent(stream[i].vkCode, true, 0));
+        events.push_back(KeyEvent(stream[i].vkCode, false, 0));
+        for (int m = 0; m < 4; m++) {
+            if (stream[i].modifiers & (1 << m)) events.push_back(KeyEvent(MODIFIER_KEYS[m], false, 0));
+        }
+    }
+    LockEngineConfig config;
+    BuildConfig(config);
+    for (int withChords = 0; withChords < 2; withChords++) {
+        PipelineObserver observer;
+        memset(&observer, 0, sizeof(observer));
+        LockPipeline pipeline;
+        pipeline.Configure(config);
+        LockPipelineCallbacks callbacks = { nullptr, nullptr, OnChord, OnReplay, &observer };
+        pipeline.SetCallbacks(callbacks);
+        if (withChords) pipeline.ConfigureChords(trie);
+
+        size_t blocked = 0;
+        start = ToolClock::now();
+        for (int round = 0; round < ROUNDS; round++) {
+            for (size_t i = 0; i < events.size(); i++) {
+                InputEvent event = events[i];
+                event.time = (uint32_t)i;
+                blocked += pipeline.OnInputEvent(event) == INPUT_VERDICT_BLOCK;
+            }
+        }
+        seconds = SecondsSince(start);
+        size_t eventCount = ROUNDS * events.size();
+        printf("pipeline unlocked %s chords: %.2f ns per event (%zu events, %zu blocked, %zu actions, %zu replays)\n",
+               withChords ? "with" : "without", seconds * 1e9 / eventCount, eventCount, blocked, observer.actions,
+               observer.replays);
+        if (!withChords) CHECK(blocked == 0 && observer.actions == 0);
+        if (withChords) CHECK(observer.actions >= ROUNDS * 66666);
+    }
+
+    return CheckResult("chord_matcher_bench");
+}
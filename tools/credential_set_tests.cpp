@@ -0,0 +1,182 @@
+// tools/credential_set_tests.cpp
+// CredentialSet against a std::set reference, its registry blob round trip, and lookup cost
+//
+// From the repository root: g++ -std=c++17 -O2 -Isrc tools/credential_set_tests.cpp
+//   src/features/lock_input/credential_set.cpp src/features/lock_input/password_matcher.cpp
+//   src/utils/sha256.cpp
+// The lookup benchmark compares FindBatch() with a linear scan of every
+// credential, for sets from one PIN up to MAX_CREDENTIALS.
+
+#include "features/lock_input/credential_set.h"
+#include "features/lock_input/password_matcher.h"
+#include "tool_check.h"
+#include <array>
+#include <cstring>
+#include <random>
+#include <set>
+#include <string>
+
+typedef std::array<uint8_t, SHA256_DIGEST_SIZE> Digest;
+
+static Digest HashText(const std::string& text) {
+    Digest digest;
+    Sha256(text.data(), text.size(), digest.data());
+    return digest;
+}
+
+// Random adds and removes, checked step by step against std::set
+static void CheckAgainstReference(CredentialSet& set) {
+    std::mt19937_64 random(7);
+    std::set<Digest> reference;
+    for (int step = 0; step < 20000; step++) {
+        std::string text = std::to_string(random() % 3000);
+        Digest digest = HashText(text);
+        if (random() % 3) {
+            bool expected = reference.size() < CredentialSet::MAX_CREDENTIALS && reference.count(digest) == 0;
+            CHECK(set.Add(digest.data(), text.size(), CREDENTIAL_PASSWORD) == expected);
+            if (expected) reference.insert(digest);
+        } else {
+            CHECK(set.Remove(digest.data()) == (reference.erase(digest) > 0));
+        }
+
+        if (step % 1000 == 0) {
+            for (int query = 0; query < 3000; query++) {
+                Digest probe = HashText(std::to_string(query));
+                int found = set.Find(probe.data());
+                CHECK((found >= 0) == (reference.count(probe) > 0));
+                if (found >= 0) CHECK(memcmp(set.Get((size_t)found).digest, probe.data(), SHA256_DIGEST_SIZE) == 0);
+            }
+        }
+    }
+    CHECK(set.GetCount() == reference.size());
+    for (size_t i = 1; i < set.GetCount(); i++) {
+        CHECK(memcmp(set.Get(i - 1).digest, set.Get(i).digest, SHA256_DIGEST_SIZE) < 0);
+    }
+}
+
+static void CheckRoundTrip(const CredentialSet& set) {
+    std::vector<uint8_t> blob;
+    set.Serialize(blob);
+    CHECK(blob.size() == 12 + set.GetCount() * (SHA256_DIGEST_SIZE + 2));
+
+    CredentialSet loaded;
+    CHECK(loaded.Deserialize(blob.data(), blob.size()));
+    CHECK(loaded.GetCount() == set.GetCount());
+    for (size_t i = 0; i < set.GetCount() && i < loaded.GetCount(); i++) {
+        CHECK(memcmp(loaded.Get(i).digest, set.Get(i).digest, SHA256_DIGEST_SIZE) == 0);
+        CHECK(loaded.Get(i).length == set.Get(i).length && loaded.Get(i).kind == set.Get(i).kind);
+        CHECK(loaded.Find(set.Get(i).digest) == (int)i);
+    }
+    std::vector<uint8_t> again;
+    loaded.Serialize(again);
+    CHECK(again == blob);
+
+    // Damaged blobs are refused and leave the loaded set as it was
+    std::vector<uint8_t> damaged = blob;
+    damaged[0] ^= 1; // Magic
+    CHECK(!loaded.Deserialize(damaged.data(), damaged.size()));
+    damaged = blob;
+    damaged[5] ^= 1; // Version
+    CHECK(!loaded.Deserialize(damaged.data(), damaged.size()));
+    CHECK(!loaded.Deserialize(blob.data(), blob.size() - 1)); // Truncated entry
+    CHECK(!loaded.Deserialize(blob.data(), 11));              // Truncated header
+    damaged = blob;
+    damaged[8]++; // Count disagrees with the size
+    CHECK(!loaded.Deserialize(damaged.data(), damaged.size()));
+    CHECK(loaded.GetCount() == set.GetCount());
+}
+
+// A hand-edited blob: unsorted, a duplicate, and a kind from a newer version
+static void CheckHandEditedBlob() {
+    Digest first = HashText("1234"), second = HashText("recovery-0001"), third = HashText("future");
+    const Digest* entries[] = { &second, &first, &second, &third };
+    const uint8_t kinds[] = { CREDENTIAL_RECOVERY_CODE, CREDENTIAL_PASSWORD, CREDENTIAL_RECOVERY_CODE, 7 };
+    const uint8_t lengths[] = { 13, 4, 13, 6 };
+
+    std::vector<uint8_t> blob = { 'U', 'A', 'C', 'S', 1, 0, 0, 0, 4, 0, 0, 0 };
+    for (int i = 0; i < 4; i++) {
+        blob.insert(blob.end(), entries[i]->begin(), entries[i]->end());
+        blob.push_back(lengths[i]);
+        blob.push_back(kinds[i]);
+    }
+
+    CredentialSet set;
+    CHECK(set.Deserialize(blob.data(), blob.size()));
+    CHECK(set.GetCount() == 2);
+    CHECK(set.GetCount(CREDENTIAL_PASSWORD) == 1 && set.GetCount(CREDENTIAL_RECOVERY_CODE) == 1);
+    CHECK(set.Find(first.data()) >= 0 && set.Find(second.data()) >= 0 && set.Find(third.data()) < 0);
+    CHECK(set.GetCandidateLengths() == (PasswordMatcher::LengthBit(4) | PasswordMatcher::LengthBit(13)));
+
+    // Recovery codes go together; an unknown length asks for every legacy length
+    CHECK(set.RemoveKind(CREDENTIAL_RECOVERY_CODE) == 1 && set.GetCount() == 1);
+    set.SetLength(0, 0);
+    CHECK((set.GetCandidateLengths() & PasswordMatcher::LegacyLengthMask()) == PasswordMatcher::LegacyLengthMask());
+}
+
+static volatile int g_sink;
+
+int main() {
+    CredentialSet set;
+    CheckAgainstReference(set);
+    CheckRoundTrip(set);
+    CheckHandEditedBlob();
+
+    CredentialSet empty;
+    CheckRoundTrip(empty);
+
+    // Fill to the limit: the next Add fails
+    CredentialSet full;
+    for (size_t i = 0; full.GetCount() < CredentialSet::MAX_CREDENTIALS; i++) {
+        Digest digest = HashText("pin" + std::to_string(i));
+        full.Add(digest.data(), 8, i % 2 ? CREDENTIAL_PASSWORD : CREDENTIAL_RECOVERY_CODE);
+    }
+    Digest extra = HashText("one too many");
+    CHECK(!full.Add(extra.data(), 12, CREDENTIAL_PASSWORD));
+    CheckRoundTrip(full);
+
+    // Six candidate digests per key press, as for a typical set of lengths
+    std::mt19937_64 random(18);
+    const size_t SIZES[] = { 1, 10, 100, 1000, CredentialSet::MAX_CREDENTIALS };
+    for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+        CredentialSet bench;
+        std::vector<Digest> stored;
+        while (bench.GetCount() < SIZES[s]) {
+            Digest digest = HashText(std::to_string(random()));
+            if (bench.Add(digest.data(), 10, CREDENTIAL_PASSWORD)) stored.push_back(digest);
+        }
+
+        uint8_t digests[32][SHA256_DIGEST_SIZE];
+        for (int i = 0; i < 32; i++) {
+            if (i % 8 == 0) memcpy(digests[i], stored[random() % stored.size()].data(), SHA256_DIGEST_SIZE);
+            else Sha256(&i, sizeof(i), digests[i]);
+        }
+
+        const int LOOKUPS = 200000;
+        int found[32], hits = 0;
+        ToolClock::time_point start = ToolClock::now();
+        for (int k = 0; k < LOOKUPS; k++) {
+            bench.FindBatch(&digests[(k * 6) & 31 & ~7], 6, found);
+            hits += found[0] >= 0;
+        }
+        double batchSeconds = SecondsSince(start);
+        CHECK(hits == LOOKUPS); // Every batch starts with a stored digest
+
+        const int SCANS = 2000;
+        int scanHits = 0;
+        start = ToolClock::now();
+        for (int k = 0; k < SCANS; k++) {
+            const uint8_t (*batch)[SHA256_DIGEST_SIZE] = &digests[(k * 6) & 31 & ~7];
+            for (int c = 0; c < 6; c++) {
+                for (size_t j = 0; j < bench.GetCount(); j++) scanHits += Sha256DigestEquals(bench.Get(j).digest, batch[c]);
+            }
+        }
+        double scanSeconds = SecondsSince(start);
+        CHECK(scanHits == SCANS);
+
+        printf("%4zu credentials: FindBatch(6) %6.1f ns, linear scan(6) %9.1f ns\n", bench.GetCount(),
+               batchSeconds * 1e9 / LOOKUPS, scanSeconds * 1e9 / SCANS);
+        g_sink = hits + scanHits;
+    }
+
+    return CheckResult("credential_set_tests");
+}
@@ -0,0 +1,312 @@
+// tools/hook_watchdog_tests.cpp
+// HookWatchdog against a fake clock and fake hooks: what it reports, when, and what a check costs
+//
+// From the repository root: g++ -std=c++17 -O2 -Isrc tools/hook_watchdog_tests.cpp
+//   src/features/lock_input/hook_watchdog.cpp
+// FakeInput plays the system: every input moves lastInputTime, and a hook
+// that is still alive counts a heartbeat, as the real callbacks do.
+
+#include "features/lock_input/hook_watchdog.h"
+#include "tool_check.h"
+#include <cstring>
+
+struct FakeInput {
+    HookWatchdogSample sample;
+    bool alive[HOOK_WATCHDOG_HOOK_COUNT];
+
+    FakeInput() {
+        memset(&sample, 0, sizeof(sample));
+        sample.now = 1000;
+        sample.lastInputTime = 1000;
+        for (int hook = 0; hook < HOOK_WATCHDOG_HOOK_COUNT; hook++) {
+            sample.installed[hook] = true;
+            alive[hook] = true;
+        }
+    }
+
+    void Tick(uint32_t milliseconds) { sample.now += milliseconds; }
+
+    void Input(int hook, uint32_t beats) {
+        sample.lastInputTime = sample.now;
+        // Neither hook sees input it cannot reach
+        if (alive[hook] && sample.installed[hook] && !sample.unobservable) sample.heartbeats[hook] += beats;
+    }
+
+    void Key() { Input(HOOK_WATCHDOG_KEYBOARD, 1); }
+    void Move(int32_t dx) {
+        sample.cursorX += dx;
+        Input(HOOK_WATCHDOG_MOUSE, 1);
+    }
+    void Click() { Input(HOOK_WATCHDOG_MOUSE, 2); }
+};
+
+static const uint32_t TICK = 50; // The app's watchdog interval
+
+static void CheckHealthy() {
+    HookWatchdog watchdog;
+    FakeInput input;
+    uint32_t silentFor[HOOK_WATCHDOG_HOOK_COUNT];
+    CHECK(watchdog.Check(input.sample, silentFor) == 0);
+    for (int i = 0; i < 10000; i++) {
+        input.Tick(TICK);
+        if (i % 2) input.Key();
+        if (i % 3 == 0) input.Move(3);
+        if (i % 7 == 0) input.Click();
+        CHECK(watchdog.Check(input.sample, silentFor) == 0);
+    }
+}
+
+static void CheckLost() {
+    // Keyboard: reported on the second unexplained interval, then judged afresh
+    {
+        HookWatchdog watchdog;
+        FakeInput input;
+        uint32_t silentFor[HOOK_WATCHDOG_HOOK_COUNT] = { 0, 0 };
+        watchdog.Check(input.sample, silentFor);
+        input.alive[HOOK_WATCHDOG_KEYBOARD] = false;
+        input.Tick(TICK);
+        input.Key();
+        CHECK(watchdog.Check(input.sample, silentFor) == 0);
+        input.Tick(TICK);
+        input.Key();
+        CHECK(watchdog.Check(input.sample, silentFor) == 1 << HOOK_WATCHDOG_KEYBOARD);
+        CHECK(silentFor[HOOK_WATCHDOG_KEYBOARD] == TICK);
+        input.Tick(TICK);
+        input.Key();
+        CHECK(watchdog.Check(input.sample, silentFor) == 0);
+    }
+
+    // Mouse: the cursor moves without a heartbeat
+    {
+        HookWatchdog watchdog;
+        FakeInput input;
+        uint32_t silentFor[HOOK_WATCHDOG_HOOK_COUNT];
+        watchdog.Check(input.sample, silentFor);
+        input.alive[HOOK_WATCHDOG_MOUSE] = false;
+        input.Tick(TICK);
+        input.Move(5);
+        CHECK(watchdog.Check(input.sample, silentFor) == 0);
+        input.Tick(TICK);
+        input.Move(5);
+        CHECK(watchdog.Check(input.sample, silentFor) == 1 << HOOK_WATCHDOG_MOUSE);
+    }
+
+    // Both at once: the keyboard needs intervals without cursor movement
+    {
+        HookWatchdog watchdog;
+        FakeInput input;
+        uint32_t silentFor[HOOK_WATCHDOG_HOOK_COUNT];
+        watchdog.Check(input.sample, silentFor);
+        input.alive[HOOK_WATCHDOG_KEYBOARD] = input.alive[HOOK_WATCHDOG_MOUSE] = false;
+        uint8_t lost = 0;
+        for (int i = 0; i < 6; i++) {
+            input.Tick(TICK);
+            if (i % 2) input.Key();
+            else input.Move(2);
+            lost |= watchdog.Check(input.sample, silentFor);
+        }
+        CHECK(lost & (1 << HOOK_WATCHDOG_MOUSE));
+        for (int i = 0; i < 3; i++) {
+            input.Tick(TICK);
+            input.Key();
+            lost |= watchdog.Check(input.sample, silentFor);
+        }
+        CHECK(lost == ((1 << HOOK_WATCHDOG_KEYBOARD) | (1 << HOOK_WATCHDOG_MOUSE)));
+    }
+
+    // Across the 49.7-day wrap of GetTickCount
+    {
+        HookWatchdog watchdog;
+        FakeInput input;
+        uint32_t silentFor[HOOK_WATCHDOG_HOOK_COUNT] = { 0, 0 };
+        input.sample.now = input.sample.lastInputTime = 0xFFFFFFF0u;
+        watchdog.Check(input.sample, silentFor);
+        input.alive[HOOK_WATCHDOG_KEYBOARD] = false;
+        input.Tick(TICK);
+        input.Key();
+        watchdog.Check(input.sample, silentFor);
+        input.Tick(TICK);
+        input.Key();
+        CHECK(watchdog.Check(input.sample, silentFor) == 1 << HOOK_WATCHDOG_KEYBOARD);
+        CHECK(silentFor[HOOK_WATCHDOG_KEYBOARD] == TICK);
+    }
+}
+
+// Input that does not implicate a hook
+static void CheckNoEvidence() {
+    uint32_t silentFor[HOOK_WATCHDOG_HOOK_COUNT];
+
+    // A dead keyboard hook while the user only moves the mouse
+    {
+        HookWatchdog watchdog;
+        FakeInput input;
+        watchdog.Check(input.sample, silentFor);
+        input.alive[HOOK_WATCHDOG_KEYBOARD] = false;
+        for (int i = 0; i < 100; i++) {
+            input.Tick(TICK);
+            input.Move(1);
+            CHECK(watchdog.Check(input.sample, silentFor) == 0);
+        }
+    }
+
+    // A heartbeat between unexplained intervals clears the suspicion
+    {
+        HookWatchdog watchdog;
+        FakeInput input;
+        watchdog.Check(input.sample, silentFor);
+        input.alive[HOOK_WATCHDOG_KEYBOARD] = false;
+        input.Tick(TICK);
+        input.Key();
+        watchdog.Check(input.sample, silentFor);
+        CHECK(watchdog.GetSuspicion(HOOK_WATCHDOG_KEYBOARD) == 1);
+        input.alive[HOOK_WATCHDOG_KEYBOARD] = true;
+        input.Tick(TICK);
+        input.Key();
+        CHECK(watchdog.Check(input.sample, silentFor) == 0);
+        CHECK(watchdog.GetSuspicion(HOOK_WATCHDOG_KEYBOARD) == 0);
+    }
+
+    // No mouse hook: clicks change the buttons and so are not keyboard input
+    {
+        HookWatchdog watchdog;
+        FakeInput input;
+        input.sample.installed[HOOK_WATCHDOG_MOUSE] = false;
+        watchdog.Check(input.sample, silentFor);
+        for (int i = 0; i < 50; i++) {
+            input.Tick(TICK);
+            input.Click();
+            input.sample.mouseButtons ^= 1;
+            CHECK(watchdog.Check(input.sample, silentFor) == 0);
+        }
+    }
+
+    // A hook that is not installed is never judged; installing it starts afresh
+    {
+        HookWatchdog watchdog;
+        FakeInput input;
+        input.sample.installed[HOOK_WATCHDOG_KEYBOARD] = false;
+        watchdog.Check(input.sample, silentFor);
+        for (int i = 0; i < 10; i++) {
+            input.Tick(TICK);
+            input.Key();
+            CHECK(watchdog.Check(input.sample, silentFor) == 0);
+        }
+        input.sample.installed[HOOK_WATCHDOG_KEYBOARD] = true;
+        input.alive[HOOK_WATCHDOG_KEYBOARD] = false;
+        for (int i = 0; i < 2; i++) {
+            input.Tick(TICK);
+            input.Key();
+            CHECK(watchdog.Check(input.sample, silentFor) == 0);
+        }
+        input.Tick(TICK);
+        input.Key();
+        CHECK(watchdog.Check(input.sample, silentFor) == 1 << HOOK_WATCHDOG_KEYBOARD);
+    }
+
+    // Idle: dead hooks and no input
+    {
+        HookWatchdog watchdog;
+        FakeInput input;
+        watchdog.Check(input.sample, silentFor);
+        input.alive[HOOK_WATCHDOG_KEYBOARD] = input.alive[HOOK_WATCHDOG_MOUSE] = false;
+        for (int i = 0; i < 100; i++) {
+            input.Tick(TICK);
+            CHECK(watchdog.Check(input.sample, silentFor) == 0);
+        }
+    }
+}
+
+// Typing and mousing into an elevated window or on the UAC desktop: the
+// hooks are alive but never called
+static void CheckUnobservable() {
+    uint32_t silentFor[HOOK_WATCHDOG_HOOK_COUNT];
+    HookWatchdog watchdog;
+    FakeInput input;
+    watchdog.Check(input.sample, silentFor);
+    input.sample.unobservable = true;
+    for (int i = 0; i < 200; i++) {
+        input.Tick(TICK);
+        input.Key();
+        if (i % 2) input.Move(4);
+        CHECK(watchdog.Check(input.sample, silentFor) == 0);
+    }
+
+    // Back to a window we can hook: the interval spanning the switch is no
+    // evidence either, and the first unexplained one afterwards only suspects
+    input.sample.unobservable = false;
+    input.Tick(TICK);
+    input.Key();
+    CHECK(watchdog.Check(input.sample, silentFor) == 0);
+    CHECK(watchdog.GetSuspicion(HOOK_WATCHDOG_KEYBOARD) == 0);
+    for (int i = 0; i < 100; i++) {
+        input.Tick(TICK);
+        input.Key();
+        input.Move(1);
+        CHECK(watchdog.Check(input.sample, silentFor) == 0);
+    }
+
+    // A hook lost while unobservable is still found once input is hookable again
+    input.alive[HOOK_WATCHDOG_MOUSE] = false;
+    input.sample.unobservable = true;
+    input.Tick(TICK);
+    input.Move(3);
+    CHECK(watchdog.Check(input.sample, silentFor) == 0);
+    input.sample.unobservable = false;
+    uint8_t lost = 0;
+    for (int i = 0; i < 3; i++) {
+        input.Tick(TICK);
+        input.Move(3);
+        lost |= watchdog.Check(input.sample, silentFor);
+    }
+    CHECK(lost == 1 << HOOK_WATCHDOG_MOUSE);
+}
+
+static volatile uint64_t g_sink;
+
+int main() {
+    CheckHealthy();
+    CheckLost();
+    CheckNoEvidence();
+    CheckUnobservable();
+
+    // Detection latency: a key every 10 ms after the keyboard hook is lost, checked every tick
+    {
+        HookWatchdog watchdog;
+        FakeInput input;
+        uint32_t silentFor[HOOK_WATCHDOG_HOOK_COUNT];
+        watchdog.Check(input.sample, silentFor);
+        uint32_t lostAt = input.sample.now;
+        input.alive[HOOK_WATCHDOG_KEYBOARD] = false;
+        uint8_t lost = 0;
+        for (uint32_t elapsed = 10; !lost && elapsed <= 1000; elapsed += 10) {
+            input.Tick(10);
+            input.Key();
+            if (elapsed % TICK == 0) lost = watchdog.Check(input.sample, silentFor);
+        }
+        CHECK(lost == 1 << HOOK_WATCHDOG_KEYBOARD);
+        CHECK(input.sample.now - lostAt <= HookWatchdog::CONFIRM_CHECKS * TICK);
+        printf("keyboard hook lost while typing: found after %u ms at %u ms ticks\n",
+               (unsigned)(input.sample.now - lostAt), (unsigned)TICK);
+    }
+
+    // What one tick costs the UI thread, sampling aside
+    {
+        HookWatchdog watchdog;
+        FakeInput input;
+        uint32_t silentFor[HOOK_WATCHDOG_HOOK_COUNT];
+        const int CHECKS = 10000000;
+        uint64_t found = 0;
+        ToolClock::time_point start = ToolClock::now();
+        for (int i = 0; i < CHECKS; i++) {
+            input.Tick(1);
+            if (i & 1) input.Key();
+            found += watchdog.Check(input.sample, silentFor);
+        }
+        double seconds = SecondsSince(start);
+        CHECK(found == 0);
+        printf("Check(): %.2f ns\n", seconds * 1e9 / CHECKS);
+        g_sink = found;
+    }
+
+    return CheckResult("hook_watchdog_tests");
+}
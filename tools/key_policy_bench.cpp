@@ -0,0 +1,161 @@
+// tools/key_policy_bench.cpp
+// KeyPolicy lookups against the comparison chain the keyboard hook used before, for decisions and cost per event
+//
+// From the repository root: g++ -std=c++17 -O2 -Isrc tools/key_policy_bench.cpp
+//   src/features/lock_input/key_policy.cpp
+// The old chain is replayed from the hook as it was, reading the settings
+// on every event. Both are checked to decide every (setting, event, key)
+// the same way, apart from whitelisted key releases, which now pass.
+
+#include "features/lock_input/key_policy.h"
+#include "tool_check.h"
+#include <random>
+#include <vector>
+
+// Virtual-key codes the old chain compared against (winuser.h values)
+static const uint32_t VK_ESCAPE_KEY = 0x1B;
+static const uint32_t VK_F1_KEY = 0x70, VK_F12_KEY = 0x7B;
+
+struct OldSettings {
+    bool keyboardLockEnabled;
+    bool whitelistEnabled;
+    int unlockMethod;
+};
+
+static bool IsOldWhitelisted(uint32_t vk) {
+    return vk == VK_ESCAPE_KEY || (vk >= VK_F1_KEY && vk <= VK_F12_KEY);
+}
+
+// LowLevelKeyboardProc's locked branch before the policy, as KeyPolicyAction bits
+static uint32_t OldDecision(const OldSettings& settings, bool isUp, uint32_t vk) {
+    if (!settings.keyboardLockEnabled) return KEY_ACTION_PASS;
+    if (isUp) {
+        if (vk == 0x11 || vk == 0xA2 || vk == 0xA3 || // VK_CONTROL, VK_LCONTROL, VK_RCONTROL
+            vk == 0x10 || vk == 0xA0 || vk == 0xA1 || // VK_SHIFT, VK_LSHIFT, VK_RSHIFT
+            vk == 0x12 || vk == 0xA4 || vk == 0xA5 || // VK_MENU, VK_LMENU, VK_RMENU
+            vk == 0x5B || vk == 0x5C) {               // VK_LWIN, VK_RWIN
+            return KEY_ACTION_PASS;
+        }
+        return KEY_ACTION_BLOCK;
+    }
+    if (settings.whitelistEnabled) {
+        if (vk == VK_ESCAPE_KEY || (vk >= VK_F1_KEY && vk <= VK_F12_KEY)) return KEY_ACTION_PASS;
+    }
+    switch (settings.unlockMethod) {
+        case 0:
+            if ((vk >= '0' && vk <= '9') || (vk >= 'A' && vk <= 'Z')) return KEY_ACTION_QUEUE | KEY_ACTION_PASSWORD;
+            return KEY_ACTION_QUEUE;
+        case 1:
+        default:
+            return KEY_ACTION_BLOCK;
+    }
+}
+
+static void Compile(const OldSettings& old, const char* whitelist, KeyPolicy& policy) {
+    KeyPolicySettings settings;
+    settings.keyboardLockEnabled = old.keyboardLockEnabled;
+    settings.whitelistEnabled = old.whitelistEnabled;
+    settings.whitelistedKeys = whitelist;
+    settings.unlockMethod = old.unlockMethod;
+    CompileKeyPolicy(settings, false, policy);
+}
+
+// Every combination of the settings the old chain knew about
+static void CheckAgainstOldChain() {
+    size_t mismatches = 0, releasesNowPassed = 0;
+    for (int combination = 0; combination < 8; combination++) {
+        OldSettings old;
+        old.keyboardLockEnabled = (combination & 1) != 0;
+        old.whitelistEnabled = (combination & 2) != 0;
+        old.unlockMethod = (combination & 4) ? 1 : 0;
+        KeyPolicy policy;
+        Compile(old, DEFAULT_WHITELISTED_KEYS, policy);
+
+        for (uint32_t vk = 0; vk < 256; vk++) {
+            for (int isUp = 0; isUp < 2; isUp++) {
+                uint32_t expected = OldDecision(old, isUp != 0, vk);
+                uint32_t actual = policy.Lookup(isUp ? KEY_POLICY_UP : KEY_POLICY_DOWN, vk);
+                if (isUp && old.keyboardLockEnabled && old.whitelistEnabled && IsOldWhitelisted(vk)) {
+                    releasesNowPassed += actual == KEY_ACTION_PASS && expected == KEY_ACTION_BLOCK;
+                    continue;
+                }
+                mismatches += actual != expected;
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(releasesNowPassed == 2 * 13); // Esc and F1-F12, for either unlock method
+}
+
+static void CheckKeyLists() {
+    KeySet expected, keys;
+    expected.Clear();
+    expected.Add((uint8_t)VK_ESCAPE_KEY);
+    expected.AddRange((uint8_t)VK_F1_KEY, (uint8_t)VK_F12_KEY);
+
+    keys.Clear();
+    CHECK(ParseKeyList(" esc , f1 - f12 ", keys) == 2);
+    for (int i = 0; i < 4; i++) CHECK(keys.words[i] == expected.words[i]);
+
+    // Unknown names, reversed ranges and empty entries are skipped
+    keys.Clear();
+    CHECK(ParseKeyList("F13,Z-A,,Bogus,Space,0-9", keys) == 2);
+    CHECK(keys.Contains(0x20) && keys.Contains('0') && keys.Contains('9') && !keys.Contains('Z') && !keys.Contains('A'));
+
+    // A list with nothing recognisable falls back to the default whitelist
+    OldSettings old = { true, true, 0 };
+    KeyPolicy fallback, defaults;
+    Compile(old, "nothing, here", fallback);
+    Compile(old, DEFAULT_WHITELISTED_KEYS, defaults);
+    for (uint32_t vk = 0; vk < 256; vk++) {
+        CHECK(fallback.Lookup(KEY_POLICY_DOWN, vk) == defaults.Lookup(KEY_POLICY_DOWN, vk));
+    }
+}
+
+static volatile uint64_t g_sink;
+
+// Settings as the hook saw them: a global it re-read for every event
+static OldSettings g_oldSettings = { true, true, 0 };
+
+int main() {
+    CheckAgainstOldChain();
+    CheckKeyLists();
+
+    // Typing while locked: mostly letters and digits, some other keys, downs and ups alike
+    const size_t EVENTS = 1 << 20;
+    const int ROUNDS = 20;
+    std::mt19937 random(5);
+    std::vector<uint8_t> keys(EVENTS), ups(EVENTS);
+    for (size_t i = 0; i < EVENTS; i++) {
+        uint32_t pick = random() % 10;
+        keys[i] = (uint8_t)(pick < 6 ? 'A' + random() % 26 : pick < 8 ? '0' + random() % 10 : random() % 256);
+        ups[i] = (uint8_t)(random() % 2);
+    }
+
+    KeyPolicy policy;
+    ToolClock::time_point start = ToolClock::now();
+    for (int i = 0; i < 1000; i++) Compile(g_oldSettings, "Esc, F1-F12, Space", policy);
+    double compileSeconds = SecondsSince(start) / 1000;
+    Compile(g_oldSettings, DEFAULT_WHITELISTED_KEYS, policy);
+
+    uint64_t policySum = 0, oldSum = 0;
+    start = ToolClock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < EVENTS; i++) {
+            policySum += policy.Lookup(ups[i] ? KEY_POLICY_UP : KEY_POLICY_DOWN, keys[i]);
+        }
+    }
+    double policySeconds = SecondsSince(start);
+
+    start = ToolClock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < EVENTS; i++) oldSum += OldDecision(g_oldSettings, ups[i] != 0, keys[i]);
+    }
+    double oldSeconds = SecondsSince(start);
+    g_sink = policySum + oldSum;
+
+    printf("per event: policy lookup %.2f ns, old comparison chain %.2f ns; compile %.1f us\n",
+           policySeconds * 1e9 / (EVENTS * ROUNDS), oldSeconds * 1e9 / (EVENTS * ROUNDS), compileSeconds * 1e6);
+
+    return CheckResult("key_policy_bench");
+}
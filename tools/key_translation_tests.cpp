@@ -0,0 +1,264 @@
+// tools/key_translation_tests.cpp
+// Layout translation tables against fixture layouts, the layout cache, and the cost per queued key
+//
+// From the repository root: g++ -std=c++17 -O2 -Isrc tools/key_translation_tests.cpp
+//   src/features/lock_input/key_translation.cpp src/features/lock_input/lock_pipeline.cpp
+//   src/features/lock_input/lock_engine.cpp src/features/lock_input/hook_policy.cpp
+//   src/features/lock_input/key_policy.cpp src/features/lock_input/chord_trie.cpp
+// The fixtures stand in for ToUnicodeEx: US, French AZERTY, German QWERTZ
+// and Russian, each reduced to the keys the checks use.
+
+#include "features/lock_input/key_translation.h"
+#include "features/lock_input/lock_pipeline.h"
+#include "tool_check.h"
+#include <cstring>
+#include <string>
+
+// One fixture key: what it types in the base, Shift and AltGr planes
+// (0 = nothing, DEAD = a dead key)
+struct FixtureKey {
+    uint8_t vkCode;
+    int base, shift, altGr;
+};
+
+struct FixtureLayout {
+    const FixtureKey* keys;
+    size_t count;
+};
+
+static const int DEAD = -1;
+
+static const FixtureKey US_KEYS[] = {
+    { 'A', 'a', 'A', 0 }, { 'B', 'b', 'B', 0 }, { 'P', 'p', 'P', 0 }, { 'S', 's', 'S', 0 },
+    { '1', '1', '!', 0 }, { '4', '4', '$', 0 }, { 0x20, ' ', ' ', 0 }, // VK_SPACE
+    { 0x08, 0x08, 0x08, 0 }, { 0x1B, 0x1B, 0x1B, 0 },                  // VK_BACK, VK_ESCAPE: control characters
+    { 0xBA, ';', ':', 0 }                                               // VK_OEM_1
+};
+static const FixtureKey FRENCH_KEYS[] = {
+    { 'A', 'a', 'A', 0 }, { 'Q', 'q', 'Q', 0 }, { '1', '&', '1', 0 }, { '2', 0xE9, '2', '~' },
+    { '0', 0xE0, '0', '@' }, { 0xDD, DEAD, DEAD, 0 } // VK_OEM_6: circumflex
+};
+static const FixtureKey GERMAN_KEYS[] = {
+    { 'Q', 'q', 'Q', '@' }, { 'Z', 'z', 'Z', 0 }, { 'Y', 'y', 'Y', 0 }, { '4', '4', '$', 0 },
+    { 'E', 'e', 'E', 0x20AC },
+    { 0xBA, 0xFC, 0xDC, 0 },  // VK_OEM_1: u umlaut
+    { 0xDB, 0xDF, '?', '\\' }, // VK_OEM_4: sharp s
+    { 0xDC, DEAD, 0xB0, 0 }    // VK_OEM_5: circumflex, degree sign
+};
+static const FixtureKey RUSSIAN_KEYS[] = { { 'F', 0x430, 0x410, 0 }, { 'D', 0x432, 0x412, 0 } };
+
+static const FixtureLayout US = { US_KEYS, sizeof(US_KEYS) / sizeof(US_KEYS[0]) };
+static const FixtureLayout FRENCH = { FRENCH_KEYS, sizeof(FRENCH_KEYS) / sizeof(FRENCH_KEYS[0]) };
+static const FixtureLayout GERMAN = { GERMAN_KEYS, sizeof(GERMAN_KEYS) / sizeof(GERMAN_KEYS[0]) };
+static const FixtureLayout RUSSIAN = { RUSSIAN_KEYS, sizeof(RUSSIAN_KEYS) / sizeof(RUSSIAN_KEYS[0]) };
+
+static size_t g_lookups = 0;
+
+// ToUnicodeEx's contract over a fixture; Caps Lock shifts letters only
+static int LookupFixture(void* context, uint8_t vkCode, uint8_t plane, uint16_t* out, int capacity) {
+    const FixtureLayout* layout = (const FixtureLayout*)context;
+    g_lookups++;
+    for (size_t i = 0; i < layout->count; i++) {
+        const FixtureKey& key = layout->keys[i];
+        if (key.vkCode != vkCode) continue;
+
+        bool shift = (plane & KEY_PLANE_SHIFT) != 0;
+        bool letter = (key.base >= 'a' && key.base <= 'z') || (key.base >= 0x430 && key.base < 0x450) || key.base == 0xFC;
+        if (letter && (plane & KEY_PLANE_CAPS) && !(plane & KEY_PLANE_ALTGR)) shift = !shift;
+
+        int value;
+        if (plane & KEY_PLANE_ALTGR) {
+            if (shift) return 0;
+            value = key.altGr;
+        } else {
+            value = shift ? key.shift : key.base;
+        }
+        if (value == 0 || capacity < 1) return 0;
+        if (value == DEAD) return -1;
+        out[0] = (uint16_t)value;
+        return 1;
+    }
+    return 0;
+}
+
+static const uint8_t ALTGR = LOCK_MOD_CONTROL | LOCK_MOD_ALT;
+
+static void CheckTables() {
+    KeyTranslationTable table;
+    BuildKeyTranslationTable(LookupFixture, (void*)&US, 1, table);
+    CHECK(table.layout == 1);
+    CHECK(table.Translate(0, 'A') == 'a');
+    CHECK(table.Translate(LOCK_MOD_SHIFT, 'A') == 'A');
+    CHECK(table.Translate(LOCK_MOD_SHIFT, '4') == '$');
+    CHECK(table.Translate(LOCK_MOD_SHIFT, 0xBA) == ':');
+    // Shortcut states type nothing
+    CHECK(table.Translate(LOCK_MOD_CONTROL, 'A') == 0);
+    CHECK(table.Translate(LOCK_MOD_ALT, 'A') == 0);
+    CHECK(table.Translate(LOCK_MOD_WIN, 'A') == 0);
+    CHECK(table.Translate(LOCK_MOD_WIN | LOCK_MOD_SHIFT, 'A') == 0);
+    // Control characters, modifiers and mouse buttons are not password characters
+    CHECK(table.Translate(0, 0x08) == 0);
+    CHECK(table.Translate(0, 0x1B) == 0);
+    CHECK(table.Translate(0, 0x10) == 0); // VK_SHIFT
+    CHECK(table.Translate(0, 0x01) == 0); // VK_LBUTTON
+    CHECK(table.Translate(0, 0x20) == ' ');
+
+    table.capsLock = 1;
+    CHECK(table.Translate(0, 'A') == 'A');
+    CHECK(table.Translate(LOCK_MOD_SHIFT, 'A') == 'a');
+    CHECK(table.Translate(0, '1') == '1');
+
+    BuildKeyTranslationTable(LookupFixture, (void*)&FRENCH, 2, table);
+    table.capsLock = 0;
+    CHECK(table.Translate(0, '1') == '&');
+    CHECK(table.Translate(LOCK_MOD_SHIFT, '1') == '1');
+    CHECK(table.Translate(0, '2') == 0xE9);
+    CHECK(table.Translate(ALTGR, '0') == '@');
+    CHECK(table.Translate(0, 0xDD) == 0); // Dead key
+
+    BuildKeyTranslationTable(LookupFixture, (void*)&GERMAN, 3, table);
+    CHECK(table.Translate(ALTGR, 'Q') == '@');
+    CHECK(table.Translate(0, 0xDB) == 0xDF);
+    CHECK(table.Translate(0, 0xDC) == 0);
+    CHECK(table.Translate(LOCK_MOD_SHIFT, 0xDC) == 0xB0);
+    CHECK(table.Translate(ALTGR, 'E') == 0x20AC);
+    CHECK(table.Translate(ALTGR | LOCK_MOD_SHIFT, 'E') == 0);
+    table.capsLock = 1;
+    CHECK(table.Translate(0, 0xBA) == 0xDC);
+
+    BuildKeyTranslationTable(LookupFixture, (void*)&RUSSIAN, 4, table);
+    table.capsLock = 0;
+    CHECK(table.Translate(0, 'F') == 0x430);
+    CHECK(table.Translate(LOCK_MOD_SHIFT, 'D') == 0x412);
+
+    char bytes[3];
+    CHECK(EncodeKeyCharUtf8('a', bytes) == 1 && bytes[0] == 'a');
+    CHECK(EncodeKeyCharUtf8(0xFC, bytes) == 2 && (uint8_t)bytes[0] == 0xC3 && (uint8_t)bytes[1] == 0xBC);
+    CHECK(EncodeKeyCharUtf8(0x20AC, bytes) == 3 && (uint8_t)bytes[0] == 0xE2 && (uint8_t)bytes[1] == 0x82 &&
+          (uint8_t)bytes[2] == 0xAC);
+}
+
+static void CheckCache() {
+    KeyTranslationCache cache;
+    const FixtureLayout* layouts[] = { &US, &FRENCH, &GERMAN, &RUSSIAN };
+    for (int i = 0; i < 4; i++) cache.Get((uint64_t)(i + 1), LookupFixture, (void*)layouts[i]);
+    CHECK(cache.GetBuildCount() == 4);
+
+    // Hits never call the lookup
+    size_t before = g_lookups;
+    CHECK(cache.Get(2, LookupFixture, (void*)&FRENCH).Translate(0, '1') == '&');
+    CHECK(cache.Get(1, LookupFixture, (void*)&US).Translate(0, 'A') == 'a');
+    CHECK(g_lookups == before && cache.GetBuildCount() == 4);
+
+    // A fifth layout replaces the least recently used one (3)
+    cache.Get(9, LookupFixture, (void*)&US);
+    CHECK(cache.GetBuildCount() == 5);
+    before = g_lookups;
+    cache.Get(4, LookupFixture, (void*)&RUSSIAN);
+    CHECK(g_lookups == before);
+    cache.Get(3, LookupFixture, (void*)&GERMAN);
+    CHECK(cache.GetBuildCount() == 6);
+
+    cache.Clear();
+    cache.Get(1, LookupFixture, (void*)&US);
+    CHECK(cache.GetBuildCount() == 7);
+}
+
+static InputEvent KeyEvent(uint8_t code, bool down) {
+    InputEvent event;
+    memset(&event, 0, sizeof(event));
+    event.device = INPUT_DEVICE_KEYBOARD;
+    event.type = down ? INPUT_EVENT_KEY_DOWN : INPUT_EVENT_KEY_UP;
+    event.code = code;
+    return event;
+}
+
+static void Tap(LockPipeline& pipeline, uint8_t vk) {
+    pipeline.OnInputEvent(KeyEvent(vk, true));
+    pipeline.OnInputEvent(KeyEvent(vk, false));
+}
+
+// Keyboard locked with a typed password: every key but the modifiers is queued
+static void BuildConfig(LockEngineConfig& config) {
+    KeyPolicySettings settings;
+    settings.keyboardLockEnabled = true;
+    settings.whitelistEnabled = false;
+    settings.unlockMethod = 0;
+    CompileKeyPolicy(settings, true, config.keyPolicy);
+    config.mouseBlockMask = 0;
+    config.failsafeEnabled = true;
+    memset(config.unlockChords, 0, sizeof(config.unlockChords));
+}
+
+static volatile unsigned g_sink;
+
+int main() {
+    CheckTables();
+    CheckCache();
+
+    LockEngineConfig config;
+    BuildConfig(config);
+    LockPipeline pipeline;
+    pipeline.Configure(config);
+    KeyTranslationTable german;
+    BuildKeyTranslationTable(LookupFixture, (void*)&GERMAN, 3, german);
+    pipeline.ConfigureKeyTranslation(&german);
+    pipeline.SetLocked(true);
+
+    // German, typing u umlaut, AltGr+Q, sharp s, Shift+4, Shift+E, then the dead key
+    const uint8_t LCONTROL = 0xA2, RMENU = 0xA5, LSHIFT = 0xA0;
+    Tap(pipeline, 0xBA);
+    pipeline.OnInputEvent(KeyEvent(LCONTROL, true));
+    pipeline.OnInputEvent(KeyEvent(RMENU, true));
+    Tap(pipeline, 'Q');
+    pipeline.OnInputEvent(KeyEvent(RMENU, false));
+    pipeline.OnInputEvent(KeyEvent(LCONTROL, false));
+    Tap(pipeline, 0xDB);
+    pipeline.OnInputEvent(KeyEvent(LSHIFT, true));
+    Tap(pipeline, '4');
+    Tap(pipeline, 'E');
+    pipeline.OnInputEvent(KeyEvent(LSHIFT, false));
+    Tap(pipeline, 0xDC);
+
+    KeyEventRecord records[64];
+    size_t count = pipeline.PopKeyEvents(records, 64);
+    std::string typed;
+    for (size_t i = 0; i < count; i++) {
+        if (!records[i].character) {
+            typed += "|";
+            continue;
+        }
+        char bytes[3];
+        typed.append(bytes, EncodeKeyCharUtf8(records[i].character, bytes));
+    }
+    printf("typed: %s (%zu records)\n", typed.c_str(), count);
+    CHECK(typed == "\xC3\xBC@\xC3\x9F$E|");
+
+    // Translation off: the key is still queued, without a character
+    pipeline.ConfigureKeyTranslation(nullptr);
+    Tap(pipeline, 'Q');
+    count = pipeline.PopKeyEvents(records, 64);
+    CHECK(count == 1 && records[0].character == 0 && records[0].vkCode == 'Q');
+
+    // Cost of a queued key press with and without translation
+    for (int translated = 0; translated < 2; translated++) {
+        pipeline.ConfigureKeyTranslation(translated ? &german : nullptr);
+        const int PRESSES = 50000000;
+        unsigned checksum = 0;
+        ToolClock::time_point start = ToolClock::now();
+        for (int i = 0; i < PRESSES; i++) {
+            pipeline.OnInputEvent(KeyEvent((uint8_t)('A' + (i & 15)), true));
+            if ((i & 31) == 31) {
+                size_t popped = pipeline.PopKeyEvents(records, 64);
+                for (size_t k = 0; k < popped; k++) checksum += records[k].character;
+                pipeline.ConsumeWake();
+            }
+        }
+        double seconds = SecondsSince(start);
+        printf("%s: %.2f ns per queued key\n", translated ? "translated" : "untranslated", seconds * 1e9 / PRESSES);
+        CHECK(translated ? checksum != 0 : checksum == 0);
+        g_sink = checksum;
+    }
+
+    return CheckResult("key_translation_tests");
+}
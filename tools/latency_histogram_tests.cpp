@@ -0,0 +1,189 @@
+// tools/latency_histogram_tests.cpp
+// LatencyHistogram bucket boundaries, percentile accuracy, snapshot intervals and the cost of Record()
+//
+// From the repository root: g++ -std=c++17 -O2 -Isrc tools/latency_histogram_tests.cpp
+//   src/utils/latency_histogram.cpp
+// Percentiles are compared with the exact value of the same rank from the
+// sorted samples: the histogram may report up to 1/16 above it, never below.
+
+#include "utils/latency_histogram.h"
+#include "tool_check.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+static const uint64_t MAX_VALUE = ~0ULL;
+
+// Record() budget per call on the hook thread, in ns (about 12 measured)
+static const double RECORD_BUDGET_NS = 50.0;
+
+static LatencyHistogram g_histogram; // About 8 KB of counters, kept off the stack
+static LatencyHistogram::Snapshot g_snapshots[3];
+
+static void CheckBuckets() {
+    typedef LatencyHistogram H;
+
+    // One bucket per value below the first power of two that is split
+    for (uint64_t value = 0; value < H::SUB_BUCKET_COUNT; value++) {
+        CHECK(H::BucketIndex(value) == value);
+        CHECK(H::BucketLowerBound((unsigned)value) == value && H::BucketUpperBound((unsigned)value) == value);
+    }
+    CHECK(H::BucketIndex(H::SUB_BUCKET_COUNT) == H::SUB_BUCKET_COUNT);
+
+    // Each power of two and its neighbours, up to the top bit
+    for (unsigned bit = H::SUB_BUCKET_BITS; bit < 64; bit++) {
+        uint64_t power = 1ULL << bit;
+        unsigned index = H::BucketIndex(power);
+        CHECK(H::BucketLowerBound(index) == power);
+        CHECK(H::BucketIndex(power - 1) == index - 1);
+        CHECK(H::BucketUpperBound(index - 1) == power - 1);
+
+        // The sub-buckets split [power, 2 * power) evenly
+        uint64_t width = power >> H::SUB_BUCKET_BITS;
+        for (unsigned sub = 0; sub < H::SUB_BUCKET_COUNT; sub++) {
+            uint64_t lower = power + sub * width;
+            CHECK(H::BucketIndex(lower) == index + sub);
+            CHECK(H::BucketIndex(lower + width - 1) == index + sub);
+            CHECK(H::BucketLowerBound(index + sub) == lower && H::BucketUpperBound(index + sub) == lower + width - 1);
+        }
+    }
+
+    // The largest value lands in the last bucket, whose bound does not wrap
+    CHECK(H::BucketIndex(MAX_VALUE) == H::BUCKET_COUNT - 1);
+    CHECK(H::BucketUpperBound(H::BUCKET_COUNT - 1) == MAX_VALUE);
+    CHECK(H::BucketLowerBound(H::BUCKET_COUNT - 1) == MAX_VALUE - ((1ULL << 59) - 1));
+
+    // Random values fall inside their bucket
+    std::mt19937_64 random(6);
+    for (int i = 0; i < 1000000; i++) {
+        uint64_t value = random() >> (random() % 64);
+        unsigned index = H::BucketIndex(value);
+        CHECK(index < H::BUCKET_COUNT && H::BucketLowerBound(index) <= value && value <= H::BucketUpperBound(index));
+    }
+
+    g_histogram.Reset();
+    g_histogram.Record(MAX_VALUE);
+    g_histogram.Record(0);
+    CHECK(g_histogram.GetMax() == MAX_VALUE && g_histogram.GetPercentile(1.0) == MAX_VALUE);
+    CHECK(g_histogram.GetPercentile(0.0) == 0);
+}
+
+// The histogram's answer against the sorted samples, at the rank it uses
+static size_t CheckPercentiles(const char* name, const std::vector<uint64_t>& samples) {
+    g_histogram.Reset();
+    uint64_t sum = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        g_histogram.Record(samples[i]);
+        sum += samples[i];
+    }
+    std::vector<uint64_t> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    static const double FRACTIONS[] = { 0.0, 0.5, 0.9, 0.99, 0.999, 1.0 };
+    size_t outside = 0;
+    double worstError = 0;
+    for (size_t f = 0; f < sizeof(FRACTIONS) / sizeof(FRACTIONS[0]); f++) {
+        uint64_t rank = (uint64_t)(FRACTIONS[f] * (double)sorted.size() + 0.5);
+        if (rank == 0) rank = 1;
+        uint64_t exact = sorted[rank - 1];
+        uint64_t reported = g_histogram.GetPercentile(FRACTIONS[f]);
+        outside += reported < exact || reported - exact > exact / LatencyHistogram::SUB_BUCKET_COUNT;
+        if (exact) worstError = std::max(worstError, (double)(reported - exact) / (double)exact);
+    }
+
+    LatencySummary summary = g_histogram.GetSummary();
+    CHECK(summary.count == samples.size() && summary.max == sorted.back());
+    CHECK(summary.min <= sorted.front() && LatencyHistogram::BucketIndex(summary.min) == LatencyHistogram::BucketIndex(sorted.front()));
+    CHECK(std::fabs(summary.mean - (double)sum / samples.size()) < 1e-6 * summary.mean + 1e-9);
+    CHECK(summary.p999 == g_histogram.GetPercentile(0.999));
+
+    printf("%-34s p50 %8llu, p99 %8llu, p99.9 %8llu, max %8llu; worst error %.2f%%\n", name,
+           (unsigned long long)summary.p50, (unsigned long long)summary.p99, (unsigned long long)summary.p999,
+           (unsigned long long)summary.max, worstError * 100);
+    return outside;
+}
+
+static void CheckDistributions() {
+    std::mt19937_64 random(9);
+    const size_t SAMPLES = 200000;
+    std::vector<uint64_t> samples(SAMPLES);
+
+    for (size_t i = 0; i < SAMPLES; i++) samples[i] = random() % 1000;
+    CHECK(CheckPercentiles("uniform 0-999", samples) == 0);
+
+    std::exponential_distribution<double> exponential(1.0 / 5000);
+    for (size_t i = 0; i < SAMPLES; i++) samples[i] = (uint64_t)exponential(random);
+    CHECK(CheckPercentiles("exponential, mean 5000", samples) == 0);
+
+    // Hook-like: fast calls, with one in 500 a hundred times slower
+    for (size_t i = 0; i < SAMPLES; i++) samples[i] = i % 500 == 0 ? 200000 + random() % 50000 : 1500 + random() % 1000;
+    CHECK(CheckPercentiles("bimodal, 0.2% slow tail", samples) == 0);
+    CHECK(g_histogram.GetPercentile(0.999) >= 200000 && g_histogram.GetPercentile(0.99) < 2600);
+
+    // Every sample the same: every percentile is that value, not the bucket bound
+    for (size_t i = 0; i < SAMPLES; i++) samples[i] = 1234;
+    CHECK(CheckPercentiles("constant 1234", samples) == 0);
+    CHECK(g_histogram.GetPercentile(0.5) == 1234 && g_histogram.GetPercentile(0.999) == 1234);
+
+    g_histogram.Reset();
+    CHECK(g_histogram.GetPercentile(0.5) == 0 && g_histogram.GetSummary().count == 0);
+}
+
+// A slow spell early on does not show in a later interval, and a late one is not diluted
+static void CheckIntervals() {
+    g_histogram.Reset();
+    g_histogram.TakeSnapshot(g_snapshots[0]);
+    for (int i = 0; i < 10000; i++) g_histogram.Record(i % 100 == 0 ? 250000 : 2000);
+    g_histogram.TakeSnapshot(g_snapshots[1]);
+    for (int i = 0; i < 10000; i++) g_histogram.Record(2000);
+    g_histogram.TakeSnapshot(g_snapshots[2]);
+
+    CHECK(LatencyHistogram::GetPercentileBetween(g_snapshots[0], g_snapshots[1], 0.999) == 250000);
+    uint64_t quiet = LatencyHistogram::GetPercentileBetween(g_snapshots[1], g_snapshots[2], 0.999);
+    CHECK(quiet >= 2000 && quiet <= 2000 + 2000 / LatencyHistogram::SUB_BUCKET_COUNT);
+    CHECK(g_histogram.GetPercentile(0.999) == 250000); // Lifetime still remembers it
+
+    // The same tail after hours of fast calls: invisible in the lifetime p99.9
+    for (int i = 0; i < 1000000; i++) g_histogram.Record(2000);
+    g_histogram.TakeSnapshot(g_snapshots[0]);
+    for (int i = 0; i < 1000; i++) g_histogram.Record(i % 100 == 0 ? 180000 : 2000);
+    g_histogram.TakeSnapshot(g_snapshots[1]);
+    CHECK(g_histogram.GetPercentile(0.999) < 2200);
+    uint64_t late = LatencyHistogram::GetPercentileBetween(g_snapshots[0], g_snapshots[1], 0.999);
+    CHECK(late >= 180000 && late <= 180000 + 180000 / LatencyHistogram::SUB_BUCKET_COUNT);
+
+    // Nothing recorded, or the histogram reset in between: no figure
+    CHECK(LatencyHistogram::GetPercentileBetween(g_snapshots[1], g_snapshots[1], 0.999) == 0);
+    g_histogram.Reset();
+    g_histogram.Record(5);
+    g_histogram.TakeSnapshot(g_snapshots[2]);
+    CHECK(LatencyHistogram::GetPercentileBetween(g_snapshots[1], g_snapshots[2], 0.999) == 0);
+}
+
+int main() {
+    CheckBuckets();
+    CheckDistributions();
+    CheckIntervals();
+
+    // Record() of hook-like durations in QueryPerformanceCounter ticks (10 MHz)
+    const size_t VALUES = 1 << 16;
+    const int ROUNDS = 300;
+    std::mt19937_64 random(12);
+    std::vector<uint64_t> values(VALUES);
+    for (size_t i = 0; i < VALUES; i++) values[i] = 5 + random() % 400 + (random() % 1000 == 0 ? 100000 : 0);
+
+    double best = 1e30;
+    for (int attempt = 0; attempt < 3; attempt++) {
+        g_histogram.Reset();
+        ToolClock::time_point start = ToolClock::now();
+        for (int round = 0; round < ROUNDS; round++) {
+            for (size_t i = 0; i < VALUES; i++) g_histogram.Record(values[i]);
+        }
+        best = std::min(best, SecondsSince(start) * 1e9 / (VALUES * ROUNDS));
+    }
+    CHECK(g_histogram.GetCount() == VALUES * ROUNDS);
+    printf("Record(): %.1f ns per call (budget %.0f ns)\n", best, RECORD_BUDGET_NS);
+    CHECK(best < RECORD_BUDGET_NS);
+
+    return CheckResult("latency_histogram_tests");
+}
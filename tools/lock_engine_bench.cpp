@@ -0,0 +1,150 @@
+// tools/lock_engine_bench.cpp
+// LockEngine decisions per second, with a check that 10M events allocate nothing
+//
+// From the repository root: g++ -std=c++17 -O2 -Isrc tools/lock_engine_bench.cpp
+//   src/features/lock_input/lock_engine.cpp src/features/lock_input/hook_policy.cpp
+//   src/features/lock_input/key_policy.cpp
+// Also checks the decisions that guard the lock: the hotkeys never unlock.
+
+#include "features/lock_input/lock_engine.h"
+#include "features/lock_input/key_event_ring.h"
+#include "alloc_counter.h"
+#include "tool_check.h"
+#include <cstring>
+#include <random>
+
+static const uint16_t VK_CONTROL_KEY = 0x11;
+static const uint16_t VK_SHIFT_KEY = 0x10;
+static const uint16_t VK_ESCAPE_KEY = 0x1B;
+
+static InputEvent KeyEvent(uint16_t code, bool down, uint32_t time) {
+    InputEvent event;
+    memset(&event, 0, sizeof(event));
+    event.device = INPUT_DEVICE_KEYBOARD;
+    event.type = down ? INPUT_EVENT_KEY_DOWN : INPUT_EVENT_KEY_UP;
+    event.code = code;
+    event.time = time;
+    return event;
+}
+
+static InputEvent MouseEvent(InputEventType type, int32_t x, int32_t y, uint32_t time) {
+    InputEvent event;
+    memset(&event, 0, sizeof(event));
+    event.device = INPUT_DEVICE_MOUSE;
+    event.type = (uint8_t)type;
+    event.code = type == INPUT_EVENT_BUTTON_DOWN || type == INPUT_EVENT_BUTTON_UP ? INPUT_BUTTON_LEFT : 0;
+    event.x = x;
+    event.y = y;
+    event.time = time;
+    return event;
+}
+
+// The app's defaults: keyboard and mouse locked, password unlock, Esc and
+// F1-F12 whitelisted, failsafe on, Ctrl+O and Ctrl+Shift+L swallowed
+static void BuildConfig(LockEngineConfig& config) {
+    KeyPolicySettings settings;
+    settings.keyboardLockEnabled = true;
+    settings.whitelistEnabled = true;
+    settings.whitelistedKeys = DEFAULT_WHITELISTED_KEYS;
+    settings.unlockMethod = 0;
+    CompileKeyPolicy(settings, false, config.keyPolicy);
+    config.mouseBlockMask = MouseLockEventMask(MOUSE_LOCK_ALL);
+    config.failsafeEnabled = true;
+    config.unlockChords[0].modifiers = LOCK_MOD_CONTROL;
+    config.unlockChords[0].vkCode = 'O';
+    config.unlockChords[1].modifiers = LOCK_MOD_CONTROL | LOCK_MOD_SHIFT;
+    config.unlockChords[1].vkCode = 'L';
+}
+
+// Holds the modifiers, presses key, releases everything; returns the key's result
+static LockResult PressChord(LockEngine& engine, const uint16_t* modifiers, size_t count, uint16_t key, uint32_t time) {
+    for (size_t i = 0; i < count; i++) engine.Process(KeyEvent(modifiers[i], true, time));
+    LockResult result = engine.Process(KeyEvent(key, true, time));
+    engine.Process(KeyEvent(key, false, time));
+    for (size_t i = 0; i < count; i++) engine.Process(KeyEvent(modifiers[i], false, time));
+    return result;
+}
+
+static void CheckDecisions(LockEngine& engine) {
+    engine.SetLocked(false);
+    CHECK(engine.Process(KeyEvent('A', true, 0)).decision == LOCK_DECISION_PASS);
+    CHECK(engine.Process(MouseEvent(INPUT_EVENT_BUTTON_DOWN, 0, 0, 0)).decision == LOCK_DECISION_PASS);
+
+    engine.SetLocked(true);
+    LockResult result = engine.Process(KeyEvent('A', true, 10));
+    CHECK(result.decision == LOCK_DECISION_BLOCK && result.queueFlags == KEY_EVENT_DOWN);
+    result = engine.Process(KeyEvent(0x20, true, 10)); // Space: not a password key
+    CHECK(result.decision == LOCK_DECISION_BLOCK && result.queueFlags == KEY_EVENT_RESET);
+    CHECK(engine.Process(KeyEvent(0x71, true, 10)).decision == LOCK_DECISION_PASS); // F2 is whitelisted
+    CHECK(engine.Process(MouseEvent(INPUT_EVENT_MOUSE_MOVE, 5, 5, 10)).decision == LOCK_DECISION_BLOCK);
+
+    // Neither hotkey may unlock: that would bypass every credential
+    CHECK(engine.GetEntry(LOCK_STATE_LOCKED, LOCK_EVENT_UNLOCK_CHORD) == LockEngine::MakeEntry(LOCK_DECISION_BLOCK, 0));
+    const uint16_t control[] = { VK_CONTROL_KEY };
+    const uint16_t controlShift[] = { VK_CONTROL_KEY, VK_SHIFT_KEY };
+    result = PressChord(engine, control, 1, 'O', 20);
+    CHECK(result.decision == LOCK_DECISION_BLOCK && result.queueFlags == 0);
+    CHECK(engine.GetState() == LOCK_STATE_LOCKED);
+    result = PressChord(engine, controlShift, 2, 'L', 30);
+    CHECK(result.decision == LOCK_DECISION_BLOCK && result.queueFlags == 0);
+    CHECK(engine.GetState() == LOCK_STATE_LOCKED);
+
+    // Outside a per-app scope input passes, but the hotkeys are still swallowed
+    engine.SetScope(LOCK_SCOPE_NONE);
+    CHECK(engine.Process(KeyEvent('A', true, 40)).decision == LOCK_DECISION_PASS);
+    CHECK(PressChord(engine, control, 1, 'O', 40).decision == LOCK_DECISION_BLOCK);
+    CHECK(engine.GetState() == LOCK_STATE_LOCKED);
+    engine.SetScope(LOCK_SCOPE_ALL);
+
+    // The failsafe: Esc x3
+    CHECK(engine.Process(KeyEvent(VK_ESCAPE_KEY, true, 1000)).decision == LOCK_DECISION_PASS);
+    CHECK(engine.Process(KeyEvent(VK_ESCAPE_KEY, true, 1100)).decision == LOCK_DECISION_PASS);
+    CHECK(engine.Process(KeyEvent(VK_ESCAPE_KEY, true, 1200)).decision == LOCK_DECISION_REQUEST_EXIT);
+}
+
+int main() {
+    LockEngineConfig config;
+    BuildConfig(config);
+    LockEngine engine;
+    engine.Configure(config);
+    CheckDecisions(engine);
+
+    // A mixed workload: typing, modifiers, hotkeys, mouse moves and clicks
+    const size_t PATTERN = 4096;
+    static InputEvent events[PATTERN];
+    std::mt19937 random(11);
+    for (size_t i = 0; i < PATTERN; i++) {
+        uint32_t time = (uint32_t)(i * 4);
+        unsigned kind = random() % 10;
+        if (kind < 4) events[i] = KeyEvent((uint16_t)('A' + random() % 26), random() % 2 == 0, time);
+        else if (kind == 4) events[i] = KeyEvent((uint16_t)('0' + random() % 10), true, time);
+        else if (kind == 5) events[i] = KeyEvent(random() % 2 ? VK_CONTROL_KEY : VK_SHIFT_KEY, random() % 2 == 0, time);
+        else if (kind == 6) events[i] = KeyEvent('O', true, time);
+        else if (kind < 9) events[i] = MouseEvent(INPUT_EVENT_MOUSE_MOVE, (int32_t)(random() % 1920), (int32_t)(random() % 1080), time);
+        else events[i] = MouseEvent(random() % 2 ? INPUT_EVENT_BUTTON_DOWN : INPUT_EVENT_BUTTON_UP, 0, 0, time);
+    }
+
+    const size_t EVENT_COUNT = 10000000;
+    const LockState states[] = { LOCK_STATE_UNLOCKED, LOCK_STATE_LOCKED };
+    for (size_t s = 0; s < 2; s++) {
+        engine.SetLocked(states[s] == LOCK_STATE_LOCKED);
+        uint64_t decisions[4] = { 0, 0, 0, 0 }; // Indexed by the decision's two bits
+        unsigned long long allocationsBefore = GetAllocationCount();
+        ToolClock::time_point start = ToolClock::now();
+        for (size_t i = 0; i < EVENT_COUNT; i++) {
+            decisions[engine.Process(events[i & (PATTERN - 1)]).decision & 3]++;
+        }
+        double seconds = SecondsSince(start);
+        unsigned long long allocations = GetAllocationCount() - allocationsBefore;
+
+        printf("%s: %.1f M decisions/s (%.1f ns each), %llu heap allocations over %u M events\n",
+               states[s] == LOCK_STATE_LOCKED ? "locked" : "unlocked", EVENT_COUNT / seconds / 1e6,
+               seconds * 1e9 / EVENT_COUNT, allocations, (unsigned)(EVENT_COUNT / 1000000));
+        printf("  pass %llu, block %llu, exit %llu\n", (unsigned long long)decisions[LOCK_DECISION_PASS],
+               (unsigned long long)decisions[LOCK_DECISION_BLOCK], (unsigned long long)decisions[LOCK_DECISION_REQUEST_EXIT]);
+        CHECK(allocations == 0);
+        CHECK(decisions[3] == 0);
+        CHECK(engine.GetState() == states[s]); // Ctrl+O appears throughout the workload
+    }
+    return CheckResult("lock_engine_bench");
+}
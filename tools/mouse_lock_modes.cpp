@@ -0,0 +1,179 @@
+// tools/mouse_lock_modes.cpp
+// Checks what each mouse lock mode blocks, and times a mouse-heavy locked session per mode
+//
+// From the repository root: g++ -std=c++17 -O2 -Isrc tools/mouse_lock_modes.cpp
+//   src/features/lock_input/lock_engine.cpp src/features/lock_input/hook_policy.cpp
+//   src/features/lock_input/key_policy.cpp
+// The session is synthetic: 85% moves, 6% clicks, 5% wheel, 4% keys. In the
+// modes that never block movement the mouse hook passes moves on without
+// building an event; "skip-move" times that path.
+
+#include "features/lock_input/lock_engine.h"
+#include "tool_check.h"
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const char* const MODE_NAMES[MOUSE_LOCK_MODE_COUNT] = { "all", "clicks", "wheel", "confine" };
+
+static InputEvent MouseEvent(InputEventType type, int32_t x, int32_t y, uint32_t time) {
+    InputEvent event;
+    memset(&event, 0, sizeof(event));
+    event.device = INPUT_DEVICE_MOUSE;
+    event.type = (uint8_t)type;
+    event.code = type == INPUT_EVENT_BUTTON_DOWN || type == INPUT_EVENT_BUTTON_UP ? INPUT_BUTTON_LEFT : 0;
+    event.x = x;
+    event.y = y;
+    event.time = time;
+    return event;
+}
+
+static InputEvent KeyEvent(uint16_t code, bool down, uint32_t time) {
+    InputEvent event;
+    memset(&event, 0, sizeof(event));
+    event.device = INPUT_DEVICE_KEYBOARD;
+    event.type = down ? INPUT_EVENT_KEY_DOWN : INPUT_EVENT_KEY_UP;
+    event.code = code;
+    event.time = time;
+    return event;
+}
+
+// Keyboard and mouse locked with the given mode, password unlock
+static void BuildConfig(int mode, LockEngineConfig& config) {
+    KeyPolicySettings settings;
+    settings.keyboardLockEnabled = true;
+    settings.whitelistEnabled = true;
+    settings.whitelistedKeys = DEFAULT_WHITELISTED_KEYS;
+    settings.unlockMethod = 0;
+    CompileKeyPolicy(settings, false, config.keyPolicy);
+    config.mouseBlockMask = MouseLockEventMask(mode);
+    config.failsafeEnabled = true;
+    memset(config.unlockChords, 0, sizeof(config.unlockChords));
+}
+
+static bool Blocks(LockEngine& engine, InputEventType type) {
+    return engine.Process(MouseEvent(type, 10, 10, 0)).decision == LOCK_DECISION_BLOCK;
+}
+
+static void CheckModes() {
+    const uint8_t move = 1 << INPUT_EVENT_MOUSE_MOVE;
+    const uint8_t buttons = (1 << INPUT_EVENT_BUTTON_DOWN) | (1 << INPUT_EVENT_BUTTON_UP);
+    const uint8_t wheel = 1 << INPUT_EVENT_WHEEL;
+    CHECK(MouseLockEventMask(MOUSE_LOCK_ALL) == (move | buttons | wheel));
+    CHECK(MouseLockEventMask(MOUSE_LOCK_CLICKS) == buttons);
+    CHECK(MouseLockEventMask(MOUSE_LOCK_WHEEL) == wheel);
+    CHECK(MouseLockEventMask(MOUSE_LOCK_CONFINE) == (buttons | wheel));
+    // A mode from a newer or corrupted setting blocks everything rather than nothing
+    CHECK(MouseLockEventMask(MOUSE_LOCK_MODE_COUNT) == (move | buttons | wheel));
+    CHECK(MouseLockEventMask(-1) == (move | buttons | wheel));
+
+    for (int mode = 0; mode < MOUSE_LOCK_MODE_COUNT; mode++) {
+        LockEngineConfig config;
+        BuildConfig(mode, config);
+        uint8_t mask = config.mouseBlockMask;
+
+        HookPolicy policy;
+        CompileHookPolicy(config, policy);
+        CHECK(policy.mouseBlock == mask);
+
+        LockEngine engine;
+        engine.Configure(config);
+
+        // Unlocked, nothing is blocked whatever the mode
+        CHECK(!Blocks(engine, INPUT_EVENT_MOUSE_MOVE) && !Blocks(engine, INPUT_EVENT_BUTTON_DOWN));
+        CHECK(!Blocks(engine, INPUT_EVENT_WHEEL));
+
+        engine.SetLocked(true);
+        CHECK(Blocks(engine, INPUT_EVENT_MOUSE_MOVE) == ((mask & move) != 0));
+        CHECK(Blocks(engine, INPUT_EVENT_BUTTON_DOWN) == ((mask & buttons) != 0));
+        CHECK(Blocks(engine, INPUT_EVENT_BUTTON_UP) == ((mask & buttons) != 0));
+        CHECK(Blocks(engine, INPUT_EVENT_WHEEL) == ((mask & wheel) != 0));
+        CHECK(engine.Process(KeyEvent('A', true, 0)).decision == LOCK_DECISION_BLOCK); // Keyboard untouched
+        CHECK(engine.GetState() == LOCK_STATE_LOCKED);
+
+        // A per-app scope without the mouse lets every mouse event through
+        engine.SetScope(LOCK_SCOPE_KEYBOARD);
+        CHECK(!Blocks(engine, INPUT_EVENT_MOUSE_MOVE) && !Blocks(engine, INPUT_EVENT_BUTTON_DOWN));
+        CHECK(!Blocks(engine, INPUT_EVENT_WHEEL));
+        CHECK(engine.Process(KeyEvent('A', true, 0)).decision == LOCK_DECISION_BLOCK);
+        engine.SetScope(LOCK_SCOPE_ALL);
+    }
+
+    // Mouse lock off: no mode applies
+    LockEngineConfig config;
+    BuildConfig(MOUSE_LOCK_ALL, config);
+    config.mouseBlockMask = 0;
+    LockEngine engine;
+    engine.Configure(config);
+    engine.SetLocked(true);
+    CHECK(!Blocks(engine, INPUT_EVENT_MOUSE_MOVE) && !Blocks(engine, INPUT_EVENT_BUTTON_DOWN));
+    CHECK(!Blocks(engine, INPUT_EVENT_WHEEL));
+}
+
+static volatile uint64_t g_sink;
+
+int main() {
+    CheckModes();
+
+    std::vector<InputEvent> events;
+    std::mt19937 random(7);
+    uint32_t time = 1000;
+    int32_t x = 500, y = 400;
+    size_t counts[INPUT_EVENT_WHEEL + 1] = {};
+    for (int i = 0; i < 3000000; i++) {
+        unsigned kind = random() % 100;
+        time += 4;
+        if (kind < 85) {
+            x += (int32_t)(random() % 11) - 5;
+            y += (int32_t)(random() % 11) - 5;
+            events.push_back(MouseEvent(INPUT_EVENT_MOUSE_MOVE, x, y, time));
+        } else if (kind < 91) {
+            events.push_back(MouseEvent((kind & 1) ? INPUT_EVENT_BUTTON_UP : INPUT_EVENT_BUTTON_DOWN, x, y, time));
+        } else if (kind < 96) {
+            InputEvent event = MouseEvent(INPUT_EVENT_WHEEL, x, y, time);
+            event.wheelDelta = (kind & 1) ? 120 : -120;
+            events.push_back(event);
+        } else {
+            events.push_back(KeyEvent((uint16_t)('A' + random() % 26), (kind & 1) != 0, time));
+        }
+        if (events.back().device == INPUT_DEVICE_MOUSE) counts[events.back().type]++;
+    }
+
+    const int ROUNDS = 20;
+    for (int mode = 0; mode < MOUSE_LOCK_MODE_COUNT; mode++) {
+        LockEngineConfig config;
+        BuildConfig(mode, config);
+        uint8_t mask = config.mouseBlockMask;
+        size_t expectedMouse = 0;
+        for (int type = INPUT_EVENT_MOUSE_MOVE; type <= INPUT_EVENT_WHEEL; type++) {
+            if (mask & (1 << type)) expectedMouse += counts[type];
+        }
+
+        for (int skipMoves = 0; skipMoves < 2; skipMoves++) {
+            if (skipMoves && (mask & (1 << INPUT_EVENT_MOUSE_MOVE))) continue; // The hook only skips moves that pass
+
+            LockEngine engine;
+            engine.Configure(config);
+            engine.SetLocked(true);
+            uint64_t blockedMouse = 0;
+            ToolClock::time_point start = ToolClock::now();
+            for (int round = 0; round < ROUNDS; round++) {
+                for (size_t i = 0; i < events.size(); i++) {
+                    const InputEvent& event = events[i];
+                    if (skipMoves && event.type == INPUT_EVENT_MOUSE_MOVE) continue;
+                    bool blocked = engine.Process(event).decision == LOCK_DECISION_BLOCK;
+                    if (event.device == INPUT_DEVICE_MOUSE) blockedMouse += blocked;
+                }
+            }
+            double seconds = SecondsSince(start);
+            printf("%-8s %-9s %6.1f M events/s (%llu mouse events blocked per pass)\n", MODE_NAMES[mode],
+                   skipMoves ? "skip-move" : "engine", events.size() * ROUNDS / seconds / 1e6,
+                   (unsigned long long)(blockedMouse / ROUNDS));
+            CHECK(blockedMouse == (uint64_t)expectedMouse * ROUNDS);
+            CHECK(engine.GetState() == LOCK_STATE_LOCKED);
+            g_sink = blockedMouse;
+        }
+    }
+
+    return CheckResult("mouse_lock_modes");
+}
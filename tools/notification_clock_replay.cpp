@@ -0,0 +1,348 @@
+// tools/notification_clock_replay.cpp
+// Fake-clock replay of notification timelines through the animation clock's scheduling: ticks, wakes and expiry
+//
+// From the repository root: g++ -std=c++17 -O2 -Isrc tools/notification_clock_replay.cpp
+//   src/utils/notification_compositor.cpp src/utils/pixel_kernels.cpp src/utils/notification_queue.cpp
+// The window and the clock thread are Win32, so the parts that decide when
+// anything runs are replayed here in simulated milliseconds: AnimationClock's
+// loop on a 60 Hz composition (a tick at most every FRAME_INTERVAL, less
+// FRAME_SLACK), and ShowNotification, UpdateNotifications, OnFrameTick,
+// ScheduleNextAnimation and the one-shot wake as CustomNotificationSystem has
+// them, with the real NotificationQueue, NotificationIdleTime and
+// NotificationSlide. Tick messages are handled as soon as they are posted.
+// Each scenario is compared with the 33 ms timer the window used to keep.
+
+#include "utils/notification_compositor.h"
+#include "utils/notification_queue.h"
+#include "tool_check.h"
+#include <cstring>
+
+static const uint32_t FRAME_INTERVAL = 33;
+static const uint32_t FRAME_SLACK = 4;
+static const uint32_t FADE_DURATION = 200;
+static const uint32_t DURATION = 4000;
+static const int SCREEN_HEIGHT = 1080;
+static const int NOTIFY_HEIGHT = 80;
+static const int NOTIFY_MARGIN = 10;
+static const NotificationLayout LAYOUT = { 320, NOTIFY_HEIGHT, 10, NOTIFY_HEIGHT - 3, 2, 4 };
+static const uint32_t NO_TIMER = 0xFFFFFFFFu;
+
+// Composition n, at 60 Hz, in whole milliseconds
+static uint32_t Composition(uint64_t n) {
+    return (uint32_t)(n * 1000 / 60);
+}
+
+struct ReplayNotification {
+    uint32_t showTime;
+    uint32_t duration;
+    uint32_t baseDuration;
+    float opacity;
+    int yPosition;
+    int targetY;
+};
+
+struct ReplayStats {
+    uint64_t clockTicks;     // renderStats.clockTicks
+    uint64_t idleTicks;      // renderStats.idleTicks
+    uint64_t scheduledWakes; // renderStats.scheduledWakes
+    uint64_t resumes;        // AnimationClockStats::resumes
+    uint64_t threadWakeups;  // AnimationClockStats::threadWakeups
+    uint64_t shown;
+    uint64_t coalesced;
+    uint64_t removed;
+    uint32_t worstLateness;  // Removal after showTime + duration, ms
+};
+
+class NotificationClockReplay {
+private:
+    ReplayNotification slots[NotificationQueue::CAPACITY];
+    NotificationQueue queue;
+
+    // AnimationClock
+    bool ticking;
+    uint32_t lastTick;
+    uint64_t composition; // Next one the clock thread waits for
+
+    uint32_t wakeDue; // WAKE_TIMER_ID, NO_TIMER when killed
+    uint32_t now;
+
+    ReplayNotification* At(size_t position) { return &slots[queue.GetSlot(position)]; }
+
+    void Resume() {
+        if (ticking) return;
+        ticking = true;
+        stats.resumes++;
+        // The thread leaves its wait and blocks in DwmFlush for the next composition
+        composition = (uint64_t)now * 60 / 1000 + 1;
+    }
+
+    void Pause() { ticking = false; }
+
+    bool UpdateNotifications() {
+        bool needsUpdate = false;
+        for (size_t position = 0; position < queue.GetCount();) {
+            ReplayNotification* notif = At(position);
+            uint32_t elapsed = now - notif->showTime;
+            if (elapsed < FADE_DURATION) {
+                notif->opacity = (float)elapsed / FADE_DURATION;
+                needsUpdate = true;
+            } else if (elapsed > notif->duration - FADE_DURATION) {
+                uint32_t fadeElapsed = elapsed - (notif->duration - FADE_DURATION);
+                notif->opacity = 1.0f - ((float)fadeElapsed / FADE_DURATION);
+                needsUpdate = true;
+                if (notif->opacity <= 0) {
+                    uint32_t lateness = elapsed - notif->duration;
+                    if (lateness > stats.worstLateness) stats.worstLateness = lateness;
+                    stats.removed++;
+                    queue.Remove(queue.GetSlot(position));
+                    continue;
+                }
+            } else {
+                notif->opacity = 1.0f;
+            }
+            if (notif->yPosition != notif->targetY) {
+                notif->yPosition = NotificationSlide(notif->yPosition, notif->targetY);
+                needsUpdate = true;
+            }
+            ++position;
+        }
+        return needsUpdate && queue.GetCount() > 0;
+    }
+
+    void ScheduleNextAnimation() {
+        wakeDue = NO_TIMER;
+        if (queue.GetCount() == 0) return;
+        uint32_t wait = 0xFFFFFFFFu;
+        for (size_t position = 0; position < queue.GetCount(); position++) {
+            const ReplayNotification* notif = At(position);
+            uint32_t idle = NotificationIdleTime(now - notif->showTime, notif->duration, FADE_DURATION);
+            if (idle < wait) wait = idle;
+        }
+        if (wait == 0) Resume();
+        else wakeDue = now + wait;
+    }
+
+    void OnFrameTick() {
+        stats.clockTicks++;
+        if (queue.GetCount() == 0) stats.idleTicks++;
+        if (UpdateNotifications()) return;
+        Pause();
+        ScheduleNextAnimation();
+    }
+
+public:
+    ReplayStats stats;
+
+    NotificationClockReplay() : ticking(false), lastTick(0 - FRAME_INTERVAL), composition(0), wakeDue(NO_TIMER), now(0) {
+        memset(slots, 0, sizeof(slots));
+        memset(&stats, 0, sizeof(stats));
+    }
+
+    bool IsTicking() const { return ticking; }
+    bool IsWakeScheduled() const { return wakeDue != NO_TIMER; }
+    size_t GetCount() const { return queue.GetCount(); }
+
+    // Runs the clock thread and the wake timer up to time
+    void AdvanceTo(uint32_t time) {
+        for (;;) {
+            uint32_t next = time;
+            bool frame = false;
+            if (ticking && Composition(composition) <= next) {
+                next = Composition(composition);
+                frame = true;
+            }
+            if (wakeDue != NO_TIMER && wakeDue <= next) {
+                next = wakeDue;
+                frame = false;
+            }
+            now = next;
+            if (frame) {
+                composition++;
+                stats.threadWakeups++;
+                if (now - lastTick + FRAME_SLACK >= FRAME_INTERVAL) {
+                    lastTick = now;
+                    OnFrameTick();
+                }
+            } else if (wakeDue == now) {
+                // TimerProc
+                wakeDue = NO_TIMER;
+                stats.scheduledWakes++;
+                Resume();
+            } else {
+                return;
+            }
+        }
+    }
+
+    // The NOTIFY_STYLE_CUSTOM path of ShowNotification
+    void Show(uint32_t time, const char* title, const char* message, uint8_t level = 0, uint32_t source = 0,
+              uint32_t duration = DURATION) {
+        AdvanceTo(time);
+        NotificationOffer offer = queue.Offer(NotificationKey(level, title, message), source, level, now);
+        if (offer.admission == NOTIFY_ADMIT_COALESCED) {
+            ReplayNotification* notif = &slots[offer.slot];
+            notif->duration = (now - notif->showTime) + notif->baseDuration;
+            stats.coalesced++;
+            wakeDue = NO_TIMER;
+            Resume();
+            return;
+        }
+        if (offer.admission != NOTIFY_ADMIT_NEW) return;
+
+        ReplayNotification* notif = &slots[offer.slot];
+        notif->showTime = now;
+        notif->duration = duration;
+        notif->baseDuration = duration;
+        notif->opacity = 0.0f;
+        notif->targetY = SCREEN_HEIGHT - NOTIFY_HEIGHT - NOTIFY_MARGIN - NotificationSlotTop(LAYOUT, queue.GetCount() - 1);
+        notif->yPosition = SCREEN_HEIGHT;
+        stats.shown++;
+        wakeDue = NO_TIMER;
+        Resume();
+    }
+
+    // Click to dismiss
+    void ClearAll(uint32_t time) {
+        AdvanceTo(time);
+        queue.Clear();
+        Pause();
+        wakeDue = NO_TIMER;
+    }
+};
+
+// The old always-on window timer over the same span
+static uint64_t FixedTimerTicks(uint32_t span) {
+    return span / FRAME_INTERVAL;
+}
+
+static void Report(const char* name, const ReplayStats& stats, uint32_t span) {
+    printf("%-34s %5llu ticks (timer: %7llu), %2llu wakes, %2llu resumes, %5llu clock wake-ups, %llu idle, "
+           "removed up to %u ms late\n", name, (unsigned long long)stats.clockTicks,
+           (unsigned long long)FixedTimerTicks(span), (unsigned long long)stats.scheduledWakes,
+           (unsigned long long)stats.resumes, (unsigned long long)stats.threadWakeups,
+           (unsigned long long)stats.idleTicks, stats.worstLateness);
+}
+
+// Ticks while one notification animates: its fade-in (with the slide, which
+// ends later) and its fade-out, a frame each way for the clock to catch up
+static uint64_t AnimatedTicks(uint32_t animatedMs) {
+    return animatedMs / (FRAME_INTERVAL - FRAME_SLACK) + 2;
+}
+
+// Frames the slide from off-screen to the first slot takes
+static uint32_t SlideFrames() {
+    int position = SCREEN_HEIGHT, target = SCREEN_HEIGHT - NOTIFY_HEIGHT - NOTIFY_MARGIN;
+    uint32_t frames = 0;
+    while (position != target) {
+        position = NotificationSlide(position, target);
+        frames++;
+    }
+    return frames;
+}
+
+// Once the stack is empty nothing runs: no ticks, no wakes, no clock wake-ups
+static void CheckSilentAfter(NotificationClockReplay& replay, uint32_t from, uint32_t to) {
+    CHECK(replay.GetCount() == 0 && !replay.IsTicking() && !replay.IsWakeScheduled());
+    ReplayStats before = replay.stats;
+    replay.AdvanceTo(from);
+    replay.AdvanceTo(to);
+    CHECK(replay.stats.clockTicks == before.clockTicks && replay.stats.threadWakeups == before.threadWakeups);
+    CHECK(replay.stats.scheduledWakes == before.scheduledWakes && replay.stats.resumes == before.resumes);
+}
+
+// One notification, then an hour of nothing
+static void CheckSingle() {
+    NotificationClockReplay replay;
+    replay.Show(1000, "UtilityApp", "Settings applied");
+    replay.AdvanceTo(1000 + DURATION + 100);
+    const ReplayStats& stats = replay.stats;
+
+    uint32_t entering = SlideFrames() * FRAME_INTERVAL;
+    if (entering < FADE_DURATION) entering = FADE_DURATION;
+    CHECK(stats.removed == 1 && stats.worstLateness <= FRAME_INTERVAL + 1);
+    CHECK(stats.scheduledWakes == 1 && stats.resumes == 2 && stats.idleTicks == 0);
+    CHECK(stats.clockTicks <= AnimatedTicks(entering) + AnimatedTicks(FADE_DURATION));
+    CHECK(stats.threadWakeups <= 2 * stats.clockTicks + 2);
+    CheckSilentAfter(replay, 1000 + DURATION + 100, 3600 * 1000);
+    Report("1 notification, then 1 h", stats, 3600 * 1000);
+}
+
+// The same message again within the coalescing window keeps it up for a
+// full duration from the repeat: one tick per repeat, and the pending wake
+// moves to the new fade-out instead of firing early
+static void CheckCoalesce() {
+    NotificationClockReplay replay;
+    replay.Show(0, "USB", "Device connected");
+    replay.AdvanceTo(1500); // Faded and slid in; waiting for the fade-out
+    uint64_t ticksBefore = replay.stats.clockTicks;
+    CHECK(replay.IsWakeScheduled() && !replay.IsTicking());
+    replay.Show(1500, "USB", "Device connected");
+    replay.Show(2500, "USB", "Device connected");
+    replay.AdvanceTo(2500 + DURATION - FADE_DURATION - 1);
+    CHECK(replay.GetCount() == 1 && replay.stats.coalesced == 2);
+    CHECK(replay.stats.clockTicks == ticksBefore + 2 && replay.stats.scheduledWakes == 0);
+
+    replay.AdvanceTo(2500 + DURATION + 100);
+    const ReplayStats& stats = replay.stats;
+    CHECK(stats.removed == 1 && stats.scheduledWakes == 1 && stats.idleTicks == 0);
+    CHECK(stats.worstLateness <= 2500 + FRAME_INTERVAL + 1); // Against the first duration: shown 2.5 s longer
+    CheckSilentAfter(replay, 2500 + DURATION + 100, 60 * 1000);
+    Report("1 notification, repeated twice", stats, 60 * 1000);
+}
+
+// Four staggered notifications over a minute; the clock runs only around
+// their fades and slides
+static void CheckStaggered() {
+    NotificationClockReplay replay;
+    static const uint32_t TIMES[] = { 0, 700, 1500, 2600 };
+    static const char* MESSAGES[] = { "Keyboard locked", "USB device connected", "Settings applied", "Keyboard unlocked" };
+    for (int i = 0; i < 4; i++) replay.Show(TIMES[i], "UtilityApp", MESSAGES[i], 0, (uint32_t)i);
+    replay.AdvanceTo(2600 + DURATION + 100);
+    const ReplayStats& stats = replay.stats;
+    CHECK(stats.removed == 4 && stats.worstLateness <= FRAME_INTERVAL + 1 && stats.idleTicks == 0);
+    CHECK(stats.clockTicks * 10 < FixedTimerTicks(60 * 1000));
+    CheckSilentAfter(replay, 2600 + DURATION + 100, 60 * 1000);
+    Report("4 staggered, over 60 s", stats, 60 * 1000);
+}
+
+// A burst from several sources: rate limits, eviction and coalescing all
+// happen, and every notification still leaves on time
+static void CheckBurst() {
+    NotificationClockReplay replay;
+    char message[32];
+    for (uint32_t i = 0; i < 200; i++) {
+        snprintf(message, sizeof(message), "Event %u", i % 40);
+        replay.Show(i * 50, "Burst", message, (uint8_t)(i % 7 == 0 ? 2 : 0), i % 5);
+    }
+    uint32_t end = 200 * 50 + DURATION * 3;
+    replay.AdvanceTo(end);
+    const ReplayStats& stats = replay.stats;
+    CHECK(stats.shown > NotificationQueue::CAPACITY && stats.removed <= stats.shown);
+    CHECK(stats.idleTicks == 0 && stats.worstLateness <= FRAME_INTERVAL + 1);
+    CheckSilentAfter(replay, end, 600 * 1000);
+    Report("200 over 10 s from 5 sources", stats, 600 * 1000);
+}
+
+// Click to dismiss while one waits for its fade-out: the wake goes too
+static void CheckClearAll() {
+    NotificationClockReplay replay;
+    replay.Show(0, "UtilityApp", "Timer finished");
+    replay.Show(300, "UtilityApp", "Break reminder");
+    replay.AdvanceTo(2000);
+    CHECK(replay.IsWakeScheduled());
+    replay.ClearAll(2000);
+    CHECK(replay.stats.idleTicks == 0 && replay.stats.scheduledWakes == 0);
+    CheckSilentAfter(replay, 2000, 600 * 1000);
+    Report("2 notifications, dismissed", replay.stats, 600 * 1000);
+}
+
+int main() {
+    CheckSingle();
+    CheckCoalesce();
+    CheckStaggered();
+    CheckBurst();
+    CheckClearAll();
+    printf("slide from off-screen: %u frames\n", SlideFrames());
+
+    return CheckResult("notification_clock_replay");
+}
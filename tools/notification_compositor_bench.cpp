@@ -0,0 +1,318 @@
+// tools/notification_compositor_bench.cpp
+// Paint cost and per-frame churn of the cached-body notification compositor against the old per-paint rebuild
+//
+// From the repository root: g++ -std=c++17 -O2 -Isrc tools/notification_compositor_bench.cpp
+//   src/utils/notification_compositor.cpp src/utils/pixel_kernels.cpp src/utils/latency_histogram.cpp
+// GDI does not run here, so both paths are modelled on what PresentFrame()
+// and the old DrawNotification() did with it. A DIB section and its DC count
+// as the two objects CreateSurface() adds to gdiObjectsCreated; the old path
+// made a DC, a bitmap, a brush, a border pen and an accent pen per
+// notification per paint, counted the same way, and its bitmap is a heap
+// block here. Drawing the body (background, border, text rows) is a fill and
+// a few row writes, far cheaper than DrawText, so the old path's figures are
+// a floor. Frame times go into a LatencyHistogram in nanoseconds, as
+// renderStats.paintTicks holds them in QPC ticks; the BitBlt or
+// UpdateLayeredWindow is not included.
+
+#include "utils/notification_compositor.h"
+#include "utils/pixel_kernels.h"
+#include "utils/latency_histogram.h"
+#include "alloc_counter.h"
+#include "tool_check.h"
+#include <cstring>
+#include <vector>
+
+static const int NOTIFY_WIDTH = 320;
+static const int NOTIFY_HEIGHT = 80;
+static const size_t CAPACITY = 8; // NotificationQueue::CAPACITY
+static const uint32_t DURATION = 4000;
+static const uint32_t FADE = 200;
+static const uint32_t FRAME_MS = 33; // The animation clock's 30 FPS
+
+// As CustomNotificationSystem::LAYOUT
+static const NotificationLayout LAYOUT = { NOTIFY_WIDTH, NOTIFY_HEIGHT, 10, NOTIFY_HEIGHT - 3, 2, 4 };
+
+static const uint32_t BG_PIXEL = MakePixel(13, 13, 13);
+static const uint32_t BORDER_PIXEL = MakePixel(40, 40, 40);
+static const uint32_t TEXT_PIXEL = MakePixel(221, 221, 221);
+static const uint32_t ACCENT_PIXEL = MakePixel(58, 159, 255);
+
+// Paint p99 budget for a full stack while fading, in ns: an eighth of a frame
+static const uint64_t PAINT_BUDGET_NS = FRAME_MS * 1000000ULL / 8;
+
+// Objects the old DrawNotification() created per notification per paint
+static const uint64_t LEGACY_OBJECTS_PER_NOTIFICATION = 5;
+
+// Stand-in for RenderBody(): background, a 1 px border, a title row and
+// message rows with a different pattern per notification, then opaque with
+// rounded corners. GDI leaves the alpha byte 0, so the drawing does too.
+static void DrawBody(PixelSurface& body, unsigned seed) {
+    FillSurface(body, BG_PIXEL & 0x00FFFFFFu);
+    for (int x = 0; x < body.width; x++) {
+        body.pixels[x] = BORDER_PIXEL & 0x00FFFFFFu;
+        body.pixels[(size_t)(body.height - 1) * body.stride + x] = BORDER_PIXEL & 0x00FFFFFFu;
+    }
+    for (int y = 0; y < body.height; y++) {
+        body.pixels[(size_t)y * body.stride] = BORDER_PIXEL & 0x00FFFFFFu;
+        body.pixels[(size_t)y * body.stride + body.width - 1] = BORDER_PIXEL & 0x00FFFFFFu;
+    }
+    for (int y = 12; y < 60; y += 3) {
+        uint32_t* row = body.pixels + (size_t)y * body.stride;
+        for (int x = 15; x < body.width - 15; x++) {
+            if (((x * 7 + y * 13 + (int)seed) % 11) < 4) row[x] = TEXT_PIXEL & 0x00FFFFFFu;
+        }
+    }
+    SetSurfaceOpaque(body, LAYOUT.cornerRadius);
+}
+
+// The shown stack, oldest first: each notification's fixed slot and when it
+// appeared, in frame time
+struct Stack {
+    size_t slot[CAPACITY];
+    uint32_t showTime[CAPACITY];
+    size_t count;
+};
+
+// Opacity as UpdateAnimations() gives it: fade in, hold, fade out
+static float Opacity(uint32_t elapsed) {
+    if (elapsed < FADE) return (float)elapsed / FADE;
+    if (elapsed >= DURATION) return 0.0f;
+    if (elapsed > DURATION - FADE) return (float)(DURATION - elapsed) / FADE;
+    return 1.0f;
+}
+
+// PresentFrame() from cache: bodies drawn once, the frame surface kept
+// until the stack height changes
+class CachedCompositor {
+private:
+    std::vector<uint32_t> bodies[CAPACITY];
+    std::vector<uint32_t> frame;
+    int frameHeight;
+
+public:
+    uint64_t objectsCreated;
+    uint64_t bodiesRendered;
+    LatencyHistogram paintNs;
+
+    CachedCompositor() : frameHeight(0), objectsCreated(0), bodiesRendered(0) {
+        // Reserved up front, as the fixed notification slots and a DIB the size of the full stack would be
+        for (size_t i = 0; i < CAPACITY; i++) bodies[i].reserve((size_t)NOTIFY_WIDTH * NOTIFY_HEIGHT);
+        frame.reserve((size_t)NOTIFY_WIDTH * NotificationStackHeight(LAYOUT, CAPACITY));
+    }
+
+    // A notification left its slot; the next one there is drawn afresh
+    void Release(size_t slot) { bodies[slot].clear(); }
+
+    const uint32_t* Pixels() const { return frame.data(); }
+
+    void Present(const Stack& stack, uint32_t now) {
+        ToolClock::time_point start = ToolClock::now();
+        int height = NotificationStackHeight(LAYOUT, stack.count);
+        if (height <= 0) return;
+        if (frameHeight != height) {
+            frame.resize((size_t)NOTIFY_WIDTH * height);
+            frameHeight = height;
+            objectsCreated += 2;
+        }
+
+        PixelSurface target = { frame.data(), NOTIFY_WIDTH, height, NOTIFY_WIDTH };
+        FillSurface(target, 0);
+        for (size_t i = 0; i < stack.count; i++) {
+            std::vector<uint32_t>& body = bodies[stack.slot[i]];
+            if (body.empty()) {
+                body.resize((size_t)NOTIFY_WIDTH * NOTIFY_HEIGHT);
+                PixelSurface view = { body.data(), NOTIFY_WIDTH, NOTIFY_HEIGHT, NOTIFY_WIDTH };
+                DrawBody(view, (unsigned)stack.slot[i]);
+                bodiesRendered++;
+            }
+            uint32_t elapsed = now - stack.showTime[i];
+            NotificationBand band = NotificationProgressBand(LAYOUT, elapsed, DURATION, ACCENT_PIXEL);
+            PixelSurface view = { body.data(), NOTIFY_WIDTH, NOTIFY_HEIGHT, NOTIFY_WIDTH };
+            CompositeNotification(target, 0, NotificationSlotTop(LAYOUT, i), view, band,
+                                  NotificationAlpha(Opacity(elapsed)));
+        }
+        paintNs.Record((uint64_t)(SecondsSince(start) * 1e9));
+    }
+};
+
+// The old WM_PAINT: clear the window, then per notification a fresh bitmap,
+// the body and progress line drawn into it, and a constant-alpha blend
+class LegacyCompositor {
+private:
+    std::vector<uint32_t> window;
+
+public:
+    uint64_t objectsCreated;
+    LatencyHistogram paintNs;
+
+    LegacyCompositor() : objectsCreated(0) {
+        window.resize((size_t)NOTIFY_WIDTH * NotificationStackHeight(LAYOUT, CAPACITY));
+    }
+
+    void Present(const Stack& stack, uint32_t now) {
+        ToolClock::time_point start = ToolClock::now();
+        int height = NotificationStackHeight(LAYOUT, stack.count);
+        PixelSurface target = { window.data(), NOTIFY_WIDTH, height, NOTIFY_WIDTH };
+        FillSurface(target, MakePixel(0, 0, 0));
+        for (size_t i = 0; i < stack.count; i++) {
+            uint32_t* bitmap = new uint32_t[(size_t)NOTIFY_WIDTH * NOTIFY_HEIGHT];
+            objectsCreated += LEGACY_OBJECTS_PER_NOTIFICATION;
+            PixelSurface body = { bitmap, NOTIFY_WIDTH, NOTIFY_HEIGHT, NOTIFY_WIDTH };
+            DrawBody(body, (unsigned)stack.slot[i]);
+
+            uint32_t elapsed = now - stack.showTime[i];
+            NotificationBand band = NotificationProgressBand(LAYOUT, elapsed, DURATION, ACCENT_PIXEL);
+            for (int row = band.top; row < band.top + band.height; row++) {
+                PixelFillRow(bitmap + (size_t)row * NOTIFY_WIDTH, ACCENT_PIXEL, (size_t)band.width);
+            }
+            uint8_t alpha = NotificationAlpha(Opacity(elapsed));
+            int top = NotificationSlotTop(LAYOUT, i);
+            for (int row = 0; row < NOTIFY_HEIGHT; row++) {
+                PixelBlendRow(window.data() + (size_t)(top + row) * NOTIFY_WIDTH, bitmap + (size_t)row * NOTIFY_WIDTH,
+                              NOTIFY_WIDTH, alpha);
+            }
+            delete[] bitmap;
+        }
+        paintNs.Record((uint64_t)(SecondsSince(start) * 1e9));
+    }
+};
+
+static volatile uint32_t g_sink;
+
+// count notifications shown together at showTime; frames from there on
+static void Show(Stack& stack, size_t count, uint32_t showTime) {
+    stack.count = count;
+    for (size_t i = 0; i < count; i++) {
+        stack.slot[i] = i;
+        stack.showTime[i] = showTime;
+    }
+}
+
+// The cached frame against the body, band and gaps it was built from
+static void CheckFramePixels() {
+    static CachedCompositor compositor;
+    Stack stack;
+    Show(stack, 3, 0);
+    uint32_t now = DURATION / 2; // Opaque, band half way
+    compositor.Present(stack, now);
+
+    std::vector<uint32_t> body((size_t)NOTIFY_WIDTH * NOTIFY_HEIGHT);
+    PixelSurface view = { body.data(), NOTIFY_WIDTH, NOTIFY_HEIGHT, NOTIFY_WIDTH };
+    int height = NotificationStackHeight(LAYOUT, 3);
+    NotificationBand band = NotificationProgressBand(LAYOUT, now, DURATION, ACCENT_PIXEL);
+    CHECK(band.width == NOTIFY_WIDTH / 2);
+
+    size_t wrong = 0;
+    for (size_t i = 0; i < 3; i++) {
+        DrawBody(view, (unsigned)i);
+        int top = NotificationSlotTop(LAYOUT, i);
+        for (int y = 0; y < NOTIFY_HEIGHT; y++) {
+            for (int x = 0; x < NOTIFY_WIDTH; x++) {
+                uint32_t expected = body[(size_t)y * NOTIFY_WIDTH + x];
+                bool inBand = y >= band.top && y < band.top + band.height && x < band.width;
+                if (inBand) {
+                    // The band is cut away with the body at the rounded corners
+                    uint8_t coverage = (uint8_t)(expected >> 24);
+                    PixelScaleRow(&expected, &ACCENT_PIXEL, 1, coverage);
+                }
+                wrong += compositor.Pixels()[(size_t)(top + y) * NOTIFY_WIDTH + x] != expected;
+            }
+        }
+        // The gap below each notification stays transparent
+        for (int y = top + NOTIFY_HEIGHT; y < height && y < top + NOTIFY_HEIGHT + LAYOUT.gap; y++) {
+            for (int x = 0; x < NOTIFY_WIDTH; x++) wrong += compositor.Pixels()[(size_t)y * NOTIFY_WIDTH + x] != 0;
+        }
+    }
+    CHECK(wrong == 0);
+    CHECK(compositor.bodiesRendered == 3 && compositor.objectsCreated == 2);
+}
+
+// A stack that grows to full, shrinks as the oldest expire, and refills:
+// the frame surface is remade once per height, and a body is drawn once per
+// notification however often it moves up the stack
+static void CheckChurn() {
+    static CachedCompositor compositor;
+    Stack stack;
+    stack.count = 0;
+    uint32_t now = 0;
+    uint64_t heightChanges = 0;
+    uint64_t shown = 0;
+    size_t freeSlots[CAPACITY];
+    size_t freeCount = CAPACITY;
+    for (size_t i = 0; i < CAPACITY; i++) freeSlots[i] = CAPACITY - 1 - i;
+
+    unsigned long long allocationsBefore = GetAllocationCount();
+    for (int round = 0; round < 2; round++) {
+        while (stack.count < CAPACITY) {
+            stack.slot[stack.count] = freeSlots[--freeCount];
+            stack.showTime[stack.count++] = now;
+            shown++;
+            heightChanges++;
+            for (int frame = 0; frame < 30; frame++) compositor.Present(stack, now += FRAME_MS);
+        }
+        while (stack.count > 1) {
+            compositor.Release(stack.slot[0]);
+            freeSlots[freeCount++] = stack.slot[0];
+            memmove(stack.slot, stack.slot + 1, (stack.count - 1) * sizeof(stack.slot[0]));
+            memmove(stack.showTime, stack.showTime + 1, (stack.count - 1) * sizeof(stack.showTime[0]));
+            stack.count--;
+            heightChanges++;
+            for (int frame = 0; frame < 30; frame++) compositor.Present(stack, now += FRAME_MS);
+        }
+    }
+    unsigned long long allocations = GetAllocationCount() - allocationsBefore;
+
+    CHECK(compositor.objectsCreated == 2 * heightChanges);
+    CHECK(compositor.bodiesRendered == shown);
+    CHECK(allocations == 0);
+    printf("grow to %zu and back twice, 30 frames each: %llu objects created over %llu frames, %llu bodies drawn, "
+           "%llu allocations\n", CAPACITY, (unsigned long long)compositor.objectsCreated,
+           (unsigned long long)compositor.paintNs.GetCount(), (unsigned long long)compositor.bodiesRendered, allocations);
+}
+
+int main() {
+    CheckFramePixels();
+    CheckChurn();
+    printf("pixel kernel: %s\n", PixelKernelName(GetPixelKernel()));
+
+    // Steady stacks of each size, opaque (mid life) and fading (last FADE ms)
+    const int FRAMES = 600;
+    const char* phases[] = { "opaque", "fading" };
+    for (int phase = 0; phase < 2; phase++) {
+        for (size_t count = 1; count <= CAPACITY; count *= 2) {
+            static CachedCompositor cached;
+            static LegacyCompositor legacy;
+            cached.paintNs.Reset();
+            legacy.paintNs.Reset();
+            uint64_t objectsBefore = legacy.objectsCreated;
+            Stack stack;
+            Show(stack, count, 0);
+            uint32_t first = phase == 0 ? FADE : DURATION - FADE + 1;
+
+            cached.Present(stack, first); // Bodies and frame surface made; not counted below
+            cached.paintNs.Reset();
+            uint64_t cachedObjectsBefore = cached.objectsCreated;
+            unsigned long long allocationsBefore = GetAllocationCount();
+            for (int frame = 0; frame < FRAMES; frame++) cached.Present(stack, first + (uint32_t)frame % (FADE - 1));
+            unsigned long long cachedAllocations = GetAllocationCount() - allocationsBefore;
+
+            allocationsBefore = GetAllocationCount();
+            for (int frame = 0; frame < FRAMES; frame++) legacy.Present(stack, first + (uint32_t)frame % (FADE - 1));
+            unsigned long long legacyAllocations = GetAllocationCount() - allocationsBefore;
+
+            LatencySummary now = cached.paintNs.GetSummary();
+            LatencySummary old = legacy.paintNs.GetSummary();
+            CHECK(cached.objectsCreated == cachedObjectsBefore && cachedAllocations == 0);
+            CHECK(legacy.objectsCreated - objectsBefore == LEGACY_OBJECTS_PER_NOTIFICATION * count * FRAMES);
+            CHECK(legacyAllocations == count * FRAMES);
+            if (count == CAPACITY && phase == 1) CHECK(now.p99 < PAINT_BUDGET_NS);
+            g_sink = cached.Pixels()[0];
+
+            printf("%zu %s: cached p50 %6.1f us, p99 %6.1f us, 0 objects/frame | rebuilt p50 %6.1f us, "
+                   "p99 %6.1f us, %llu objects/frame\n", count, phases[phase], now.p50 / 1e3, now.p99 / 1e3,
+                   old.p50 / 1e3, old.p99 / 1e3, (unsigned long long)(LEGACY_OBJECTS_PER_NOTIFICATION * count));
+        }
+    }
+
+    return CheckResult("notification_compositor_bench");
+}
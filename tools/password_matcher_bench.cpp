@@ -0,0 +1,180 @@
+// tools/password_matcher_bench.cpp
+// PasswordMatcher candidates against a brute-force reference, and ns per key versus the old per-suffix scan
+//
+// From the repository root: g++ -std=c++17 -O2 -Isrc tools/password_matcher_bench.cpp
+//   src/features/lock_input/password_matcher.cpp src/utils/sha256.cpp
+// Millions of random keys go through Feed(), GetCandidates() and a hash of
+// each candidate. The old scan (a 20-byte rolling buffer, a std::string per
+// key and a hash of every suffix) is replayed with the same SHA-256, so it
+// is a lower bound: the real one also set up a CryptoAPI provider per hash.
+
+#include "features/lock_input/password_matcher.h"
+#include "utils/sha256.h"
+#include "tool_check.h"
+#include <cstring>
+#include <random>
+#include <string>
+
+// Every suffix the matcher should report after each key, from the whole typed history
+static void CheckAgainstReference() {
+    std::mt19937 random(2);
+    const uint64_t MASKS[] = { PasswordMatcher::LengthBit(8), PasswordMatcher::LegacyLengthMask(),
+                               PasswordMatcher::LengthBit(3) | PasswordMatcher::LengthBit(32), 0 };
+    for (size_t m = 0; m < sizeof(MASKS) / sizeof(MASKS[0]); m++) {
+        PasswordMatcher matcher;
+        matcher.SetCandidateLengths(MASKS[m]);
+        std::string typed;
+        for (int key = 0; key < 5000; key++) {
+            char c = (char)('a' + random() % 26);
+            matcher.Feed(c);
+            typed += c;
+
+            PasswordCandidate candidates[PasswordMatcher::MAX_PASSWORD_LENGTH + 1];
+            size_t count = matcher.GetCandidates(candidates, PasswordMatcher::MAX_PASSWORD_LENGTH + 1);
+            size_t expected = 0;
+            for (size_t length = 0; length <= PasswordMatcher::MAX_PASSWORD_LENGTH; length++) {
+                if (!(MASKS[m] & PasswordMatcher::LengthBit(length)) || length > typed.size()) continue;
+                // Shortest first, each the suffix of that length
+                CHECK(expected < count && candidates[expected].length == length &&
+                      memcmp(candidates[expected].data, typed.data() + typed.size() - length, length) == 0);
+                expected++;
+            }
+            CHECK(count == expected);
+
+            size_t recentLength;
+            const char* recent = matcher.GetRecentInput(&recentLength);
+            size_t wanted = typed.size() < PasswordMatcher::MAX_PASSWORD_LENGTH ? typed.size() : PasswordMatcher::MAX_PASSWORD_LENGTH;
+            CHECK(recentLength == wanted && memcmp(recent, typed.data() + typed.size() - wanted, wanted) == 0);
+        }
+    }
+
+    // A limited output buffer gets the shortest candidates
+    PasswordMatcher matcher;
+    matcher.SetCandidateLengths(PasswordMatcher::LegacyLengthMask());
+    for (int key = 0; key < 40; key++) matcher.Feed('x');
+    PasswordCandidate two[2];
+    CHECK(matcher.GetCandidates(two, 2) == 2 && two[0].length == 3 && two[1].length == 4);
+    matcher.Reset();
+    CHECK(matcher.GetInputLength() == 0 && matcher.GetCandidates(two, 2) == 0);
+}
+
+// The password is found when, and only when, its last key is typed
+static void CheckUnlock(const char* password) {
+    size_t passwordLength = strlen(password);
+    uint8_t stored[SHA256_DIGEST_SIZE];
+    Sha256(password, passwordLength, stored);
+
+    PasswordMatcher matcher;
+    matcher.SetCandidateLengths(PasswordMatcher::LengthBit(passwordLength));
+    std::mt19937 random(3);
+    int found = 0, foundAt = -1;
+    std::string typed;
+    for (int key = 0; key < 1000; key++) {
+        char c = key >= 500 && key < 500 + (int)passwordLength ? password[key - 500] : (char)('0' + random() % 10);
+        matcher.Feed(c);
+        typed += c;
+        PasswordCandidate candidate;
+        if (matcher.GetCandidates(&candidate, 1) == 0) continue;
+        uint8_t digest[SHA256_DIGEST_SIZE];
+        Sha256(candidate.data, candidate.length, digest);
+        if (Sha256DigestEquals(digest, stored)) {
+            found++;
+            foundAt = key;
+        }
+    }
+    CHECK(found == 1 && foundAt == 500 + (int)passwordLength - 1);
+}
+
+static volatile uint64_t g_sink;
+
+// Keys through the matcher, hashing each candidate; returns ns per key
+static double TimeMatcher(uint64_t mask, const std::string& keys, bool hash, uint64_t* hits) {
+    PasswordMatcher matcher;
+    matcher.SetCandidateLengths(mask);
+    uint8_t stored[SHA256_DIGEST_SIZE];
+    Sha256("not typed", 9, stored);
+    uint64_t checked = 0;
+    ToolClock::time_point start = ToolClock::now();
+    for (size_t i = 0; i < keys.size(); i++) {
+        matcher.Feed(keys[i]);
+        PasswordCandidate candidates[PasswordMatcher::MAX_PASSWORD_LENGTH + 1];
+        size_t count = matcher.GetCandidates(candidates, PasswordMatcher::MAX_PASSWORD_LENGTH + 1);
+        checked += count;
+        if (!hash) continue;
+        if (count == 1) {
+            uint8_t digest[SHA256_DIGEST_SIZE];
+            Sha256(candidates[0].data, candidates[0].length, digest);
+            *hits += Sha256DigestEquals(digest, stored);
+        } else if (count > 1) {
+            const uint8_t* messages[PasswordMatcher::MAX_PASSWORD_LENGTH + 1];
+            size_t lengths[PasswordMatcher::MAX_PASSWORD_LENGTH + 1];
+            uint8_t digests[PasswordMatcher::MAX_PASSWORD_LENGTH + 1][SHA256_DIGEST_SIZE];
+            for (size_t c = 0; c < count; c++) {
+                messages[c] = (const uint8_t*)candidates[c].data;
+                lengths[c] = candidates[c].length;
+            }
+            Sha256Batch(messages, lengths, count, digests);
+            for (size_t c = 0; c < count; c++) *hits += Sha256DigestEquals(digests[c], stored);
+        }
+    }
+    double seconds = SecondsSince(start);
+    g_sink = checked;
+    return seconds * 1e9 / keys.size();
+}
+
+// The scan the matcher replaced (AppendPasswordKey before the change)
+static double TimeOldScan(const std::string& keys, uint64_t* hits) {
+    const size_t MAX_BUFFER_SIZE = 20, TRIMMED_BUFFER_SIZE = 16;
+    char buffer[MAX_BUFFER_SIZE + 1];
+    size_t length = 0;
+    uint8_t stored[SHA256_DIGEST_SIZE];
+    Sha256("not typed", 9, stored);
+    ToolClock::time_point start = ToolClock::now();
+    for (size_t i = 0; i < keys.size(); i++) {
+        buffer[length++] = keys[i];
+        if (length > MAX_BUFFER_SIZE) {
+            memmove(buffer, buffer + (length - TRIMMED_BUFFER_SIZE), TRIMMED_BUFFER_SIZE);
+            length = TRIMMED_BUFFER_SIZE;
+        }
+        if (length < 3) continue;
+        std::string input(buffer, length);
+        uint8_t digest[SHA256_DIGEST_SIZE];
+        Sha256(input.data(), input.size(), digest);
+        *hits += Sha256DigestEquals(digest, stored);
+        if (input.length() > 8) {
+            for (size_t from = 1; from < input.length() - 3; from++) {
+                std::string suffix = input.substr(from);
+                Sha256(suffix.data(), suffix.size(), digest);
+                *hits += Sha256DigestEquals(digest, stored);
+            }
+        }
+    }
+    return SecondsSince(start) * 1e9 / keys.size();
+}
+
+int main() {
+    CheckAgainstReference();
+    CheckUnlock("10203040");
+    CheckUnlock("abc");
+    CheckUnlock("correct horse battery staple!!!!");
+
+    std::mt19937 random(5);
+    std::string keys(5000000, ' ');
+    for (size_t i = 0; i < keys.size(); i++) keys[i] = (char)('0' + random() % 43);
+    std::string fewerKeys = keys.substr(0, 500000);
+
+    uint64_t hits = 0;
+    double feedOnly = TimeMatcher(PasswordMatcher::LengthBit(8), keys, false, &hits);
+    double oneLength = TimeMatcher(PasswordMatcher::LengthBit(8), keys, true, &hits);
+    double legacy = TimeMatcher(PasswordMatcher::LegacyLengthMask(), fewerKeys, true, &hits);
+    double oldScan = TimeOldScan(fewerKeys, &hits);
+    CHECK(hits == 0);
+
+    printf("matcher, Feed + GetCandidates:          %8.1f ns/key\n", feedOnly);
+    printf("matcher, known length (1 hash per key): %8.1f ns/key\n", oneLength);
+    printf("matcher, legacy hash (18 lengths):      %8.1f ns/key (%s batches)\n", legacy,
+           Sha256KernelName(GetSha256BatchKernel()));
+    printf("old per-suffix scan (string + hashes):  %8.1f ns/key\n", oldScan);
+
+    return CheckResult("password_matcher_bench");
+}
@@ -0,0 +1,204 @@
+// tools/pipeline_bench.cpp
+// SyntheticInputBackend through LockPipeline into PasswordMatcher: unlocks per script pass and events per second
+//
+// From the repository root: g++ -std=c++17 -O2 -pthread -Isrc tools/pipeline_bench.cpp
+//   src/features/lock_input/synthetic_input_backend.cpp src/features/lock_input/lock_pipeline.cpp
+//   src/features/lock_input/lock_engine.cpp src/features/lock_input/hook_policy.cpp
+//   src/features/lock_input/key_policy.cpp src/features/lock_input/chord_trie.cpp
+//   src/features/lock_input/key_translation.cpp src/features/lock_input/password_matcher.cpp
+// A looping script of wrong input, mouse moves and the default password is
+// delivered one event per Pump() as a hook would, with the consumer draining
+// the key ring on every wake-up. A match is counted but the lock stays on,
+// so every pass is typed while locked. The threaded case puts the backend
+// and the consumer on separate threads.
+
+#include "features/lock_input/synthetic_input_backend.h"
+#include "features/lock_input/lock_pipeline.h"
+#include "features/lock_input/password_matcher.h"
+#include "alloc_counter.h"
+#include "tool_check.h"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static const char PASSWORD[] = "10203040";
+static const uint16_t VK_RETURN_KEY = 0x0D;
+
+static InputEvent KeyEvent(uint16_t code, bool down, uint32_t time) {
+    InputEvent event;
+    memset(&event, 0, sizeof(event));
+    event.device = INPUT_DEVICE_KEYBOARD;
+    event.type = down ? INPUT_EVENT_KEY_DOWN : INPUT_EVENT_KEY_UP;
+    event.code = code;
+    event.time = time;
+    return event;
+}
+
+// One pass: a wrong word and Enter, the mouse nudged, then the password.
+// Returns how many key records the pass queues (every blocked press).
+static size_t BuildScript(std::vector<InputEvent>& script) {
+    uint32_t time = 0;
+    size_t presses = 0;
+    const char* typed[] = { "HELLO", PASSWORD };
+    for (int part = 0; part < 2; part++) {
+        for (const char* c = typed[part]; *c; c++) {
+            script.push_back(KeyEvent((uint16_t)*c, true, time += 40));
+            script.push_back(KeyEvent((uint16_t)*c, false, time += 30));
+            presses++;
+        }
+        if (part == 0) {
+            script.push_back(KeyEvent(VK_RETURN_KEY, true, time += 40));
+            script.push_back(KeyEvent(VK_RETURN_KEY, false, time += 30));
+            presses++;
+            for (int i = 0; i < 20; i++) {
+                InputEvent move;
+                memset(&move, 0, sizeof(move));
+                move.device = INPUT_DEVICE_MOUSE;
+                move.type = INPUT_EVENT_MOUSE_MOVE;
+                move.x = 400 + i * 3;
+                move.y = 300 + i;
+                move.time = time += 8;
+                script.push_back(move);
+            }
+        }
+    }
+    return presses;
+}
+
+struct Consumer {
+    LockPipeline* pipeline;
+    PasswordMatcher matcher;
+    std::atomic<bool> wakePending;
+    uint64_t drained;
+    uint64_t unlocks;
+    uint64_t overflows;
+
+    Consumer() : pipeline(nullptr), wakePending(false), drained(0), unlocks(0), overflows(0) {}
+};
+
+static void OnWake(void* context) {
+    ((Consumer*)context)->wakePending.store(true, std::memory_order_release);
+}
+
+// ProcessKeyEvents, with the typed password compared directly
+static void Drain(Consumer& consumer) {
+    consumer.wakePending.store(false, std::memory_order_relaxed);
+    consumer.pipeline->ConsumeWake();
+    if (consumer.pipeline->ConsumeOverflow()) {
+        consumer.overflows++;
+        consumer.matcher.Reset();
+    }
+    KeyEventRecord batch[KEY_EVENT_RING_CAPACITY];
+    PasswordCandidate candidate;
+    size_t count;
+    while ((count = consumer.pipeline->PopKeyEvents(batch, KEY_EVENT_RING_CAPACITY)) > 0) {
+        consumer.drained += count;
+        for (size_t k = 0; k < count; k++) {
+            if (batch[k].flags & KEY_EVENT_RESET) {
+                consumer.matcher.Reset();
+                continue;
+            }
+            consumer.matcher.Feed((char)batch[k].vkCode);
+            if (consumer.matcher.GetCandidates(&candidate, 1) == 1 &&
+                memcmp(candidate.data, PASSWORD, candidate.length) == 0) {
+                consumer.unlocks++;
+                consumer.matcher.Reset();
+            }
+        }
+    }
+}
+
+static void Setup(LockPipeline& pipeline, Consumer& consumer) {
+    LockPipelineCallbacks callbacks;
+    memset(&callbacks, 0, sizeof(callbacks));
+    callbacks.wake = OnWake;
+    callbacks.context = &consumer;
+    pipeline.SetCallbacks(callbacks);
+
+    LockEngineConfig config;
+    KeyPolicySettings settings;
+    settings.keyboardLockEnabled = true;
+    settings.whitelistEnabled = true;
+    settings.whitelistedKeys = DEFAULT_WHITELISTED_KEYS;
+    settings.unlockMethod = 0;
+    CompileKeyPolicy(settings, false, config.keyPolicy);
+    config.mouseBlockMask = MouseLockEventMask(MOUSE_LOCK_ALL);
+    pipeline.Configure(config);
+    pipeline.SetLocked(true);
+
+    consumer.pipeline = &pipeline;
+    consumer.matcher.SetCandidateLengths(PasswordMatcher::LengthBit(sizeof(PASSWORD) - 1));
+}
+
+int main() {
+    std::vector<InputEvent> script;
+    size_t pressesPerPass = BuildScript(script);
+    const size_t PASSES = 500000;
+    const uint64_t EVENTS = (uint64_t)script.size() * PASSES;
+
+    // Same thread, draining on each wake-up as the UI thread does between hook calls
+    {
+        static LockPipeline pipeline;
+        Consumer consumer;
+        Setup(pipeline, consumer);
+        SyntheticInputBackend backend;
+        backend.SetEvents(script.data(), script.size(), true);
+        CHECK(backend.Start(&pipeline));
+
+        unsigned long long allocationsBefore = GetAllocationCount();
+        ToolClock::time_point start = ToolClock::now();
+        for (uint64_t i = 0; i < EVENTS; i++) {
+            backend.Pump(1);
+            if (consumer.wakePending.load(std::memory_order_relaxed)) Drain(consumer);
+        }
+        double seconds = SecondsSince(start);
+        unsigned long long allocations = GetAllocationCount() - allocationsBefore;
+        backend.Stop();
+
+        CHECK(backend.GetDeliveredCount() == EVENTS);
+        CHECK(backend.GetBlockedCount() == EVENTS); // Locked throughout: keys and mouse alike
+        CHECK(consumer.unlocks == PASSES && consumer.overflows == 0);
+        CHECK(consumer.drained == pressesPerPass * PASSES);
+        CHECK(allocations == 0);
+        printf("one thread:  %.1f M events/s (%.1f ns each), %llu unlocks in %.1f M events, %llu allocations\n",
+               EVENTS / seconds / 1e6, seconds * 1e9 / EVENTS, (unsigned long long)consumer.unlocks, EVENTS / 1e6,
+               allocations);
+    }
+
+    // Backend and consumer on their own threads, as the hook and UI threads are
+    {
+        static LockPipeline pipeline;
+        Consumer consumer;
+        Setup(pipeline, consumer);
+        SyntheticInputBackend backend;
+        backend.SetEvents(script.data(), script.size(), true);
+        CHECK(backend.Start(&pipeline));
+        std::atomic<bool> done(false);
+
+        std::thread ui([&]() {
+            while (!done.load(std::memory_order_acquire)) {
+                if (consumer.wakePending.load(std::memory_order_acquire)) Drain(consumer);
+                else std::this_thread::yield();
+            }
+            Drain(consumer);
+        });
+        ToolClock::time_point start = ToolClock::now();
+        for (uint64_t i = 0; i < EVENTS; i += script.size()) {
+            backend.Pump(script.size());
+            std::this_thread::yield(); // Hook events arrive spaced out; give the consumer its turn
+        }
+        double seconds = SecondsSince(start);
+        done.store(true, std::memory_order_release);
+        ui.join();
+        backend.Stop();
+
+        // Keys are only lost to an overflow the consumer was told about
+        CHECK(consumer.drained <= pressesPerPass * PASSES);
+        CHECK(consumer.overflows > 0 || (consumer.drained == pressesPerPass * PASSES && consumer.unlocks == PASSES));
+        printf("two threads: %.1f M events/s (%.1f ns each), %llu unlocks, %llu overflows\n",
+               EVENTS / seconds / 1e6, seconds * 1e9 / EVENTS, (unsigned long long)consumer.unlocks,
+               (unsigned long long)consumer.overflows);
+    }
+
+    return CheckResult("pipeline_bench");
+}
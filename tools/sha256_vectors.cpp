@@ -0,0 +1,134 @@
+// tools/sha256_vectors.cpp
+// SHA-256 against the FIPS 180-2 / NIST example vectors, on every kernel this CPU runs
+//
+// From the repository root: g++ -std=c++17 -O2 -pthread -Isrc tools/sha256_vectors.cpp src/utils/sha256.cpp
+// Also checks Sha256Batch against single hashing and reports ns per short hash.
+
+#include "utils/sha256.h"
+#include "tool_check.h"
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+
+struct Sha256Vector {
+    const char* message; // nullptr = one million 'a'
+    const char* digest;
+};
+
+static const Sha256Vector VECTORS[] = {
+    { "", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+    { "abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+      "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+    { "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+      "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1" },
+    { nullptr, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" },
+};
+
+static std::string HexDigest(const void* data, size_t length) {
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    char hex[65];
+    Sha256(data, length, digest);
+    Sha256ToHex(digest, hex);
+    return hex;
+}
+
+// Several threads make the very first call together: dispatch must come up once
+static void ConcurrentFirstUse() {
+    std::string results[4];
+    std::thread threads[4];
+    for (int i = 0; i < 4; i++) {
+        threads[i] = std::thread([&results, i] { results[i] = HexDigest("abc", 3); });
+    }
+    for (int i = 0; i < 4; i++) {
+        threads[i].join();
+        CHECK(results[i] == VECTORS[1].digest);
+    }
+}
+
+static void CheckVectors(Sha256Kernel kernel) {
+    std::string million(1000000, 'a');
+    for (size_t i = 0; i < sizeof(VECTORS) / sizeof(VECTORS[0]); i++) {
+        const char* message = VECTORS[i].message ? VECTORS[i].message : million.c_str();
+        std::string hex = HexDigest(message, strlen(message));
+        if (hex != VECTORS[i].digest) {
+            fprintf(stderr, "%s: vector %u gave %s\n", Sha256KernelName(kernel), (unsigned)i, hex.c_str());
+        }
+        CHECK(hex == VECTORS[i].digest);
+    }
+}
+
+// Every length around the block and batch boundaries, batched vs one by one
+static void CheckBatch() {
+    std::mt19937 random(180);
+    std::vector<std::vector<uint8_t> > messages(150);
+    std::vector<const uint8_t*> pointers(messages.size());
+    std::vector<size_t> lengths(messages.size());
+    for (size_t i = 0; i < messages.size(); i++) {
+        messages[i].resize(i);
+        for (size_t j = 0; j < i; j++) messages[i][j] = (uint8_t)random();
+        pointers[i] = messages[i].data();
+        lengths[i] = i;
+    }
+    std::vector<uint8_t[SHA256_DIGEST_SIZE]> batch(messages.size());
+    Sha256Batch(pointers.data(), lengths.data(), messages.size(), batch.data());
+    for (size_t i = 0; i < messages.size(); i++) {
+        uint8_t single[SHA256_DIGEST_SIZE];
+        Sha256(pointers[i], lengths[i], single);
+        CHECK(memcmp(single, batch[i], SHA256_DIGEST_SIZE) == 0);
+    }
+}
+
+static volatile uint8_t g_sink; // Keeps the benchmark loops from being optimized out
+
+static void Benchmark() {
+    const size_t COUNT = 2000000;
+    uint8_t message[8] = { '1', '0', '2', '0', '3', '0', '4', '0' };
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    uint8_t fold = 0;
+    ToolClock::time_point start = ToolClock::now();
+    for (size_t i = 0; i < COUNT; i++) {
+        message[0] = (uint8_t)i;
+        Sha256(message, sizeof(message), digest);
+        fold ^= digest[0];
+    }
+    double single = SecondsSince(start) * 1e9 / COUNT;
+
+    const uint8_t* messages[8];
+    size_t lengths[8];
+    uint8_t batch[8][SHA256_DIGEST_SIZE];
+    for (int lane = 0; lane < 8; lane++) {
+        messages[lane] = message;
+        lengths[lane] = sizeof(message);
+    }
+    start = ToolClock::now();
+    for (size_t i = 0; i < COUNT; i += 8) {
+        message[0] = (uint8_t)i;
+        Sha256Batch(messages, lengths, 8, batch);
+        fold ^= batch[7][0];
+    }
+    double batched = SecondsSince(start) * 1e9 / COUNT;
+    g_sink = fold;
+    printf("  8-byte message: %.0f ns single, %.0f ns batched (%s)\n", single, batched,
+           Sha256KernelName(GetSha256BatchKernel()));
+}
+
+int main() {
+    ConcurrentFirstUse();
+
+    const Sha256Kernel kernels[] = { SHA256_KERNEL_SCALAR, SHA256_KERNEL_SHANI, SHA256_KERNEL_AVX2 };
+    for (size_t i = 0; i < 3; i++) {
+        ForceSha256Kernel(kernels[i]);
+        if (GetSha256Kernel() != kernels[i] && GetSha256BatchKernel() != kernels[i]) {
+            printf("%s: not available on this CPU\n", Sha256KernelName(kernels[i]));
+            continue;
+        }
+        printf("%s (single %s, batch %s)\n", Sha256KernelName(kernels[i]),
+               Sha256KernelName(GetSha256Kernel()), Sha256KernelName(GetSha256BatchKernel()));
+        CheckVectors(kernels[i]);
+        CheckBatch();
+        Benchmark();
+    }
+    return CheckResult("sha256_vectors");
+}
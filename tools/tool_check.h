@@ -0,0 +1,43 @@
+// tools/tool_check.h
+// Check and timing helpers shared by the portable tests and benchmarks in tools/
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+static int g_checkFailures = 0;
+
+// Records a failure and keeps going, so one run reports every broken case
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            g_checkFailures++; \
+        } \
+    } while (0)
+
+typedef std::chrono::steady_clock ToolClock;
+
+inline double SecondsSince(ToolClock::time_point start) {
+    return std::chrono::duration<double>(ToolClock::now() - start).count();
+}
+
+// Value at fraction (0..1) of the samples, sorting them in place
+inline double Percentile(std::vector<double>& samples, double fraction) {
+    if (samples.empty()) return 0.0;
+    std::sort(samples.begin(), samples.end());
+    size_t index = (size_t)(fraction * (double)(samples.size() - 1) + 0.5);
+    return samples[index];
+}
+
+// Exit code for main(): 0 if every CHECK passed
+inline int CheckResult(const char* name) {
+    if (g_checkFailures) {
+        fprintf(stderr, "%s: %d check(s) failed\n", name, g_checkFailures);
+        return 1;
+    }
+    printf("%s: all checks passed\n", name);
+    return 0;
+}
@@ -0,0 +1,199 @@
+// tools/totp_vectors.cpp
+// SHA-1, HMAC (RFC 2202 / 4231), HOTP (RFC 4226) and TOTP (RFC 6238) against their published vectors
+//
+// From the repository root: g++ -std=c++17 -O2 -Isrc tools/totp_vectors.cpp
+//   src/features/lock_input/totp.cpp src/utils/hmac.cpp src/utils/sha1.cpp src/utils/sha256.cpp
+// Also checks TotpCodeWindow (skew, replay, incremental refresh), base32,
+// and what a key press costs with the codes precomputed versus hashed per key.
+
+#include "features/lock_input/totp.h"
+#include "tool_check.h"
+#include <cstring>
+#include <string>
+
+static std::string ToHex(const uint8_t* data, size_t length) {
+    static const char DIGITS[] = "0123456789abcdef";
+    std::string hex;
+    for (size_t i = 0; i < length; i++) {
+        hex += DIGITS[data[i] >> 4];
+        hex += DIGITS[data[i] & 15];
+    }
+    return hex;
+}
+
+static std::string Sha1Hex(const std::string& message) {
+    uint8_t digest[SHA1_DIGEST_SIZE];
+    Sha1(message.data(), message.size(), digest);
+    return ToHex(digest, SHA1_DIGEST_SIZE);
+}
+
+static std::string HmacHex(HmacAlgorithm algorithm, const uint8_t* key, size_t keyLength, const char* message) {
+    uint8_t tag[HMAC_MAX_SIZE];
+    Hmac(algorithm, key, keyLength, message, strlen(message), tag);
+    return ToHex(tag, HmacSize(algorithm));
+}
+
+static void CheckSha1() {
+    CHECK(Sha1Hex("") == "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    CHECK(Sha1Hex("abc") == "a9993e364706816aba3e25717850c26c9cd0d89d");
+    CHECK(Sha1Hex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+          "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+    CHECK(Sha1Hex(std::string(1000000, 'a')) == "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+}
+
+static void CheckHmac() {
+    uint8_t key20[20], key80[80], key131[131];
+    memset(key20, 0x0b, sizeof(key20));
+    memset(key80, 0xaa, sizeof(key80));
+    memset(key131, 0xaa, sizeof(key131));
+    const uint8_t* jefe = (const uint8_t*)"Jefe";
+
+    // RFC 2202 test cases 1, 2 and 6
+    CHECK(HmacHex(HMAC_SHA1, key20, 20, "Hi There") == "b617318655057264e28bc0b6fb378c8ef146be00");
+    CHECK(HmacHex(HMAC_SHA1, jefe, 4, "what do ya want for nothing?") == "effcdf6ae5eb2fa2d27416d5f184df9c259a7c79");
+    CHECK(HmacHex(HMAC_SHA1, key80, 80, "Test Using Larger Than Block-Size Key - Hash Key First") ==
+          "aa4ae5e15272d00e95705637ce8a3b55ed402112");
+
+    // RFC 4231 test cases 1, 2, 6 and 7
+    CHECK(HmacHex(HMAC_SHA256, key20, 20, "Hi There") ==
+          "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+    CHECK(HmacHex(HMAC_SHA256, jefe, 4, "what do ya want for nothing?") ==
+          "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+    CHECK(HmacHex(HMAC_SHA256, key131, 131, "Test Using Larger Than Block-Size Key - Hash Key First") ==
+          "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+    CHECK(HmacHex(HMAC_SHA256, key131, 131,
+                  "This is a test using a larger than block-size key and a larger than block-size data. "
+                  "The key needs to be hashed before being used by the HMAC algorithm.") ==
+          "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2");
+}
+
+static const uint8_t* const SECRET_SHA1 = (const uint8_t*)"12345678901234567890";
+static const uint8_t* const SECRET_SHA256 = (const uint8_t*)"12345678901234567890123456789012";
+
+// RFC 4226 appendix D
+static void CheckHotp() {
+    static const uint32_t EXPECTED[10] = { 755224, 287082, 359152, 969429, 338314, 254676, 287922, 162583, 399871, 520489 };
+    for (uint64_t counter = 0; counter < 10; counter++) {
+        CHECK(HotpValue(SECRET_SHA1, 20, counter, HMAC_SHA1, 6) == EXPECTED[counter]);
+    }
+
+    char code[8];
+    FormatOtpCode(42, 6, code);
+    CHECK(memcmp(code, "000042", 6) == 0);
+}
+
+struct TotpVector {
+    uint64_t unixTime;
+    const char* sha1;
+    const char* sha256;
+};
+
+// RFC 6238 appendix B (8 digits, 30-second steps)
+static const TotpVector TOTP_VECTORS[] = {
+    { 59, "94287082", "46119246" },
+    { 1111111109, "07081804", "68084774" },
+    { 1111111111, "14050471", "67062674" },
+    { 1234567890, "89005924", "91819424" },
+    { 2000000000, "69279037", "90698825" },
+    { 20000000000ULL, "65353130", "77737706" },
+};
+
+static void CheckTotp() {
+    TotpParameters parameters;
+    parameters.digits = 8;
+    for (size_t v = 0; v < sizeof(TOTP_VECTORS) / sizeof(TOTP_VECTORS[0]); v++) {
+        const TotpVector& vector = TOTP_VECTORS[v];
+        uint64_t step = TotpCodeWindow::StepAt(vector.unixTime, 30);
+        char code[8];
+        FormatOtpCode(HotpValue(SECRET_SHA1, 20, step, HMAC_SHA1, 8), 8, code);
+        CHECK(memcmp(code, vector.sha1, 8) == 0);
+        FormatOtpCode(HotpValue(SECRET_SHA256, 32, step, HMAC_SHA256, 8), 8, code);
+        CHECK(memcmp(code, vector.sha256, 8) == 0);
+
+        // Through the window: the step before, at and after are each accepted once
+        for (int offset = -1; offset <= 1; offset++) {
+            TotpCodeWindow window;
+            window.Refresh(SECRET_SHA1, 20, parameters, vector.unixTime + offset * 30);
+            char typed[10] = { 'x', 'x' };
+            memcpy(typed + 2, vector.sha1, 8);
+            CHECK(window.Match(typed, 10));
+            CHECK(!window.Match(typed, 10)); // Replay
+        }
+        TotpCodeWindow window;
+        window.Refresh(SECRET_SHA1, 20, parameters, vector.unixTime + 90);
+        CHECK(!window.Match(vector.sha1, 8)); // Outside the skew
+        CHECK(!window.Match(vector.sha1, 7)); // Too short
+    }
+
+    // SHA-256 through the window as well
+    TotpParameters sha256;
+    sha256.digits = 8;
+    sha256.algorithm = HMAC_SHA256;
+    TotpCodeWindow window;
+    window.Refresh(SECRET_SHA256, 32, sha256, TOTP_VECTORS[3].unixTime);
+    CHECK(window.Match(TOTP_VECTORS[3].sha256, 8));
+
+    // Refreshing as time passes accepts exactly what a fresh window would
+    TotpParameters sixDigits;
+    TotpCodeWindow incremental;
+    for (uint64_t time = 1000000; time < 1000000 + 3600; time += 7) {
+        incremental.Refresh(SECRET_SHA1, 20, sixDigits, time);
+        for (int offset = -1; offset <= 1; offset++) {
+            char code[6];
+            FormatOtpCode(HotpValue(SECRET_SHA1, 20, time / 30 + offset, HMAC_SHA1, 6), 6, code);
+            TotpCodeWindow copy = incremental;
+            CHECK(copy.Match(code, 6));
+        }
+    }
+}
+
+static void CheckBase32() {
+    CHECK(Base32Encode(SECRET_SHA1, 20) == "GEZDGNBVGY3TQOJQGEZDGNBVGY3TQOJQ");
+    CHECK(Base32Encode((const uint8_t*)"f", 1) == "MY");
+    std::vector<uint8_t> decoded;
+    CHECK(Base32Decode("gezd gnbv-gy3tqojqgezdgnbvgy3tqojq====", decoded));
+    CHECK(decoded.size() == 20 && memcmp(decoded.data(), SECRET_SHA1, 20) == 0);
+    CHECK(!Base32Decode("ABC1", decoded));
+}
+
+static volatile int g_sink;
+
+int main() {
+    CheckSha1();
+    CheckHmac();
+    CheckHotp();
+    CheckTotp();
+    CheckBase32();
+
+    // Per key press: compare against the precomputed window (refreshed every
+    // 1000 keys, far more often than once a second) versus three HMACs
+    TotpParameters parameters;
+    TotpCodeWindow window;
+    char typed[32];
+    memset(typed, '5', sizeof(typed));
+    const int KEYS = 1000000;
+    int hits = 0;
+    ToolClock::time_point start = ToolClock::now();
+    for (int i = 0; i < KEYS; i++) {
+        window.Refresh(SECRET_SHA1, 20, parameters, 1700000000 + i / 1000);
+        typed[31] = (char)('0' + i % 10);
+        hits += window.Match(typed, 32);
+    }
+    double windowSeconds = SecondsSince(start);
+
+    const int HASHED_KEYS = 100000;
+    start = ToolClock::now();
+    for (int i = 0; i < HASHED_KEYS; i++) {
+        for (int offset = -1; offset <= 1; offset++) {
+            char code[6];
+            FormatOtpCode(HotpValue(SECRET_SHA1, 20, 56666666 + offset + i, HMAC_SHA1, 6), 6, code);
+            hits += memcmp(code, typed + 26, 6) == 0;
+        }
+    }
+    double hashedSeconds = SecondsSince(start);
+    printf("per key: %.1f ns with the precomputed window, %.1f ns computing 3 HMACs\n",
+           windowSeconds * 1e9 / KEYS, hashedSeconds * 1e9 / HASHED_KEYS);
+    g_sink = hits;
+
+    return CheckResult("totp_vectors");
+}
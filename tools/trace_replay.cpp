@@ -0,0 +1,100 @@
+// tools/trace_replay.cpp
+// Command-line replayer for input traces recorded with "Record Input Trace"
+//
+// Builds anywhere with a C++17 compiler (no Windows headers needed). From the
+// repository root, compile this file together with
+//   src/features/lock_input/input_trace.cpp
+//   src/features/lock_input/input_trace_replay.cpp
+//   src/features/lock_input/lock_pipeline.cpp
+//   src/features/lock_input/lock_engine.cpp
+//   src/features/lock_input/hook_policy.cpp
+//   src/features/lock_input/chord_trie.cpp
+//   src/features/lock_input/key_translation.cpp
+//   src/features/lock_input/password_matcher.cpp
+//   src/utils/latency_histogram.cpp
+// using -std=c++17 -O2 -pthread -Isrc.
+//
+// Usage: trace_replay <trace.bin> [iterations] [password] [--mouse-lock[=all|clicks|wheel|confine]]
+//                     [--expect-unlocks=N]
+// With --expect-unlocks it exits with 1 unless every pass unlocks N times;
+// build.bat tools runs it that way on tools/traces/lock_session.bin, a
+// scripted session with two locks, each ended by typing 10203040 (scrubbed
+// to digits, so it replays with the password 00000000).
+
+#include "features/lock_input/input_trace_replay.h"
+#include "features/lock_input/input_trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <trace.bin> [iterations] [password] [--mouse-lock[=all|clicks|wheel|confine]] "
+                "[--expect-unlocks=N]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<uint8_t> trace;
+    if (!LoadInputTrace(argv[1], trace)) {
+        fprintf(stderr, "Cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    TraceReplayOptions options;
+    BuildDefaultReplayConfig(options.engine);
+    options.password = NULL;
+    options.iterations = 1;
+    long expectedUnlocks = -1;
+    for (int i = 2; i < argc; i++) {
+        if (strncmp(argv[i], "--expect-unlocks=", 17) == 0) {
+            expectedUnlocks = strtol(argv[i] + 17, NULL, 10);
+        } else if (strcmp(argv[i], "--mouse-lock") == 0) {
+            options.engine.mouseBlockMask = MouseLockEventMask(MOUSE_LOCK_ALL);
+        } else if (strncmp(argv[i], "--mouse-lock=", 13) == 0) {
+            static const char* MODE_NAMES[MOUSE_LOCK_MODE_COUNT] = { "all", "clicks", "wheel", "confine" };
+            int mode = 0;
+            while (mode < MOUSE_LOCK_MODE_COUNT && strcmp(argv[i] + 13, MODE_NAMES[mode]) != 0) mode++;
+            if (mode == MOUSE_LOCK_MODE_COUNT) {
+                fprintf(stderr, "Unknown mouse lock mode %s\n", argv[i] + 13);
+                return 2;
+            }
+            options.engine.mouseBlockMask = MouseLockEventMask(mode);
+        } else if (i == 2) {
+            options.iterations = (unsigned)strtoul(argv[i], NULL, 10);
+        } else {
+            options.password = argv[i];
+        }
+    }
+    if (options.iterations == 0) options.iterations = 1;
+
+    // One untimed-per-event pass for throughput, one timed pass for latency
+    TraceReplayStats stats;
+    options.measureLatency = false;
+    if (!ReplayInputTrace(trace.data(), trace.size(), options, stats)) {
+        fprintf(stderr, "%s is not a valid input trace\n", argv[1]);
+        return 1;
+    }
+    printf("events %llu (%llu blocked), %llu lock changes, %llu keys queued, %llu overflows\n",
+           (unsigned long long)stats.events, (unsigned long long)stats.blocked,
+           (unsigned long long)stats.lockChanges, (unsigned long long)stats.keysQueued,
+           (unsigned long long)stats.overflows);
+    printf("unlocks %llu, failsafe triggers %llu\n",
+           (unsigned long long)stats.unlocks, (unsigned long long)stats.failsafeTriggers);
+    printf("throughput %.1f M events/s (%.2f s)\n",
+           stats.seconds > 0.0 ? stats.events / stats.seconds / 1e6 : 0.0, stats.seconds);
+
+    options.measureLatency = true;
+    ReplayInputTrace(trace.data(), trace.size(), options, stats);
+    const LatencySummary& latency = stats.eventLatency;
+    printf("per-event ns: p50 %llu, p99 %llu, p99.9 %llu, max %llu, mean %.1f\n",
+           (unsigned long long)latency.p50, (unsigned long long)latency.p99,
+           (unsigned long long)latency.p999, (unsigned long long)latency.max, latency.mean);
+
+    if (expectedUnlocks >= 0 && stats.unlocks != (uint64_t)expectedUnlocks * options.iterations) {
+        fprintf(stderr, "expected %ld unlocks per pass, got %llu over %u passes\n", expectedUnlocks,
+                (unsigned long long)stats.unlocks, options.iterations);
+        return 1;
+    }
+    return 0;
+}
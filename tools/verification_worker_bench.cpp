@@ -0,0 +1,186 @@
+// tools/verification_worker_bench.cpp
+// VerificationWorker: enqueue-to-verdict delay, the bounded queue under bursts, cancellation and scrubbing
+//
+// From the repository root: g++ -std=c++17 -O2 -pthread -Isrc tools/verification_worker_bench.cpp
+//   src/features/lock_input/verification_worker.cpp
+// Each request carries its sequence number as its typed text, so the verify
+// callback knows which submission it is judging. Verification cost is
+// simulated by spinning, standing in for a key-stretched hash.
+
+#include "features/lock_input/verification_worker.h"
+#include "tool_check.h"
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+static const size_t MAX_REQUESTS = 4096;
+
+struct Harness {
+    ToolClock::time_point submittedAt[MAX_REQUESTS];
+    std::vector<double> delays;       // Submit to verdict, ms (worker thread only)
+    std::atomic<int> lastVerified;
+    std::atomic<int> matchSequence;   // This request's text is the password
+    std::atomic<int> completions;
+    double costMicroseconds;
+    std::atomic<bool> gateOpen;       // Verification waits while false
+    std::atomic<bool> inVerify;
+
+    Harness() : lastVerified(-1), matchSequence(-1), completions(0), costMicroseconds(0), gateOpen(true), inVerify(false) {}
+};
+
+static int ParseSequence(const PasswordCandidate& candidate) {
+    int sequence = 0;
+    for (size_t i = 0; i < candidate.length; i++) sequence = sequence * 10 + (candidate.data[i] - '0');
+    return sequence;
+}
+
+static int VerifyCandidates(const PasswordCandidate* candidates, size_t count, void* context) {
+    Harness* harness = (Harness*)context;
+    harness->inVerify = true;
+    while (!harness->gateOpen.load()) std::this_thread::yield();
+    ToolClock::time_point start = ToolClock::now();
+    while (SecondsSince(start) * 1e6 < harness->costMicroseconds) {
+    }
+
+    // Candidates come shortest first; the longest is the whole request
+    int sequence = ParseSequence(candidates[count - 1]);
+    harness->delays.push_back(SecondsSince(harness->submittedAt[sequence]) * 1e3);
+    harness->lastVerified = sequence;
+    harness->inVerify = false;
+    return sequence == harness->matchSequence.load() ? (int)count - 1 : -1;
+}
+
+static void OnComplete(uint32_t, size_t, void* context) {
+    ((Harness*)context)->completions++;
+}
+
+static void Submit(VerificationWorker& worker, Harness& harness, int sequence) {
+    char text[8];
+    snprintf(text, sizeof(text), "%06d", sequence);
+    harness.submittedAt[sequence] = ToolClock::now();
+    worker.Submit(text, 6, PasswordMatcher::LengthBit(3) | PasswordMatcher::LengthBit(6));
+}
+
+// Every submission ends verified, dropped or cancelled
+static void WaitForDrain(VerificationWorker& worker) {
+    for (int waited = 0; waited < 10000; waited++) {
+        VerificationStats stats = worker.GetStats();
+        if (stats.verified + stats.dropped + stats.cancelled == stats.submitted) return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(!"worker did not drain");
+}
+
+static void PrintDelays(const char* name, Harness& harness, const VerificationStats& stats) {
+    std::vector<double>& delays = harness.delays;
+    double p50 = Percentile(delays, 0.5), p99 = Percentile(delays, 0.99), worst = Percentile(delays, 1.0);
+    printf("%-30s %5llu submitted, %5llu verified, %5llu dropped; delay p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+           name, (unsigned long long)stats.submitted, (unsigned long long)stats.verified,
+           (unsigned long long)stats.dropped, p50, p99, worst);
+}
+
+// Typing slower than verification: nothing waits behind anything
+static void RunPaced() {
+    Harness harness;
+    harness.costMicroseconds = 500;
+    VerificationWorker worker;
+    CHECK(worker.Start(VerifyCandidates, OnComplete, &harness));
+    const int KEYS = 200;
+    for (int i = 0; i < KEYS; i++) {
+        Submit(worker, harness, i);
+        std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    }
+    WaitForDrain(worker);
+    VerificationStats stats = worker.GetStats();
+    CHECK(stats.submitted == KEYS && stats.verified == KEYS && stats.dropped == 0);
+    PrintDelays("paced (3 ms keys, 0.5 ms check)", harness, stats);
+    worker.Stop();
+}
+
+// Keys far faster than verification: the queue stays at QUEUE_CAPACITY and the newest input is checked
+static void RunBurst() {
+    Harness harness;
+    harness.costMicroseconds = 200;
+    VerificationWorker worker;
+    CHECK(worker.Start(VerifyCandidates, OnComplete, &harness));
+    const int KEYS = 2000;
+    harness.matchSequence = KEYS - 1;
+    for (int i = 0; i < KEYS; i++) Submit(worker, harness, i);
+    WaitForDrain(worker);
+
+    VerificationStats stats = worker.GetStats();
+    CHECK(stats.submitted == KEYS && stats.cancelled == 0);
+    CHECK(stats.verified + stats.dropped == KEYS);
+    CHECK(stats.verified >= VerificationWorker::QUEUE_CAPACITY);
+    CHECK(harness.lastVerified.load() == KEYS - 1); // Dropping is oldest first
+    CHECK(stats.matched == 1 && harness.completions.load() == 1);
+    PrintDelays("burst (2000 keys, 0.2 ms check)", harness, stats);
+    worker.Stop();
+}
+
+static bool Contains(const void* memory, size_t size, const char* text) {
+    size_t length = strlen(text);
+    const char* bytes = (const char*)memory;
+    for (size_t i = 0; i + length <= size; i++) {
+        if (memcmp(bytes + i, text, length) == 0) return true;
+    }
+    return false;
+}
+
+// A match in flight and requests queued behind it, then Cancel() and Stop().
+// The worker lives in storage we can search afterwards for typed text.
+static void RunCancel() {
+    alignas(VerificationWorker) static unsigned char storage[sizeof(VerificationWorker)];
+    VerificationWorker* worker = new (storage) VerificationWorker();
+    Harness harness;
+    harness.gateOpen = false;
+    CHECK(worker->Start(VerifyCandidates, OnComplete, &harness));
+
+    harness.matchSequence = 100;
+    Submit(*worker, harness, 100);
+    while (!harness.inVerify.load()) std::this_thread::yield();
+    for (int i = 101; i < 106; i++) Submit(*worker, harness, i);
+    CHECK(Contains(storage, sizeof(storage), "000105"));
+
+    ToolClock::time_point start = ToolClock::now();
+    uint32_t generation = worker->Cancel();
+    double cancelMicroseconds = SecondsSince(start) * 1e6;
+    CHECK(harness.inVerify.load()); // Cancel() did not wait for the check in progress
+    CHECK(generation == worker->GetGeneration());
+    CHECK(!Contains(storage, sizeof(storage), "000101") && !Contains(storage, sizeof(storage), "000105"));
+
+    // The in-flight check matches, but its generation is gone: no completion
+    harness.gateOpen = true;
+    WaitForDrain(*worker);
+    VerificationStats stats = worker->GetStats();
+    CHECK(stats.cancelled == 5 && stats.verified == 1 && stats.matched == 0);
+    CHECK(harness.completions.load() == 0);
+
+    // Requests after the cancel are judged normally
+    harness.matchSequence = 200;
+    Submit(*worker, harness, 200);
+    WaitForDrain(*worker);
+    CHECK(harness.completions.load() == 1);
+    CHECK(!Contains(storage, sizeof(storage), "000200"));
+
+    // Stop() with requests queued behind a blocked check
+    harness.gateOpen = false;
+    Submit(*worker, harness, 300);
+    while (!harness.inVerify.load()) std::this_thread::yield();
+    for (int i = 301; i < 304; i++) Submit(*worker, harness, i);
+    harness.gateOpen = true;
+    worker->Stop();
+    CHECK(!Contains(storage, sizeof(storage), "000301") && !Contains(storage, sizeof(storage), "000303"));
+    worker->~VerificationWorker();
+
+    printf("Cancel() with a check in flight: %.1f us\n", cancelMicroseconds);
+}
+
+int main() {
+    RunPaced();
+    RunBurst();
+    RunCancel();
+    return CheckResult("verification_worker_bench");
+}